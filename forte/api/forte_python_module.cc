@@ -33,6 +33,7 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libmints/wavefunction.h"
 
+#include "helpers/helpers.h"
 #include "helpers/printing.h"
 #include "helpers/lbfgs/rosenbrock.h"
 
@@ -144,6 +145,8 @@ PYBIND11_MODULE(forte, m) {
     m.def("make_ints_from_psi4", &make_forte_integrals_from_psi4,
           "Make Forte integral object from psi4");
     m.def("make_custom_ints", &make_custom_forte_integrals, "Make a custom integral object");
+    m.def("make_custom_ints_from_fcidump", &make_custom_forte_integrals_from_fcidump,
+          "Make a custom integral object from a FCIDUMP object");
     m.def("make_active_space_method", &make_active_space_method, "Make an active space method");
     m.def("make_active_space_solver", &make_active_space_solver, "Make an active space solver");
     m.def("make_orbital_transformation", &make_orbital_transformation,
@@ -232,6 +235,27 @@ PYBIND11_MODULE(forte, m) {
         .def("tei_aa", &ActiveSpaceIntegrals::tei_aa, "alpha-alpha two-electron integral <pq||rs>")
         .def("tei_ab", &ActiveSpaceIntegrals::tei_ab, "alpha-beta two-electron integral <pq|rs>")
         .def("tei_bb", &ActiveSpaceIntegrals::tei_bb, "beta-beta two-electron integral <pq||rs>")
+        .def(
+            "tei_aa_array",
+            [](ActiveSpaceIntegrals& ints) {
+                std::vector<size_t> dims(4, ints.nmo());
+                return vector_to_np(ints.tei_aa_vector(), dims);
+            },
+            "Return the alpha-alpha two-electron integrals <pq||rs> as a numpy array")
+        .def(
+            "tei_ab_array",
+            [](ActiveSpaceIntegrals& ints) {
+                std::vector<size_t> dims(4, ints.nmo());
+                return vector_to_np(ints.tei_ab_vector(), dims);
+            },
+            "Return the alpha-beta two-electron integrals <pq|rs> as a numpy array")
+        .def(
+            "tei_bb_array",
+            [](ActiveSpaceIntegrals& ints) {
+                std::vector<size_t> dims(4, ints.nmo());
+                return vector_to_np(ints.tei_bb_vector(), dims);
+            },
+            "Return the beta-beta two-electron integrals <pq||rs> as a numpy array")
         .def("print", &ActiveSpaceIntegrals::print, "Print the integrals (alpha-alpha case)");
 
     // export SemiCanonical
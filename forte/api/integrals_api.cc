@@ -26,13 +26,16 @@
  * @END LICENSE
  */
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "helpers/helpers.h"
+#include "integrals/fcidump.h"
 #include "integrals/integrals.h"
 
 namespace py = pybind11;
+using namespace pybind11::literals;
 
 namespace forte {
 
@@ -45,34 +48,34 @@ void export_ForteIntegrals(py::module& m) {
         .def(
             "oei_a_block",
             [](ForteIntegrals& ints, const std::vector<size_t>& p, const std::vector<size_t>& q) {
-                return ambit_to_np(ints.oei_a_block(p, q));
+                return ambit_to_np(ints.oei_a_block(p, q), true);
             },
             "Return the alpha 1e-integrals")
         .def(
             "oei_b_block",
             [](ForteIntegrals& ints, const std::vector<size_t>& p, const std::vector<size_t>& q) {
-                return ambit_to_np(ints.oei_b_block(p, q));
+                return ambit_to_np(ints.oei_b_block(p, q), true);
             },
             "Return the beta 1e-integrals")
         .def(
             "tei_aa_block",
             [](ForteIntegrals& ints, const std::vector<size_t>& p, const std::vector<size_t>& q,
                const std::vector<size_t>& r, const std::vector<size_t>& s) {
-                return ambit_to_np(ints.aptei_aa_block(p, q, r, s));
+                return ambit_to_np(ints.aptei_aa_block(p, q, r, s), true);
             },
             "Return the alpha-alpha 2e-integrals in physicists' notation")
         .def(
             "tei_ab_block",
             [](ForteIntegrals& ints, const std::vector<size_t>& p, const std::vector<size_t>& q,
                const std::vector<size_t>& r, const std::vector<size_t>& s) {
-                return ambit_to_np(ints.aptei_ab_block(p, q, r, s));
+                return ambit_to_np(ints.aptei_ab_block(p, q, r, s), true);
             },
             "Return the alpha-beta 2e-integrals in physicists' notation")
         .def(
             "tei_bb_block",
             [](ForteIntegrals& ints, const std::vector<size_t>& p, const std::vector<size_t>& q,
                const std::vector<size_t>& r, const std::vector<size_t>& s) {
-                return ambit_to_np(ints.aptei_bb_block(p, q, r, s));
+                return ambit_to_np(ints.aptei_bb_block(p, q, r, s), true);
             },
             "Return the beta-beta 2e-integrals in physicists' notation")
         .def("set_nuclear_repulsion", &ForteIntegrals::set_nuclear_repulsion,
@@ -82,5 +85,30 @@ void export_ForteIntegrals(py::module& m) {
         .def("set_tei", &ForteIntegrals::set_tei_all, "Set the two-electron integrals")
         .def("initialize", &ForteIntegrals::initialize, "Initialize the integrals")
         .def("print_ints", &ForteIntegrals::print_ints, "Print the integrals");
+
+    py::class_<FCIDUMP, std::shared_ptr<FCIDUMP>>(m, "FCIDUMP")
+        .def(py::init<const std::string&>(), "filename"_a, "Read a text or binary FCIDUMP file")
+        .def("norb", &FCIDUMP::norb, "Return the number of orbitals")
+        .def("nelec", &FCIDUMP::nelec, "Return the number of electrons")
+        .def("ms2", &FCIDUMP::ms2, "Return twice the spin projection")
+        .def("isym", &FCIDUMP::isym, "Return the symmetry of the state (starts from 1)")
+        .def("orbsym", &FCIDUMP::orbsym, "Return the symmetry of the orbitals (starts from 1)")
+        .def("pntgrp", &FCIDUMP::pntgrp, "Return the point group (empty if absent)")
+        .def("enuc", &FCIDUMP::enuc, "Return the scalar energy")
+        .def(
+            "hcore",
+            [](std::shared_ptr<FCIDUMP> fcidump) {
+                // a read-only view that keeps the FCIDUMP object alive
+                size_t n = fcidump->norb();
+                py::array_t<double> hcore({n, n}, fcidump->hcore().data(), py::cast(fcidump));
+                hcore.attr("flags").attr("writeable") = false;
+                return hcore;
+            },
+            "Return the one-electron integrals as a read-only numpy array")
+        .def("epsilon", &FCIDUMP::epsilon, "Return the orbital energies (empty if absent)")
+        .def("eri", &FCIDUMP::eri, "p"_a, "q"_a, "r"_a, "s"_a,
+             "Return the two-electron integral (pq|rs) in chemists' notation")
+        .def("write_binary", &FCIDUMP::write_binary, "filename"_a, "tolerance"_a = 0.0,
+             "Write the integrals in the binary FCIDUMP format");
 }
 } // namespace forte
@@ -37,60 +37,74 @@ using namespace pybind11::literals;
 
 namespace forte {
 
-/// Export the RDMs class
+namespace {
+/// Return a function that exports a stored RDM as a numpy array that shares its data.
+/// A writable view discards the quantities built from the RDMs (cumulants, spin-free RDMs, and
+/// ms-averaged spin cases), so they are rebuilt from the modified data when next requested.
+/// If spin_case is true the RDM is built from g1a/g2ab/g3aab when ms averaging is assumed, and
+/// then it can only be viewed read-only.
+template <typename Getter> auto rdm_to_np(Getter getter, bool spin_case = false) {
+    return [getter, spin_case](RDMs& rdm, bool writable) {
+        if (writable) {
+            if (spin_case and rdm.ms_avg()) {
+                throw std::runtime_error("This RDM is built from the alpha and alpha-beta RDMs "
+                                         "(ms averaging) and cannot be modified.");
+            }
+            rdm.clear_derived();
+        }
+        return ambit_to_np((rdm.*getter)(), writable);
+    };
+}
+
+/// Return a function that exports a quantity built from the RDMs as a read-only numpy array
+template <typename Getter> auto derived_to_np(Getter getter) {
+    return [getter](RDMs& rdm) { return ambit_to_np((rdm.*getter)()); };
+}
+} // namespace
+
+/// Export the RDMs class. The tensors are returned as read-only numpy views. The stored RDMs may
+/// be requested as writable views, in which case changes to the arrays are seen by the RDMs and
+/// the cumulants and spin-free RDMs are recomputed the next time they are requested. Request a
+/// writable view again after further changes to make sure these are recomputed.
 void export_RDMs(py::module& m) {
     py::class_<RDMs>(m, "RDMs")
         .def("max_rdm_level", &RDMs::max_rdm_level, "Return the max RDM level")
-        .def(
-            "g1a", [](RDMs& rdm) { return ambit_to_np(rdm.g1a()); },
-            "Return the alpha 1RDM as a numpy array")
-        .def(
-            "g1b", [](RDMs& rdm) { return ambit_to_np(rdm.g1b()); },
-            "Return the beta 1RDM as a numpy array")
-        .def(
-            "g2aa", [](RDMs& rdm) { return ambit_to_np(rdm.g2aa()); },
-            "Return the alpha-alpha 2RDM as a numpy array")
-        .def(
-            "g2ab", [](RDMs& rdm) { return ambit_to_np(rdm.g2ab()); },
-            "Return the alpha-beta 2RDM as a numpy array")
-        .def(
-            "g2bb", [](RDMs& rdm) { return ambit_to_np(rdm.g2bb()); },
-            "Return the beta-beta 2RDM as a numpy array")
-        .def(
-            "g3aaa", [](RDMs& rdm) { return ambit_to_np(rdm.g3aaa()); },
-            "Return the alpha-alpha-alpha 3RDM as a numpy array")
-        .def(
-            "g3aab", [](RDMs& rdm) { return ambit_to_np(rdm.g3aab()); },
-            "Return the alpha-alpha-beta 3RDM as a numpy array")
-        .def(
-            "g3abb", [](RDMs& rdm) { return ambit_to_np(rdm.g3abb()); },
-            "Return the alpha-beta-beta 3RDM as a numpy array")
-        .def(
-            "g3bbb", [](RDMs& rdm) { return ambit_to_np(rdm.g3bbb()); },
-            "Return the beta-beta-beta 3RDM as a numpy array")
-        .def(
-            "SFg2_data", [](RDMs& rdm) { return ambit_to_np(rdm.SFg2()); },
-            "Return the spin-free 2-RDM as a numpy array")
-        .def(
-            "L2aa", [](RDMs& rdm) { return ambit_to_np(rdm.L2aa()); },
-            "Return the alpha-alpha 2-cumulant as a numpy array")
-        .def(
-            "L2ab", [](RDMs& rdm) { return ambit_to_np(rdm.L2ab()); },
-            "Return the alpha-beta 2-cumulant as a numpy array")
-        .def(
-            "L2bb", [](RDMs& rdm) { return ambit_to_np(rdm.L2bb()); },
-            "Return the beta-beta 2-cumulant as a numpy array")
-        .def(
-            "L3aaa", [](RDMs& rdm) { return ambit_to_np(rdm.L3aaa()); },
-            "Return the alpha-alpha-alpha 3-cumulant as a numpy array")
-        .def(
-            "L3aab", [](RDMs& rdm) { return ambit_to_np(rdm.L3aab()); },
-            "Return the alpha-alpha-beta 3-cumulant as a numpy array")
-        .def(
-            "L3abb", [](RDMs& rdm) { return ambit_to_np(rdm.L3abb()); },
-            "Return the alpha-beta-beta 3-cumulant as a numpy array")
-        .def(
-            "L3bbb", [](RDMs& rdm) { return ambit_to_np(rdm.L3bbb()); },
-            "Return the beta-beta-beta 3-cumulant as a numpy array");
+        .def("ms_avg", &RDMs::ms_avg, "Return true if the RDMs assume ms averaging")
+        .def("clear_derived", &RDMs::clear_derived,
+             "Discard the cumulants and spin-free RDMs built from the stored RDMs")
+        .def("g1a", rdm_to_np(&RDMs::g1a), "writable"_a = false,
+             "Return the alpha 1RDM as a numpy array")
+        .def("g1b", rdm_to_np(&RDMs::g1b, true), "writable"_a = false,
+             "Return the beta 1RDM as a numpy array")
+        .def("g2aa", rdm_to_np(&RDMs::g2aa, true), "writable"_a = false,
+             "Return the alpha-alpha 2RDM as a numpy array")
+        .def("g2ab", rdm_to_np(&RDMs::g2ab), "writable"_a = false,
+             "Return the alpha-beta 2RDM as a numpy array")
+        .def("g2bb", rdm_to_np(&RDMs::g2bb, true), "writable"_a = false,
+             "Return the beta-beta 2RDM as a numpy array")
+        .def("g3aaa", rdm_to_np(&RDMs::g3aaa, true), "writable"_a = false,
+             "Return the alpha-alpha-alpha 3RDM as a numpy array")
+        .def("g3aab", rdm_to_np(&RDMs::g3aab), "writable"_a = false,
+             "Return the alpha-alpha-beta 3RDM as a numpy array")
+        .def("g3abb", rdm_to_np(&RDMs::g3abb, true), "writable"_a = false,
+             "Return the alpha-beta-beta 3RDM as a numpy array")
+        .def("g3bbb", rdm_to_np(&RDMs::g3bbb, true), "writable"_a = false,
+             "Return the beta-beta-beta 3RDM as a numpy array")
+        .def("SFg2_data", derived_to_np(&RDMs::SFg2),
+             "Return the spin-free 2-RDM as a read-only numpy array")
+        .def("L2aa", derived_to_np(&RDMs::L2aa),
+             "Return the alpha-alpha 2-cumulant as a read-only numpy array")
+        .def("L2ab", derived_to_np(&RDMs::L2ab),
+             "Return the alpha-beta 2-cumulant as a read-only numpy array")
+        .def("L2bb", derived_to_np(&RDMs::L2bb),
+             "Return the beta-beta 2-cumulant as a read-only numpy array")
+        .def("L3aaa", derived_to_np(&RDMs::L3aaa),
+             "Return the alpha-alpha-alpha 3-cumulant as a read-only numpy array")
+        .def("L3aab", derived_to_np(&RDMs::L3aab),
+             "Return the alpha-alpha-beta 3-cumulant as a read-only numpy array")
+        .def("L3abb", derived_to_np(&RDMs::L3abb),
+             "Return the alpha-beta-beta 3-cumulant as a read-only numpy array")
+        .def("L3bbb", derived_to_np(&RDMs::L3bbb),
+             "Return the beta-beta-beta 3-cumulant as a read-only numpy array");
 }
 } // namespace forte
@@ -175,7 +175,8 @@ void export_Determinant(py::module& m) {
     py::class_<SparseExp>(m, "SparseExp")
         .def(py::init<>())
         .def("compute", &SparseExp::compute, "sop"_a, "state"_a, "algorithm"_a = "cached",
-             "scaling_factor"_a = 1.0, "maxk"_a = 19, "screen_thresh"_a = 1.0e-12)
+             "scaling_factor"_a = 1.0, "maxk"_a = 19, "screen_thresh"_a = 1.0e-12,
+             "adaptive"_a = false)
         .def("timings", &SparseExp::timings);
 
     py::class_<SparseFactExp>(m, "SparseFactExp")
@@ -212,6 +213,8 @@ void export_SigmaVector(py::module& m) {
         .value("Full", SigmaVectorType::Full)
         .value("Dynamic", SigmaVectorType::Dynamic)
         .value("SparseList", SigmaVectorType::SparseList)
+        .value("GAS", SigmaVectorType::GAS)
+        .value("Hybrid", SigmaVectorType::Hybrid)
         .export_values();
 }
 
@@ -84,6 +84,8 @@ class DynamicCorrelationSolver {
     int diis_max_vec_;
     /// Frequency of extrapolating the current DIIS vectors
     int diis_freq_;
+    /// Store DIIS vectors in single precision
+    bool diis_float_;
 
     // ==> amplitudes file names <==
 
@@ -107,6 +107,28 @@ ambit::Tensor RDMs::g3bbb() {
     return g3bbb_;
 }
 
+void RDMs::clear_derived() {
+    if (ms_avg_) {
+        have_g1b_ = false;
+        have_g2aa_ = false;
+        have_g2bb_ = false;
+        have_g3aaa_ = false;
+        have_g3abb_ = false;
+        have_g3bbb_ = false;
+    }
+    have_L2aa_ = false;
+    have_L2ab_ = false;
+    have_L2bb_ = false;
+    have_L3aaa_ = false;
+    have_L3aab_ = false;
+    have_L3abb_ = false;
+    have_L3bbb_ = false;
+    have_SF_L1_ = false;
+    have_SF_L2_ = false;
+    have_SF_L3_ = false;
+    have_SF_g2_ = false;
+}
+
 ambit::Tensor RDMs::L2aa() {
     if (not have_L2aa_) {
         L2aa_ = g2aa().clone();
@@ -146,7 +168,7 @@ ambit::Tensor RDMs::L3aaa() {
 ambit::Tensor RDMs::L3aab() {
     if (not have_L3aab_) {
         L3aab_ = g3aab_.clone();
-        make_cumulant_L3aab_in_place(g1a_, g1b(), L2aa(), L2ab_, L3aab_);
+        make_cumulant_L3aab_in_place(g1a_, g1b(), L2aa(), L2ab(), L3aab_);
         have_L3aab_ = true;
     }
     return L3aab_;
@@ -155,7 +177,7 @@ ambit::Tensor RDMs::L3aab() {
 ambit::Tensor RDMs::L3abb() {
     if (not have_L3abb_) {
         L3abb_ = g3abb().clone();
-        make_cumulant_L3abb_in_place(g1a_, g1b(), L2ab_, L2bb(), L3abb_);
+        make_cumulant_L3abb_in_place(g1a_, g1b(), L2ab(), L2bb(), L3abb_);
         have_L3abb_ = true;
     }
     return L3abb_;
@@ -62,7 +62,8 @@ class MOSpaceInfo;
  *
  * auto L2aa = rdms.L2aa();
  *
- * @note Once passed in, the RDMs are assumed to be fixed and immutable.
+ * @note Once passed in, the RDMs are assumed to be fixed and immutable. If the stored RDMs are
+ * modified, call clear_derived() so that the quantities built from them are recomputed.
  *
  */
 class RDMs {
@@ -144,6 +145,10 @@ class RDMs {
     /// @return the spin-free 3-cumulant
     ambit::Tensor SF_L3();
 
+    /// Discard the cumulants, spin-free quantities, and (if ms averaged) spin cases built from
+    /// the stored RDMs. They are rebuilt from the current RDMs on the next request.
+    void clear_derived();
+
     // class variables
 
     size_t max_rdm_level() { return max_rdm_; }
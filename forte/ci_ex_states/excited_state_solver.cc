@@ -482,7 +482,8 @@ RDMs ExcitedStateSolver::compute_rdms(std::shared_ptr<ActiveSpaceIntegrals> fci_
     // TODO: this code might be OBSOLETE (Francesco)
     if (!direct_rdms_) {
         auto op = std::make_shared<DeterminantSubstitutionLists>(fci_ints);
-        if (sci_->sigma_vector_type() == SigmaVectorType::Dynamic) {
+        if (sci_->sigma_vector_type() == SigmaVectorType::Dynamic or
+            sci_->sigma_vector_type() == SigmaVectorType::GAS) {
             op->build_strings(dets);
         }
         op->op_s_lists(dets);
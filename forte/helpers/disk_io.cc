@@ -26,10 +26,12 @@
  * @END LICENSE
  */
 
+#include <cstring>
 #include <numeric>
 #include <iostream>
 #include <fstream>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "psi4/psi4-dec.h"
 
@@ -92,6 +94,61 @@ void read_disk_vector_double(const std::string& filename, std::vector<double>& d
     in.close();
 }
 
+void write_disk_vector_double_keyed(const std::string& filename, uint64_t key,
+                                    const std::vector<double>& data) {
+    uint64_t header[3] = {key, data.size(), hash_bytes(data.data(), data.size() * sizeof(double))};
+
+    std::string tmp_filename = filename + ".tmp." + std::to_string(getpid());
+    std::ofstream out(tmp_filename.c_str(), std::ios_base::binary);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+    out.close();
+
+    if (out.fail() or std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        remove(tmp_filename.c_str());
+        std::string error = "Error when writing " + filename;
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+}
+
+bool read_disk_vector_double_keyed(const std::string& filename, uint64_t key,
+                                   std::vector<double>& data) {
+    std::ifstream in(filename.c_str(), std::ios_base::binary);
+    if (!in.good()) {
+        return false;
+    }
+
+    uint64_t header[3];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in.good() or header[0] != key) {
+        return false;
+    }
+
+    data.resize(header[1]);
+    in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double));
+    if (!in.good() or hash_bytes(data.data(), data.size() * sizeof(double)) != header[2]) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+uint64_t hash_bytes(const void* data, size_t nbytes, uint64_t seed) {
+    constexpr uint64_t prime = 1099511628211ULL;
+    const char* bytes = static_cast<const char*>(data);
+    uint64_t hash = seed;
+    size_t nwords = nbytes / sizeof(uint64_t);
+    for (size_t i = 0; i < nwords; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        hash = (hash ^ word) * prime;
+    }
+    for (size_t i = nwords * sizeof(uint64_t); i < nbytes; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * prime;
+    }
+    return hash;
+}
+
 //std::string write_disk_BT(ambit::BlockedTensor& BT, const std::string& name,
 //                          const std::string& file_prefix) {
 //    auto block_labels = BT.block_labels();
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <numeric>
 #include <string>
@@ -67,6 +68,39 @@ void write_disk_vector_double(const std::string& filename, const std::vector<dou
  */
 void read_disk_vector_double(const std::string& filename, std::vector<double>& data);
 
+/**
+ * @brief Save a vector of double to file together with a key and a checksum
+ * @param filename The file name
+ * @param key A key that identifies the data
+ * @param data The data to be dumped
+ *
+ * The file is written under a temporary name and then renamed, so that readers never see a
+ * partially written file.
+ */
+void write_disk_vector_double_keyed(const std::string& filename, uint64_t key,
+                                    const std::vector<double>& data);
+
+/**
+ * @brief Read a vector of double written by write_disk_vector_double_keyed
+ * @param filename The file name
+ * @param key The expected key
+ * @param data The data to be read
+ * @return true if the file exists, has the expected key, and passes the checksum
+ */
+bool read_disk_vector_double_keyed(const std::string& filename, uint64_t key,
+                                   std::vector<double>& data);
+
+/**
+ * @brief Hash a sequence of bytes (64-bit FNV-1a over 8-byte words)
+ * @param data The bytes to be hashed
+ * @param nbytes The number of bytes
+ * @param seed The hash of the preceding bytes (if the data is hashed in pieces)
+ * @return The hash value
+ *
+ * When hashing in pieces, all pieces but the last must have a size that is a multiple of 8.
+ */
+uint64_t hash_bytes(const void* data, size_t nbytes, uint64_t seed = 14695981039346656037ULL);
+
 ///**
 // * @brief Save a BlockedTensor to file
 // * @param BT The BlockedTensor to be dumped to files
@@ -61,8 +61,15 @@ std::string get_ms_string(double twice_ms) {
     return ms_str;
 }
 
-py::array_t<double> ambit_to_np(ambit::Tensor t) {
-    return py::array_t<double>(t.dims(), &(t.data()[0]));
+py::array_t<double> ambit_to_np(ambit::Tensor t, bool writable) {
+    // the capsule owns a handle to the tensor and keeps its data alive
+    auto handle = new ambit::Tensor(t);
+    py::capsule owner(handle, [](void* ptr) { delete static_cast<ambit::Tensor*>(ptr); });
+    py::array_t<double> array(t.dims(), handle->data().data(), owner);
+    if (not writable) {
+        array.attr("flags").attr("writeable") = false;
+    }
+    return array;
 }
 
 py::array_t<double> vector_to_np(const std::vector<double>& v, const std::vector<size_t>& dims) {
@@ -73,6 +80,12 @@ py::array_t<double> vector_to_np(const std::vector<double>& v, const std::vector
     return py::array_t<double>(dims, &(v.data()[0]));
 }
 
+py::array_t<double> vector_to_np(std::vector<double>&& v, const std::vector<size_t>& dims) {
+    auto data = new std::vector<double>(std::move(v));
+    py::capsule owner(data, [](void* ptr) { delete static_cast<std::vector<double>*>(ptr); });
+    return py::array_t<double>(dims, data->data(), owner);
+}
+
 psi::SharedMatrix tensor_to_matrix(ambit::Tensor t) {
     size_t size1 = t.dim(0);
     size_t size2 = t.dim(1);
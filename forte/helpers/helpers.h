@@ -54,12 +54,14 @@ class Options;
 namespace forte {
 
 /**
- * @brief Convert an ambit tensor to a numpy ndarray.
- *        The returned tensor is stored according to the C storage convention.
- * @param t The input tensor
+ * @brief Convert an ambit tensor to a numpy ndarray without copying its data.
+ *        The returned array is a view stored according to the C storage convention.
+ *        The array holds a reference to the tensor, so the data stays alive as long as the array.
+ * @param t The input tensor (a CoreTensor)
+ * @param writable If false, the array is read-only. If true, changes are seen by the tensor.
  * @return A numpy array
  */
-py::array_t<double> ambit_to_np(ambit::Tensor t);
+py::array_t<double> ambit_to_np(ambit::Tensor t, bool writable = false);
 
 /**
  * @brief Convert a std::vector<double> to a numpy ndarray.
@@ -71,6 +73,15 @@ py::array_t<double> ambit_to_np(ambit::Tensor t);
 py::array_t<double> vector_to_np(const std::vector<double>& v, const std::vector<size_t>& dims);
 py::array_t<double> vector_to_np(const std::vector<double>& v, const std::vector<int>& dims);
 
+/**
+ * @brief Convert a std::vector<double> to a numpy ndarray that takes ownership of the data.
+ *        The vector is moved into the array, so its elements are not copied.
+ * @param v The input vector
+ * @param dims The dimensions of the tensor
+ * @return A numpy array
+ */
+py::array_t<double> vector_to_np(std::vector<double>&& v, const std::vector<size_t>& dims);
+
 /**
  * @brief tensor_to_matrix
  * @param t The input tensor
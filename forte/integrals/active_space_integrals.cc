@@ -38,6 +38,17 @@
 
 namespace forte {
 
+namespace {
+/// Store the occupied orbitals of a string in occ and return their number
+inline int string_occupation(String I, int* occ) {
+    int nocc = I.count();
+    for (int k = 0; k < nocc; ++k) {
+        occ[k] = I.find_and_clear_first_one();
+    }
+    return nocc;
+}
+} // namespace
+
 ActiveSpaceIntegrals::ActiveSpaceIntegrals(std::shared_ptr<ForteIntegrals> ints,
                                            const std::vector<size_t>& active_mo,
                                            const std::vector<int>& active_mo_symmetry,
@@ -168,26 +179,78 @@ void ActiveSpaceIntegrals::RestrictedOneBodyOperator(std::vector<double>& oei_a,
 void ActiveSpaceIntegrals::startup() {
 
     nmo2_ = nmo_ * nmo_;
-    nmo3_ = nmo_ * nmo_ * nmo_;
-    nmo4_ = nmo_ * nmo_ * nmo_ * nmo_;
 
     oei_a_.resize(nmo2_);
     oei_b_.resize(nmo2_);
-    tei_aa_.resize(nmo4_);
-    tei_ab_.resize(nmo4_);
-    tei_bb_.resize(nmo4_);
+    auto mo_sym = packing_symmetry();
+    tei_aa_ = std::make_shared<const SymmetryPackedTEI>(mo_sym, true);
+    tei_ab_ = std::make_shared<const SymmetryPackedTEI>(mo_sym, false);
+    tei_bb_ = tei_aa_;
+    set_tei_pointers();
     diag_tei_aa_.resize(nmo2_);
     diag_tei_ab_.resize(nmo2_);
     diag_tei_bb_.resize(nmo2_);
+    single_tei_aa_.assign(nmo2_ * nmo_, 0.0);
+    single_tei_ab_a_.assign(nmo2_ * nmo_, 0.0);
+    single_tei_ab_b_.assign(nmo2_ * nmo_, 0.0);
+    single_tei_bb_.assign(nmo2_ * nmo_, 0.0);
     frozen_core_energy_ = ints_->frozen_core_energy();
 }
 
 void ActiveSpaceIntegrals::set_active_integrals(const ambit::Tensor& act_aa,
                                                 const ambit::Tensor& act_ab,
                                                 const ambit::Tensor& act_bb) {
-    tei_aa_ = act_aa.data();
-    tei_ab_ = act_ab.data();
-    tei_bb_ = act_bb.data();
+    set_tei(act_aa.data(), act_ab.data(), act_bb.data());
+}
+
+std::vector<int> ActiveSpaceIntegrals::packing_symmetry() const {
+    if (active_mo_symmetry_.size() == nmo_) {
+        return active_mo_symmetry_;
+    }
+    return std::vector<int>(nmo_, 0);
+}
+
+void ActiveSpaceIntegrals::set_tei(const std::vector<double>& tei_aa,
+                                   const std::vector<double>& tei_ab,
+                                   const std::vector<double>& tei_bb) {
+    auto mo_sym = packing_symmetry();
+    tei_aa_ = std::make_shared<const SymmetryPackedTEI>(tei_aa, mo_sym, true);
+    tei_ab_ = std::make_shared<const SymmetryPackedTEI>(tei_ab, mo_sym, false);
+    // restricted integrals: keep a single copy of the same-spin integrals
+    if (tei_bb == tei_aa) {
+        tei_bb_ = tei_aa_;
+    } else {
+        tei_bb_ = std::make_shared<const SymmetryPackedTEI>(tei_bb, mo_sym, true);
+    }
+    set_tei_pointers();
+    compute_diagonal_integrals();
+}
+
+void ActiveSpaceIntegrals::set_tei_pointers() {
+    tei_aa_dense_ = tei_aa_->dense_data();
+    tei_ab_dense_ = tei_ab_->dense_data();
+    tei_bb_dense_ = tei_bb_->dense_data();
+}
+
+void ActiveSpaceIntegrals::compute_diagonal_integrals() {
+    for (size_t p = 0; p < nmo_; ++p) {
+        for (size_t q = 0; q < nmo_; ++q) {
+            diag_tei_aa_[p * nmo_ + q] = tei_aa_->get(p, q, p, q);
+            diag_tei_ab_[p * nmo_ + q] = tei_ab_->get(p, q, p, q);
+            diag_tei_bb_[p * nmo_ + q] = tei_bb_->get(p, q, p, q);
+        }
+    }
+    for (size_t i = 0; i < nmo_; ++i) {
+        for (size_t a = 0; a < nmo_; ++a) {
+            const size_t ia = (i * nmo_ + a) * nmo_;
+            for (size_t p = 0; p < nmo_; ++p) {
+                single_tei_aa_[ia + p] = tei_aa_->get(i, p, a, p);
+                single_tei_ab_a_[ia + p] = tei_ab_->get(i, p, a, p);
+                single_tei_ab_b_[ia + p] = tei_ab_->get(p, i, p, a);
+                single_tei_bb_[ia + p] = tei_bb_->get(i, p, a, p);
+            }
+        }
+    }
 }
 
 void ActiveSpaceIntegrals::compute_restricted_one_body_operator() {
@@ -202,9 +265,7 @@ void ActiveSpaceIntegrals::set_active_integrals_and_restricted_docc() {
     ambit::Tensor act_ab = ints_->aptei_ab_block(active_mo_, active_mo_, active_mo_, active_mo_);
     ambit::Tensor act_bb = ints_->aptei_bb_block(active_mo_, active_mo_, active_mo_, active_mo_);
 
-    tei_aa_ = act_aa.data();
-    tei_ab_ = act_ab.data();
-    tei_bb_ = act_bb.data();
+    set_tei(act_aa.data(), act_ab.data(), act_bb.data());
     RestrictedOneBodyOperator(oei_a_, oei_b_);
 }
 
@@ -215,40 +276,68 @@ std::vector<int> ActiveSpaceIntegrals::active_mo_symmetry() const { return activ
 std::vector<size_t> ActiveSpaceIntegrals::restricted_docc_mo() const { return restricted_docc_mo_; }
 
 double ActiveSpaceIntegrals::energy(const Determinant& det) const {
-    double energy = frozen_core_energy_;
+    int aocc[Norb];
+    int bocc[Norb];
+    int naocc = string_occupation(det.get_alfa_bits(), aocc);
+    int nbocc = string_occupation(det.get_beta_bits(), bocc);
+    return energy_from_occupation(aocc, naocc, bocc, nbocc);
+}
 
-    String Ia = det.get_alfa_bits();
-    String Ib = det.get_beta_bits();
-    String Iac;
-    String Ibc;
+std::vector<double> ActiveSpaceIntegrals::energy(const std::vector<Determinant>& dets) const {
+    std::vector<double> energies(dets.size());
+    compute_energies(dets, dets.size(), energies.data());
+    return energies;
+}
 
-    int naocc = Ia.count();
-    int nbocc = Ib.count();
+std::vector<double> ActiveSpaceIntegrals::energy(const det_hashvec& dets) const {
+    std::vector<double> energies(dets.size());
+    compute_energies(dets, dets.size(), energies.data());
+    return energies;
+}
+
+template <class Container>
+void ActiveSpaceIntegrals::compute_energies(const Container& dets, size_t n,
+                                            double* energies) const {
+#pragma omp parallel
+    {
+        int aocc[Norb];
+        int bocc[Norb];
+#pragma omp for schedule(static)
+        for (size_t I = 0; I < n; ++I) {
+            const Determinant& det = dets[I];
+            int naocc = string_occupation(det.get_alfa_bits(), aocc);
+            int nbocc = string_occupation(det.get_beta_bits(), bocc);
+            energies[I] = energy_from_occupation(aocc, naocc, bocc, nbocc);
+        }
+    }
+}
+
+double ActiveSpaceIntegrals::energy_from_occupation(const int* aocc, int naocc, const int* bocc,
+                                                    int nbocc) const {
+    double energy = frozen_core_energy_;
 
     for (int A = 0; A < naocc; ++A) {
-        int p = Ia.find_and_clear_first_one();
+        size_t p = aocc[A];
         energy += oei_a_[p * nmo_ + p];
 
-        Iac = Ia;
+        const double* diag_aa_p = &diag_tei_aa_[p * nmo_];
         for (int AA = A + 1; AA < naocc; ++AA) {
-            int q = Iac.find_and_clear_first_one();
-            energy += tei_aa_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+            energy += diag_aa_p[aocc[AA]];
         }
 
-        Ibc = Ib;
+        const double* diag_ab_p = &diag_tei_ab_[p * nmo_];
         for (int B = 0; B < nbocc; ++B) {
-            int q = Ibc.find_and_clear_first_one();
-            energy += tei_ab_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+            energy += diag_ab_p[bocc[B]];
         }
     }
 
     for (int B = 0; B < nbocc; ++B) {
-        int p = Ib.find_and_clear_first_one();
+        size_t p = bocc[B];
         energy += oei_b_[p * nmo_ + p];
-        Ibc = Ib;
+
+        const double* diag_bb_p = &diag_tei_bb_[p * nmo_];
         for (int BB = B + 1; BB < nbocc; ++BB) {
-            int q = Ibc.find_and_clear_first_one();
-            energy += tei_bb_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+            energy += diag_bb_p[bocc[BB]];
         }
     }
 
@@ -289,11 +378,11 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
                 matrix_element += oei_b_[p * nmo_ + p];
             for (size_t q = 0; q < nmo_; ++q) {
                 if (lhs.get_alfa_bit(p) and lhs.get_alfa_bit(q))
-                    matrix_element += 0.5 * tei_aa_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+                    matrix_element += 0.5 * tei_aa(p, q, p, q);
                 if (lhs.get_beta_bit(p) and lhs.get_beta_bit(q))
-                    matrix_element += 0.5 * tei_bb_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+                    matrix_element += 0.5 * tei_bb(p, q, p, q);
                 if (lhs.get_alfa_bit(p) and lhs.get_beta_bit(q))
-                    matrix_element += tei_ab_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+                    matrix_element += tei_ab(p, q, p, q);
             }
         }
     }
@@ -314,10 +403,10 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
         matrix_element = sign * oei_a_[i * nmo_ + j];
         for (size_t p = 0; p < nmo_; ++p) {
             if (lhs.get_alfa_bit(p) and rhs.get_alfa_bit(p)) {
-                matrix_element += sign * tei_aa_[i * nmo3_ + p * nmo2_ + j * nmo_ + p];
+                matrix_element += sign * tei_aa(i, p, j, p);
             }
             if (lhs.get_beta_bit(p) and rhs.get_beta_bit(p)) {
-                matrix_element += sign * tei_ab_[i * nmo3_ + p * nmo2_ + j * nmo_ + p];
+                matrix_element += sign * tei_ab(i, p, j, p);
             }
         }
     }
@@ -337,10 +426,10 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
         matrix_element = sign * oei_b_[i * nmo_ + j];
         for (size_t p = 0; p < nmo_; ++p) {
             if (lhs.get_alfa_bit(p) and rhs.get_alfa_bit(p)) {
-                matrix_element += sign * tei_ab_[p * nmo3_ + i * nmo2_ + p * nmo_ + j];
+                matrix_element += sign * tei_ab(p, i, p, j);
             }
             if (lhs.get_beta_bit(p) and rhs.get_beta_bit(p)) {
-                matrix_element += sign * tei_bb_[i * nmo3_ + p * nmo2_ + j * nmo_ + p];
+                matrix_element += sign * tei_bb(i, p, j, p);
             }
         }
     }
@@ -370,7 +459,7 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
         }
         // double sign = SlaterSign(I, i, j, k, l);
         double sign = lhs.slater_sign_aaaa(i, j, k, l);
-        matrix_element = sign * tei_aa_[i * nmo3_ + j * nmo2_ + k * nmo_ + l];
+        matrix_element = sign * tei_aa(i, j, k, l);
     }
 
     // Slater rule 3 PhiI = k_a^+ l_a^+ j_a i_a PhiJ
@@ -399,7 +488,7 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
         }
         // double sign = SlaterSign(I, nmo_ + i, nmo_ + j, nmo_ + k, nmo_ + l);
         double sign = lhs.slater_sign_bbbb(i, j, k, l);
-        matrix_element = sign * tei_bb_[i * nmo3_ + j * nmo2_ + k * nmo_ + l];
+        matrix_element = sign * tei_bb(i, j, k, l);
     }
 
     // Slater rule 3 PhiI = j_a^+ i_a PhiJ
@@ -420,7 +509,7 @@ double ActiveSpaceIntegrals::slater_rules(const Determinant& lhs, const Determin
         //  double sign = SlaterSign(I, i, nmo_ + j, k, nmo_ + l);
         // double sign = lhs.slater_sign(i, nmo_ + j, k, nmo_ + l);
         double sign = lhs.slater_sign_aa(i, k) * lhs.slater_sign_bb(j, l);
-        matrix_element = sign * tei_ab_[i * nmo3_ + j * nmo2_ + k * nmo_ + l];
+        matrix_element = sign * tei_ab(i, j, k, l);
     }
 #endif
     return (matrix_element);
@@ -432,10 +521,10 @@ double ActiveSpaceIntegrals::slater_rules_single_alpha(const Determinant& det, i
     double matrix_element = oei_a_[i * nmo_ + a];
     for (size_t p = 0; p < nmo_; ++p) {
         if (det.get_alfa_bit(p)) {
-            matrix_element += tei_aa_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_aa(i, p, a, p);
         }
         if (det.get_beta_bit(p)) {
-            matrix_element += tei_ab_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_ab(i, p, a, p);
         }
     }
     return sign * matrix_element;
@@ -447,10 +536,10 @@ double ActiveSpaceIntegrals::slater_rules_single_alpha_abs(const Determinant& de
     double matrix_element = oei_a_[i * nmo_ + a];
     for (size_t p = 0; p < nmo_; ++p) {
         if (det.get_alfa_bit(p)) {
-            matrix_element += tei_aa_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_aa(i, p, a, p);
         }
         if (det.get_beta_bit(p)) {
-            matrix_element += tei_ab_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_ab(i, p, a, p);
         }
     }
     return matrix_element;
@@ -462,10 +551,10 @@ double ActiveSpaceIntegrals::slater_rules_single_beta(const Determinant& det, in
     double matrix_element = oei_b_[i * nmo_ + a];
     for (size_t p = 0; p < nmo_; ++p) {
         if (det.get_alfa_bit(p)) {
-            matrix_element += tei_ab_[p * nmo3_ + i * nmo2_ + p * nmo_ + a];
+            matrix_element += tei_ab(p, i, p, a);
         }
         if (det.get_beta_bit(p)) {
-            matrix_element += tei_bb_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_bb(i, p, a, p);
         }
     }
     return sign * matrix_element;
@@ -477,15 +566,57 @@ double ActiveSpaceIntegrals::slater_rules_single_beta_abs(const Determinant& det
     double matrix_element = oei_b_[i * nmo_ + a];
     for (size_t p = 0; p < nmo_; ++p) {
         if (det.get_alfa_bit(p)) {
-            matrix_element += tei_ab_[p * nmo3_ + i * nmo2_ + p * nmo_ + a];
+            matrix_element += tei_ab(p, i, p, a);
         }
         if (det.get_beta_bit(p)) {
-            matrix_element += tei_bb_[i * nmo3_ + p * nmo2_ + a * nmo_ + p];
+            matrix_element += tei_bb(i, p, a, p);
         }
     }
     return matrix_element;
 }
 
+void ActiveSpaceIntegrals::slater_rules_singles_alpha_abs(
+    const std::vector<int>& aocc, const std::vector<int>& bocc,
+    const std::vector<std::pair<int, int>>& excitations, std::vector<double>& couplings) const {
+    // <ip||ap> vanishes for p = i and p = a, so the occupation of det or of the excited
+    // determinant give the same matrix element
+    couplings.resize(excitations.size());
+    for (size_t k = 0, maxk = excitations.size(); k < maxk; ++k) {
+        size_t i = excitations[k].first;
+        size_t a = excitations[k].second;
+        const double* tei_aa_ia = &single_tei_aa_[(i * nmo_ + a) * nmo_];
+        const double* tei_ab_ia = &single_tei_ab_a_[(i * nmo_ + a) * nmo_];
+        double matrix_element = oei_a_[i * nmo_ + a];
+        for (int p : aocc) {
+            matrix_element += tei_aa_ia[p];
+        }
+        for (int p : bocc) {
+            matrix_element += tei_ab_ia[p];
+        }
+        couplings[k] = matrix_element;
+    }
+}
+
+void ActiveSpaceIntegrals::slater_rules_singles_beta_abs(
+    const std::vector<int>& aocc, const std::vector<int>& bocc,
+    const std::vector<std::pair<int, int>>& excitations, std::vector<double>& couplings) const {
+    couplings.resize(excitations.size());
+    for (size_t k = 0, maxk = excitations.size(); k < maxk; ++k) {
+        size_t i = excitations[k].first;
+        size_t a = excitations[k].second;
+        const double* tei_ab_ia = &single_tei_ab_b_[(i * nmo_ + a) * nmo_];
+        const double* tei_bb_ia = &single_tei_bb_[(i * nmo_ + a) * nmo_];
+        double matrix_element = oei_b_[i * nmo_ + a];
+        for (int p : aocc) {
+            matrix_element += tei_ab_ia[p];
+        }
+        for (int p : bocc) {
+            matrix_element += tei_bb_ia[p];
+        }
+        couplings[k] = matrix_element;
+    }
+}
+
 void ActiveSpaceIntegrals::print() {
     psi::outfile->Printf("\n\n  ==> Active Space Integrals <==\n");
     psi::outfile->Printf("\n  Nuclear repulsion energy:   %20.12f\n", nuclear_repulsion_energy());
@@ -30,7 +30,9 @@
 #define _active_space_integrals_
 
 #include "integrals/integrals.h"
+#include "integrals/symmetry_packed_tei.h"
 #include "sparse_ci/determinant.h"
+#include "sparse_ci/determinant_hashvector.h"
 
 class Dimension;
 
@@ -84,6 +86,11 @@ class ActiveSpaceIntegrals {
     /// Compute a determinant's energy
     double energy(const Determinant& det) const;
 
+    /// Compute the energy of a list of determinants (in parallel)
+    std::vector<double> energy(const std::vector<Determinant>& dets) const;
+    /// Compute the energy of a list of determinants (in parallel)
+    std::vector<double> energy(const det_hashvec& dets) const;
+
     /// Compute the matrix element of the Hamiltonian between this determinant
     /// and a given one
     double slater_rules(const Determinant& lhs, const Determinant& rhs) const;
@@ -100,6 +107,23 @@ class ActiveSpaceIntegrals {
     /// and a given one
     double slater_rules_single_beta_abs(const Determinant& det, int i, int a) const;
 
+    /**
+     * @brief Compute the unsigned matrix elements between a determinant and a list of its alpha
+     * single excitations a^+_a a_i |det> (slater_rules_single_alpha_abs for a block of i, a)
+     * @param aocc the alpha occupied orbitals of det
+     * @param bocc the beta occupied orbitals of det
+     * @param excitations a list of (i, a) pairs
+     * @param couplings the matrix elements of each excitation
+     */
+    void slater_rules_singles_alpha_abs(const std::vector<int>& aocc,
+                                        const std::vector<int>& bocc,
+                                        const std::vector<std::pair<int, int>>& excitations,
+                                        std::vector<double>& couplings) const;
+    /// Same as slater_rules_singles_alpha_abs for beta single excitations
+    void slater_rules_singles_beta_abs(const std::vector<int>& aocc, const std::vector<int>& bocc,
+                                       const std::vector<std::pair<int, int>>& excitations,
+                                       std::vector<double>& couplings) const;
+
     /// Return the alpha effective one-electron integral
     double oei_a(size_t p, size_t q) const { return oei_a_[p * nmo_ + q]; }
     /// Return the beta effective one-electron integral
@@ -109,35 +133,41 @@ class ActiveSpaceIntegrals {
 
     /// Return the alpha-alpha antisymmetrized two-electron integral <pq||rs>
     double tei_aa(size_t p, size_t q, size_t r, size_t s) const {
-        return tei_aa_[nmo3_ * p + nmo2_ * q + nmo_ * r + s];
+        return tei_aa_dense_ ? tei_aa_dense_[((p * nmo_ + q) * nmo_ + r) * nmo_ + s]
+                             : tei_aa_->get(p, q, r, s);
     }
     /// Return the alpha-beta two-electron integral <pq|rs>
     double tei_ab(size_t p, size_t q, size_t r, size_t s) const {
-        return tei_ab_[nmo3_ * p + nmo2_ * q + nmo_ * r + s];
+        return tei_ab_dense_ ? tei_ab_dense_[((p * nmo_ + q) * nmo_ + r) * nmo_ + s]
+                             : tei_ab_->get(p, q, r, s);
     }
     /// Return the beta-beta antisymmetrized two-electron integral <pq||rs>
     double tei_bb(size_t p, size_t q, size_t r, size_t s) const {
-        return tei_bb_[nmo3_ * p + nmo2_ * q + nmo_ * r + s];
+        return tei_bb_dense_ ? tei_bb_dense_[((p * nmo_ + q) * nmo_ + r) * nmo_ + s]
+                             : tei_bb_->get(p, q, r, s);
     }
+    /// Return the alpha-beta integrals <pq|rs> as a flat nmo^4 array, or nullptr if they are
+    /// stored packed (see SymmetryPackedTEI)
+    const double* tei_ab_dense() const { return tei_ab_dense_; }
 
-    /// Return a vector of alpha-alpha antisymmetrized two-electron integrals
-    const std::vector<double>& tei_aa_vector() const { return tei_aa_; }
-    /// Return a vector of alpha-beta antisymmetrized two-electron integrals
-    const std::vector<double>& tei_ab_vector() const { return tei_ab_; }
-    /// Return a vector of beta-beta antisymmetrized two-electron integrals
-    const std::vector<double>& tei_bb_vector() const { return tei_bb_; }
+    /// Return a dense vector of alpha-alpha antisymmetrized two-electron integrals
+    std::vector<double> tei_aa_vector() const { return tei_aa_->dense(); }
+    /// Return a dense vector of alpha-beta antisymmetrized two-electron integrals
+    std::vector<double> tei_ab_vector() const { return tei_ab_->dense(); }
+    /// Return a dense vector of beta-beta antisymmetrized two-electron integrals
+    std::vector<double> tei_bb_vector() const { return tei_bb_->dense(); }
 
     /// Return the alpha-alpha antisymmetrized two-electron integral <pq||pq>
     double diag_tei_aa(size_t p, size_t q) const {
-        return tei_aa_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+        return diag_tei_aa_[p * nmo_ + q];
     }
     /// Return the alpha-beta two-electron integral <pq|rs>
     double diag_tei_ab(size_t p, size_t q) const {
-        return tei_ab_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+        return diag_tei_ab_[p * nmo_ + q];
     }
     /// Return the beta-beta antisymmetrized two-electron integral <pq||rs>
     double diag_tei_bb(size_t p, size_t q) const {
-        return tei_bb_[p * nmo3_ + q * nmo2_ + p * nmo_ + q];
+        return diag_tei_bb_[p * nmo_ + q];
     }
     IntegralType get_integral_type() { return integral_type_; }
     /// Set the active integrals
@@ -168,10 +198,6 @@ class ActiveSpaceIntegrals {
     size_t nmo_;
     /// The number of MOs squared
     size_t nmo2_;
-    /// The number of MOs cubed
-    size_t nmo3_;
-    /// The number of MOs to the fourth power
-    size_t nmo4_;
     /// The integral type
     IntegralType integral_type_;
     /// The integrals object
@@ -185,14 +211,19 @@ class ActiveSpaceIntegrals {
     /// The beta one-electron integrals
     std::vector<double> oei_b_;
     /// The alpha-alpha antisymmetrized two-electron integrals in physicist
-    /// notation
-    std::vector<double> tei_aa_;
+    /// notation. The packed integrals are immutable and shared by copies of this object
+    std::shared_ptr<const SymmetryPackedTEI> tei_aa_;
     /// The alpha-beta antisymmetrized two-electron integrals in physicist
     /// notation
-    std::vector<double> tei_ab_;
+    std::shared_ptr<const SymmetryPackedTEI> tei_ab_;
     /// The beta-beta antisymmetrized two-electron integrals in physicist
-    /// notation
-    std::vector<double> tei_bb_;
+    /// notation (the same object as tei_aa_ for restricted integrals)
+    std::shared_ptr<const SymmetryPackedTEI> tei_bb_;
+    /// The flat arrays of tei_aa_, tei_ab_, and tei_bb_ when they are small enough not to be
+    /// packed (nullptr otherwise)
+    const double* tei_aa_dense_ = nullptr;
+    const double* tei_ab_dense_ = nullptr;
+    const double* tei_bb_dense_ = nullptr;
     /// The diagonal alpha-alpha antisymmetrized two-electron integrals in
     /// physicist notation
     std::vector<double> diag_tei_aa_;
@@ -202,6 +233,13 @@ class ActiveSpaceIntegrals {
     /// The diagonal beta-beta antisymmetrized two-electron integrals in
     /// physicist notation
     std::vector<double> diag_tei_bb_;
+    /// The integrals that enter the single-replacement matrix elements, stored as contiguous
+    /// rows over p: <ip||ap> (aa), <ip|ap> (ab, alpha), <pi|pa> (ab, beta), and <ip||ap> (bb),
+    /// each at [(i * nmo + a) * nmo + p]
+    std::vector<double> single_tei_aa_;
+    std::vector<double> single_tei_ab_a_;
+    std::vector<double> single_tei_ab_b_;
+    std::vector<double> single_tei_bb_;
     /// A vector of indices for the active molecular orbitals
     std::vector<size_t> active_mo_;
     /// A vector of the symmetry ofthe active molecular orbitals
@@ -211,9 +249,21 @@ class ActiveSpaceIntegrals {
 
     // ==> Class Private Functions <==
 
-    inline size_t tei_index(size_t p, size_t q, size_t r, size_t s) const {
-        return nmo3_ * p + nmo2_ * q + nmo_ * r + s;
-    }
+    /// Set tei_*_dense_ from the stored integrals
+    void set_tei_pointers();
+    /// Pack and store the dense two-electron integrals
+    void set_tei(const std::vector<double>& tei_aa, const std::vector<double>& tei_ab,
+                 const std::vector<double>& tei_bb);
+    /// The orbital symmetry used to pack the integrals
+    std::vector<int> packing_symmetry() const;
+    /// Store the diagonal integrals <pq||pq> and <pq|pq> contiguously in diag_tei_*_ and the
+    /// single-replacement integrals in single_tei_*_
+    void compute_diagonal_integrals();
+    /// The energy of a determinant with the given lists of alpha and beta occupied orbitals
+    double energy_from_occupation(const int* aocc, int naocc, const int* bocc, int nbocc) const;
+    /// Compute the energy of n determinants dets[0], ..., dets[n - 1] (in parallel)
+    template <class Container>
+    void compute_energies(const Container& dets, size_t n, double* energies) const;
     /// F^{closed}_{uv} = h_{uv} + \sum_{i = frozen_core}^{restricted_core} 2(uv|ii) - (ui|vi)
     void RestrictedOneBodyOperator(std::vector<double>& oei_a, std::vector<double>& oei_b);
     void startup();
@@ -103,36 +103,21 @@ ambit::Tensor CholeskyIntegrals::aptei_aa_block(const std::vector<size_t>& p,
                                                 const std::vector<size_t>& q,
                                                 const std::vector<size_t>& r,
                                                 const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_aa(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, true);
 }
 
 ambit::Tensor CholeskyIntegrals::aptei_ab_block(const std::vector<size_t>& p,
                                                 const std::vector<size_t>& q,
                                                 const std::vector<size_t>& r,
                                                 const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_ab(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, false);
 }
 
 ambit::Tensor CholeskyIntegrals::aptei_bb_block(const std::vector<size_t>& p,
                                                 const std::vector<size_t>& q,
                                                 const std::vector<size_t>& r,
                                                 const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_bb(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, true);
 }
 
 double CholeskyIntegrals::three_integral(size_t A, size_t p, size_t q) const {
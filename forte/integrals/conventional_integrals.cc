@@ -39,6 +39,7 @@
 #include "base_classes/mo_space_info.h"
 
 #include "helpers/blockedtensorfactory.h"
+#include "helpers/disk_io.h"
 #include "helpers/timer.h"
 #include "helpers/printing.h"
 
@@ -170,50 +171,42 @@ void ConventionalIntegrals::gather_integrals() {
         outfile->Printf("\n  Computing Conventional Integrals");
     }
     local_timer timer;
-    MintsHelper mints = MintsHelper(wfn_->basisset());
-    mints.integrals();
-    auto integral_transform = transform_integrals();
 
     if (print_ > 0) {
-        outfile->Printf("\n  Reading the two-electron integrals from disk");
         outfile->Printf("\n  Size of two-electron integrals: %10.6f GB",
                         double(3 * 8 * num_aptei_) / 1073741824.0);
     }
     int_mem_ = sizeof(double) * 3 * 8 * num_aptei_ / 1073741824.0;
 
-    std::fill(aphys_tei_aa_.begin(), aphys_tei_aa_.end(), 0.0);
-    std::fill(aphys_tei_ab_.begin(), aphys_tei_ab_.end(), 0.0);
-    std::fill(aphys_tei_bb_.begin(), aphys_tei_bb_.end(), 0.0);
+    // the integrals may have been resorted to the correlated orbitals by a previous call
+    aphys_tei_aa_.assign(num_aptei_, 0.0);
+    aphys_tei_ab_.assign(num_aptei_, 0.0);
 
     if (spin_restriction_ == IntegralSpinRestriction::Restricted) {
-        std::vector<double> two_electron_integrals(num_tei_, 0.0);
-
-        // Read the integrals
-        dpdbuf4 K;
-        std::shared_ptr<PSIO> psio(_default_psio_lib_);
-        psio->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
-        // To only process the permutationally unique integrals, change the
-        // ID("[A,A]") to ID("[A>=A]+")
-        global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[A,A]"), ID("[A,A]"), ID("[A>=A]+"),
-                               ID("[A>=A]+"), 0, "MO Ints (AA|AA)");
-        for (int h = 0; h < nirrep_; ++h) {
-            global_dpd_->buf4_mat_irrep_init(&K, h);
-            global_dpd_->buf4_mat_irrep_rd(&K, h);
-            for (int pq = 0; pq < K.params->rowtot[h]; ++pq) {
-                int p = K.params->roworb[h][pq][0];
-                int q = K.params->roworb[h][pq][1];
-                for (int rs = 0; rs < K.params->coltot[h]; ++rs) {
-                    int r = K.params->colorb[h][rs][0];
-                    int s = K.params->colorb[h][rs][1];
-                    two_electron_integrals[INDEX4(p, q, r, s)] = K.matrix[h][pq][rs];
+        std::vector<double> two_electron_integrals;
+
+        // skip the transformation if the integrals for these orbitals are cached
+        uint64_t key = orbital_hash();
+        auto cache_file = integral_cache_file("conventional", key);
+        if (not cache_file.empty() and
+            read_disk_vector_double_keyed(cache_file, key, two_electron_integrals) and
+            two_electron_integrals.size() == num_tei_) {
+            if (print_ > 0) {
+                outfile->Printf("\n  Two-electron integrals read from %s", cache_file.c_str());
+            }
+        } else {
+            read_transformed_integrals(two_electron_integrals);
+            if (not cache_file.empty()) {
+                write_disk_vector_double_keyed(cache_file, key, two_electron_integrals);
+                if (print_ > 0) {
+                    outfile->Printf("\n  Two-electron integrals written to %s",
+                                    cache_file.c_str());
                 }
             }
-            global_dpd_->buf4_mat_irrep_close(&K, h);
         }
-        global_dpd_->buf4_close(&K);
-        psio->close(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
 
         // Store the integrals
+#pragma omp parallel for schedule(dynamic)
         for (size_t p = 0; p < nmo_; ++p) {
             for (size_t q = 0; q < nmo_; ++q) {
                 for (size_t r = 0; r < nmo_; ++r) {
@@ -224,11 +217,12 @@ void ConventionalIntegrals::gather_integrals() {
                         size_t index = aptei_index(p, q, r, s);
                         aphys_tei_aa_[index] = direct - exchange;
                         aphys_tei_ab_[index] = direct;
-                        aphys_tei_bb_[index] = direct - exchange;
                     }
                 }
             }
         }
+        // restricted orbitals: the beta-beta integrals are identical to the alpha-alpha ones
+        aphys_tei_bb_ = aphys_tei_aa_;
     } else {
         outfile->Printf("\n  Unrestricted orbitals are currently disabled");
         throw psi::PSIEXCEPTION("Unrestricted orbitals are currently disabled in "
@@ -239,6 +233,42 @@ void ConventionalIntegrals::gather_integrals() {
     }
 }
 
+void ConventionalIntegrals::read_transformed_integrals(std::vector<double>& tei) {
+    MintsHelper mints = MintsHelper(wfn_->basisset());
+    mints.integrals();
+    auto integral_transform = transform_integrals();
+
+    if (print_ > 0) {
+        outfile->Printf("\n  Reading the two-electron integrals from disk");
+    }
+    tei.assign(num_tei_, 0.0);
+
+    // Read the integrals
+    dpdbuf4 K;
+    std::shared_ptr<PSIO> psio(_default_psio_lib_);
+    psio->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
+    // To only process the permutationally unique integrals, change the
+    // ID("[A,A]") to ID("[A>=A]+")
+    global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[A,A]"), ID("[A,A]"), ID("[A>=A]+"),
+                           ID("[A>=A]+"), 0, "MO Ints (AA|AA)");
+    for (int h = 0; h < nirrep_; ++h) {
+        global_dpd_->buf4_mat_irrep_init(&K, h);
+        global_dpd_->buf4_mat_irrep_rd(&K, h);
+        for (int pq = 0; pq < K.params->rowtot[h]; ++pq) {
+            int p = K.params->roworb[h][pq][0];
+            int q = K.params->roworb[h][pq][1];
+            for (int rs = 0; rs < K.params->coltot[h]; ++rs) {
+                int r = K.params->colorb[h][rs][0];
+                int s = K.params->colorb[h][rs][1];
+                tei[INDEX4(p, q, r, s)] = K.matrix[h][pq][rs];
+            }
+        }
+        global_dpd_->buf4_mat_irrep_close(&K, h);
+    }
+    global_dpd_->buf4_close(&K);
+    psio->close(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
+}
+
 void ConventionalIntegrals::resort_integrals_after_freezing() {
     if (print_ > 0) {
         outfile->Printf("\n  Resorting integrals after freezing core.");
@@ -249,22 +279,4 @@ void ConventionalIntegrals::resort_integrals_after_freezing() {
     resort_four(aphys_tei_bb_, cmotomo_);
 }
 
-void ConventionalIntegrals::resort_four(std::vector<double>& tei, std::vector<size_t>& map) {
-    // Store the integrals in a temporary array
-    size_t num_aptei_corr = nmo_ * nmo_ * nmo_ * nmo_;
-    std::vector<double> temp_ints(num_aptei_corr, 0.0);
-    for (size_t p = 0; p < ncmo_; ++p) {
-        for (size_t q = 0; q < ncmo_; ++q) {
-            for (size_t r = 0; r < ncmo_; ++r) {
-                for (size_t s = 0; s < ncmo_; ++s) {
-                    size_t pqrs_cmo = ncmo_ * ncmo_ * ncmo_ * p + ncmo_ * ncmo_ * q + ncmo_ * r + s;
-                    size_t pqrs_mo =
-                        nmo_ * nmo_ * nmo_ * map[p] + nmo_ * nmo_ * map[q] + nmo_ * map[r] + map[s];
-                    temp_ints[pqrs_cmo] = tei[pqrs_mo];
-                }
-            }
-        }
-    }
-    temp_ints.swap(tei);
-}
 } // namespace forte
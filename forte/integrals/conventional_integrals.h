@@ -80,7 +80,8 @@ class ConventionalIntegrals : public Psi4Integrals {
 
     /// Transform the integrals
     std::shared_ptr<psi::IntegralTransform> transform_integrals();
-    void resort_four(std::vector<double>& tei, std::vector<size_t>& map);
+    /// Transform the integrals and read the unique (pq|rs) from the DPD file
+    void read_transformed_integrals(std::vector<double>& tei);
 
     // ==> Class private virtual functions <==
     void gather_integrals() override;
@@ -56,11 +56,11 @@ CustomIntegrals::CustomIntegrals(std::shared_ptr<ForteOptions> options,
                                  std::shared_ptr<MOSpaceInfo> mo_space_info,
                                  IntegralSpinRestriction restricted, double scalar,
                                  const std::vector<double>& oei_a, const std::vector<double>& oei_b,
-                                 const std::vector<double>& tei_aa,
-                                 const std::vector<double>& tei_ab,
-                                 const std::vector<double>& tei_bb)
-    : ForteIntegrals(options, mo_space_info, Custom, restricted), full_aphys_tei_aa_(tei_aa),
-      full_aphys_tei_ab_(tei_ab), full_aphys_tei_bb_(tei_bb) {
+                                 std::vector<double> tei_aa, std::vector<double> tei_ab,
+                                 std::vector<double> tei_bb)
+    : ForteIntegrals(options, mo_space_info, Custom, restricted),
+      full_aphys_tei_aa_(std::move(tei_aa)), full_aphys_tei_ab_(std::move(tei_ab)),
+      full_aphys_tei_bb_(std::move(tei_bb)) {
     set_nuclear_repulsion(scalar);
     set_oei_all(oei_a, oei_b);
     initialize();
@@ -165,25 +165,6 @@ void CustomIntegrals::resort_integrals_after_freezing() {
     resort_four(aphys_tei_bb_, cmotomo_);
 }
 
-void CustomIntegrals::resort_four(std::vector<double>& tei, std::vector<size_t>& map) {
-    // Store the integrals in a temporary array
-    size_t num_aptei_corr = ncmo_ * ncmo_ * ncmo_ * ncmo_;
-    std::vector<double> temp_ints(num_aptei_corr, 0.0);
-    for (size_t p = 0; p < ncmo_; ++p) {
-        for (size_t q = 0; q < ncmo_; ++q) {
-            for (size_t r = 0; r < ncmo_; ++r) {
-                for (size_t s = 0; s < ncmo_; ++s) {
-                    size_t pqrs_cmo = ncmo_ * ncmo_ * ncmo_ * p + ncmo_ * ncmo_ * q + ncmo_ * r + s;
-                    size_t pqrs_mo =
-                        nmo_ * nmo_ * nmo_ * map[p] + nmo_ * nmo_ * map[q] + nmo_ * map[r] + map[s];
-                    temp_ints[pqrs_cmo] = tei[pqrs_mo];
-                }
-            }
-        }
-    }
-    temp_ints.swap(tei);
-}
-
 void CustomIntegrals::compute_frozen_one_body_operator() {
     local_timer timer_frozen_one_body;
 
@@ -52,8 +52,8 @@ class CustomIntegrals : public ForteIntegrals {
     CustomIntegrals(std::shared_ptr<ForteOptions> options,
                     std::shared_ptr<MOSpaceInfo> mo_space_info, IntegralSpinRestriction restricted,
                     double scalar, const std::vector<double>& oei_a,
-                    const std::vector<double>& oei_b, const std::vector<double>& tei_aa,
-                    const std::vector<double>& tei_ab, const std::vector<double>& tei_bb);
+                    const std::vector<double>& oei_b, std::vector<double> tei_aa,
+                    std::vector<double> tei_ab, std::vector<double> tei_bb);
 
     void initialize() override;
 
@@ -118,7 +118,6 @@ class CustomIntegrals : public ForteIntegrals {
 
     // ==> Class private functions <==
 
-    void resort_four(std::vector<double>& tei, std::vector<size_t>& map);
     /// An addressing function to for two-electron integrals
     /// @return the address of the integral <pq|rs> or <pq||rs>
     size_t aptei_index(size_t p, size_t q, size_t r, size_t s) {
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -44,6 +45,7 @@
 #include <mpi.h>
 #endif
 
+#include "base_classes/forte_options.h"
 #include "forte-def.h"
 #include "helpers/blockedtensorfactory.h"
 #include "helpers/helpers.h"
@@ -117,36 +119,21 @@ ambit::Tensor DFIntegrals::aptei_aa_block(const std::vector<size_t>& p,
                                           const std::vector<size_t>& q,
                                           const std::vector<size_t>& r,
                                           const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_aa(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, true);
 }
 
 ambit::Tensor DFIntegrals::aptei_ab_block(const std::vector<size_t>& p,
                                           const std::vector<size_t>& q,
                                           const std::vector<size_t>& r,
                                           const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_ab(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, false);
 }
 
 ambit::Tensor DFIntegrals::aptei_bb_block(const std::vector<size_t>& p,
                                           const std::vector<size_t>& q,
                                           const std::vector<size_t>& r,
                                           const std::vector<size_t>& s) {
-    ambit::Tensor ReturnTensor =
-        ambit::Tensor::build(tensor_type_, "Return", {p.size(), q.size(), r.size(), s.size()});
-    ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
-        value = aptei_bb(p[i[0]], q[i[1]], r[i[2]], s[i[3]]);
-    });
-    return ReturnTensor;
+    return three_index_aptei_block(ThreeIntegral_->pointer(), nthree_, p, q, r, s, true);
 }
 
 double DFIntegrals::three_integral(size_t A, size_t p, size_t q) {
@@ -196,6 +183,21 @@ void DFIntegrals::gather_integrals() {
                         mem_info.second.c_str());
     }
 
+    // reuse the integrals stored in THREE_INDEX_FILE (or cached) if they match the orbitals
+    uint64_t key = three_index_key(auxiliary);
+    auto filename = three_index_filename(key);
+    if (not filename.empty() and ThreeIndexFile::is_valid(filename, key, naux, nmo_)) {
+        local_timer timer;
+        ThreeIndexFile file(filename);
+        ThreeIntegral_ = std::make_shared<psi::Matrix>("Bpq", nmo_ * nmo_, naux);
+        file.read_pqQ(ThreeIntegral_->pointer()[0], {0, naux}, {0, nmo_}, {0, nmo_});
+        if (print_ > 0) {
+            outfile->Printf("\n  Three-index integrals read from %s", filename.c_str());
+            print_timing("reading three-index integrals", timer.get());
+        }
+        return;
+    }
+
     psi::Dimension nsopi_ = wfn_->nsopi();
     std::shared_ptr<psi::Matrix> aotoso = wfn_->aotoso();
     std::shared_ptr<psi::Matrix> Ca = wfn_->Ca();
@@ -268,6 +270,18 @@ void DFIntegrals::gather_integrals() {
 
     // Store as transpose for now
     ThreeIntegral_ = Bpq->transpose()->clone();
+
+    if (not filename.empty()) {
+        double** Bp = Bpq->pointer();
+        write_three_index_file(filename, key, naux,
+                               [&](size_t Q0, size_t Q1, size_t p0, size_t p1, double* out) {
+                                   size_t size = (p1 - p0) * nmo_;
+                                   for (size_t Q = Q0; Q < Q1; ++Q) {
+                                       std::copy_n(&Bp[Q][p0 * nmo_], size, out);
+                                       out += size;
+                                   }
+                               });
+    }
 }
 
 void DFIntegrals::resort_three(std::shared_ptr<psi::Matrix>& threeint, std::vector<size_t>& map) {
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -36,6 +37,7 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libqt/qt.h"
 
+#include "base_classes/forte_options.h"
 #include "base_classes/mo_space_info.h"
 
 #ifdef HAVE_GA
@@ -78,120 +80,150 @@ void DISKDFIntegrals::initialize() {
     }
 }
 
-double DISKDFIntegrals::aptei_aa(size_t p, size_t q, size_t r, size_t s) {
-    size_t pn, qn, rn, sn;
-
-    if (frzcpi_.sum() > 0 && ncmo_ == aptei_idx_) {
-        pn = cmotomo_[p];
-        qn = cmotomo_[q];
-        rn = cmotomo_[r];
-        sn = cmotomo_[s];
-    } else {
-        pn = p;
-        qn = q;
-        rn = r;
-        sn = s;
+void DISKDFIntegrals::set_slab_cache_size() {
+    size_t slab_size = std::max(nthree_ * nmo_, size_t(1));
+    size_t max_memory = options_->get_int("DISKDF_CACHE_MAX_MEMORY");
+    if (max_memory == 0) {
+        max_memory = psi::Process::environment.get_memory() / (8 * sizeof(double));
     }
+    slab_cache_size_ = std::max(max_memory / slab_size, size_t(2));
+    outfile->Printf("\n  DiskDF slab cache: %zu slabs of (Q|pq) (%.3f MB)", slab_cache_size_,
+                    slab_cache_size_ * slab_size * sizeof(double) / 1048576.0);
+}
 
-    std::vector<size_t> A_range = {0, nthree_};
-    std::vector<size_t> p_range = {pn, pn + 1};
-    std::vector<size_t> q_range = {qn, qn + 1};
-    std::vector<size_t> r_range = {rn, rn + 1};
-    std::vector<size_t> s_range = {sn, sn + 1};
-
-    double vpqrsalphaC = 0.0;
-    double vpqrsalphaE = 0.0;
-
-    std::shared_ptr<psi::Matrix> B1(new psi::Matrix(1, nthree_));
-    std::shared_ptr<psi::Matrix> B2(new psi::Matrix(1, nthree_));
+size_t DISKDFIntegrals::df_index(size_t p) const {
+    return (frzcpi_.sum() > 0 && ncmo_ == aptei_idx_) ? cmotomo_[p] : p;
+}
 
-    df_->fill_tensor("B", B1, A_range, p_range, r_range);
-    df_->fill_tensor("B", B2, A_range, q_range, s_range);
+void DISKDFIntegrals::read_B(double* out, const std::vector<size_t>& Q_range,
+                             const std::vector<size_t>& p_range,
+                             const std::vector<size_t>& q_range) {
+    if (file_) {
+        file_->read_Qpq(out, Q_range, p_range, q_range);
+    } else {
+        df_->fill_tensor("B", out, Q_range, p_range, q_range);
+    }
+}
 
-    vpqrsalphaC = B1->vector_dot(B2);
+DISKDFIntegrals::Slab DISKDFIntegrals::slab(size_t p) {
+    std::lock_guard<std::mutex> lock(slab_mutex_);
 
-    B1->zero();
-    B2->zero();
+    auto it = slab_cache_.find(p);
+    if (it != slab_cache_.end()) {
+        slab_hits_++;
+        slab_lru_.splice(slab_lru_.begin(), slab_lru_, it->second.second);
+        return it->second.first;
+    }
+    slab_misses_++;
+
+    // read (Q|pq) for all q and store it transposed, so that each (Q|pq) is contiguous
+    auto Aq = std::make_shared<psi::Matrix>("Aq", nthree_, nmo_);
+    read_B(Aq->pointer()[0], {0, nthree_}, {p, p + 1}, {0, nmo_});
+    auto data = std::make_shared<std::vector<double>>(nmo_ * nthree_);
+    double** Aq_p = Aq->pointer();
+    for (size_t Q = 0; Q < nthree_; ++Q) {
+        for (size_t q = 0; q < nmo_; ++q) {
+            (*data)[q * nthree_ + Q] = Aq_p[Q][q];
+        }
+    }
 
-    df_->fill_tensor("B", B1, A_range, p_range, s_range);
-    df_->fill_tensor("B", B2, A_range, q_range, r_range);
+    if (slab_cache_.size() >= slab_cache_size_) {
+        slab_cache_.erase(slab_lru_.back());
+        slab_lru_.pop_back();
+    }
+    slab_lru_.push_front(p);
+    Slab out = data;
+    slab_cache_[p] = std::make_pair(out, slab_lru_.begin());
+    return out;
+}
 
-    vpqrsalphaE = B1->vector_dot(B2);
+void DISKDFIntegrals::clear_slab_cache() {
+    std::lock_guard<std::mutex> lock(slab_mutex_);
+    if (print_ > 1 and (slab_hits_ + slab_misses_ > 0)) {
+        outfile->Printf("\n  DiskDF slab cache: %zu hits, %zu misses", slab_hits_, slab_misses_);
+    }
+    slab_cache_.clear();
+    slab_lru_.clear();
+    slab_hits_ = 0;
+    slab_misses_ = 0;
+}
 
+double DISKDFIntegrals::aptei_aa(size_t p, size_t q, size_t r, size_t s) {
+    auto Bp = slab(df_index(p));
+    auto Bq = slab(df_index(q));
+    double* Bp_ptr = Bp->data();
+    double* Bq_ptr = Bq->data();
+    size_t rn = df_index(r) * nthree_;
+    size_t sn = df_index(s) * nthree_;
+    double vpqrsalphaC = C_DDOT(nthree_, Bp_ptr + rn, 1, Bq_ptr + sn, 1);
+    double vpqrsalphaE = C_DDOT(nthree_, Bp_ptr + sn, 1, Bq_ptr + rn, 1);
     return (vpqrsalphaC - vpqrsalphaE);
 }
 
 double DISKDFIntegrals::aptei_ab(size_t p, size_t q, size_t r, size_t s) {
-    size_t pn, qn, rn, sn;
-    if (frzcpi_.sum() > 0 && ncmo_ == aptei_idx_) {
-        pn = cmotomo_[p];
-        qn = cmotomo_[q];
-        rn = cmotomo_[r];
-        sn = cmotomo_[s];
-    } else {
-        pn = p;
-        qn = q;
-        rn = r;
-        sn = s;
-    }
-    std::vector<size_t> A_range = {0, nthree_};
-    std::vector<size_t> p_range = {pn, pn + 1};
-    std::vector<size_t> q_range = {qn, qn + 1};
-    std::vector<size_t> r_range = {rn, rn + 1};
-    std::vector<size_t> s_range = {sn, sn + 1};
-
-    double vpqrsalphaC = 0.0;
-    std::shared_ptr<psi::Matrix> B1(new psi::Matrix(1, nthree_));
-    std::shared_ptr<psi::Matrix> B2(new psi::Matrix(1, nthree_));
-
-    df_->fill_tensor("B", B1, A_range, p_range, r_range);
-    df_->fill_tensor("B", B2, A_range, q_range, s_range);
-
-    vpqrsalphaC = B1->vector_dot(B2);
-
-    return (vpqrsalphaC);
+    auto Bp = slab(df_index(p));
+    auto Bq = slab(df_index(q));
+    return C_DDOT(nthree_, Bp->data() + df_index(r) * nthree_, 1,
+                  Bq->data() + df_index(s) * nthree_, 1);
 }
 
 double DISKDFIntegrals::aptei_bb(size_t p, size_t q, size_t r, size_t s) {
-    size_t pn, qn, rn, sn;
+    return aptei_aa(p, q, r, s);
+}
 
-    if (frzcpi_.sum() > 0 && ncmo_ == aptei_idx_) {
-        pn = cmotomo_[p];
-        qn = cmotomo_[q];
-        rn = cmotomo_[r];
-        sn = cmotomo_[s];
-    } else {
-        pn = p;
-        qn = q;
-        rn = r;
-        sn = s;
+std::vector<double>
+DISKDFIntegrals::aptei_batch(const std::vector<std::array<size_t, 4>>& indices,
+                             bool antisymmetrize) {
+    size_t nind = indices.size();
+    std::vector<double> out(nind);
+
+    // visit the requests sorted by the pair of slabs (p, q) they need, so that each slab is read
+    // at most once as long as two of them fit in the cache
+    std::vector<std::pair<std::pair<size_t, size_t>, size_t>> order(nind);
+    for (size_t n = 0; n < nind; ++n) {
+        size_t pn = df_index(indices[n][0]);
+        size_t qn = df_index(indices[n][1]);
+        order[n] = {{std::min(pn, qn), std::max(pn, qn)}, n};
     }
-    std::vector<size_t> A_range = {0, nthree_};
-    std::vector<size_t> p_range = {pn, pn + 1};
-    std::vector<size_t> q_range = {qn, qn + 1};
-    std::vector<size_t> r_range = {rn, rn + 1};
-    std::vector<size_t> s_range = {sn, sn + 1};
-
-    double vpqrsalphaC = 0.0;
-    double vpqrsalphaE = 0.0;
-
-    std::shared_ptr<psi::Matrix> B1(new psi::Matrix(1, nthree_));
-    std::shared_ptr<psi::Matrix> B2(new psi::Matrix(1, nthree_));
-
-    df_->fill_tensor("B", B1, A_range, p_range, r_range);
-    df_->fill_tensor("B", B2, A_range, q_range, s_range);
-
-    vpqrsalphaC = B1->vector_dot(B2);
-
-    B1->zero();
-    B2->zero();
+    std::sort(order.begin(), order.end());
+
+    Slab Bp, Bq;
+    size_t p_last = nmo_, q_last = nmo_;
+    for (const auto& [pq, n] : order) {
+        const auto& [p, q, r, s] = indices[n];
+        size_t pn = df_index(p);
+        size_t qn = df_index(q);
+        if (pn != p_last) {
+            Bp = slab(pn);
+            p_last = pn;
+        }
+        if (qn != q_last) {
+            Bq = (qn == pn) ? Bp : slab(qn);
+            q_last = qn;
+        }
+        size_t rn = df_index(r) * nthree_;
+        size_t sn = df_index(s) * nthree_;
+        out[n] = C_DDOT(nthree_, Bp->data() + rn, 1, Bq->data() + sn, 1);
+        if (antisymmetrize) {
+            out[n] -= C_DDOT(nthree_, Bp->data() + sn, 1, Bq->data() + rn, 1);
+        }
+    }
+    return out;
+}
 
-    df_->fill_tensor("B", B1, A_range, p_range, s_range);
-    df_->fill_tensor("B", B2, A_range, q_range, r_range);
+std::vector<double>
+DISKDFIntegrals::aptei_aa_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    return aptei_batch(indices, true);
+}
 
-    vpqrsalphaE = B1->vector_dot(B2);
+std::vector<double>
+DISKDFIntegrals::aptei_ab_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    return aptei_batch(indices, false);
+}
 
-    return (vpqrsalphaC - vpqrsalphaE);
+std::vector<double>
+DISKDFIntegrals::aptei_bb_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    return aptei_batch(indices, true);
 }
 
 ambit::Tensor DISKDFIntegrals::aptei_aa_block(const std::vector<size_t>& p,
@@ -355,14 +387,14 @@ ambit::Tensor DISKDFIntegrals::three_integral_block(const std::vector<size_t>& Q
         std::vector<size_t> p_range{cmotomo[p_vec[0]], cmotomo[p_vec[0]] + psize};
         std::vector<size_t> q_range{cmotomo[q_vec[0]], cmotomo[q_vec[0]] + qsize};
 
-        df_->fill_tensor("B", out_data.data(), Q_range, p_range, q_range);
+        read_B(out_data.data(), Q_range, p_range, q_range);
     } else if ((not p_contiguous) and q_contiguous) {
         std::vector<size_t> q_range{cmotomo[q_vec[0]], cmotomo[q_vec[0]] + qsize};
 
         for (size_t p = 0; p < psize; ++p) {
             auto np = cmotomo[p_vec[p]];
             auto Aq = std::make_shared<psi::Matrix>("Aq", Qsize, qsize);
-            df_->fill_tensor("B", Aq, Q_range, {np, np + 1}, q_range);
+            read_B(Aq->pointer()[0], Q_range, {np, np + 1}, q_range);
 
             for (size_t a = 0; a < Qsize; ++a) {
                 for (size_t q = 0; q < qsize; ++q) {
@@ -376,7 +408,7 @@ ambit::Tensor DISKDFIntegrals::three_integral_block(const std::vector<size_t>& Q
         for (size_t q = 0; q < qsize; ++q) {
             auto nq = cmotomo[q_vec[q]];
             auto Ap = std::make_shared<psi::Matrix>("Aq", Qsize, psize);
-            df_->fill_tensor("B", Ap, Q_range, {nq, nq + 1}, p_range);
+            read_B(Ap->pointer()[0], Q_range, {nq, nq + 1}, p_range);
 
             for (size_t a = 0; a < Qsize; ++a) {
                 for (size_t p = 0; p < psize; ++p) {
@@ -385,7 +417,9 @@ ambit::Tensor DISKDFIntegrals::three_integral_block(const std::vector<size_t>& Q
             }
         }
     } else {
-        size_t memory = df_->get_memory() - Qsize * pqsize;
+        size_t memory = (df_ ? df_->get_memory()
+                             : psi::Process::environment.get_memory() * 0.9 / sizeof(double)) -
+                        Qsize * pqsize;
         std::vector<size_t> vec_small = psize < qsize ? p_vec : q_vec;
 
         size_t max_nslice = memory / (Qsize * nmo_);
@@ -399,7 +433,7 @@ ambit::Tensor DISKDFIntegrals::three_integral_block(const std::vector<size_t>& Q
             for (size_t i = 0; i < batches[n]; ++i) {
                 auto ni = cmotomo[vec_small[i + offset]];
                 auto Am = std::make_shared<psi::Matrix>("Am", Qsize, nmo_);
-                df_->fill_tensor("B", Am, Q_range, {ni, ni + 1}, {0, nmo_});
+                read_B(Am->pointer()[0], Q_range, {ni, ni + 1}, {0, nmo_});
                 Am_vec.push_back(Am);
             }
 
@@ -459,6 +493,9 @@ void DISKDFIntegrals::set_tei(size_t, size_t, size_t, size_t, double, bool, bool
 void DISKDFIntegrals::gather_integrals() {
     outfile->Printf("\n Computing density fitted integrals\n");
 
+    // cached slabs refer to the previous orbitals
+    clear_slab_cache();
+
     std::shared_ptr<psi::BasisSet> primary = wfn_->basisset();
     std::shared_ptr<psi::BasisSet> auxiliary = wfn_->get_basisset("DF_BASIS_MP2");
 
@@ -470,6 +507,19 @@ void DISKDFIntegrals::gather_integrals() {
                     (nprim * nprim * naux * sizeof(double) / 1073741824.0));
     int_mem_ = (nprim * nprim * naux * sizeof(double));
 
+    // reuse the integrals stored in THREE_INDEX_FILE (or cached) if they match the orbitals
+    file_.reset();
+    uint64_t key = three_index_key(auxiliary);
+    auto filename = three_index_filename(key);
+    if (not filename.empty() and ThreeIndexFile::is_valid(filename, key, naux, nmo_)) {
+        file_ = std::make_shared<ThreeIndexFile>(filename,
+                                                 options_->get_bool("THREE_INDEX_FILE_VERIFY"));
+        df_.reset();
+        outfile->Printf("\n  Three-index integrals mapped from %s", filename.c_str());
+        set_slab_cache_size();
+        return;
+    }
+
     psi::Dimension nsopi_ = wfn_->nsopi();
     std::shared_ptr<psi::Matrix> aotoso = wfn_->aotoso();
     std::shared_ptr<psi::Matrix> Ca = wfn_->Ca();
@@ -528,6 +578,17 @@ void DISKDFIntegrals::gather_integrals() {
     outfile->Printf("\n  Computing DF Integrals");
     df_->transform();
     print_timing("computing density-fitted integrals", timer.get());
+
+    // store the integrals in THREE_INDEX_FILE and read them from there
+    if (not filename.empty()) {
+        write_three_index_file(filename, key, naux,
+                               [&](size_t Q0, size_t Q1, size_t p0, size_t p1, double* out) {
+                                   df_->fill_tensor("B", out, {Q0, Q1}, {p0, p1}, {0, nmo_});
+                               });
+        file_ = std::make_shared<ThreeIndexFile>(filename);
+    }
+
+    set_slab_cache_size();
 }
 
 void DISKDFIntegrals::resort_integrals_after_freezing() {
@@ -564,7 +625,7 @@ ambit::Tensor DISKDFIntegrals::three_integral_block_two_index(const std::vector<
         std::vector<size_t> prange = {p_min, p_max};
 
         std::shared_ptr<psi::Matrix> Aq(new psi::Matrix("Aq", nthree_, nmo_));
-        df_->fill_tensor("B", Aq, arange, prange, qrange);
+        read_B(Aq->pointer()[0], arange, prange, qrange);
 
         if (frozen_core) {
             ReturnTensor.iterate([&](const std::vector<size_t>& i, double& value) {
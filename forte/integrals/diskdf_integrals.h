@@ -30,6 +30,10 @@
 #ifndef _diskdf_integrals_h_
 #define _diskdf_integrals_h_
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 #include "psi4/lib3index/dfhelper.h"
 #include "integrals.h"
 
@@ -37,9 +41,10 @@ namespace forte {
 
 /// A DiskDFIntegrals class for avoiding the storage of the ThreeIntegral tensor
 /// Assumes that the DFIntegrals are stored in a binary file generated by
-/// DF_Helper
-/// Aptei_xy are extremely slow -> Try to use three_electron_block.  Much faster
-/// Reading individual elements is slow
+/// DF_Helper or, if THREE_INDEX_FILE is set, in a memory-mapped ThreeIndexFile
+/// Aptei_xy read the (Q|pq) slabs through an LRU cache (DISKDF_CACHE_MAX_MEMORY).
+/// For many elements prefer the aptei_xy_batch functions, which visit the slabs in
+/// disk order, or three_integral_block for whole blocks.
 class DISKDFIntegrals : public Psi4Integrals {
   public:
     /// Contructor of DISKDFIntegrals
@@ -56,6 +61,13 @@ class DISKDFIntegrals : public Psi4Integrals {
     double aptei_ab(size_t p, size_t q, size_t r, size_t s) override;
     double aptei_bb(size_t p, size_t q, size_t r, size_t s) override;
 
+    /// Evaluate a list of alpha-alpha integrals, grouped by the slabs they touch
+    std::vector<double> aptei_aa_batch(const std::vector<std::array<size_t, 4>>& indices) override;
+    /// Evaluate a list of alpha-beta integrals, grouped by the slabs they touch
+    std::vector<double> aptei_ab_batch(const std::vector<std::array<size_t, 4>>& indices) override;
+    /// Evaluate a list of beta-beta integrals, grouped by the slabs they touch
+    std::vector<double> aptei_bb_batch(const std::vector<std::array<size_t, 4>>& indices) override;
+
     /// Return the antisymmetrized alpha-alpha chunck as an ambit::Tensor
     ambit::Tensor aptei_aa_block(const std::vector<size_t>& p, const std::vector<size_t>& q,
                                  const std::vector<size_t>& r,
@@ -87,9 +99,42 @@ class DISKDFIntegrals : public Psi4Integrals {
     // ==> Class data <==
 
     std::shared_ptr<psi::DFHelper> df_;
+    /// The three-index integral file (THREE_INDEX_FILE), used instead of df_ if available
+    std::shared_ptr<ThreeIndexFile> file_;
     std::shared_ptr<psi::Matrix> ThreeIntegral_;
     size_t nthree_ = 0;
 
+    /// A slab holds (Q|pq) for one MO index p and all q, stored as [q][Q]
+    using Slab = std::shared_ptr<std::vector<double>>;
+    /// The maximum number of slabs kept in the cache
+    size_t slab_cache_size_ = 2;
+    /// The slabs in the cache, most recently used first
+    std::list<size_t> slab_lru_;
+    /// Map from MO index to the cached slab and its position in slab_lru_
+    std::unordered_map<size_t, std::pair<Slab, std::list<size_t>::iterator>> slab_cache_;
+    /// Guards the slab cache and the DFHelper reads
+    std::mutex slab_mutex_;
+    /// Number of cache hits and misses
+    size_t slab_hits_ = 0;
+    size_t slab_misses_ = 0;
+
+    // ==> Class private functions <==
+
+    /// Read B(Q|pq) in the Qpq order from file_ or df_
+    void read_B(double* out, const std::vector<size_t>& Q_range,
+                const std::vector<size_t>& p_range, const std::vector<size_t>& q_range);
+    /// Map a (correlated) orbital index to the MO index used by DFHelper
+    size_t df_index(size_t p) const;
+    /// Return the slab of MO index p, reading it from disk if not cached
+    Slab slab(size_t p);
+    /// Drop all cached slabs (called when the integrals are recomputed)
+    void clear_slab_cache();
+    /// Set the number of cached slabs from DISKDF_CACHE_MAX_MEMORY
+    void set_slab_cache_size();
+    /// Evaluate a list of <pq|rs> (minus <pq|sr> if antisymmetrize) sorted by slab pairs
+    std::vector<double> aptei_batch(const std::vector<std::array<size_t, 4>>& indices,
+                                    bool antisymmetrize);
+
     // ==> Class private virtual functions <==
 
     void gather_integrals() override;
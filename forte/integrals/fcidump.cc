@@ -0,0 +1,414 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+
+#include "fcidump.h"
+
+namespace forte {
+
+namespace {
+/// The first bytes of a binary FCIDUMP file
+constexpr char binary_magic[8] = {'F', 'C', 'I', 'D', 'U', 'M', 'P', 'B'};
+
+/// A record of a binary FCIDUMP file
+struct BinaryRecord {
+    double value;
+    int32_t i, j, k, l;
+};
+static_assert(sizeof(BinaryRecord) == 24, "Unexpected padding in BinaryRecord");
+
+/// A read-only memory map of a file
+class MappedFile {
+  public:
+    MappedFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open the FCIDUMP file " + filename);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot read the size of the FCIDUMP file " + filename);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* ptr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map the FCIDUMP file " + filename);
+            }
+            data_ = static_cast<const char*>(ptr);
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+  private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/// Remove blanks and commas from both ends of a string
+std::string trim(const std::string& s) {
+    const char* blanks = " \t\r\n,";
+    auto first = s.find_first_not_of(blanks);
+    if (first == std::string::npos) {
+        return "";
+    }
+    return s.substr(first, s.find_last_not_of(blanks) - first + 1);
+}
+
+/// Is this line the last one of the namelist header?
+bool is_header_end(const char* begin, const char* end) {
+    std::string line = trim(std::string(begin, end));
+    return (line == "/") or (line.find("END") != std::string::npos);
+}
+} // namespace
+
+FCIDUMP::FCIDUMP(const std::string& filename) {
+    MappedFile file(filename);
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    if ((file.size() >= sizeof(binary_magic)) and
+        (std::memcmp(begin, binary_magic, sizeof(binary_magic)) == 0)) {
+        const char* ptr = begin + sizeof(binary_magic);
+        uint64_t header_size = 0;
+        if (end - ptr < static_cast<std::ptrdiff_t>(sizeof(uint64_t))) {
+            throw std::runtime_error("The binary FCIDUMP file " + filename + " is truncated");
+        }
+        std::memcpy(&header_size, ptr, sizeof(uint64_t));
+        ptr += sizeof(uint64_t);
+        if (static_cast<uint64_t>(end - ptr) < header_size) {
+            throw std::runtime_error("The binary FCIDUMP file " + filename + " is truncated");
+        }
+        parse_header(std::string(ptr, header_size));
+        parse_binary(ptr + header_size, end);
+        return;
+    }
+
+    // the namelist header ends with a line that contains &END (or $END, or only /)
+    const char* body = begin;
+    bool found = false;
+    while (body < end and not found) {
+        const char* eol = static_cast<const char*>(std::memchr(body, '\n', end - body));
+        eol = eol ? eol : end;
+        found = is_header_end(body, eol);
+        body = std::min(eol + 1, end);
+    }
+    if (not found) {
+        throw std::runtime_error("Could not find the end of the header of the FCIDUMP file " +
+                                 filename);
+    }
+    parse_header(std::string(begin, body));
+    parse_text(body, end);
+}
+
+void FCIDUMP::parse_header(const std::string& header) {
+    // find all the KEY= and read the value up to the next key
+    std::regex key_regex("([A-Za-z_][A-Za-z0-9_]*)\\s*=");
+    std::vector<std::pair<std::string, size_t>> keys;
+    std::vector<size_t> key_begin;
+    for (auto it = std::sregex_iterator(header.begin(), header.end(), key_regex);
+         it != std::sregex_iterator(); ++it) {
+        keys.emplace_back((*it)[1].str(), it->position() + it->length());
+        key_begin.push_back(it->position());
+    }
+    key_begin.push_back(header.size());
+
+    bool has_norb = false;
+    for (size_t n = 0; n < keys.size(); ++n) {
+        std::string key = keys[n].first;
+        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+        std::string value = header.substr(keys[n].second, key_begin[n + 1] - keys[n].second);
+        // drop the end of the namelist
+        for (const char* stop : {"&END", "$END", "/"}) {
+            auto pos = value.find(stop);
+            if (pos != std::string::npos) {
+                value = value.substr(0, pos);
+            }
+        }
+        value = trim(value);
+        if (key == "NORB") {
+            norb_ = std::stoul(value);
+            has_norb = true;
+        } else if (key == "NELEC") {
+            nelec_ = std::stoi(value);
+        } else if (key == "MS2") {
+            ms2_ = std::stoi(value);
+        } else if (key == "ISYM") {
+            isym_ = std::stoi(value);
+        } else if (key == "UHF") {
+            uhf_ = (value.find("TRUE") != std::string::npos) or
+                   (value.find(".T") != std::string::npos) or (value == "1");
+        } else if (key == "PNTGRP") {
+            pntgrp_ = value;
+        } else if (key == "ORBSYM") {
+            std::replace(value.begin(), value.end(), ',', ' ');
+            char* ptr = &value[0];
+            char* next = ptr;
+            for (long h = std::strtol(ptr, &next, 10); next != ptr;
+                 h = std::strtol(ptr, &next, 10)) {
+                orbsym_.push_back(static_cast<int>(h));
+                ptr = next;
+            }
+        }
+    }
+    if (not has_norb) {
+        throw std::runtime_error("The FCIDUMP header does not contain NORB");
+    }
+    if (uhf_) {
+        throw std::runtime_error("Unrestricted (UHF) FCIDUMP files are not supported");
+    }
+    if (orbsym_.empty()) {
+        orbsym_.assign(norb_, 1);
+    }
+    if (orbsym_.size() != norb_) {
+        throw std::runtime_error("The FCIDUMP header contains an ORBSYM of the wrong size");
+    }
+
+    hcore_.assign(norb_ * norb_, 0.0);
+    epsilon_.assign(norb_, 0.0);
+    tei_.assign(norb_ * norb_ * norb_ * norb_, 0.0);
+}
+
+void FCIDUMP::store(double value, int i, int j, int k, int l, int& nscalar) {
+    const size_t n = norb_;
+    if (i > 0 and j > 0 and k > 0 and l > 0) {
+        size_t p = i - 1, q = j - 1, r = k - 1, s = l - 1;
+        // (pq|rs) = <pr|qs> for the eight permutations of (pq|rs)
+        tei_[((p * n + r) * n + q) * n + s] = value;
+        tei_[((q * n + r) * n + p) * n + s] = value;
+        tei_[((p * n + s) * n + q) * n + r] = value;
+        tei_[((q * n + s) * n + p) * n + r] = value;
+        tei_[((r * n + p) * n + s) * n + q] = value;
+        tei_[((s * n + p) * n + r) * n + q] = value;
+        tei_[((r * n + q) * n + s) * n + p] = value;
+        tei_[((s * n + q) * n + r) * n + p] = value;
+    } else if (i > 0 and j > 0) {
+        hcore_[(i - 1) * n + (j - 1)] = value;
+        hcore_[(j - 1) * n + (i - 1)] = value;
+    } else if (i > 0) {
+        epsilon_[i - 1] = value;
+    } else {
+        enuc_ = value;
+        nscalar += 1;
+    }
+}
+
+void FCIDUMP::parse_text(const char* begin, const char* end) {
+    // split the body in chunks that start at the beginning of a line
+    int nchunks = std::max(1, omp_get_max_threads());
+    size_t size = end - begin;
+    std::vector<const char*> chunk_begin(nchunks + 1, end);
+    chunk_begin[0] = begin;
+    for (int c = 1; c < nchunks; ++c) {
+        const char* ptr = std::max(begin + size * c / nchunks, chunk_begin[c - 1]);
+        const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+        chunk_begin[c] = eol ? eol + 1 : end;
+    }
+
+    int nscalar = 0;
+    bool bad_index = false;
+    bool bad_line = false;
+    const int n = static_cast<int>(norb_);
+#pragma omp parallel for schedule(dynamic) reduction(+ : nscalar)                                 \
+    reduction(|| : bad_index, bad_line)
+    for (int c = 0; c < nchunks; ++c) {
+        char line[256];
+        const char* ptr = chunk_begin[c];
+        const char* chunk_end = chunk_begin[c + 1];
+        while (ptr < chunk_end) {
+            const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+            eol = eol ? eol : end;
+            size_t length = std::min<size_t>(eol - ptr, sizeof(line) - 1);
+            // copy the line to convert Fortran exponents (1.0D-01) and terminate it
+            for (size_t m = 0; m < length; ++m) {
+                line[m] = (ptr[m] == 'D' or ptr[m] == 'd') ? 'E' : ptr[m];
+            }
+            line[length] = '\0';
+            ptr = eol + 1;
+
+            char* next = line;
+            double value = std::strtod(line, &next);
+            if (next == line)
+                continue; // blank line
+            int idx[4];
+            for (int m = 0; m < 4; ++m) {
+                char* start = next;
+                idx[m] = static_cast<int>(std::strtol(start, &next, 10));
+                bad_line = bad_line or (next == start);
+            }
+            if (std::any_of(idx, idx + 4, [n](int x) { return x < 0 or x > n; })) {
+                bad_index = true;
+                continue;
+            }
+            store(value, idx[0], idx[1], idx[2], idx[3], nscalar);
+        }
+    }
+    finish_parsing(nscalar, bad_index or bad_line);
+}
+
+void FCIDUMP::parse_binary(const char* begin, const char* end) {
+    uint64_t nrecords = 0;
+    if (end - begin < static_cast<std::ptrdiff_t>(sizeof(uint64_t))) {
+        throw std::runtime_error("The binary FCIDUMP file is truncated");
+    }
+    std::memcpy(&nrecords, begin, sizeof(uint64_t));
+    const char* records = begin + sizeof(uint64_t);
+    if (static_cast<uint64_t>(end - records) < nrecords * sizeof(BinaryRecord)) {
+        throw std::runtime_error("The binary FCIDUMP file is truncated");
+    }
+
+    int nscalar = 0;
+    bool bad_index = false;
+    const int32_t n = static_cast<int32_t>(norb_);
+#pragma omp parallel for reduction(+ : nscalar) reduction(|| : bad_index)
+    for (uint64_t m = 0; m < nrecords; ++m) {
+        BinaryRecord rec;
+        std::memcpy(&rec, records + m * sizeof(BinaryRecord), sizeof(BinaryRecord));
+        int32_t idx[4] = {rec.i, rec.j, rec.k, rec.l};
+        if (std::any_of(idx, idx + 4, [n](int32_t x) { return x < 0 or x > n; })) {
+            bad_index = true;
+            continue;
+        }
+        store(rec.value, rec.i, rec.j, rec.k, rec.l, nscalar);
+    }
+    finish_parsing(nscalar, bad_index);
+}
+
+void FCIDUMP::finish_parsing(int nscalar, bool bad_records) {
+    if (bad_records) {
+        throw std::runtime_error("The FCIDUMP file contains invalid lines or orbital indices");
+    }
+    if (nscalar > 1) {
+        throw std::runtime_error("The FCIDUMP file contains more than one scalar energy");
+    }
+    if (std::all_of(epsilon_.begin(), epsilon_.end(), [](double e) { return e == 0.0; })) {
+        epsilon_.clear();
+    }
+}
+
+double FCIDUMP::eri(size_t p, size_t q, size_t r, size_t s) const {
+    if (tei_.empty()) {
+        throw std::runtime_error("The FCIDUMP integrals have been released");
+    }
+    const size_t n = norb_;
+    return tei_[((p * n + r) * n + q) * n + s];
+}
+
+std::vector<double> FCIDUMP::release_tei() { return std::move(tei_); }
+
+std::string FCIDUMP::header() const {
+    std::string header = "&FCI NORB=" + std::to_string(norb_) + ",NELEC=" +
+                         std::to_string(nelec_) + ",MS2=" + std::to_string(ms2_) + ",\n ORBSYM=";
+    for (int h : orbsym_) {
+        header += std::to_string(h) + ",";
+    }
+    header += "\n ISYM=" + std::to_string(isym_) + ",\n";
+    if (not pntgrp_.empty()) {
+        header += " PNTGRP=" + pntgrp_ + ",\n";
+    }
+    header += " UHF=.FALSE.,\n&END\n";
+    return header;
+}
+
+void FCIDUMP::write_binary(const std::string& filename, double tolerance) const {
+    if (tei_.empty()) {
+        throw std::runtime_error("The FCIDUMP integrals have been released");
+    }
+    const int32_t n = static_cast<int32_t>(norb_);
+    std::vector<BinaryRecord> records;
+    for (int32_t p = 0; p < n; ++p) {
+        for (int32_t q = 0; q <= p; ++q) {
+            for (int32_t r = 0; r <= p; ++r) {
+                for (int32_t s = 0; s <= (r == p ? q : r); ++s) {
+                    double value = eri(p, q, r, s);
+                    if (std::fabs(value) > tolerance) {
+                        records.push_back({value, p + 1, q + 1, r + 1, s + 1});
+                    }
+                }
+            }
+        }
+    }
+    for (int32_t p = 0; p < n; ++p) {
+        for (int32_t q = 0; q <= p; ++q) {
+            double value = hcore_[p * n + q];
+            if (std::fabs(value) > tolerance) {
+                records.push_back({value, p + 1, q + 1, 0, 0});
+            }
+        }
+    }
+    for (int32_t p = 0; p < static_cast<int32_t>(epsilon_.size()); ++p) {
+        records.push_back({epsilon_[p], p + 1, 0, 0, 0});
+    }
+    records.push_back({enuc_, 0, 0, 0, 0});
+
+    std::string text = header();
+    uint64_t header_size = text.size();
+    uint64_t nrecords = records.size();
+    std::ofstream out(filename, std::ios_base::binary);
+    out.write(binary_magic, sizeof(binary_magic));
+    out.write(reinterpret_cast<const char*>(&header_size), sizeof(uint64_t));
+    out.write(text.data(), text.size());
+    out.write(reinterpret_cast<const char*>(&nrecords), sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BinaryRecord));
+    if (not out.good()) {
+        throw std::runtime_error("Error when writing the binary FCIDUMP file " + filename);
+    }
+}
+
+} // namespace forte
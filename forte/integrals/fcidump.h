@@ -0,0 +1,112 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _fcidump_h_
+#define _fcidump_h_
+
+#include <string>
+#include <vector>
+
+namespace forte {
+
+/**
+ * @brief The FCIDUMP class reads integrals stored in the FCIDUMP format
+ * (Comp. Phys. Commun. 54, 75 (1989)).
+ *
+ * Both the text format and a binary variant are supported. The binary file contains the magic
+ * string "FCIDUMPB", the length and text of the namelist header, the number of records, and
+ * the records (double value, int32 i, j, k, l). The file is memory-mapped and split into
+ * chunks that are parsed in parallel. The two-electron integrals are stored directly as the
+ * physicist's integrals <pq|rs> = (pr|qs) used by CustomIntegrals.
+ *
+ * Only restricted (UHF = FALSE) files are supported.
+ */
+class FCIDUMP {
+  public:
+    /// Read a FCIDUMP file (text or binary, detected from the first bytes)
+    FCIDUMP(const std::string& filename);
+
+    /// The number of orbitals
+    size_t norb() const { return norb_; }
+    /// The number of electrons
+    int nelec() const { return nelec_; }
+    /// Twice the spin projection
+    int ms2() const { return ms2_; }
+    /// The symmetry of the state (FCIDUMP convention, starts from 1)
+    int isym() const { return isym_; }
+    /// The symmetry of the orbitals (FCIDUMP convention, starts from 1)
+    const std::vector<int>& orbsym() const { return orbsym_; }
+    /// The point group (empty if not stored in the file)
+    const std::string& pntgrp() const { return pntgrp_; }
+    /// The nuclear repulsion plus frozen core energy
+    double enuc() const { return enuc_; }
+    /// The one-electron integrals h[p][q]
+    const std::vector<double>& hcore() const { return hcore_; }
+    /// The orbital energies (empty if not stored in the file)
+    const std::vector<double>& epsilon() const { return epsilon_; }
+
+    /// Return the two-electron integral (pq|rs) in chemist's notation
+    double eri(size_t p, size_t q, size_t r, size_t s) const;
+
+    /// Return the integrals <pq|rs> (nmo^4 elements) and release them from this object
+    std::vector<double> release_tei();
+
+    /// Write the integrals in the binary FCIDUMP format, skipping (pq|rs) below tolerance
+    void write_binary(const std::string& filename, double tolerance = 0.0) const;
+
+  private:
+    /// Parse the namelist header
+    void parse_header(const std::string& header);
+    /// Parse the lines of a text FCIDUMP in the range [begin, end)
+    void parse_text(const char* begin, const char* end);
+    /// Parse the records of a binary FCIDUMP in the range [begin, end)
+    void parse_binary(const char* begin, const char* end);
+    /// Check the parsed records and drop the orbital energies if absent
+    void finish_parsing(int nscalar, bool bad_records);
+    /// Store an integral with FCIDUMP indices (starting from 1, 0 = absent)
+    void store(double value, int i, int j, int k, int l, int& nscalar);
+    /// Return the header in the namelist format
+    std::string header() const;
+
+    size_t norb_ = 0;
+    int nelec_ = 0;
+    int ms2_ = 0;
+    int isym_ = 1;
+    bool uhf_ = false;
+    std::vector<int> orbsym_;
+    std::string pntgrp_;
+    double enuc_ = 0.0;
+    std::vector<double> hcore_;
+    std::vector<double> epsilon_;
+    /// The integrals <pq|rs> stored as tei_[p][q][r][s]
+    std::vector<double> tei_;
+};
+
+} // namespace forte
+
+#endif // _fcidump_h_
@@ -28,11 +28,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <numeric>
 
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libqt/qt.h"
 
 #include "helpers/blockedtensorfactory.h"
 #include "base_classes/forte_options.h"
@@ -211,6 +213,36 @@ ambit::Tensor ForteIntegrals::oei_b_block(const std::vector<size_t>& p,
     return t;
 }
 
+std::vector<double>
+ForteIntegrals::aptei_aa_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    std::vector<double> out(indices.size());
+    for (size_t n = 0, size = indices.size(); n < size; ++n) {
+        const auto& [p, q, r, s] = indices[n];
+        out[n] = aptei_aa(p, q, r, s);
+    }
+    return out;
+}
+
+std::vector<double>
+ForteIntegrals::aptei_ab_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    std::vector<double> out(indices.size());
+    for (size_t n = 0, size = indices.size(); n < size; ++n) {
+        const auto& [p, q, r, s] = indices[n];
+        out[n] = aptei_ab(p, q, r, s);
+    }
+    return out;
+}
+
+std::vector<double>
+ForteIntegrals::aptei_bb_batch(const std::vector<std::array<size_t, 4>>& indices) {
+    std::vector<double> out(indices.size());
+    for (size_t n = 0, size = indices.size(); n < size; ++n) {
+        const auto& [p, q, r, s] = indices[n];
+        out[n] = aptei_bb(p, q, r, s);
+    }
+    return out;
+}
+
 void ForteIntegrals::set_fock_matrix(psi::SharedMatrix fa, psi::SharedMatrix fb) {
     fock_a_ = fa;
     fock_b_ = fb;
@@ -391,6 +423,45 @@ bool ForteIntegrals::test_orbital_spin_restriction(std::shared_ptr<psi::Matrix>
     return (A_minus_B->absmax() < 1.0e-7 ? true : false);
 }
 
+void ForteIntegrals::resort_four(std::vector<double>& tei, const std::vector<size_t>& map) const {
+    const size_t ncmo = map.size();
+    const size_t ncmo2 = ncmo * ncmo;
+    const size_t ncmo3 = ncmo2 * ncmo;
+    const size_t nmo2 = nmo_ * nmo_;
+    const size_t nmo3 = nmo2 * nmo_;
+
+    // If map is increasing then map[p] >= p and the slab tei[p][*][*][*] of the resorted
+    // integrals ends before the slabs tei[map[p']][*][*][*] (p' > p) that are still to be read,
+    // so each slab can be gathered in a buffer and written back in place
+    bool in_place =
+        std::adjacent_find(map.begin(), map.end(), std::greater_equal<size_t>()) == map.end();
+    std::vector<double> source;
+    if (not in_place) {
+        source = tei;
+    }
+    const double* tei_mo = in_place ? tei.data() : source.data();
+
+    std::vector<double> slab(ncmo3);
+    for (size_t p = 0; p < ncmo; ++p) {
+        const double* tei_p = tei_mo + map[p] * nmo3;
+#pragma omp parallel for
+        for (size_t q = 0; q < ncmo; ++q) {
+            const double* tei_pq = tei_p + map[q] * nmo2;
+            double* slab_q = slab.data() + q * ncmo2;
+            for (size_t r = 0; r < ncmo; ++r) {
+                const double* tei_pqr = tei_pq + map[r] * nmo_;
+                double* slab_qr = slab_q + r * ncmo;
+                for (size_t s = 0; s < ncmo; ++s) {
+                    slab_qr[s] = tei_pqr[map[s]];
+                }
+            }
+        }
+        std::copy(slab.begin(), slab.end(), tei.begin() + p * ncmo3);
+    }
+    tei.resize(ncmo3 * ncmo);
+    tei.shrink_to_fit();
+}
+
 void ForteIntegrals::freeze_core_orbitals() {
     local_timer freeze_timer;
     if (ncmo_ < nmo_) {
@@ -533,6 +604,85 @@ double** ForteIntegrals::three_integral_pointer() {
     return nullptr;
 }
 
+ambit::Tensor ForteIntegrals::three_index_aptei_block(double** B, size_t naux,
+                                                      const std::vector<size_t>& p,
+                                                      const std::vector<size_t>& q,
+                                                      const std::vector<size_t>& r,
+                                                      const std::vector<size_t>& s,
+                                                      bool antisymmetrize) {
+    const size_t np = p.size();
+    const size_t nq = q.size();
+    const size_t nr = r.size();
+    const size_t ns = s.size();
+    ambit::Tensor ReturnTensor = ambit::Tensor::build(tensor_type_, "Return", {np, nq, nr, ns});
+    if ((np * nq * nr * ns == 0) or (naux == 0))
+        return ReturnTensor;
+
+    // gather the rows B_xy^A (x in X, y in Y) into a contiguous (|X| |Y|) x naux matrix
+    auto gather = [&](const std::vector<size_t>& X, const std::vector<size_t>& Y) {
+        const size_t nx = X.size();
+        const size_t ny = Y.size();
+        std::vector<double> slab(nx * ny * naux);
+#pragma omp parallel for
+        for (size_t x = 0; x < nx; ++x) {
+            for (size_t y = 0; y < ny; ++y) {
+                std::copy_n(B[X[x] * aptei_idx_ + Y[y]], naux, &slab[(x * ny + y) * naux]);
+            }
+        }
+        return slab;
+    };
+
+    auto& data = ReturnTensor.data();
+    const size_t nqs = nq * ns;
+    const size_t nqr = nq * nr;
+
+    // Coulomb term: for each p_i, J_i[k,(j,l)] = sum_A B_{p_i r_k}^A B_{q_j s_l}^A
+    {
+        std::vector<double> Bqs = gather(q, s);
+        std::vector<double> Bpr(nr * naux);
+        std::vector<double> J(nr * nqs);
+        for (size_t i = 0; i < np; ++i) {
+            for (size_t k = 0; k < nr; ++k) {
+                std::copy_n(B[p[i] * aptei_idx_ + r[k]], naux, &Bpr[k * naux]);
+            }
+            C_DGEMM('N', 'T', nr, nqs, naux, 1.0, Bpr.data(), naux, Bqs.data(), naux, 0.0,
+                    J.data(), nqs);
+            double* V_i = &data[i * nq * nr * ns];
+#pragma omp parallel for
+            for (size_t j = 0; j < nq; ++j) {
+                for (size_t k = 0; k < nr; ++k) {
+                    std::copy_n(&J[k * nqs + j * ns], ns, &V_i[(j * nr + k) * ns]);
+                }
+            }
+        }
+    }
+
+    // Exchange term: for each p_i, K_i[l,(j,k)] = sum_A B_{p_i s_l}^A B_{q_j r_k}^A
+    if (antisymmetrize) {
+        std::vector<double> Bqr = gather(q, r);
+        std::vector<double> Bps(ns * naux);
+        std::vector<double> K(ns * nqr);
+        for (size_t i = 0; i < np; ++i) {
+            for (size_t l = 0; l < ns; ++l) {
+                std::copy_n(B[p[i] * aptei_idx_ + s[l]], naux, &Bps[l * naux]);
+            }
+            C_DGEMM('N', 'T', ns, nqr, naux, 1.0, Bps.data(), naux, Bqr.data(), naux, 0.0,
+                    K.data(), nqr);
+            double* V_i = &data[i * nq * nr * ns];
+#pragma omp parallel for
+            for (size_t j = 0; j < nq; ++j) {
+                for (size_t k = 0; k < nr; ++k) {
+                    double* V_ijk = &V_i[(j * nr + k) * ns];
+                    for (size_t l = 0; l < ns; ++l) {
+                        V_ijk[l] -= K[l * nqr + j * nr + k];
+                    }
+                }
+            }
+        }
+    }
+    return ReturnTensor;
+}
+
 void ForteIntegrals::rotate_mos() { _undefined_function("rotate_mos"); }
 
 std::vector<std::shared_ptr<psi::Matrix>> ForteIntegrals::mo_dipole_ints(const bool&, const bool&) {
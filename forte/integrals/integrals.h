@@ -30,12 +30,15 @@
 #ifndef _integrals_h_
 #define _integrals_h_
 
+#include <array>
 #include <vector>
 
 #include "psi4/libfock/jk.h"
 #include "psi4/libmints/dimension.h"
 #include "ambit/blocked_tensor.h"
 
+#include "integrals/three_index_file.h"
+
 class Tensor;
 
 namespace psi {
@@ -224,6 +227,15 @@ class ForteIntegrals {
     /// The antisymmetrixed beta-beta two-electron integrals in physicist notation <pq||rs>
     virtual double aptei_bb(size_t p, size_t q, size_t r, size_t s) = 0;
 
+    /// Evaluate a list of alpha-alpha integrals <pq||rs>
+    /// @param indices a list of (p, q, r, s) tuples
+    /// @return the integrals in the same order as indices
+    virtual std::vector<double> aptei_aa_batch(const std::vector<std::array<size_t, 4>>& indices);
+    /// Evaluate a list of alpha-beta integrals <pq|rs>
+    virtual std::vector<double> aptei_ab_batch(const std::vector<std::array<size_t, 4>>& indices);
+    /// Evaluate a list of beta-beta integrals <pq||rs>
+    virtual std::vector<double> aptei_bb_batch(const std::vector<std::array<size_t, 4>>& indices);
+
     /// @return a tensor with a block of the alpha one-electron integrals
     ambit::Tensor oei_a_block(const std::vector<size_t>& p, const std::vector<size_t>& q);
     /// @return a tensor with a block of the beta one-electron integrals
@@ -511,6 +523,11 @@ class ForteIntegrals {
     bool test_orbital_spin_restriction(std::shared_ptr<psi::Matrix> A,
                                        std::shared_ptr<psi::Matrix> B) const;
 
+    /// Resort the four-index integrals tei[p][q][r][s] (nmo^4 elements) to the correlated
+    /// orbitals tei[map[p]][map[q]][map[r]][map[s]] (ncmo^4 elements). Done in place and in
+    /// parallel when map is increasing
+    void resort_four(std::vector<double>& tei, const std::vector<size_t>& map) const;
+
     /// An addressing function to for two-electron integrals
     /// @return the address of the integral <pq|rs> or <pq||rs>
     size_t aptei_index(size_t p, size_t q, size_t r, size_t s) {
@@ -518,6 +535,14 @@ class ForteIntegrals {
                aptei_idx_ * r + s;
     }
 
+    /// Build a block of two-electron integrals from three-index integrals B stored as a matrix
+    /// with rows B[p * aptei_idx_ + q][A] and naux columns. Computes <pq|rs> = sum_A B_pr^A B_qs^A
+    /// (minus the exchange term sum_A B_ps^A B_qr^A if antisymmetrize = true) using DGEMM
+    ambit::Tensor three_index_aptei_block(double** B, size_t naux, const std::vector<size_t>& p,
+                                          const std::vector<size_t>& q,
+                                          const std::vector<size_t>& r,
+                                          const std::vector<size_t>& s, bool antisymmetrize);
+
     void _undefined_function(const std::string& method) const;
 
     // ==> Class private virtual functions <==
@@ -594,6 +619,27 @@ class Psi4Integrals : public ForteIntegrals {
 
   protected:
     void freeze_core_orbitals() override;
+
+    /// @return a hash of the basis set, the geometry, the orbitals, and the frozen orbitals
+    uint64_t orbital_hash() const;
+
+    /// @return the key that identifies the three-index integrals of a given auxiliary basis
+    uint64_t three_index_key(std::shared_ptr<psi::BasisSet> auxiliary) const;
+
+    /// @return the file used to cache integrals with a given label and key in
+    /// INTEGRAL_CACHE_DIR (empty if the cache is disabled)
+    std::string integral_cache_file(const std::string& label, uint64_t key) const;
+
+    /// @return THREE_INDEX_FILE if set, otherwise the cache file for the three-index integrals
+    std::string three_index_filename(uint64_t key) const;
+
+    /// Write the three-index integrals to a file using the THREE_INDEX_FILE_* options
+    void write_three_index_file(const std::string& filename, uint64_t key, size_t naux,
+                                const ThreeIndexFile::FillFunction& fill);
+
+    /// Use INTEGRAL_CACHE_DIR? Turned off once the orbitals are updated, since every set of
+    /// orbitals of an orbital optimization would otherwise leave a file in the cache
+    bool use_integral_cache_ = true;
 }; // namespace forte
 
 } // namespace forte
@@ -26,6 +26,10 @@
  * @END LICENSE
  */
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/stat.h>
 
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -41,6 +45,7 @@
 #include "psi4/libpsi4util/process.h"
 
 #include "base_classes/mo_space_info.h"
+#include "helpers/disk_io.h"
 #include "helpers/printing.h"
 #include "helpers/timer.h"
 #include "integrals/integrals.h"
@@ -278,7 +283,8 @@ void Psi4Integrals::update_orbitals(std::shared_ptr<psi::Matrix> Ca,
     wfn_->Ca()->copy(Ca_);
     wfn_->Cb()->copy(Cb_);
 
-    // 3. Re-transform the integrals
+    // 3. Re-transform the integrals (only the integrals of the initial orbitals are cached)
+    use_integral_cache_ = false;
     aptei_idx_ = nmo_;
     transform_one_electron_integrals();
     int my_proc = 0;
@@ -784,4 +790,78 @@ Psi4Integrals::make_fock_active_unrestricted(psi::SharedMatrix g1a, psi::SharedM
 
     return {Fa_active, Fb_active};
 }
+
+uint64_t Psi4Integrals::orbital_hash() const {
+    auto basis = wfn_->basisset();
+    uint64_t hash = hash_bytes(basis->name().data(), basis->name().size());
+    std::vector<double> values{static_cast<double>(basis->nbf())};
+
+    auto molecule = wfn_->molecule();
+    for (int A = 0; A < molecule->natom(); ++A) {
+        values.insert(values.end(), {molecule->Z(A), molecule->x(A), molecule->y(A),
+                                     molecule->z(A)});
+    }
+    for (int h = 0; h < nirrep_; ++h) {
+        values.insert(values.end(), {static_cast<double>(frzcpi_[h]),
+                                     static_cast<double>(frzvpi_[h])});
+    }
+    hash = hash_bytes(values.data(), values.size() * sizeof(double), hash);
+
+    for (const auto& C : {wfn_->Ca(), wfn_->Cb()}) {
+        for (int h = 0; h < C->nirrep(); ++h) {
+            size_t size = static_cast<size_t>(C->rowdim(h)) * C->coldim(h);
+            if (size > 0) {
+                hash = hash_bytes(C->pointer(h)[0], size * sizeof(double), hash);
+            }
+        }
+    }
+    return hash;
+}
+
+uint64_t Psi4Integrals::three_index_key(std::shared_ptr<psi::BasisSet> auxiliary) const {
+    std::vector<uint64_t> values{orbital_hash(), static_cast<uint64_t>(auxiliary->nbf()),
+                                 static_cast<uint64_t>(nmo_)};
+    uint64_t hash = hash_bytes(values.data(), values.size() * sizeof(uint64_t));
+    return hash_bytes(auxiliary->name().data(), auxiliary->name().size(), hash);
+}
+
+std::string Psi4Integrals::integral_cache_file(const std::string& label, uint64_t key) const {
+    auto dir = options_->get_str("INTEGRAL_CACHE_DIR");
+    if (dir.empty() or not use_integral_cache_) {
+        return "";
+    }
+    // create the directory if needed (other jobs may be doing the same)
+    struct stat buf;
+    if (stat(dir.c_str(), &buf) != 0 and mkdir(dir.c_str(), 0755) != 0 and errno != EEXIST) {
+        outfile->Printf("\n  Cannot create the integral cache directory %s", dir.c_str());
+        return "";
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    return dir + "/forte." + label + "." + hex + ".bin";
+}
+
+std::string Psi4Integrals::three_index_filename(uint64_t key) const {
+    auto filename = options_->get_str("THREE_INDEX_FILE");
+    return filename.empty() ? integral_cache_file("three_index", key) : filename;
+}
+
+void Psi4Integrals::write_three_index_file(const std::string& filename, uint64_t key, size_t naux,
+                                           const ThreeIndexFile::FillFunction& fill) {
+    local_timer timer;
+    auto layout = options_->get_str("THREE_INDEX_FILE_LAYOUT") == "QMAJOR"
+                      ? ThreeIndexLayout::QMajor
+                      : ThreeIndexLayout::PQMajor;
+    auto compression = options_->get_str("THREE_INDEX_FILE_COMPRESSION") == "BOUNDED"
+                           ? ThreeIndexCompression::Bounded
+                           : ThreeIndexCompression::None;
+    double max_error = options_->get_double("THREE_INDEX_FILE_MAX_ERROR");
+
+    ThreeIndexFile::write(filename, naux, nmo_, key, fill, layout, compression, max_error);
+
+    if (print_ > 0) {
+        outfile->Printf("\n  Three-index integrals written to %s", filename.c_str());
+        print_timing("writing three-index integrals", timer.get());
+    }
+}
 } // namespace forte
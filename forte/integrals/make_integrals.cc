@@ -38,6 +38,7 @@
 #include "integrals/df_integrals.h"
 #include "integrals/diskdf_integrals.h"
 #include "integrals/conventional_integrals.h"
+#include "integrals/fcidump.h"
 
 #include "make_integrals.h"
 
@@ -90,4 +91,33 @@ make_custom_forte_integrals(std::shared_ptr<ForteOptions> options,
                                              oei_b, tei_aa, tei_ab, tei_bb);
 }
 
+std::shared_ptr<ForteIntegrals>
+make_custom_forte_integrals_from_fcidump(std::shared_ptr<ForteOptions> options,
+                                         std::shared_ptr<MOSpaceInfo> mo_space_info,
+                                         std::shared_ptr<FCIDUMP> fcidump) {
+    const size_t n = fcidump->norb();
+    std::vector<double> tei_ab = fcidump->release_tei();
+    if (tei_ab.size() != n * n * n * n) {
+        throw std::runtime_error("The integrals of this FCIDUMP object have already been used");
+    }
+
+    // <pq||rs> = <pq|rs> - <pq|sr>
+    std::vector<double> tei_aa(tei_ab.size());
+    const size_t n3 = n * n * n;
+#pragma omp parallel for
+    for (size_t pqr = 0; pqr < n3; ++pqr) {
+        const size_t pq = pqr / n;
+        const size_t r = pqr % n;
+        for (size_t s = 0; s < n; ++s) {
+            tei_aa[pqr * n + s] = tei_ab[pqr * n + s] - tei_ab[(pq * n + s) * n + r];
+        }
+    }
+    std::vector<double> tei_bb(tei_aa);
+
+    return std::make_shared<CustomIntegrals>(
+        options, mo_space_info, IntegralSpinRestriction::Restricted, fcidump->enuc(),
+        fcidump->hcore(), fcidump->hcore(), std::move(tei_aa), std::move(tei_ab),
+        std::move(tei_bb));
+}
+
 } // namespace forte
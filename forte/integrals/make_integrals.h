@@ -31,6 +31,8 @@
 #define _make_integrals_h_
 
 namespace forte {
+class FCIDUMP;
+
 std::shared_ptr<ForteIntegrals>
 make_forte_integrals_from_psi4(std::shared_ptr<psi::Wavefunction> ref_wfn,
                                std::shared_ptr<forte::ForteOptions> options,
@@ -43,6 +45,12 @@ make_custom_forte_integrals(std::shared_ptr<ForteOptions> options,
                             const std::vector<double>& tei_aa, const std::vector<double>& tei_ab,
                             const std::vector<double>& tei_bb);
 
+/// Make a custom integral object from a FCIDUMP file, moving the two-electron integrals
+std::shared_ptr<ForteIntegrals>
+make_custom_forte_integrals_from_fcidump(std::shared_ptr<ForteOptions> options,
+                                         std::shared_ptr<MOSpaceInfo> mo_space_info,
+                                         std::shared_ptr<FCIDUMP> fcidump);
+
 } // namespace forte
 
 #endif // _make_integrals_h_
@@ -26,7 +26,8 @@
  * @END LICENSE
  */
 
-#ifdef HAVE_MPI
+// These algorithms need Global Arrays; plain MPI runs use three_dsrg_mrpt2_mpi.cc
+#if defined(HAVE_MPI) && defined(HAVE_GA)
 
 #include <numeric>
 
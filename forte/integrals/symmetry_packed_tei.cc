@@ -0,0 +1,169 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "symmetry_packed_tei.h"
+
+namespace forte {
+
+namespace {
+/// The threshold used to decide if the dense integrals have a given symmetry
+constexpr double packing_threshold = 1.0e-12;
+} // namespace
+
+SymmetryPackedTEI::SymmetryPackedTEI(const std::vector<int>& mo_sym, bool antisymmetric,
+                                     size_t max_dense_size)
+    : antisymmetric_(antisymmetric) {
+    size_t n2 = mo_sym.size() * mo_sym.size();
+    if (n2 * n2 <= max_dense_size) {
+        nmo_ = mo_sym.size();
+        dense_ = true;
+        antisymmetric_ = false;
+        data_.assign(n2 * n2, 0.0);
+        return;
+    }
+    setup(mo_sym);
+}
+
+SymmetryPackedTEI::SymmetryPackedTEI(const std::vector<double>& tei,
+                                     const std::vector<int>& mo_sym, bool antisymmetric,
+                                     size_t max_dense_size) {
+    size_t n = mo_sym.size();
+    size_t n2 = n * n;
+    size_t n3 = n2 * n;
+
+    // small integrals are kept as they are
+    if (n2 * n2 <= max_dense_size) {
+        nmo_ = n;
+        dense_ = true;
+        antisymmetric_ = false;
+        data_ = tei;
+        return;
+    }
+
+    // check that the integrals are symmetry blocked and (anti)symmetric
+    bool blocked = true;
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t q = 0; q < n; ++q) {
+            for (size_t r = 0; r < n; ++r) {
+                for (size_t s = 0; s < n; ++s) {
+                    double v = tei[p * n3 + q * n2 + r * n + s];
+                    if (std::fabs(v) <= packing_threshold)
+                        continue;
+                    if ((mo_sym[p] ^ mo_sym[q] ^ mo_sym[r] ^ mo_sym[s]) != 0)
+                        blocked = false;
+                    if (antisymmetric and
+                        ((p == q) or (r == s) or
+                         (std::fabs(v + tei[q * n3 + p * n2 + r * n + s]) > packing_threshold) or
+                         (std::fabs(v + tei[p * n3 + q * n2 + s * n + r]) > packing_threshold)))
+                        antisymmetric = false;
+                }
+            }
+        }
+    }
+
+    antisymmetric_ = antisymmetric;
+    setup(blocked ? mo_sym : std::vector<int>(n, 0));
+
+    for (size_t pq = 0; pq < n2; ++pq) {
+        if (pair_sign_[pq] <= 0.0)
+            continue;
+        for (size_t rs = 0; rs < n2; ++rs) {
+            if ((pair_sign_[rs] <= 0.0) or (pair_sym_[pq] != pair_sym_[rs]))
+                continue;
+            data_[row_offset_[pq] + pair_index_[rs]] = tei[pq * n2 + rs];
+        }
+    }
+}
+
+void SymmetryPackedTEI::setup(const std::vector<int>& mo_sym) {
+    nmo_ = mo_sym.size();
+    size_t n2 = nmo_ * nmo_;
+    int nirrep = 1;
+    for (int h : mo_sym) {
+        nirrep = std::max(nirrep, h + 1);
+    }
+
+    // assign an index to each pair in its irrep (p > q only for antisymmetric integrals)
+    pair_sym_.assign(n2, 0);
+    pair_index_.assign(n2, 0);
+    pair_sign_.assign(n2, 1.0);
+    std::vector<size_t> npairs(nirrep + 1, 0);
+    for (size_t p = 0; p < nmo_; ++p) {
+        for (size_t q = 0; q < nmo_; ++q) {
+            size_t pq = p * nmo_ + q;
+            pair_sym_[pq] = mo_sym[p] ^ mo_sym[q];
+            if (not antisymmetric_ or p > q) {
+                pair_index_[pq] = npairs[pair_sym_[pq]]++;
+            }
+        }
+    }
+    if (antisymmetric_) {
+        npairs[nirrep] = 1;
+        for (size_t p = 0; p < nmo_; ++p) {
+            for (size_t q = 0; q < p; ++q) {
+                pair_index_[q * nmo_ + p] = pair_index_[p * nmo_ + q];
+                pair_sign_[q * nmo_ + p] = -1.0;
+            }
+            pair_sym_[p * nmo_ + p] = nirrep;
+            pair_sign_[p * nmo_ + p] = 0.0;
+        }
+    }
+
+    // each irrep stores a square matrix of pairs
+    std::vector<size_t> block_offset(nirrep + 1, 0);
+    size_t size = 0;
+    for (int h = 0; h <= nirrep; ++h) {
+        block_offset[h] = size;
+        size += npairs[h] * npairs[h];
+    }
+    row_offset_.resize(n2);
+    for (size_t pq = 0; pq < n2; ++pq) {
+        int h = pair_sym_[pq];
+        row_offset_[pq] = block_offset[h] + pair_index_[pq] * npairs[h];
+    }
+    data_.assign(size, 0.0);
+}
+
+std::vector<double> SymmetryPackedTEI::dense() const {
+    if (dense_)
+        return data_;
+    size_t n2 = nmo_ * nmo_;
+    std::vector<double> tei(n2 * n2);
+#pragma omp parallel for
+    for (size_t pq = 0; pq < n2; ++pq) {
+        for (size_t rs = 0; rs < n2; ++rs) {
+            tei[pq * n2 + rs] = get(pq / nmo_, pq % nmo_, rs / nmo_, rs % nmo_);
+        }
+    }
+    return tei;
+}
+
+} // namespace forte
@@ -0,0 +1,116 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _symmetry_packed_tei_h_
+#define _symmetry_packed_tei_h_
+
+#include <cstddef>
+#include <vector>
+
+namespace forte {
+
+/**
+ * @brief Two-electron integrals V[p][q][r][s] of an active space packed by point-group blocks
+ *
+ * Only the elements with sym(p) ^ sym(q) = sym(r) ^ sym(s) are stored, as one matrix
+ * V[pq][rs] per irrep of the pair pq. If the integrals are antisymmetric
+ * (V[pqrs] = -V[qprs] = -V[pqsr], as for <pq||rs>) only the pairs p > q are stored.
+ *
+ * The layout is chosen when the object is built from the dense integrals: symmetry blocking
+ * (antisymmetry) is used only if all the forbidden (antisymmetric) elements vanish to within
+ * 1.0e-12, so packing never changes the integrals. The object is immutable and can be shared.
+ *
+ * Integrals with at most max_dense_size elements (nmo^4) are not packed. They are stored as a
+ * flat array that callers can index directly through dense_data(), which keeps the
+ * element-wise access of the CI kernels free of the pair tables.
+ */
+class SymmetryPackedTEI {
+  public:
+    /// Integrals up to this number of elements (2^25, 256 MB) are stored dense
+    static constexpr size_t default_max_dense_size = size_t(1) << 25;
+
+    /// Build zero integrals
+    SymmetryPackedTEI(const std::vector<int>& mo_sym, bool antisymmetric,
+                      size_t max_dense_size = default_max_dense_size);
+    /// Pack the dense integrals V[p][q][r][s] (nmo^4 elements)
+    SymmetryPackedTEI(const std::vector<double>& tei, const std::vector<int>& mo_sym,
+                      bool antisymmetric, size_t max_dense_size = default_max_dense_size);
+
+    /// Return the element V[p][q][r][s]
+    double get(size_t p, size_t q, size_t r, size_t s) const {
+        if (dense_)
+            return data_[((p * nmo_ + q) * nmo_ + r) * nmo_ + s];
+        size_t pq = p * nmo_ + q;
+        size_t rs = r * nmo_ + s;
+        if (pair_sym_[pq] != pair_sym_[rs])
+            return 0.0;
+        return pair_sign_[pq] * pair_sign_[rs] * data_[row_offset_[pq] + pair_index_[rs]];
+    }
+
+    /// Return the integrals as a dense nmo^4 vector
+    std::vector<double> dense() const;
+
+    /// Return the flat array V[((p * nmo + q) * nmo + r) * nmo + s] if the integrals are not
+    /// packed, otherwise nullptr
+    const double* dense_data() const { return dense_ ? data_.data() : nullptr; }
+
+    /// The number of orbitals
+    size_t nmo() const { return nmo_; }
+    /// The number of elements stored
+    size_t size() const { return data_.size(); }
+    /// Are the integrals stored as a flat nmo^4 array?
+    bool is_dense() const { return dense_; }
+    /// Are only the pairs p > q stored?
+    bool antisymmetric() const { return antisymmetric_; }
+
+  private:
+    /// Build the pair tables for a given orbital symmetry
+    void setup(const std::vector<int>& mo_sym);
+
+    /// The number of orbitals
+    size_t nmo_;
+    /// Are the integrals stored as a flat nmo^4 array (the pair tables are then empty)?
+    bool dense_ = false;
+    /// Are only the pairs p > q stored?
+    bool antisymmetric_;
+    /// The symmetry of each pair pq (pairs p = q of antisymmetric integrals are assigned to an
+    /// extra block that holds a single zero)
+    std::vector<int> pair_sym_;
+    /// The index of each pair pq within its irrep
+    std::vector<size_t> pair_index_;
+    /// The sign of each pair pq (0 for p = q when antisymmetric)
+    std::vector<double> pair_sign_;
+    /// The position of the row V[pq][*] in data_
+    std::vector<size_t> row_offset_;
+    /// The packed (or flat) integrals
+    std::vector<double> data_;
+};
+
+} // namespace forte
+
+#endif // _symmetry_packed_tei_h_
@@ -0,0 +1,431 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "helpers/disk_io.h"
+#include "three_index_file.h"
+
+namespace forte {
+
+namespace {
+
+constexpr char magic[8] = {'F', 'O', 'R', 'T', 'E', '3', 'I', 'X'};
+constexpr uint32_t file_version = 1;
+
+/// tile encodings
+constexpr uint32_t encoding_double = 0;
+constexpr uint32_t encoding_int32 = 1;
+constexpr uint32_t encoding_int16 = 2;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t layout;
+    uint32_t compression;
+    uint32_t padding;
+    uint64_t naux;
+    uint64_t nmo;
+    uint64_t tile_Q;
+    uint64_t tile_p;
+    uint64_t ntiles;
+    uint64_t key;
+    uint64_t checksum;
+    double max_error;
+};
+
+size_t num_tiles(size_t n, size_t tile) { return (n + tile - 1) / tile; }
+
+/// Encode a tile, returning the encoding and the scale
+uint32_t encode_tile(const std::vector<double>& data, ThreeIndexCompression compression,
+                     double max_error, std::vector<char>& buffer, double& scale) {
+    scale = 0.0;
+    uint32_t encoding = encoding_double;
+
+    if (compression == ThreeIndexCompression::Bounded and max_error > 0.0) {
+        double max_abs = 0.0;
+        for (double x : data) {
+            max_abs = std::max(max_abs, std::fabs(x));
+        }
+        scale = 2.0 * max_error;
+        double max_int = max_abs / scale;
+        if (max_int < std::numeric_limits<int16_t>::max() - 1) {
+            encoding = encoding_int16;
+        } else if (max_int < std::numeric_limits<int32_t>::max() - 1) {
+            encoding = encoding_int32;
+        }
+    }
+
+    if (encoding == encoding_int16) {
+        buffer.resize(data.size() * sizeof(int16_t));
+        auto out = reinterpret_cast<int16_t*>(buffer.data());
+        for (size_t i = 0, n = data.size(); i < n; ++i) {
+            out[i] = static_cast<int16_t>(std::lround(data[i] / scale));
+        }
+    } else if (encoding == encoding_int32) {
+        buffer.resize(data.size() * sizeof(int32_t));
+        auto out = reinterpret_cast<int32_t*>(buffer.data());
+        for (size_t i = 0, n = data.size(); i < n; ++i) {
+            out[i] = static_cast<int32_t>(std::lround(data[i] / scale));
+        }
+    } else {
+        buffer.resize(data.size() * sizeof(double));
+        std::memcpy(buffer.data(), data.data(), buffer.size());
+    }
+
+    // keep every tile aligned to 8 bytes
+    buffer.resize((buffer.size() + 7) / 8 * 8, 0);
+    return encoding;
+}
+
+} // namespace
+
+void ThreeIndexFile::write(const std::string& filename, size_t naux, size_t nmo, uint64_t key,
+                           const FillFunction& fill, ThreeIndexLayout layout,
+                           ThreeIndexCompression compression, double max_error,
+                           size_t tile_size) {
+    // tiles span all q; PQMajor tiles span all Q, QMajor tiles span all p
+    size_t tile_Q, tile_p;
+    if (layout == ThreeIndexLayout::PQMajor) {
+        tile_Q = std::max(naux, size_t(1));
+        tile_p = std::clamp(tile_size / std::max(naux * nmo, size_t(1)), size_t(1),
+                            std::max(nmo, size_t(1)));
+    } else {
+        tile_p = std::max(nmo, size_t(1));
+        tile_Q = std::clamp(tile_size / std::max(nmo * nmo, size_t(1)), size_t(1),
+                            std::max(naux, size_t(1)));
+    }
+    size_t ntiles_Q = num_tiles(naux, tile_Q);
+    size_t ntiles_p = num_tiles(nmo, tile_p);
+    size_t ntiles = ntiles_Q * ntiles_p;
+
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = file_version;
+    header.layout = static_cast<uint32_t>(layout);
+    header.compression = static_cast<uint32_t>(compression);
+    header.padding = 0;
+    header.naux = naux;
+    header.nmo = nmo;
+    header.tile_Q = tile_Q;
+    header.tile_p = tile_p;
+    header.ntiles = ntiles;
+    header.key = key;
+    header.checksum = 0;
+    header.max_error = max_error;
+
+    std::string tmp_filename = filename + ".tmp." + std::to_string(getpid());
+    std::ofstream out(tmp_filename, std::ios_base::binary | std::ios_base::trunc);
+    if (not out.good()) {
+        throw std::runtime_error("ThreeIndexFile: cannot open " + tmp_filename);
+    }
+
+    std::vector<Tile> tiles(ntiles);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    out.write(reinterpret_cast<const char*>(tiles.data()), ntiles * sizeof(Tile));
+
+    uint64_t offset = sizeof(FileHeader) + ntiles * sizeof(Tile);
+    uint64_t checksum = hash_bytes(nullptr, 0);
+    std::vector<double> block, tile;
+    std::vector<char> buffer;
+
+    for (size_t t = 0; t < ntiles; ++t) {
+        size_t iQ = layout == ThreeIndexLayout::PQMajor ? t % ntiles_Q : t / ntiles_p;
+        size_t ip = layout == ThreeIndexLayout::PQMajor ? t / ntiles_Q : t % ntiles_p;
+        size_t Q0 = iQ * tile_Q, Q1 = std::min(Q0 + tile_Q, naux);
+        size_t p0 = ip * tile_p, p1 = std::min(p0 + tile_p, nmo);
+        size_t nQ = Q1 - Q0, npq = (p1 - p0) * nmo;
+
+        block.resize(nQ * npq);
+        fill(Q0, Q1, p0, p1, block.data());
+
+        if (layout == ThreeIndexLayout::PQMajor) {
+            tile.resize(block.size());
+            for (size_t Q = 0; Q < nQ; ++Q) {
+                for (size_t pq = 0; pq < npq; ++pq) {
+                    tile[pq * nQ + Q] = block[Q * npq + pq];
+                }
+            }
+        } else {
+            tile.swap(block);
+        }
+
+        auto& entry = tiles[t];
+        entry.encoding = encode_tile(tile, compression, max_error, buffer, entry.scale);
+        entry.offset = offset;
+        entry.nbytes = buffer.size();
+        entry.padding = 0;
+
+        out.write(buffer.data(), buffer.size());
+        checksum = hash_bytes(buffer.data(), buffer.size(), checksum);
+        offset += buffer.size();
+    }
+
+    header.checksum = checksum;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    out.write(reinterpret_cast<const char*>(tiles.data()), ntiles * sizeof(Tile));
+    out.close();
+    if (out.fail()) {
+        std::remove(tmp_filename.c_str());
+        throw std::runtime_error("ThreeIndexFile: error when writing " + tmp_filename);
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_filename.c_str());
+        throw std::runtime_error("ThreeIndexFile: cannot rename " + tmp_filename + " to " +
+                                 filename);
+    }
+}
+
+bool ThreeIndexFile::is_valid(const std::string& filename, uint64_t key, size_t naux,
+                              size_t nmo) {
+    std::ifstream in(filename, std::ios_base::binary);
+    if (not in.good()) {
+        return false;
+    }
+    FileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
+    if (not in.good()) {
+        return false;
+    }
+    return std::memcmp(header.magic, magic, sizeof(magic)) == 0 and
+           header.version == file_version and header.key == key and header.naux == naux and
+           header.nmo == nmo;
+}
+
+ThreeIndexFile::ThreeIndexFile(const std::string& filename, bool verify) : filename_(filename) {
+    auto error = [&](const std::string& msg) {
+        throw std::runtime_error("ThreeIndexFile: " + filename_ + " " + msg);
+    };
+
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        error("cannot be opened");
+    }
+    struct stat buf;
+    if (fstat(fd_, &buf) != 0 or static_cast<size_t>(buf.st_size) < sizeof(FileHeader)) {
+        close(fd_);
+        error("is not a three-index integral file");
+    }
+    size_ = buf.st_size;
+
+    void* ptr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (ptr == MAP_FAILED) {
+        close(fd_);
+        error("cannot be mapped");
+    }
+    data_ = static_cast<const char*>(ptr);
+
+    const auto& header = *reinterpret_cast<const FileHeader*>(data_);
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 or header.version != file_version) {
+        unmap();
+        error("is not a three-index integral file (or has a different version)");
+    }
+
+    layout_ = static_cast<ThreeIndexLayout>(header.layout);
+    naux_ = header.naux;
+    nmo_ = header.nmo;
+    tile_Q_ = header.tile_Q;
+    tile_p_ = header.tile_p;
+    key_ = header.key;
+    ntiles_Q_ = num_tiles(naux_, tile_Q_);
+    ntiles_p_ = num_tiles(nmo_, tile_p_);
+
+    checksum_ = header.checksum;
+    payload_ = sizeof(FileHeader) + header.ntiles * sizeof(Tile);
+    if (header.ntiles != ntiles_Q_ * ntiles_p_ or payload_ > size_) {
+        unmap();
+        error("is truncated");
+    }
+    // check the tile table against the dimensions (cheap, unlike the payload checksum)
+    tiles_ = reinterpret_cast<const Tile*>(data_ + sizeof(FileHeader));
+    for (size_t iQ = 0; iQ < ntiles_Q_; ++iQ) {
+        for (size_t ip = 0; ip < ntiles_p_; ++ip) {
+            size_t t = layout_ == ThreeIndexLayout::PQMajor ? ip * ntiles_Q_ + iQ
+                                                            : iQ * ntiles_p_ + ip;
+            const Tile& tile = tiles_[t];
+            size_t nQ = std::min(tile_Q_, naux_ - iQ * tile_Q_);
+            size_t np = std::min(tile_p_, nmo_ - ip * tile_p_);
+            size_t nelements = nQ * np * nmo_;
+            size_t element_size = tile.encoding == encoding_double  ? sizeof(double)
+                                  : tile.encoding == encoding_int32 ? sizeof(int32_t)
+                                  : tile.encoding == encoding_int16 ? sizeof(int16_t)
+                                                                    : 0;
+            // tiles are padded to 8 bytes
+            if (element_size == 0 or tile.nbytes != (nelements * element_size + 7) / 8 * 8) {
+                unmap();
+                error("is corrupted (inconsistent tile table)");
+            }
+            if (tile.offset < payload_ or tile.offset + tile.nbytes > size_) {
+                unmap();
+                error("is truncated");
+            }
+        }
+    }
+
+    if (verify and not this->verify()) {
+        unmap();
+        error("is corrupted (checksum mismatch)");
+    }
+}
+
+bool ThreeIndexFile::verify() const {
+    return hash_bytes(data_ + payload_, size_ - payload_) == checksum_;
+}
+
+ThreeIndexFile::~ThreeIndexFile() { unmap(); }
+
+void ThreeIndexFile::unmap() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+void ThreeIndexFile::for_each_tile(
+    const std::vector<size_t>& Q_range, const std::vector<size_t>& p_range,
+    const std::function<void(size_t, size_t, size_t, size_t, const double*)>& f) const {
+    if (Q_range[0] >= Q_range[1] or p_range[0] >= p_range[1]) {
+        return;
+    }
+    if (Q_range[1] > naux_ or p_range[1] > nmo_) {
+        throw std::runtime_error("ThreeIndexFile: indices out of range");
+    }
+
+    std::vector<std::pair<size_t, size_t>> overlap;
+    for (size_t iQ = Q_range[0] / tile_Q_; iQ <= (Q_range[1] - 1) / tile_Q_; ++iQ) {
+        for (size_t ip = p_range[0] / tile_p_; ip <= (p_range[1] - 1) / tile_p_; ++ip) {
+            overlap.emplace_back(iQ, ip);
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t n = 0; n < overlap.size(); ++n) {
+        auto [iQ, ip] = overlap[n];
+        size_t t = layout_ == ThreeIndexLayout::PQMajor ? ip * ntiles_Q_ + iQ : iQ * ntiles_p_ + ip;
+        const Tile& tile = tiles_[t];
+        size_t Q0 = iQ * tile_Q_, Q1 = std::min(Q0 + tile_Q_, naux_);
+        size_t p0 = ip * tile_p_, p1 = std::min(p0 + tile_p_, nmo_);
+        size_t nelements = (Q1 - Q0) * (p1 - p0) * nmo_;
+
+        if (tile.encoding == encoding_double) {
+            f(Q0, Q1, p0, p1, reinterpret_cast<const double*>(data_ + tile.offset));
+            continue;
+        }
+
+        std::vector<double> decoded(nelements);
+        if (tile.encoding == encoding_int16) {
+            auto in = reinterpret_cast<const int16_t*>(data_ + tile.offset);
+            for (size_t i = 0; i < nelements; ++i) {
+                decoded[i] = in[i] * tile.scale;
+            }
+        } else {
+            auto in = reinterpret_cast<const int32_t*>(data_ + tile.offset);
+            for (size_t i = 0; i < nelements; ++i) {
+                decoded[i] = in[i] * tile.scale;
+            }
+        }
+        f(Q0, Q1, p0, p1, decoded.data());
+    }
+}
+
+void ThreeIndexFile::read_Qpq(double* out, const std::vector<size_t>& Q_range,
+                              const std::vector<size_t>& p_range,
+                              const std::vector<size_t>& q_range) const {
+    size_t np = p_range[1] - p_range[0];
+    size_t nq = q_range[1] - q_range[0];
+    size_t q0 = q_range[0];
+
+    for_each_tile(Q_range, p_range, [&](size_t Q0, size_t Q1, size_t p0, size_t p1,
+                                        const double* data) {
+        size_t Qb = std::max(Q0, Q_range[0]), Qe = std::min(Q1, Q_range[1]);
+        size_t pb = std::max(p0, p_range[0]), pe = std::min(p1, p_range[1]);
+        size_t nQ_tile = Q1 - Q0, np_tile = p1 - p0;
+        for (size_t Q = Qb; Q < Qe; ++Q) {
+            for (size_t p = pb; p < pe; ++p) {
+                double* dest = out + ((Q - Q_range[0]) * np + (p - p_range[0])) * nq;
+                if (layout_ == ThreeIndexLayout::QMajor) {
+                    std::copy_n(data + ((Q - Q0) * np_tile + (p - p0)) * nmo_ + q0, nq, dest);
+                } else {
+                    const double* src = data + ((p - p0) * nmo_ + q0) * nQ_tile + (Q - Q0);
+                    for (size_t q = 0; q < nq; ++q) {
+                        dest[q] = src[q * nQ_tile];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void ThreeIndexFile::read_pqQ(double* out, const std::vector<size_t>& Q_range,
+                              const std::vector<size_t>& p_range,
+                              const std::vector<size_t>& q_range) const {
+    size_t nQ = Q_range[1] - Q_range[0];
+    size_t nq = q_range[1] - q_range[0];
+    size_t q0 = q_range[0];
+
+    for_each_tile(Q_range, p_range, [&](size_t Q0, size_t Q1, size_t p0, size_t p1,
+                                        const double* data) {
+        size_t Qb = std::max(Q0, Q_range[0]), Qe = std::min(Q1, Q_range[1]);
+        size_t pb = std::max(p0, p_range[0]), pe = std::min(p1, p_range[1]);
+        size_t nQ_tile = Q1 - Q0, np_tile = p1 - p0;
+        for (size_t p = pb; p < pe; ++p) {
+            for (size_t q = 0; q < nq; ++q) {
+                double* dest = out + ((p - p_range[0]) * nq + q) * nQ + (Qb - Q_range[0]);
+                if (layout_ == ThreeIndexLayout::PQMajor) {
+                    std::copy_n(data + ((p - p0) * nmo_ + q0 + q) * nQ_tile + (Qb - Q0), Qe - Qb,
+                                dest);
+                } else {
+                    const double* src =
+                        data + (Qb - Q0) * np_tile * nmo_ + (p - p0) * nmo_ + q0 + q;
+                    for (size_t Q = 0; Q < Qe - Qb; ++Q) {
+                        dest[Q] = src[Q * np_tile * nmo_];
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace forte
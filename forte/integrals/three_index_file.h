@@ -0,0 +1,154 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _three_index_file_h_
+#define _three_index_file_h_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace forte {
+
+/// The order of the elements inside a tile of a ThreeIndexFile
+enum class ThreeIndexLayout : uint32_t {
+    /// tiles span all q and store elements as [Q][p][q]
+    QMajor = 0,
+    /// tiles span all q and store elements as [p][q][Q]
+    PQMajor = 1
+};
+
+/// The encoding of the tiles of a ThreeIndexFile
+enum class ThreeIndexCompression : uint32_t {
+    /// store doubles as they are
+    None = 0,
+    /// store integers n such that |B - n * scale| <= max_error (16 or 32 bits per element)
+    Bounded = 1
+};
+
+/**
+ * @brief A tiled, memory-mapped file of three-index integrals B(Q|pq)
+ *
+ * The file contains a header (dimensions, layout, a user key, and a checksum of the payload),
+ * a table of tiles, and the tiles. Each tile holds a block of auxiliary indices Q and a block
+ * of orbital indices p for all q. Tiles stored without compression are read directly from the
+ * mapped memory. The file is mapped read-only and shared, so jobs running on the same node
+ * share the same pages.
+ *
+ * Files are written to a temporary name and renamed, so a reader never sees a partial file.
+ */
+class ThreeIndexFile {
+  public:
+    /// Fill out[(Q - Q0) * (p1 - p0) * nmo + (p - p0) * nmo + q] for Q in [Q0, Q1), p in [p0, p1)
+    using FillFunction = std::function<void(size_t Q0, size_t Q1, size_t p0, size_t p1, double*)>;
+
+    /**
+     * @brief Write a three-index integral file
+     * @param filename the file name
+     * @param naux the number of auxiliary functions
+     * @param nmo the number of orbitals
+     * @param key a user key used to recognize the integrals (e.g., a hash of the orbitals)
+     * @param fill a function that returns blocks of integrals
+     * @param layout the order of the elements within a tile
+     * @param compression the encoding of the tiles
+     * @param max_error the maximum absolute error of a compressed element
+     * @param tile_size the target number of elements in a tile
+     */
+    static void write(const std::string& filename, size_t naux, size_t nmo, uint64_t key,
+                      const FillFunction& fill, ThreeIndexLayout layout = ThreeIndexLayout::PQMajor,
+                      ThreeIndexCompression compression = ThreeIndexCompression::None,
+                      double max_error = 1.0e-8, size_t tile_size = 524288);
+
+    /// @return true if filename is a three-index file with the given key and dimensions
+    static bool is_valid(const std::string& filename, uint64_t key, size_t naux, size_t nmo);
+
+    /// Map a three-index file. Only the header and the tile table are checked, unless verify is
+    /// true, in which case the checksum of the whole payload is also compared (O(file size))
+    ThreeIndexFile(const std::string& filename, bool verify = false);
+    ~ThreeIndexFile();
+
+    ThreeIndexFile(const ThreeIndexFile&) = delete;
+    ThreeIndexFile& operator=(const ThreeIndexFile&) = delete;
+
+    size_t naux() const { return naux_; }
+    size_t nmo() const { return nmo_; }
+    uint64_t key() const { return key_; }
+    /// @return the size of the file in bytes
+    size_t file_size() const { return size_; }
+
+    /// @return true if the checksum of the payload matches the one stored in the header
+    bool verify() const;
+
+    /// Fill out[(Q - Q0) * np * nq + (p - p0) * nq + (q - q0)] (DFHelper Qpq order)
+    void read_Qpq(double* out, const std::vector<size_t>& Q_range,
+                  const std::vector<size_t>& p_range, const std::vector<size_t>& q_range) const;
+
+    /// Fill out[((p - p0) * nq + (q - q0)) * nQ + (Q - Q0)] (pq-major order)
+    void read_pqQ(double* out, const std::vector<size_t>& Q_range,
+                  const std::vector<size_t>& p_range, const std::vector<size_t>& q_range) const;
+
+  private:
+    struct Tile {
+        uint64_t offset;
+        uint64_t nbytes;
+        double scale;
+        uint32_t encoding;
+        uint32_t padding;
+    };
+
+    /// Unmap and close the file
+    void unmap();
+
+    /// Call f(Q0, Q1, p0, p1, data) in parallel for all tiles that overlap the Q and p ranges,
+    /// where [Q0, Q1) x [p0, p1) is the range of the tile and data its decoded elements
+    void for_each_tile(
+        const std::vector<size_t>& Q_range, const std::vector<size_t>& p_range,
+        const std::function<void(size_t, size_t, size_t, size_t, const double*)>& f) const;
+
+    std::string filename_;
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+    ThreeIndexLayout layout_;
+    size_t naux_ = 0;
+    size_t nmo_ = 0;
+    size_t tile_Q_ = 0;
+    size_t tile_p_ = 0;
+    uint64_t key_ = 0;
+    uint64_t checksum_ = 0;
+    size_t payload_ = 0;
+    const Tile* tiles_ = nullptr;
+    size_t ntiles_Q_ = 0;
+    size_t ntiles_p_ = 0;
+};
+
+} // namespace forte
+
+#endif // _three_index_file_h_
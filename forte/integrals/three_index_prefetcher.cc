@@ -0,0 +1,92 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "helpers/timer.h"
+#include "integrals.h"
+#include "three_index_prefetcher.h"
+
+namespace forte {
+
+ThreeIndexPrefetcher::ThreeIndexPrefetcher(std::shared_ptr<ForteIntegrals> ints,
+                                           const std::vector<size_t>& Q,
+                                           std::vector<Request> requests, bool async)
+    : ints_(ints), Q_(Q), requests_(std::move(requests)), async_(async) {
+    if (not requests_.empty()) {
+        launch(0);
+    }
+}
+
+ThreeIndexPrefetcher::~ThreeIndexPrefetcher() {
+    // a deferred read that was never requested does not need to run
+    if (async_ and pending_.valid()) {
+        pending_.wait();
+    }
+}
+
+void ThreeIndexPrefetcher::launch(size_t n) {
+    auto read = [this, n]() {
+        local_timer t;
+        auto B = ints_->three_integral_block(Q_, requests_[n].first, requests_[n].second);
+        return std::make_pair(B, t.get());
+    };
+    pending_ = std::async(async_ ? std::launch::async : std::launch::deferred, read);
+}
+
+ambit::Tensor ThreeIndexPrefetcher::next() {
+    if (done()) {
+        throw std::runtime_error("ThreeIndexPrefetcher::next: no blocks left to read");
+    }
+
+    local_timer t;
+    auto [B, read_time] = pending_.get();
+    last_wait_ = t.get();
+    total_wait_ += last_wait_;
+    total_read_ += read_time;
+
+    current_++;
+    if (not done()) {
+        launch(current_);
+    }
+    return B;
+}
+
+std::vector<std::vector<size_t>> split_in_batches(const std::vector<size_t>& indices,
+                                                  size_t max_size) {
+    std::vector<std::vector<size_t>> batches;
+    max_size = std::max(max_size, size_t(1));
+    for (size_t start = 0, size = indices.size(); start < size; start += max_size) {
+        size_t end = std::min(start + max_size, size);
+        batches.emplace_back(indices.begin() + start, indices.begin() + end);
+    }
+    return batches;
+}
+
+} // namespace forte
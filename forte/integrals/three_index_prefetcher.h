@@ -0,0 +1,107 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _three_index_prefetcher_h_
+#define _three_index_prefetcher_h_
+
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ambit/tensor.h"
+
+namespace forte {
+
+class ForteIntegrals;
+
+/**
+ * @brief Reads a fixed sequence of three-index integral blocks B(Q|pq) with one block of
+ * look-ahead.
+ *
+ * The caller lists the (p, q) index sets in the order in which it will consume them.
+ * Every call to next() returns the current block and starts reading the following one on
+ * a background thread, so that disk reads (DiskDF) overlap with the contractions of the
+ * caller. At most two blocks are alive inside the prefetcher at any time.
+ *
+ * All reads of the integrals must go through this object while it is active, since the
+ * integral classes are not safe for concurrent reads.
+ */
+class ThreeIndexPrefetcher {
+  public:
+    using Request = std::pair<std::vector<size_t>, std::vector<size_t>>;
+
+    /// @param ints the integral object
+    /// @param Q the auxiliary indices
+    /// @param requests the (p, q) index sets, in the order they will be requested
+    /// @param async read the next block on a background thread
+    ThreeIndexPrefetcher(std::shared_ptr<ForteIntegrals> ints, const std::vector<size_t>& Q,
+                         std::vector<Request> requests, bool async = true);
+
+    /// Wait for the pending read, if any
+    ~ThreeIndexPrefetcher();
+
+    /// @return the next block B(Q|pq) of size Q x p x q
+    ambit::Tensor next();
+
+    /// @return true if all the blocks have been returned
+    bool done() const { return current_ >= requests_.size(); }
+
+    /// @return the time (s) spent waiting for the last block returned by next()
+    double last_wait() const { return last_wait_; }
+    /// @return the total time (s) spent waiting for blocks
+    double total_wait() const { return total_wait_; }
+    /// @return the total time (s) spent reading blocks (overlapped or not)
+    double total_read() const { return total_read_; }
+
+  private:
+    /// Start reading block n
+    void launch(size_t n);
+
+    std::shared_ptr<ForteIntegrals> ints_;
+    std::vector<size_t> Q_;
+    std::vector<Request> requests_;
+    bool async_;
+
+    /// The index of the next block returned by next()
+    size_t current_ = 0;
+    /// The pending read (block and read time)
+    std::future<std::pair<ambit::Tensor, double>> pending_;
+
+    double last_wait_ = 0.0;
+    double total_wait_ = 0.0;
+    double total_read_ = 0.0;
+};
+
+/// Split a list of indices into consecutive batches that hold at most max_size elements
+std::vector<std::vector<size_t>> split_in_batches(const std::vector<size_t>& indices,
+                                                  size_t max_size);
+
+} // namespace forte
+
+#endif // _three_index_prefetcher_h_
@@ -0,0 +1,277 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include "dsrg_diis.h"
+
+namespace forte {
+
+DSRG_DIIS::DSRG_DIIS(int max_vec, bool single_precision)
+    : max_vec_(max_vec), single_precision_(single_precision) {
+    if (max_vec_ < 1) {
+        throw psi::PSIEXCEPTION("DSRG_DIIS requires at least one vector.");
+    }
+    B_.assign(max_vec_ * max_vec_, 0.0);
+}
+
+void DSRG_DIIS::add_blocks(ambit::BlockedTensor& T, ambit::BlockedTensor& R,
+                           const std::vector<std::string>& blocks) {
+    for (const std::string& block : blocks) {
+        auto Tb = T.block(block);
+        auto Rb = R.block(block);
+        if (Tb.numel() != Rb.numel()) {
+            throw psi::PSIEXCEPTION("Inconsistent amplitude and residual block " + block + ".");
+        }
+        offsets_.push_back(vec_size_);
+        vec_size_ += Tb.numel();
+        amps_.push_back(Tb);
+        res_.push_back(Rb);
+    }
+    allocate();
+}
+
+void DSRG_DIIS::allocate() {
+    reset_subspace();
+    size_t size = vec_size_ * max_vec_;
+    if (single_precision_) {
+        amps_f_.assign(size, 0.0f);
+        res_f_.assign(size, 0.0f);
+    } else {
+        amps_d_.assign(size, 0.0);
+        res_d_.assign(size, 0.0);
+    }
+}
+
+size_t DSRG_DIIS::memory() const { return memory(vec_size_, max_vec_, single_precision_); }
+
+size_t DSRG_DIIS::memory(size_t vec_size, int max_vec, bool single_precision) {
+    return 2 * vec_size * max_vec * (single_precision ? sizeof(float) : sizeof(double));
+}
+
+void DSRG_DIIS::reset_subspace() {
+    nvec_ = 0;
+    std::fill(B_.begin(), B_.end(), 0.0);
+}
+
+void DSRG_DIIS::add_entry() {
+    // replace the vector with the largest residual if the subspace is full
+    int slot = nvec_;
+    if (nvec_ == max_vec_) {
+        slot = 0;
+        for (int i = 1; i < nvec_; ++i) {
+            if (B_[i * max_vec_ + i] > B_[slot * max_vec_ + slot])
+                slot = i;
+        }
+    } else {
+        nvec_ += 1;
+    }
+
+    if (single_precision_) {
+        pack(slot, amps_f_, res_f_);
+        update_overlaps(slot, res_f_);
+    } else {
+        pack(slot, amps_d_, res_d_);
+        update_overlaps(slot, res_d_);
+    }
+}
+
+template <typename T>
+void DSRG_DIIS::pack(int slot, std::vector<T>& amps, std::vector<T>& res) {
+    T* amps_slot = amps.data() + slot * vec_size_;
+    T* res_slot = res.data() + slot * vec_size_;
+
+    for (size_t n = 0, nblocks = amps_.size(); n < nblocks; ++n) {
+        const auto& t = amps_[n].data();
+        const auto& r = res_[n].data();
+        T* a = amps_slot + offsets_[n];
+        T* e = res_slot + offsets_[n];
+        size_t size = t.size();
+#pragma omp parallel for
+        for (size_t i = 0; i < size; ++i) {
+            a[i] = static_cast<T>(t[i]);
+            e[i] = static_cast<T>(r[i]);
+        }
+    }
+}
+
+template <typename T> void DSRG_DIIS::update_overlaps(int slot, const std::vector<T>& res) {
+    const T* x = res.data() + slot * vec_size_;
+    for (int j = 0; j < nvec_; ++j) {
+        const T* y = res.data() + j * vec_size_;
+        double value = 0.0;
+#pragma omp parallel for reduction(+ : value)
+        for (size_t i = 0; i < vec_size_; ++i) {
+            value += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+        }
+        B_[slot * max_vec_ + j] = value;
+        B_[j * max_vec_ + slot] = value;
+    }
+}
+
+bool DSRG_DIIS::extrapolate() {
+    // vectors used in the extrapolation, drop the largest residual if the equations are singular
+    std::vector<int> active(nvec_);
+    std::iota(active.begin(), active.end(), 0);
+
+    while (!active.empty()) {
+        std::vector<double> c;
+        if (solve(active, c)) {
+            std::vector<double> coeffs(nvec_, 0.0);
+            for (size_t i = 0, size = active.size(); i < size; ++i) {
+                coeffs[active[i]] = c[i];
+            }
+            if (single_precision_) {
+                unpack(coeffs, amps_f_);
+            } else {
+                unpack(coeffs, amps_d_);
+            }
+            return true;
+        }
+
+        auto worst = std::max_element(active.begin(), active.end(), [&](int i, int j) {
+            return B_[i * max_vec_ + i] < B_[j * max_vec_ + j];
+        });
+        active.erase(worst);
+    }
+
+    return false;
+}
+
+bool DSRG_DIIS::solve(const std::vector<int>& active, std::vector<double>& c) {
+    /**
+     * Minimize c^T B c subject to sum_i c_i = 1, where B_ij = <r_i|r_j>.
+     * With D = diag(B)^(-1/2) and c = D x, solve
+     *   [ DBD  -d ] [ x      ]   [  0 ]
+     *   [ -d^T  0 ] [ lambda ] = [ -1 ],  d_i = D_ii.
+     */
+    int m = active.size();
+    int n = m + 1;
+
+    std::vector<double> d(m);
+    for (int i = 0; i < m; ++i) {
+        double Bii = B_[active[i] * max_vec_ + active[i]];
+        if (Bii <= 0.0)
+            return false;
+        d[i] = 1.0 / std::sqrt(Bii);
+    }
+
+    std::vector<double> A(n * n, 0.0);
+    c.assign(n, 0.0);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < m; ++j) {
+            A[i * n + j] = d[i] * B_[active[i] * max_vec_ + active[j]] * d[j];
+        }
+        A[i * n + m] = -d[i];
+        A[m * n + i] = -d[i];
+    }
+    c[m] = -1.0;
+
+    // Gaussian elimination with partial pivoting
+    for (int k = 0; k < n; ++k) {
+        int p = k;
+        for (int i = k + 1; i < n; ++i) {
+            if (std::fabs(A[i * n + k]) > std::fabs(A[p * n + k]))
+                p = i;
+        }
+        if (std::fabs(A[p * n + k]) < 1.0e-12)
+            return false;
+        if (p != k) {
+            for (int j = 0; j < n; ++j) {
+                std::swap(A[k * n + j], A[p * n + j]);
+            }
+            std::swap(c[k], c[p]);
+        }
+        for (int i = k + 1; i < n; ++i) {
+            double f = A[i * n + k] / A[k * n + k];
+            for (int j = k; j < n; ++j) {
+                A[i * n + j] -= f * A[k * n + j];
+            }
+            c[i] -= f * c[k];
+        }
+    }
+    for (int k = n - 1; k >= 0; --k) {
+        for (int j = k + 1; j < n; ++j) {
+            c[k] -= A[k * n + j] * c[j];
+        }
+        c[k] /= A[k * n + k];
+    }
+
+    c.resize(m);
+    for (int i = 0; i < m; ++i) {
+        c[i] *= d[i];
+    }
+    return true;
+}
+
+template <typename T>
+void DSRG_DIIS::unpack(const std::vector<double>& c, const std::vector<T>& amps) {
+    for (size_t n = 0, nblocks = amps_.size(); n < nblocks; ++n) {
+        auto& t = amps_[n].data();
+        size_t size = t.size(), offset = offsets_[n];
+#pragma omp parallel for
+        for (size_t i = 0; i < size; ++i) {
+            double value = 0.0;
+            for (int v = 0; v < nvec_; ++v) {
+                value += c[v] * amps[v * vec_size_ + offset + i];
+            }
+            t[i] = value;
+        }
+    }
+}
+
+int add_diis_memory_entry(DSRG_MEM& mem, size_t vec_size, int max_vec, int min_vec,
+                          bool single_precision) {
+    // memory left after the stored tensors and the largest local intermediate
+    int64_t mem_left = static_cast<int64_t>(mem.available()) -
+                       static_cast<int64_t>(mem.max_local_memory());
+    size_t mem_vec = DSRG_DIIS::memory(vec_size, 1, single_precision);
+
+    int nvec = max_vec;
+    if (mem_vec > 0 and mem_left < static_cast<int64_t>(mem_vec * max_vec)) {
+        nvec = mem_left > 0 ? static_cast<int>(mem_left / static_cast<int64_t>(mem_vec)) : 0;
+        if (nvec < min_vec) {
+            psi::outfile->Printf("\n  Warning: Not enough memory to store %d DIIS vectors.",
+                                 min_vec);
+            psi::outfile->Printf("\n  DIIS is turned off. Set DSRG_DIIS_FLOAT or increase memory.");
+            return 0;
+        }
+        psi::outfile->Printf("\n  Warning: Not enough memory to store %d DIIS vectors.",
+                             max_vec);
+        psi::outfile->Printf("\n  The number of DIIS vectors is reduced to %d.", nvec);
+    }
+
+    mem.add_entry("DIIS history", DSRG_DIIS::memory(vec_size, nvec, single_precision));
+    return nvec;
+}
+} // namespace forte
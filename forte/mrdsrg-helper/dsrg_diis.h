@@ -0,0 +1,141 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _dsrg_diis_h_
+#define _dsrg_diis_h_
+
+#include <string>
+#include <vector>
+
+#include "ambit/blocked_tensor.h"
+
+#include "mrdsrg-helper/dsrg_mem.h"
+
+namespace forte {
+
+/**
+ * @brief In-memory DIIS accelerator for DSRG amplitudes.
+ *
+ * The amplitude and residual blocks are registered once and packed directly from the tensor
+ * data into two contiguous history buffers (double or single precision), one slot per vector.
+ * The overlaps of the residuals are kept between iterations, so adding a vector costs one pass
+ * over the history and extrapolation writes straight back into the amplitude blocks.
+ * When the subspace is full, the vector with the largest residual is replaced.
+ * The history is kept in memory; use add_diis_memory_entry() to size it before construction.
+ */
+class DSRG_DIIS {
+  public:
+    /**
+     * @brief DSRG_DIIS Constructor
+     * @param max_vec The maximum number of vectors in the subspace
+     * @param single_precision Store the history vectors in single precision
+     */
+    DSRG_DIIS(int max_vec, bool single_precision = false);
+
+    /// Register blocks of the amplitudes T and the corresponding residuals R
+    void add_blocks(ambit::BlockedTensor& T, ambit::BlockedTensor& R,
+                    const std::vector<std::string>& blocks);
+
+    /// Add the current amplitudes and residuals to the subspace
+    void add_entry();
+
+    /// Overwrite the amplitudes by the extrapolated ones, return false if not successful
+    bool extrapolate();
+
+    /// Return the number of vectors in the subspace
+    int subspace_size() const { return nvec_; }
+
+    /// Remove all vectors from the subspace
+    void reset_subspace();
+
+    /// Return the memory (in bytes) of the history buffers
+    size_t memory() const;
+
+    /// Return the memory (in bytes) of the history buffers for vectors of vec_size elements
+    static size_t memory(size_t vec_size, int max_vec, bool single_precision);
+
+  private:
+    /// Maximum number of vectors
+    int max_vec_;
+    /// Store the history in single precision
+    bool single_precision_;
+
+    /// Registered amplitude blocks
+    std::vector<ambit::Tensor> amps_;
+    /// Registered residual blocks
+    std::vector<ambit::Tensor> res_;
+    /// Offsets of the blocks in a history vector
+    std::vector<size_t> offsets_;
+    /// Number of elements of a history vector
+    size_t vec_size_ = 0;
+
+    /// Amplitude history, max_vec_ slots of vec_size_ elements
+    std::vector<double> amps_d_;
+    std::vector<float> amps_f_;
+    /// Residual history, max_vec_ slots of vec_size_ elements
+    std::vector<double> res_d_;
+    std::vector<float> res_f_;
+
+    /// Number of vectors in the subspace
+    int nvec_ = 0;
+    /// Overlaps of the residuals, max_vec_ x max_vec_
+    std::vector<double> B_;
+
+    /// Allocate the history buffers
+    void allocate();
+
+    /// Solve the DIIS equations using the given vectors, return false if singular
+    bool solve(const std::vector<int>& active, std::vector<double>& c);
+
+    /// Copy the current amplitudes and residuals to the given slot
+    template <typename T> void pack(int slot, std::vector<T>& amps, std::vector<T>& res);
+    /// Overlaps of the residual in the given slot with all residuals in the subspace
+    template <typename T> void update_overlaps(int slot, const std::vector<T>& res);
+    /// Write sum_i c_i * amplitude_i to the amplitude blocks
+    template <typename T>
+    void unpack(const std::vector<double>& c, const std::vector<T>& amps);
+};
+
+/**
+ * @brief Add the DIIS history to a DSRG memory check.
+ *
+ * The number of history vectors is reduced to what fits in the memory left for DSRG.
+ * If fewer than min_vec vectors fit, no entry is added and DIIS should be turned off.
+ *
+ * @param mem The DSRG memory check, all other entries should already be added
+ * @param vec_size The number of amplitudes in one DIIS vector
+ * @param max_vec The maximum number of vectors requested
+ * @param min_vec The minimum number of vectors needed for an extrapolation
+ * @param single_precision Store the history vectors in single precision
+ * @return The number of vectors to use, or 0 if the history does not fit
+ */
+int add_diis_memory_entry(DSRG_MEM& mem, size_t vec_size, int max_vec, int min_vec,
+                          bool single_precision);
+} // namespace forte
+
+#endif // DSRG_DIIS_H
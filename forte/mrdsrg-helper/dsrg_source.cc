@@ -26,18 +26,206 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "dsrg_source.h"
 
 namespace forte {
 
+std::vector<double> compute_block_denominators(const std::vector<std::vector<double>>& e) {
+    size_t n_index = e.size();
+    if (n_index != 2 and n_index != 4) {
+        throw std::runtime_error("Block denominators are only available for 2 or 4 indices.");
+    }
+
+    size_t size = 1;
+    for (const auto& ei : e) {
+        size *= ei.size();
+    }
+    std::vector<double> D(size);
+
+    if (n_index == 2) {
+        const auto &e0 = e[0], &e1 = e[1];
+        size_t n1 = e1.size();
+        for (size_t i = 0, n0 = e0.size(); i < n0; ++i) {
+            double* Di = D.data() + i * n1;
+#pragma omp simd
+            for (size_t a = 0; a < n1; ++a) {
+                Di[a] = e0[i] - e1[a];
+            }
+        }
+    } else {
+        const auto &e0 = e[0], &e1 = e[1], &e2 = e[2], &e3 = e[3];
+        size_t n1 = e1.size(), n2 = e2.size(), n3 = e3.size();
+#pragma omp parallel for collapse(2)
+        for (size_t i = 0; i < e0.size(); ++i) {
+            for (size_t j = 0; j < n1; ++j) {
+                double eij = e0[i] + e1[j];
+                double* Dij = D.data() + (i * n1 + j) * n2 * n3;
+                for (size_t a = 0; a < n2; ++a) {
+                    double eija = eij - e2[a];
+                    double* Dija = Dij + a * n3;
+#pragma omp simd
+                    for (size_t b = 0; b < n3; ++b) {
+                        Dija[b] = eija - e3[b];
+                    }
+                }
+            }
+        }
+    }
+
+    return D;
+}
+
 DSRG_SOURCE::DSRG_SOURCE(double s, double taylor_threshold)
     : s_(s), taylor_threshold_(taylor_threshold) {}
 
+void DSRG_SOURCE::compute_renormalized(const double* D, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = compute_renormalized(D[i]);
+    }
+}
+
+void DSRG_SOURCE::compute_renormalized_denominator(const double* D, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = compute_renormalized_denominator(D[i]);
+    }
+}
+
+namespace {
+/// Number of elements renormalized at a time, small enough to stay in L1 cache
+constexpr size_t scale_chunk = 512;
+} // namespace
+
+void DSRG_SOURCE::scale_renormalized_chunk(const double* D, double* X, size_t n,
+                                           double shift) {
+    double R[scale_chunk];
+    compute_renormalized(D, R, n);
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        X[i] *= shift + R[i];
+    }
+}
+
+void DSRG_SOURCE::scale_renormalized_denominator_chunk(const double* D, double* X, size_t n,
+                                                       double screen) {
+    double R[scale_chunk];
+    compute_renormalized_denominator(D, R, n);
+    // select rather than branch, so that the loop still vectorizes
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        X[i] = std::fabs(X[i]) > screen ? X[i] * R[i] : X[i];
+    }
+}
+
+void DSRG_SOURCE::scale_renormalized(const std::vector<double>& D, std::vector<double>& X,
+                                     double shift) {
+    size_t size = std::min(D.size(), X.size());
+    size_t nchunks = (size + scale_chunk - 1) / scale_chunk;
+#pragma omp parallel for
+    for (size_t c = 0; c < nchunks; ++c) {
+        size_t offset = c * scale_chunk;
+        size_t n = std::min(scale_chunk, size - offset);
+        scale_renormalized_chunk(D.data() + offset, X.data() + offset, n, shift);
+    }
+}
+
+void DSRG_SOURCE::scale_renormalized_denominator(const std::vector<double>& D,
+                                                 std::vector<double>& X, double screen) {
+    size_t size = std::min(D.size(), X.size());
+    size_t nchunks = (size + scale_chunk - 1) / scale_chunk;
+#pragma omp parallel for
+    for (size_t c = 0; c < nchunks; ++c) {
+        size_t offset = c * scale_chunk;
+        size_t n = std::min(scale_chunk, size - offset);
+        scale_renormalized_denominator_chunk(D.data() + offset, X.data() + offset, n, screen);
+    }
+}
+
+void DSRG_SOURCE::scale_renormalized_serial(const std::vector<double>& D,
+                                            std::vector<double>& X, double shift) {
+    size_t size = std::min(D.size(), X.size());
+    for (size_t offset = 0; offset < size; offset += scale_chunk) {
+        size_t n = std::min(scale_chunk, size - offset);
+        scale_renormalized_chunk(D.data() + offset, X.data() + offset, n, shift);
+    }
+}
+
+void DSRG_SOURCE::scale_renormalized_denominator_serial(const std::vector<double>& D,
+                                                        std::vector<double>& X, double screen) {
+    size_t size = std::min(D.size(), X.size());
+    for (size_t offset = 0; offset < size; offset += scale_chunk) {
+        size_t n = std::min(scale_chunk, size - offset);
+        scale_renormalized_denominator_chunk(D.data() + offset, X.data() + offset, n, screen);
+    }
+}
+
 STD_SOURCE::STD_SOURCE(double s, double taylor_threshold) : DSRG_SOURCE(s, taylor_threshold) {}
 
+void STD_SOURCE::compute_renormalized(const double* D, double* out, size_t n) {
+    double s = s_;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::exp(-s * D[i] * D[i]);
+    }
+}
+
+void STD_SOURCE::compute_renormalized_denominator(const double* D, double* out, size_t n) {
+    if (denominator_kernel_) {
+        denominator_kernel_(s_, small_, D, out, n);
+    } else {
+        DSRG_SOURCE::compute_renormalized_denominator(D, out, n);
+    }
+}
+
 LABS_SOURCE::LABS_SOURCE(double s, double taylor_threshold) : DSRG_SOURCE(s, taylor_threshold) {}
 
+void LABS_SOURCE::compute_renormalized(const double* D, double* out, size_t n) {
+    double s = s_;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::exp(-s * std::fabs(D[i]));
+    }
+}
+
+void LABS_SOURCE::compute_renormalized_denominator(const double* D, double* out, size_t n) {
+    if (denominator_kernel_) {
+        denominator_kernel_(s_, small_, D, out, n);
+    } else {
+        DSRG_SOURCE::compute_renormalized_denominator(D, out, n);
+    }
+}
+
 DYSON_SOURCE::DYSON_SOURCE(double s, double taylor_threshold) : DSRG_SOURCE(s, taylor_threshold) {}
 
+void DYSON_SOURCE::compute_renormalized(const double* D, double* out, size_t n) {
+    double s = s_;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = 1.0 / (1.0 + s * D[i] * D[i]);
+    }
+}
+
+void DYSON_SOURCE::compute_renormalized_denominator(const double* D, double* out, size_t n) {
+    double s = s_;
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        double d = D[i];
+        out[i] = s * d / (1.0 + s * d * d);
+    }
+}
+
 MP2_SOURCE::MP2_SOURCE(double s, double taylor_threshold) : DSRG_SOURCE(s, taylor_threshold) {}
+
+void MP2_SOURCE::compute_renormalized(const double*, double* out, size_t n) {
+    std::fill(out, out + n, 1.0);
+}
+
+void MP2_SOURCE::compute_renormalized_denominator(const double* D, double* out, size_t n) {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = 1.0 / D[i];
+    }
+}
 }
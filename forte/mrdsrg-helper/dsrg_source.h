@@ -30,10 +30,95 @@
 #define _dsrg_source_h_
 
 #include <cmath>
-
+#include <cstddef>
+#include <vector>
 
 namespace forte {
 
+namespace dsrg_kernel {
+/// Coefficient of x^k in the Taylor series of [1 - exp(-x)] / x, i.e., (-1)^k / (k + 1)!
+constexpr double taylor_coeff(int k) {
+    double c = 1.0;
+    for (int x = 1; x <= k; ++x) {
+        c *= -1.0 / (x + 1);
+    }
+    return c;
+}
+
+/// The first N terms of the Taylor series of [1 - exp(-x)] / x, unrolled at compile time
+template <int N> inline double taylor_series(double x) {
+    double value = 0.0;
+    for (int k = N - 1; k >= 0; --k) {
+        value = taylor_coeff(k) + x * value;
+    }
+    return value;
+}
+
+/// out[i] = [1 - exp(-s * D[i]^2)] / D[i], Taylor expansion of order N if |sqrt(s) D[i]| < small
+template <int N>
+void std_renormalized_denominator(double s, double small, const double* D, double* out,
+                                  size_t n) {
+    double sqrt_s = std::sqrt(s);
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        double d = D[i];
+        double Z = sqrt_s * d;
+        bool taylor = std::fabs(Z) < small;
+        double exact = (1.0 - std::exp(-s * d * d)) / (taylor ? 1.0 : d);
+        out[i] = taylor ? Z * taylor_series<N>(Z * Z) * sqrt_s : exact;
+    }
+}
+
+/// out[i] = [1 - exp(-s * |D[i]|)] / D[i], Taylor expansion of order N if |s D[i]| < small
+template <int N>
+void labs_renormalized_denominator(double s, double small, const double* D, double* out,
+                                   size_t n) {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        double d = D[i];
+        double Z = s * d;
+        bool taylor = std::fabs(Z) < small;
+        double exact = (1.0 - std::exp(-s * std::fabs(d))) / (taylor ? 1.0 : d);
+        double series = taylor_series<N>(std::fabs(Z)) * s;
+        out[i] = taylor ? (Z >= 0.0 ? series : -series) : exact;
+    }
+}
+
+using batch_kernel = void (*)(double, double, const double*, double*, size_t);
+
+/// Largest Taylor order with a compile-time specialized kernel
+constexpr int max_taylor_order = 40;
+
+/// Return the kernel specialized for the given Taylor order, nullptr if not available
+template <template <int> class Kernel, int N = 1> batch_kernel select_kernel(int order) {
+    if constexpr (N > max_taylor_order) {
+        return nullptr;
+    } else {
+        return order == N ? &Kernel<N>::apply : select_kernel<Kernel, N + 1>(order);
+    }
+}
+
+template <int N> struct STD_Kernel {
+    static void apply(double s, double small, const double* D, double* out, size_t n) {
+        std_renormalized_denominator<N>(s, small, D, out, n);
+    }
+};
+
+template <int N> struct LABS_Kernel {
+    static void apply(double s, double small, const double* D, double* out, size_t n) {
+        labs_renormalized_denominator<N>(s, small, D, out, n);
+    }
+};
+} // namespace dsrg_kernel
+
+/**
+ * @brief Energy denominators of a block stored in row-major order
+ * @param e The orbital energies of each index of the block
+ * @return D[ia] = e0[i] - e1[a] for 2-index blocks,
+ *         D[ijab] = e0[i] + e1[j] - e2[a] - e3[b] for 4-index blocks
+ */
+std::vector<double> compute_block_denominators(const std::vector<std::vector<double>>& e);
+
 class DSRG_SOURCE {
   public:
     /**
@@ -50,7 +135,32 @@ class DSRG_SOURCE {
     /// Renormalize denominator
     virtual double compute_renormalized_denominator(const double& D) = 0;
 
+    /// Bare effect of source operator for n denominators, out may alias D
+    virtual void compute_renormalized(const double* D, double* out, size_t n);
+    /// Renormalize n denominators, out may alias D
+    virtual void compute_renormalized_denominator(const double* D, double* out, size_t n);
+
+    /// X[i] *= shift + compute_renormalized(D[i])
+    void scale_renormalized(const std::vector<double>& D, std::vector<double>& X,
+                            double shift = 0.0);
+    /// X[i] *= compute_renormalized_denominator(D[i]) for |X[i]| > screen
+    void scale_renormalized_denominator(const std::vector<double>& D, std::vector<double>& X,
+                                        double screen = 0.0);
+
+    /// Same as scale_renormalized, without a parallel region (for use inside one)
+    void scale_renormalized_serial(const std::vector<double>& D, std::vector<double>& X,
+                                   double shift = 0.0);
+    /// Same as scale_renormalized_denominator, without a parallel region (for use inside one)
+    void scale_renormalized_denominator_serial(const std::vector<double>& D,
+                                               std::vector<double>& X, double screen = 0.0);
+
   protected:
+    /// Scale n elements of X by shift + compute_renormalized(D)
+    void scale_renormalized_chunk(const double* D, double* X, size_t n, double shift);
+    /// Scale the n elements of X with |X[i]| > screen by compute_renormalized_denominator(D)
+    void scale_renormalized_denominator_chunk(const double* D, double* X, size_t n,
+                                              double screen);
+
     /// Flow parameter
     double s_;
     /// Smaller than which we will do Taylor expansion
@@ -78,6 +188,9 @@ class STD_SOURCE : public DSRG_SOURCE {
         }
     }
 
+    virtual void compute_renormalized(const double* D, double* out, size_t n);
+    virtual void compute_renormalized_denominator(const double* D, double* out, size_t n);
+
   private:
     /// Order of the Taylor expansion
     int taylor_order_ = static_cast<int>(0.5 * (15.0 / taylor_threshold_ + 1)) + 1;
@@ -85,6 +198,10 @@ class STD_SOURCE : public DSRG_SOURCE {
     /// Smaller than which will do Taylor expansion
     double small_ = std::pow(0.1, taylor_threshold_);
 
+    /// Batched renormalized denominator specialized for taylor_order_
+    dsrg_kernel::batch_kernel denominator_kernel_ =
+        dsrg_kernel::select_kernel<dsrg_kernel::STD_Kernel>(taylor_order_);
+
     /// Taylor Expansion of [1 - exp(- Z^2)] / Z
     double Taylor_Exp(const double& Z, const int& n) {
         if (n > 0) {
@@ -121,6 +238,9 @@ class LABS_SOURCE : public DSRG_SOURCE {
         }
     }
 
+    virtual void compute_renormalized(const double* D, double* out, size_t n);
+    virtual void compute_renormalized_denominator(const double* D, double* out, size_t n);
+
   private:
     /// Order of the Taylor expansion
     int taylor_order_ = static_cast<int>(15.0 / taylor_threshold_ + 1) + 1;
@@ -128,6 +248,10 @@ class LABS_SOURCE : public DSRG_SOURCE {
     /// Smaller than which will do Taylor expansion
     double small_ = std::pow(0.1, taylor_threshold_);
 
+    /// Batched renormalized denominator specialized for 2 * taylor_order_
+    dsrg_kernel::batch_kernel denominator_kernel_ =
+        dsrg_kernel::select_kernel<dsrg_kernel::LABS_Kernel>(2 * taylor_order_);
+
     /// Taylor Expansion of [1 - exp(-|Z|)] / Z
     double Taylor_Exp_Linear(const double& Z, const int& n) {
         double Zabs = std::fabs(Z);
@@ -163,6 +287,9 @@ class DYSON_SOURCE : public DSRG_SOURCE {
     virtual double compute_renormalized_denominator(const double& D) {
         return s_ * D / (1.0 + s_ * D * D);
     }
+
+    virtual void compute_renormalized(const double* D, double* out, size_t n);
+    virtual void compute_renormalized_denominator(const double* D, double* out, size_t n);
 };
 
 /// MP2 denominator
@@ -175,6 +302,9 @@ class MP2_SOURCE : public DSRG_SOURCE {
     virtual double compute_renormalized(const double&) { return 1.0; }
 
     virtual double compute_renormalized_denominator(const double& D) { return 1.0 / D; }
+
+    virtual void compute_renormalized(const double* D, double* out, size_t n);
+    virtual void compute_renormalized_denominator(const double* D, double* out, size_t n);
 };
 }
 
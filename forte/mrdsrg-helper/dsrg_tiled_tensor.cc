@@ -0,0 +1,109 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsio/psio.hpp"
+
+#include "dsrg_tiled_tensor.h"
+
+namespace forte {
+
+DiskTiledTensor::DiskTiledTensor(const std::string& name, const std::vector<size_t>& dims,
+                                 size_t tile_rows)
+    : name_(name), dims_(dims), tile_rows_(std::max(tile_rows, size_t(1))) {
+    if (dims_.empty()) {
+        throw psi::PSIEXCEPTION("DiskTiledTensor " + name_ + " needs at least one dimension.");
+    }
+    ntiles_ = (dims_[0] + tile_rows_ - 1) / tile_rows_;
+    row_size_ = 1;
+    for (size_t n = 1; n < dims_.size(); ++n) {
+        row_size_ *= dims_[n];
+    }
+    written_.assign(ntiles_, false);
+
+    filename_ = psi::PSIOManager::shared_object()->get_default_path() + "forte." +
+                std::to_string(getpid()) + "." + name_ + ".tiles.bin";
+    file_.open(filename_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (not file_.is_open()) {
+        throw psi::PSIEXCEPTION("Cannot open the file " + filename_ + " for DiskTiledTensor.");
+    }
+}
+
+DiskTiledTensor::~DiskTiledTensor() {
+    file_.close();
+    std::remove(filename_.c_str());
+}
+
+std::vector<size_t> DiskTiledTensor::tile_dims(size_t t) const {
+    std::vector<size_t> dims(dims_);
+    dims[0] = tile_end(t) - tile_begin(t);
+    return dims;
+}
+
+ambit::Tensor DiskTiledTensor::read_tile(size_t t) {
+    if (t >= ntiles_ or not written_[t]) {
+        throw psi::PSIEXCEPTION("Reading an invalid tile of DiskTiledTensor " + name_ + ".");
+    }
+    auto tile = ambit::Tensor::build(ambit::CoreTensor, name_ + " tile", tile_dims(t));
+    auto& data = tile.data();
+    file_.seekg(tile_begin(t) * row_size_ * sizeof(double));
+    file_.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double));
+    if (not file_.good()) {
+        throw psi::PSIEXCEPTION("Error when reading the file " + filename_ + ".");
+    }
+    return tile;
+}
+
+void DiskTiledTensor::write_tile(size_t t, ambit::Tensor tile) {
+    if (t >= ntiles_ or tile.dims() != tile_dims(t)) {
+        throw psi::PSIEXCEPTION("Writing an invalid tile of DiskTiledTensor " + name_ + ".");
+    }
+    const auto& data = tile.data();
+    file_.seekp(tile_begin(t) * row_size_ * sizeof(double));
+    file_.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+    if (not file_.good()) {
+        throw psi::PSIEXCEPTION("Error when writing the file " + filename_ + ".");
+    }
+    written_[t] = true;
+}
+
+void DiskTiledTensor::swap(DiskTiledTensor& other) {
+    if (dims_ != other.dims_ or tile_rows_ != other.tile_rows_) {
+        throw psi::PSIEXCEPTION("Cannot swap DiskTiledTensor " + name_ + " and " + other.name_ +
+                                " of different shapes.");
+    }
+    std::swap(filename_, other.filename_);
+    std::swap(file_, other.file_);
+    std::swap(written_, other.written_);
+}
+
+} // namespace forte
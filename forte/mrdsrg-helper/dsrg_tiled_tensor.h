@@ -0,0 +1,105 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _dsrg_tiled_tensor_h_
+#define _dsrg_tiled_tensor_h_
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ambit/tensor.h"
+
+namespace forte {
+
+/**
+ * @brief A tensor stored on disk in tiles along its first index.
+ *
+ * Tile t holds the elements whose first index is in [tile_begin(t), tile_end(t)), stored
+ * contiguously in row-major order, so a tile is read or written with a single I/O operation.
+ * The file lives in the psi4 scratch directory and is removed by the destructor.
+ */
+class DiskTiledTensor {
+  public:
+    /**
+     * @brief DiskTiledTensor Constructor
+     * @param name The name of the tensor (used in the file name)
+     * @param dims The dimensions of the tensor
+     * @param tile_rows The number of values of the first index in each tile
+     */
+    DiskTiledTensor(const std::string& name, const std::vector<size_t>& dims, size_t tile_rows);
+    ~DiskTiledTensor();
+
+    DiskTiledTensor(const DiskTiledTensor&) = delete;
+    DiskTiledTensor& operator=(const DiskTiledTensor&) = delete;
+
+    /// Return the name of the tensor
+    const std::string& name() const { return name_; }
+    /// Return the dimensions of the tensor
+    const std::vector<size_t>& dims() const { return dims_; }
+    /// Return the number of tiles
+    size_t ntiles() const { return ntiles_; }
+    /// Return the first value of the first index in tile t
+    size_t tile_begin(size_t t) const { return t * tile_rows_; }
+    /// Return the past-the-end value of the first index in tile t
+    size_t tile_end(size_t t) const { return std::min(dims_[0], (t + 1) * tile_rows_); }
+
+    /// Read tile t as a CoreTensor of dimensions (tile_end - tile_begin, dims[1], ...)
+    ambit::Tensor read_tile(size_t t);
+    /// Write tile t, which must have the dimensions returned by read_tile
+    void write_tile(size_t t, ambit::Tensor tile);
+
+    /// Exchange the data (files) of two tensors with the same dimensions
+    void swap(DiskTiledTensor& other);
+
+  private:
+    /// The name of the tensor
+    std::string name_;
+    /// The dimensions of the tensor
+    std::vector<size_t> dims_;
+    /// The number of values of the first index in each tile
+    size_t tile_rows_;
+    /// The number of tiles
+    size_t ntiles_;
+    /// The number of elements for one value of the first index
+    size_t row_size_;
+    /// The file name
+    std::string filename_;
+    /// The file stream
+    std::fstream file_;
+    /// Has the tile been written?
+    std::vector<bool> written_;
+
+    /// Return the dimensions of tile t
+    std::vector<size_t> tile_dims(size_t t) const;
+};
+
+} // namespace forte
+
+#endif // _dsrg_tiled_tensor_h_
@@ -64,6 +64,19 @@ void DSRG_TIME::add(const std::string& code, const double& t) {
     }
 }
 
+void DSRG_TIME::add_term(const std::string& code, const std::string& term, const double& t,
+                         const double& flops) {
+    add(code, t);
+    for (auto& entry : terms_) {
+        if (std::get<0>(entry) == code and std::get<1>(entry) == term) {
+            std::get<2>(entry) += t;
+            std::get<3>(entry) += flops;
+            return;
+        }
+    }
+    terms_.emplace_back(code, term, t, flops);
+}
+
 void DSRG_TIME::subtract(const std::string& code, const double& t) {
     if (test_code(code)) {
         auto iter = std::find(code_.begin(), code_.end(), code);
@@ -80,6 +93,7 @@ void DSRG_TIME::reset() {
     for (auto& t : timing_) {
         t = 0.0;
     }
+    terms_.clear();
 }
 
 void DSRG_TIME::reset(const std::string& code) {
@@ -170,11 +184,31 @@ void DSRG_TIME::print_comm_time() {
                                ' ' % timing_[8] % timing_[9] % timing_[10]);
         output += indent + dash + "\n";
         outfile->Printf("\n%s", output.c_str());
+        print_term_time();
     } else {
         //        print_h2("Echo from DSRG_TIME", "!!!", "!!!");
         //        outfile->Printf("  Wrong size of \"timing\". Print nothing.");
         print();
+        print_term_time();
+    }
+}
+
+void DSRG_TIME::print_term_time() {
+    if (terms_.empty())
+        return;
+
+    outfile->Printf("\n\n  ==> Timings (s) and Estimated GFLOP of Commutator Terms <==\n");
+    std::string dash(62, '-');
+    outfile->Printf("\n    %-5s  %-20s  %10s  %10s  %8s", "Code", "Term", "Time", "GFLOP",
+                    "GFLOP/s");
+    outfile->Printf("\n    %s", dash.c_str());
+    for (const auto& entry : terms_) {
+        double t = std::get<2>(entry);
+        double gflop = std::get<3>(entry) * 1.0e-9;
+        outfile->Printf("\n    %-5s  %-20s  %10.3f  %10.3f  %8.2f", std::get<0>(entry).c_str(),
+                        std::get<1>(entry).c_str(), t, gflop, t > 0.0 ? gflop / t : 0.0);
     }
+    outfile->Printf("\n    %s", dash.c_str());
 }
 
 bool DSRG_TIME::test_code(const std::string& code) {
@@ -32,6 +32,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <tuple>
 
 #include "psi4/libtrans/integraltransform.h"
 
@@ -45,6 +46,10 @@ class DSRG_TIME {
     /// Accumulate timings
     void add(const std::string& code, const double& t);
 
+    /// Accumulate timings and estimated FLOPs of one term of a commutator
+    void add_term(const std::string& code, const std::string& term, const double& t,
+                  const double& flops);
+
     /// Subtract timings
     void subtract(const std::string& code, const double& t);
 
@@ -61,6 +66,9 @@ class DSRG_TIME {
     /// Print summary for with default code
     void print_comm_time();
 
+    /// Print the timings and estimated FLOPs of the individual terms
+    void print_term_time();
+
     /// Print the timing in a generic way
     void print();
     void print(const std::string& code);
@@ -70,6 +78,7 @@ class DSRG_TIME {
         code_.clear();
         code_to_tidx_.clear();
         timing_.clear();
+        terms_.clear();
     }
 
   private:
@@ -87,6 +96,9 @@ class DSRG_TIME {
     /// Timings for commutators
     std::vector<double> timing_;
 
+    /// Timings and estimated FLOPs of individual terms: (code, term, timing, FLOPs)
+    std::vector<std::tuple<std::string, std::string, double, double>> terms_;
+
     /// Test code
     bool test_code(const std::string& code);
 };
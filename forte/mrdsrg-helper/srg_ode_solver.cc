@@ -0,0 +1,267 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "psi4/libpsi4util/exception.h"
+
+#include "srg_ode_solver.h"
+
+namespace forte {
+
+namespace {
+// Dormand-Prince 5(4) tableau, the last row of A is the fifth-order solution
+const double dp_c[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
+const std::vector<std::vector<double>> dp_a{
+    {},
+    {1.0 / 5.0},
+    {3.0 / 40.0, 9.0 / 40.0},
+    {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+    {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+    {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+    {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}};
+// difference between the fifth- and fourth-order weights
+const double dp_e[7] = {71.0 / 57600.0,      0.0, -71.0 / 16695.0, 71.0 / 1920.0,
+                        -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+} // namespace
+
+SRG_ODESolver::SRG_ODESolver(std::vector<ambit::BlockedTensor> x, double abserr, double relerr)
+    : x_(x), abserr_(abserr), relerr_(relerr) {
+    if (abserr_ <= 0.0 and relerr_ <= 0.0) {
+        throw psi::PSIEXCEPTION("SRG_ODESolver requires a positive error tolerance.");
+    }
+}
+
+void SRG_ODESolver::set_checkpoint(const std::string& filename, int freq) {
+    chk_filename_ = filename;
+    chk_freq_ = freq;
+}
+
+std::vector<ambit::BlockedTensor> SRG_ODESolver::build_like_state(const std::string& name) {
+    std::vector<ambit::BlockedTensor> out;
+    for (size_t t = 0, nt = x_.size(); t < nt; ++t) {
+        out.push_back(ambit::BlockedTensor::build(ambit::CoreTensor,
+                                                  name + " " + std::to_string(t),
+                                                  x_[t].block_labels()));
+    }
+    return out;
+}
+
+std::vector<SRG_ODESolver::segment>
+SRG_ODESolver::segments(std::vector<ambit::BlockedTensor>& x) {
+    std::vector<segment> out;
+    for (auto& T : x) {
+        for (const std::string& block : T.block_labels()) {
+            auto& data = T.block(block).data();
+            out.emplace_back(data.data(), data.size());
+        }
+    }
+    return out;
+}
+
+void SRG_ODESolver::combine(const std::vector<segment>& x,
+                            const std::vector<std::vector<segment>>& k,
+                            const std::vector<double>& c, double h,
+                            const std::vector<segment>& out) {
+    for (size_t i = 0, nseg = x.size(); i < nseg; ++i) {
+        const double* xi = x[i].first;
+        double* oi = out[i].first;
+        size_t size = x[i].second;
+
+#pragma omp parallel for
+        for (size_t p = 0; p < size; ++p) {
+            double value = xi[p];
+            for (size_t j = 0, nk = c.size(); j < nk; ++j) {
+                value += h * c[j] * k[j][i].first[p];
+            }
+            oi[p] = value;
+        }
+    }
+}
+
+int SRG_ODESolver::integrate(const rhs_type& rhs, double& x0, double s0, double s1, double ds,
+                             const observer_type& observer) {
+    auto y = segments(x_);
+
+    // stage tensors and the stage input (the new state after the last stage)
+    std::vector<std::vector<ambit::BlockedTensor>> k(7);
+    std::vector<std::vector<segment>> ks(7);
+    for (int i = 0; i < 7; ++i) {
+        k[i] = build_like_state("SRG k" + std::to_string(i + 1));
+        ks[i] = segments(k[i]);
+    }
+    auto ytmp = build_like_state("SRG x");
+    auto ytmp_s = segments(ytmp);
+
+    double s = s0, h = ds, y0 = x0;
+    double k0[7];
+    double y0tmp = y0;
+
+    rhs(s, y0, x_, k0[0], k[0]);
+    ++nevals_;
+    observer(s, y0);
+
+    int naccepted = 0;
+    double s_tol = 1.0e-12 * std::max(1.0, std::fabs(s1));
+    while (s1 - s > s_tol) {
+        h = std::min(h, s1 - s);
+
+        for (int i = 1; i < 7; ++i) {
+            const auto& a = dp_a[i];
+            std::vector<std::vector<segment>> kprev(ks.begin(), ks.begin() + i);
+            combine(y, kprev, a, h, ytmp_s);
+
+            y0tmp = y0;
+            for (int j = 0; j < i; ++j) {
+                y0tmp += h * a[j] * k0[j];
+            }
+
+            rhs(s + dp_c[i] * h, y0tmp, ytmp, k0[i], k[i]);
+            ++nevals_;
+        }
+
+        // max norm of the error scaled by abserr + relerr * max(|x_old|, |x_new|)
+        double e0 = 0.0;
+        for (int j = 0; j < 7; ++j) {
+            e0 += h * dp_e[j] * k0[j];
+        }
+        double err =
+            std::fabs(e0) / (abserr_ + relerr_ * std::max(std::fabs(y0), std::fabs(y0tmp)));
+
+        for (size_t i = 0, nseg = y.size(); i < nseg; ++i) {
+            const double* yi = y[i].first;
+            const double* yn = ytmp_s[i].first;
+            size_t size = y[i].second;
+            double err_i = 0.0;
+
+#pragma omp parallel for reduction(max : err_i)
+            for (size_t p = 0; p < size; ++p) {
+                double e = 0.0;
+                for (int j = 0; j < 7; ++j) {
+                    e += dp_e[j] * ks[j][i].first[p];
+                }
+                double scale = abserr_ + relerr_ * std::max(std::fabs(yi[p]), std::fabs(yn[p]));
+                err_i = std::max(err_i, std::fabs(h * e) / scale);
+            }
+            err = std::max(err, err_i);
+        }
+
+        if (err <= 1.0) {
+            // accept the step and reuse the last stage as the first stage of the next step
+            for (size_t i = 0, nseg = y.size(); i < nseg; ++i) {
+                std::copy(ytmp_s[i].first, ytmp_s[i].first + y[i].second, y[i].first);
+            }
+            y0 = y0tmp;
+            s += h;
+            std::swap(k[0], k[6]);
+            std::swap(ks[0], ks[6]);
+            k0[0] = k0[6];
+
+            double factor = (err == 0.0) ? 5.0 : 0.9 * std::pow(err, -0.2);
+            h *= std::min(5.0, std::max(0.2, factor));
+
+            ++naccepted;
+            observer(s, y0);
+            if (chk_freq_ > 0 and naccepted % chk_freq_ == 0) {
+                write_checkpoint(s, h, y0);
+            }
+        } else {
+            ++nrejected_;
+            h *= std::max(0.2, 0.9 * std::pow(err, -0.2));
+            if (h < 1.0e-14 * std::max(1.0, std::fabs(s))) {
+                throw psi::PSIEXCEPTION("SRG_ODESolver: step size underflow at s = " +
+                                        std::to_string(s) + ".");
+            }
+        }
+    }
+
+    x0 = y0;
+    return naccepted;
+}
+
+void SRG_ODESolver::write_checkpoint(double s, double ds, double x0) {
+    // write to a temporary file first so that an interruption never leaves a broken checkpoint
+    std::string tmp_filename = chk_filename_ + ".tmp";
+    std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (not out.good()) {
+        throw psi::PSIEXCEPTION("Cannot open SRG checkpoint file " + tmp_filename + ".");
+    }
+
+    auto y = segments(x_);
+    size_t nseg = y.size();
+    out.write(reinterpret_cast<const char*>(&nseg), sizeof(size_t));
+    out.write(reinterpret_cast<const char*>(&s), sizeof(double));
+    out.write(reinterpret_cast<const char*>(&ds), sizeof(double));
+    out.write(reinterpret_cast<const char*>(&x0), sizeof(double));
+    for (const auto& seg : y) {
+        out.write(reinterpret_cast<const char*>(&seg.second), sizeof(size_t));
+        out.write(reinterpret_cast<const char*>(seg.first), seg.second * sizeof(double));
+    }
+    out.close();
+
+    if (out.fail() or std::rename(tmp_filename.c_str(), chk_filename_.c_str()) != 0) {
+        throw psi::PSIEXCEPTION("Failed to write SRG checkpoint file " + chk_filename_ + ".");
+    }
+}
+
+bool SRG_ODESolver::read_checkpoint(double& s, double& ds, double& x0) {
+    std::ifstream in(chk_filename_, std::ios::binary);
+    if (not in.good()) {
+        return false;
+    }
+
+    auto y = segments(x_);
+    size_t nseg = 0;
+    in.read(reinterpret_cast<char*>(&nseg), sizeof(size_t));
+    if (nseg != y.size()) {
+        throw psi::PSIEXCEPTION("SRG checkpoint file " + chk_filename_ +
+                                " does not match the flow equations.");
+    }
+    in.read(reinterpret_cast<char*>(&s), sizeof(double));
+    in.read(reinterpret_cast<char*>(&ds), sizeof(double));
+    in.read(reinterpret_cast<char*>(&x0), sizeof(double));
+
+    for (auto& seg : y) {
+        size_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size_t));
+        if (size != seg.second) {
+            throw psi::PSIEXCEPTION("SRG checkpoint file " + chk_filename_ +
+                                    " does not match the flow equations.");
+        }
+        in.read(reinterpret_cast<char*>(seg.first), size * sizeof(double));
+    }
+
+    if (in.fail()) {
+        throw psi::PSIEXCEPTION("SRG checkpoint file " + chk_filename_ + " is truncated.");
+    }
+    return true;
+}
+} // namespace forte
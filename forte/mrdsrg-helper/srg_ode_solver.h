@@ -0,0 +1,130 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _srg_ode_solver_h_
+#define _srg_ode_solver_h_
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ambit/blocked_tensor.h"
+
+namespace forte {
+
+/**
+ * @brief Adaptive Dormand-Prince 5(4) integrator for SRG flow equations.
+ *
+ * The state is a scalar (the energy) and a list of BlockedTensor objects.
+ * All Runge-Kutta stages live in tensors of the same shape as the state and are combined
+ * block by block, so nothing is copied in and out of a flat vector around the right-hand side.
+ * The last stage of an accepted step is reused as the first stage of the next one, which makes
+ * six right-hand-side evaluations per step, and the step size is controlled by the embedded
+ * fourth-order error estimate.
+ *
+ * The state can be written to disk every few accepted steps and read back to resume an
+ * interrupted integration. Only these periodic checkpoints are written, so the file holds the
+ * last checkpointed state, which is the end point s1 only if the last step was checkpointed.
+ */
+class SRG_ODESolver {
+  public:
+    /// The right-hand side: compute (dx0/ds, dx/ds) at (s, x0, x), x must not be modified
+    using rhs_type = std::function<void(double s, double x0, std::vector<ambit::BlockedTensor>& x,
+                                        double& dx0ds, std::vector<ambit::BlockedTensor>& dxds)>;
+    /// Called with (s, x0) at the initial point and after every accepted step
+    using observer_type = std::function<void(double s, double x0)>;
+
+    /**
+     * @brief SRG_ODESolver Constructor
+     * @param x The tensors of the state, updated in place
+     * @param abserr The absolute error tolerance
+     * @param relerr The relative error tolerance
+     */
+    SRG_ODESolver(std::vector<ambit::BlockedTensor> x, double abserr, double relerr);
+
+    /// Write the state to filename every freq accepted steps (no checkpoint if freq < 1)
+    void set_checkpoint(const std::string& filename, int freq);
+
+    /// Read s, the step size, x0, and x from the checkpoint file, return false if not found
+    bool read_checkpoint(double& s, double& ds, double& x0);
+
+    /**
+     * @brief Integrate the flow
+     * @param rhs The right-hand side
+     * @param x0 The scalar part of the state, updated on return
+     * @param s0 The initial value of s
+     * @param s1 The final value of s
+     * @param ds The initial step size
+     * @param observer The observer of accepted steps
+     * @return The number of accepted steps
+     */
+    int integrate(const rhs_type& rhs, double& x0, double s0, double s1, double ds,
+                  const observer_type& observer);
+
+    /// Return the number of right-hand-side evaluations
+    size_t nevals() const { return nevals_; }
+    /// Return the number of rejected steps
+    size_t nrejected() const { return nrejected_; }
+
+  private:
+    /// The state tensors
+    std::vector<ambit::BlockedTensor> x_;
+    /// Absolute error tolerance
+    double abserr_;
+    /// Relative error tolerance
+    double relerr_;
+
+    /// Checkpoint file name
+    std::string chk_filename_;
+    /// Checkpoint frequency
+    int chk_freq_ = 0;
+
+    /// Number of right-hand-side evaluations
+    size_t nevals_ = 0;
+    /// Number of rejected steps
+    size_t nrejected_ = 0;
+
+    /// A contiguous piece (one tensor block) of the state
+    using segment = std::pair<double*, size_t>;
+
+    /// Build empty tensors with the blocks of the state
+    std::vector<ambit::BlockedTensor> build_like_state(const std::string& name);
+    /// Return the blocks of the given tensors as raw segments
+    std::vector<segment> segments(std::vector<ambit::BlockedTensor>& x);
+
+    /// out = x + h * sum_j c[j] * k[j]
+    void combine(const std::vector<segment>& x, const std::vector<std::vector<segment>>& k,
+                 const std::vector<double>& c, double h, const std::vector<segment>& out);
+
+    /// Write the state to the checkpoint file
+    void write_checkpoint(double s, double ds, double x0);
+};
+} // namespace forte
+
+#endif // SRG_ODE_SOLVER_H
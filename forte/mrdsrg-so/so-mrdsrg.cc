@@ -38,6 +38,7 @@
 #include "helpers/blockedtensorfactory.h"
 #include "helpers/printing.h"
 #include "helpers/helpers.h"
+#include "mrdsrg-helper/dsrg_diis.h"
 #include "so-mrdsrg.h"
 
 #define ISA(x) (x < nactv)
@@ -620,6 +621,23 @@ double SOMRDSRG::compute_energy() {
 
     compute_hbar();
 
+    // DIIS of the external amplitudes, the internal ones are zero (off unless DSRG_SO_DIIS)
+    std::shared_ptr<DSRG_DIIS> diis_manager;
+    if (foptions_->get_bool("DSRG_SO_DIIS") and diis_start_ > 0) {
+        diis_manager = std::make_shared<DSRG_DIIS>(diis_max_vec_, diis_float_);
+        std::vector<std::string> blocks1, blocks2;
+        for (const std::string& block : T1.block_labels()) {
+            if (block != "aa")
+                blocks1.push_back(block);
+        }
+        for (const std::string& block : T2.block_labels()) {
+            if (block != "aaaa")
+                blocks2.push_back(block);
+        }
+        diis_manager->add_blocks(T1, DT1, blocks1);
+        diis_manager->add_blocks(T2, DT2, blocks2);
+    }
+
     while (!converged) {
         if (print_ > 1) {
             outfile->Printf("\n  Updating the S amplitudes...");
@@ -659,44 +677,15 @@ double SOMRDSRG::compute_energy() {
         if (print_ > 1) {
             outfile->Printf(" done.");
         }
-        //        if(diis_manager){
-        //            if (do_dsrg){
-        //                diis_manager->add_entry(10,
-        //                                        &(DS1.block("ov").data()[0]),
-        //                                        &(DS1.block("OV").data()[0]),
-        //                                        &(DS2.block("oovv").data()[0]),
-        //                                        &(DS2.block("oOvV").data()[0]),
-        //                                        &(DS2.block("OOVV").data()[0]),
-        //                                        &(S1.block("ov").data()[0]),
-        //                                        &(S1.block("OV").data()[0]),
-        //                                        &(S2.block("oovv").data()[0]),
-        //                                        &(S2.block("oOvV").data()[0]),
-        //                                        &(S2.block("OOVV").data()[0]));
-        //            }else{
-        //                diis_manager->add_entry(10,
-        //                                        &(Hbar1.block("ov").data()[0]),
-        //                                        &(Hbar1.block("OV").data()[0]),
-        //                                        &(Hbar2.block("oovv").data()[0]),
-        //                                        &(Hbar2.block("oOvV").data()[0]),
-        //                                        &(Hbar2.block("OOVV").data()[0]),
-        //                                        &(S1.block("ov").data()[0]),
-        //                                        &(S1.block("OV").data()[0]),
-        //                                        &(S2.block("oovv").data()[0]),
-        //                                        &(S2.block("oOvV").data()[0]),
-        //                                        &(S2.block("OOVV").data()[0]));
-        //            }
-        //            if (cycle > max_diis_vectors){
-        //                if (cycle % max_diis_vectors == 2){
-        //                    outfile->Printf(" -> DIIS");
-        //                    diis_manager->extrapolate(5,
-        //                                             &(S1.block("ov").data()[0]),
-        //                                             &(S1.block("OV").data()[0]),
-        //                                             &(S2.block("oovv").data()[0]),
-        //                                             &(S2.block("oOvV").data()[0]),
-        //                                             &(S2.block("OOVV").data()[0]));
-        //                }
-        //            }
-        //        }
+
+        if (diis_manager and cycle >= diis_start_) {
+            diis_manager->add_entry();
+            if ((cycle - diis_start_) % diis_freq_ == 0 and
+                diis_manager->subspace_size() >= diis_min_vec_) {
+                diis_manager->extrapolate();
+            }
+        }
+
         if (print_ > 1) {
             outfile->Printf("\n  Compute recursive single commutator...");
         }
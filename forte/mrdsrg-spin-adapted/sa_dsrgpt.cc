@@ -127,14 +127,8 @@ void SA_DSRGPT::compute_t2_full() {
 
     // build T2
     for (const std::string& block : T2blocks) {
-        T2_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            size_t i2 = label_to_spacemo_[block[2]][i[2]];
-            size_t i3 = label_to_spacemo_[block[3]][i[3]];
-            double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-            value *= dsrg_source_->compute_renormalized_denominator(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, T2_.block(block).data());
     }
 
     // transform back to non-canonical basis
@@ -188,11 +182,8 @@ void SA_DSRGPT::compute_t1() {
 
     // build T1
     for (const std::string& block : T1blocks) {
-        T1_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            value *= dsrg_source_->compute_renormalized_denominator(Fdiag_[i0] - Fdiag_[i1]);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, T1_.block(block).data());
     }
 
     // transform back to non-canonical basis
@@ -225,28 +216,9 @@ void SA_DSRGPT::renormalize_integrals(bool add) {
         Vblocks.erase(std::remove(Vblocks.begin(), Vblocks.end(), "vvcc"), Vblocks.end());
     }
 
-    if (add) {
-        for (const std::string& block : Vblocks) {
-            V_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-                size_t i0 = label_to_spacemo_[block[0]][i[0]];
-                size_t i1 = label_to_spacemo_[block[1]][i[1]];
-                size_t i2 = label_to_spacemo_[block[2]][i[2]];
-                size_t i3 = label_to_spacemo_[block[3]][i[3]];
-                double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-                value *= 1.0 + dsrg_source_->compute_renormalized(denom);
-            });
-        }
-    } else {
-        for (const std::string& block : Vblocks) {
-            V_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-                size_t i0 = label_to_spacemo_[block[0]][i[0]];
-                size_t i1 = label_to_spacemo_[block[1]][i[1]];
-                size_t i2 = label_to_spacemo_[block[2]][i[2]];
-                size_t i3 = label_to_spacemo_[block[3]][i[3]];
-                double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-                value *= dsrg_source_->compute_renormalized(denom);
-            });
-        }
+    for (const std::string& block : Vblocks) {
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized(D, V_.block(block).data(), add ? 1.0 : 0.0);
     }
 
     // transform back if necessary
@@ -279,10 +251,10 @@ void SA_DSRGPT::renormalize_integrals(bool add) {
     }
 
     // scale by exp(-s * D^2)
-    temp.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>&, double& value) {
-        double denom = Fdiag_[i[0]] - Fdiag_[i[1]];
-        value *= dsrg_source_->compute_renormalized(denom);
-    });
+    for (const std::string& block : temp.block_labels()) {
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized(D, temp.block(block).data());
+    }
 
     // transform back if necessary
     if (!semi_canonical_) {
@@ -195,13 +195,24 @@ void SA_MRDSRG::compute_hbar() {
     Hbar0_ = 0.0;
     Hbar1_["pq"] = F_["pq"];
 
-    if (eri_df_) {
+    if (eri_df_ and vvvv_disk_) {
+        O2_["pqrs"] = B_["gpr"] * B_["gqs"];
+        Hbar2_["pqrs"] = O2_["pqrs"];
+    } else if (eri_df_) {
         Hbar2_["pqrs"] = B_["gpr"] * B_["gqs"];
     } else {
         Hbar2_["pqrs"] = V_["pqrs"];
-        O2_["pqrs"] = Hbar2_["pqrs"];
+        O2_["pqrs"] = V_["pqrs"];
+    }
+
+    // the vvvv block of O2 lives on disk
+    if (vvvv_disk_) {
+        init_O2_vvvv();
     }
 
+    // T2 intermediates shared by all nested commutators
+    auto T2X = build_T2_intermediates(T2_, DT2_);
+
     // temporary Hamiltonian used in every iteration
     O1_["pq"] = F_["pq"];
 
@@ -213,6 +224,9 @@ void SA_MRDSRG::compute_hbar() {
         // prefactor before n-nested commutator
         double factor = 1.0 / n;
 
+        // use the DF kernels for the bare Hamiltonian
+        bool bare_df = (n == 1) and eri_df_ and (!vvvv_disk_);
+
         // Compute the commutator C = 1/n [O, T]
         double C0 = 0.0;
         C1_.zero();
@@ -227,7 +241,7 @@ void SA_MRDSRG::compute_hbar() {
         // zero-body
         H1_T1_C0(O1_, T1_, factor, C0);
         H1_T2_C0(O1_, T2_, factor, C0);
-        if (n == 1 && eri_df_) {
+        if (bare_df) {
             V_T1_C0_DF(B_, T1_, factor, C0);
             V_T2_C0_DF(B_, T2_, DT2_, factor, C0);
         } else {
@@ -238,7 +252,7 @@ void SA_MRDSRG::compute_hbar() {
         // one-body
         H1_T1_C1(O1_, T1_, factor, C1_);
         H1_T2_C1(O1_, T2_, factor, C1_);
-        if (n == 1 && eri_df_) {
+        if (bare_df) {
             V_T1_C1_DF(B_, T1_, factor, C1_);
             V_T2_C1_DF(B_, T2_, DT2_, factor, C1_);
         } else {
@@ -248,12 +262,19 @@ void SA_MRDSRG::compute_hbar() {
 
         // two-body
         H1_T2_C2(O1_, T2_, factor, C2_);
-        if (n == 1 && eri_df_) {
+        if (bare_df) {
             V_T1_C2_DF(B_, T1_, factor, C2_);
-            V_T2_C2_DF(B_, T2_, DT2_, factor, C2_);
+            V_T2_C2_DF(B_, T2_, T2X, factor, C2_);
         } else {
             H2_T1_C2(O2_, T1_, factor, C2_);
-            H2_T2_C2(O2_, T2_, DT2_, factor, C2_);
+            H2_T2_C2(O2_, T2_, T2X, factor, C2_);
+        }
+
+        // two-body terms involving the vvvv block on disk
+        double norm2_C2_vvvv = 0.0;
+        if (vvvv_disk_) {
+            H2vvvv_T_C2(factor, C2_);
+            norm2_C2_vvvv = compute_C2_vvvv(factor);
         }
 
         // printing level
@@ -277,10 +298,14 @@ void SA_MRDSRG::compute_hbar() {
         // copy C to O for next level commutator
         O1_["pq"] = C1_["pq"];
         O2_["pqrs"] = C2_["pqrs"];
+        if (vvvv_disk_) {
+            O2vvvv_->swap(*C2vvvv_);
+        }
 
         // test convergence of C
         double norm_C1 = C1_.norm();
         double norm_C2 = C2_.norm();
+        norm_C2 = std::sqrt(norm_C2 * norm_C2 + norm2_C2_vvvv);
         if (print_ > 2) {
             outfile->Printf("\n  n: %3d, C0: %20.15f, C1 max: %20.15f, C2 max: %20.15f", n, C0,
                             C1_.norm(0), C2_.norm(0));
@@ -399,6 +424,9 @@ void SA_MRDSRG::compute_hbar_sequential() {
         O2_["pqrs"] = Hbar2_["pqrs"];
     }
 
+    // T2 intermediates shared by all nested commutators
+    auto T2X = build_T2_intermediates(T2_, DT2_);
+
     // iteration variables
     converged = false;
 
@@ -427,7 +455,7 @@ void SA_MRDSRG::compute_hbar_sequential() {
             V_T2_C1_DF(B, T2_, DT2_, factor, C1_);
             // two-body
             H1_T2_C2(O1_, T2_, factor, C2_);
-            V_T2_C2_DF(B, T2_, DT2_, factor, C2_);
+            V_T2_C2_DF(B, T2_, T2X, factor, C2_);
         } else {
             // zero-body
             H1_T2_C0(O1_, T2_, factor, C0);
@@ -437,7 +465,7 @@ void SA_MRDSRG::compute_hbar_sequential() {
             H2_T2_C1(O2_, T2_, DT2_, factor, C1_);
             // two-body
             H1_T2_C2(O1_, T2_, factor, C2_);
-            H2_T2_C2(O2_, T2_, DT2_, factor, C2_);
+            H2_T2_C2(O2_, T2_, T2X, factor, C2_);
         }
 
         // printing level
@@ -491,6 +519,9 @@ void SA_MRDSRG::compute_hbar_qc() {
         Hbar2_["ijab"] = V_["ijab"];
     }
 
+    // T2 intermediates shared by all the [H2, T2] -> C2 terms
+    auto T2X = build_T2_intermediates(T2_, DT2_);
+
     // compute S1 = H + 0.5 * [H, A]
     BlockedTensor S1 = BTF_->build(tensor_type_, "S1", {"gg"}, true);
     H1_T1_C1(F_, T1_, 0.5, S1);
@@ -533,10 +564,10 @@ void SA_MRDSRG::compute_hbar_qc() {
     H1_T2_C2(F_, T2_, 0.5, S2);
     if (eri_df_) {
         V_T1_C2_DF(B_, T1_, 0.5, S2);
-        V_T2_C2_DF(B_, T2_, DT2_, 0.5, S2);
+        V_T2_C2_DF(B_, T2_, T2X, 0.5, S2);
     } else {
         H2_T1_C2(V_, T1_, 0.5, S2);
-        H2_T2_C2(V_, T2_, DT2_, 0.5, S2);
+        H2_T2_C2(V_, T2_, T2X, 0.5, S2);
     }
 
     // 0.5 * [H, T]^+
@@ -556,12 +587,12 @@ void SA_MRDSRG::compute_hbar_qc() {
     H2_T1_C1(S2, T1_, 1.0, Hbar1_);
     H2_T2_C1(S2, T2_, DT2_, 1.0, Hbar1_);
     H2_T1_C2(S2, T1_, 1.0, Hbar2_);
-    H2_T2_C2(S2, T2_, DT2_, 1.0, Hbar2_);
+    H2_T2_C2(S2, T2_, T2X, 1.0, Hbar2_);
 
     //   Step 2: [S2, T]_{ij}^{ab}
     temp.zero();
     H2_T1_C2(S2, T1_, 1.0, temp);
-    H2_T2_C2(S2, T2_, DT2_, 1.0, temp);
+    H2_T2_C2(S2, T2_, T2X, 1.0, temp);
     Hbar2_["ijab"] += temp["abij"];
 
     temp = BTF_->build(tensor_type_, "temp", {"ph"}, true);
@@ -583,6 +614,15 @@ void SA_MRDSRG::setup_ldsrg2_tensors() {
             Hbar2_ = BTF_->build(tensor_type_, "Hbar2", blocks_exclude_V3);
             O2_ = BTF_->build(tensor_type_, "O2", blocks_exclude_V3);
             C2_ = BTF_->build(tensor_type_, "C2", blocks_exclude_V3);
+        } else if (vvvv_disk_) {
+            // Hbar2_ is only read for the hhpp and aaaa blocks after the transformation
+            Hbar2_ = BTF_->build(tensor_type_, "Hbar2", nivo_labels());
+            O2_ = BTF_->build(tensor_type_, "O2", no_vvvv_labels());
+            C2_ = BTF_->build(tensor_type_, "C2", no_vvvv_labels());
+
+            std::vector<size_t> dims(4, virt_mos_.size());
+            O2vvvv_ = std::make_unique<DiskTiledTensor>("O2vvvv", dims, vvvv_tile_rows_);
+            C2vvvv_ = std::make_unique<DiskTiledTensor>("C2vvvv", dims, vvvv_tile_rows_);
         } else {
             Hbar2_ = BTF_->build(tensor_type_, "Hbar2", {"gggg"});
             O2_ = BTF_->build(tensor_type_, "O2", {"gggg"});
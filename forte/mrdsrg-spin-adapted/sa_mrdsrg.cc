@@ -67,6 +67,18 @@ void SA_MRDSRG::read_options() {
     sequential_Hbar_ = foptions_->get_bool("DSRG_HBAR_SEQ");
     nivo_ = foptions_->get_bool("DSRG_NIVO");
 
+    vvvv_disk_ = foptions_->get_bool("DSRG_DISK_VVVV");
+    if (vvvv_disk_ and (corrlv_string_ != "LDSRG2" or nivo_ or sequential_Hbar_)) {
+        outfile->Printf("\n  Warning: DSRG_DISK_VVVV is only available for non-sequential "
+                        "LDSRG2 without NIVO.");
+        outfile->Printf("\n  Changed DSRG_DISK_VVVV option to FALSE");
+
+        vvvv_disk_ = false;
+        warnings_.push_back(std::make_tuple("Unsupported DSRG_DISK_VVVV", "Change to FALSE",
+                                            "Change options in input.dat"));
+    }
+    vvvv_tile_rows_ = virt_mos_.size();
+
     rsc_ncomm_ = foptions_->get_int("DSRG_RSC_NCOMM");
     rsc_conv_ = foptions_->get_double("DSRG_RSC_THRESHOLD");
 
@@ -141,6 +153,8 @@ void SA_MRDSRG::print_options() {
         {"Restart amplitudes", restart_amps_},
         {"Sequential DSRG transformation", sequential_Hbar_},
         {"Omit blocks of >= 3 virtual indices", nivo_},
+        {"Store vvvv intermediates on disk", vvvv_disk_},
+        {"Single-precision DIIS vectors", diis_float_},
         {"Read amplitudes from current dir", read_amps_cwd_},
         {"Write amplitudes to current dir", dump_amps_cwd_}};
 
@@ -152,12 +166,18 @@ void SA_MRDSRG::print_options() {
 void SA_MRDSRG::check_memory() {
     if (eri_df_) {
         dsrg_mem_.add_entry("1-electron and 3-index integrals", {"gg", "Lgg"});
+    } else if (vvvv_disk_) {
+        dsrg_mem_.add_entry("1-electron integrals", {"gg"});
+        dsrg_mem_.add_entry("2-electron integrals", no_vvvv_labels());
     } else {
         dsrg_mem_.add_entry("1- and 2-electron integrals", {"gg", "gggg"});
     }
 
     dsrg_mem_.add_entry("T1 cluster amplitudes and residuals", {"hp"}, 2);
     dsrg_mem_.add_entry("T2 cluster amplitudes and residuals", {"hhpp"}, 3); // T2, S2, DT2
+    dsrg_mem_.add_entry("T2 intermediates for [H2, T2] -> C2",
+                        dsrg_mem_.compute_memory({"hhpp"}, 3) +
+                            dsrg_mem_.compute_memory({"ahpp", "hhap", "hhap", "hhpa"}));
 
     if (corrlv_string_ == "LDSRG2_QC") {
         dsrg_mem_.add_entry("1- and 2-body Hbar", {"hhpp", "hp"});
@@ -166,6 +186,9 @@ void SA_MRDSRG::check_memory() {
         dsrg_mem_.add_entry("1-body Hbar and intermediates", {"gg"}, 3);
         if (nivo_) {
             dsrg_mem_.add_entry("2-body Hbar and intermediates", nivo_labels(), 3);
+        } else if (vvvv_disk_) {
+            dsrg_mem_.add_entry("2-body Hbar", nivo_labels());
+            dsrg_mem_.add_entry("2-body intermediates", no_vvvv_labels(), 2);
         } else {
             dsrg_mem_.add_entry("2-body Hbar and intermediates", {"gggg"}, 3);
         }
@@ -184,6 +207,45 @@ void SA_MRDSRG::check_memory() {
     }
     dsrg_mem_.add_entry("Local intermediates for commutators", mem_comm, false);
 
+    // vvvv tiles: one tile of O2 or C2 plus temporaries of the same size
+    if (vvvv_disk_) {
+        size_t nv = virt_mos_.size();
+        size_t mem_row = dsrg_mem_.compute_memory({"vvv"}) * 4;
+        size_t mem_local = dsrg_mem_.compute_memory({"hvvv", "ahvv"});
+        int64_t mem_avai = static_cast<int64_t>(dsrg_mem_.available() - mem_local);
+        size_t nrows = mem_avai > 0 ? static_cast<size_t>(mem_avai) / mem_row : 0;
+        int tile_rows = foptions_->get_int("DSRG_DISK_VVVV_TILE");
+        if (tile_rows > 0) {
+            nrows = static_cast<size_t>(tile_rows);
+        }
+        vvvv_tile_rows_ = std::max(std::min(nrows, nv), static_cast<size_t>(1));
+        dsrg_mem_.add_entry("Local intermediates for vvvv tiles",
+                            mem_local + mem_row * vvvv_tile_rows_, false);
+        dsrg_mem_.add_print_entry("vvvv intermediates stored on disk",
+                                  dsrg_mem_.compute_memory({"vvvv"}) * 2);
+    }
+
+    // DIIS history, reduce the number of vectors (or turn off DIIS) if it does not fit
+    if (diis_start_ > 0) {
+        size_t vec_size = 0;
+        for (const auto& blocks : {diis_blocks1(), diis_blocks2()}) {
+            for (const std::string& block : blocks) {
+                vec_size += dsrg_mem_.compute_n_elements(block);
+            }
+        }
+        int nvec = add_diis_memory_entry(dsrg_mem_, vec_size, diis_max_vec_, diis_min_vec_,
+                                         diis_float_);
+        if (nvec == 0) {
+            diis_start_ = 0;
+            warnings_.push_back(std::make_tuple("DIIS history does not fit in memory",
+                                                "Turn off DIIS", "Increase memory"));
+        } else if (nvec < diis_max_vec_) {
+            diis_max_vec_ = nvec;
+            warnings_.push_back(std::make_tuple("DIIS history does not fit in memory",
+                                                "Reduce DSRG_DIIS_MAX_VEC", "Increase memory"));
+        }
+    }
+
     dsrg_mem_.print("MR-DSRG (" + corrlv_string_ + ")");
 }
 
@@ -199,7 +261,12 @@ void SA_MRDSRG::build_ints() {
         B_ = BTF_->build(tensor_type_, "B 3-idx", {"Lgg"});
         fill_three_index_ints(B_);
     } else {
-        V_ = BTF_->build(tensor_type_, "V", {"gggg"});
+        // the vvvv block is read tile by tile from the integrals when stored on disk
+        std::vector<std::string> V_blocks{"gggg"};
+        if (vvvv_disk_) {
+            V_blocks = no_vvvv_labels();
+        }
+        V_ = BTF_->build(tensor_type_, "V", V_blocks);
 
         for (const std::string& block : V_.block_labels()) {
             auto mo_to_index = BTF_->get_mo_to_index();
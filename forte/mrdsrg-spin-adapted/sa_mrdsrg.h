@@ -29,9 +29,10 @@
 #ifndef _sa_mrdsrg_h_
 #define _sa_mrdsrg_h_
 
-#include "psi4/libdiis/diismanager.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include "mrdsrg-helper/dsrg_diis.h"
+#include "mrdsrg-helper/dsrg_tiled_tensor.h"
 #include "sadsrg.h"
 
 using namespace ambit;
@@ -82,6 +83,11 @@ class SA_MRDSRG : public SADSRG {
     /// Omitting blocks with >= 3 virtual indices?
     bool nivo_;
 
+    /// Store the vvvv blocks of the commutator intermediates on disk?
+    bool vvvv_disk_;
+    /// Number of values of the first virtual index in one vvvv tile
+    size_t vvvv_tile_rows_;
+
     /// Read amplitudes from previous reference relaxation step
     bool restart_amps_;
 
@@ -170,16 +176,30 @@ class SA_MRDSRG : public SADSRG {
     /// Temporary two-body Hamiltonian
     ambit::BlockedTensor O2_;
     ambit::BlockedTensor C2_;
+    /// The vvvv blocks of O2_ and C2_ stored on disk (only when vvvv_disk_ is true)
+    std::unique_ptr<DiskTiledTensor> O2vvvv_;
+    std::unique_ptr<DiskTiledTensor> C2vvvv_;
+
+    /// Write the vvvv block of the bare two-electron integrals to O2vvvv_
+    void init_O2_vvvv();
+    /// Add the contributions of O2vvvv_ to the in-core blocks of C2 = alpha * [O2, T]
+    void H2vvvv_T_C2(const double& alpha, BlockedTensor& C2);
+    /**
+     * Compute the vvvv block of C2 = alpha * [O2, T] + h.c. from in-core blocks
+     * @param alpha The prefactor of the commutator
+     * @return The squared 2-norm of the vvvv block written to C2vvvv_
+     */
+    double compute_C2_vvvv(const double& alpha);
 
     /// Norm of off-diagonal Hbar1 or Hbar2
     double Hbar_od_norm(const int& n, const std::vector<std::string>& blocks);
 
-    /// Shared pointer of DIISManager object from Psi4
-    std::shared_ptr<psi::DIISManager> diis_manager_;
-    /// Amplitudes pointers
-    std::vector<double*> amp_ptrs_;
-    /// Residual pointers
-    std::vector<double*> res_ptrs_;
+    /// DIIS accelerator of T1 and T2
+    std::shared_ptr<DSRG_DIIS> diis_manager_;
+    /// T1 blocks stored in DIIS
+    std::vector<std::string> diis_blocks1() const;
+    /// T2 blocks stored in DIIS
+    std::vector<std::string> diis_blocks2() const;
     /// Initialize DIISManager
     void diis_manager_init();
     /// Add entry for DIISManager
@@ -106,14 +106,8 @@ void SA_MRDSRG::guess_t2_impl(BlockedTensor& T2) {
     }
 
     for (const std::string& block : T2blocks) {
-        T2.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            size_t i2 = label_to_spacemo_[block[2]][i[2]];
-            size_t i3 = label_to_spacemo_[block[3]][i[3]];
-            double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-            value *= dsrg_source_->compute_renormalized_denominator(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, T2.block(block).data());
     }
 
     // transform back to non-canonical basis
@@ -166,11 +160,8 @@ void SA_MRDSRG::guess_t1(BlockedTensor& F, BlockedTensor& T2, BlockedTensor& T1)
         }
 
         for (const std::string& block : T1blocks) {
-            T1.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-                size_t i0 = label_to_spacemo_[block[0]][i[0]];
-                size_t i1 = label_to_spacemo_[block[1]][i[1]];
-                value *= dsrg_source_->compute_renormalized_denominator(Fdiag_[i0] - Fdiag_[i1]);
-            });
+            auto D = block_denominators(block);
+            dsrg_source_->scale_renormalized_denominator(D, T1.block(block).data());
         }
 
         // transform back to non-canonical basis
@@ -234,14 +225,8 @@ void SA_MRDSRG::update_t2() {
     }
 
     for (const std::string& block : T2blocks) {
-        DT2_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            size_t i2 = label_to_spacemo_[block[2]][i[2]];
-            size_t i3 = label_to_spacemo_[block[3]][i[3]];
-            double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-            value *= dsrg_source_->compute_renormalized_denominator(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, DT2_.block(block).data());
     }
     t2.stop();
 
@@ -264,14 +249,8 @@ void SA_MRDSRG::update_t2() {
     timer t6("scale T2 by delta exponential");
     // scale T2 by delta exponential
     for (const std::string& block : T2blocks) {
-        T2_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            size_t i2 = label_to_spacemo_[block[2]][i[2]];
-            size_t i3 = label_to_spacemo_[block[3]][i[3]];
-            double denom = Fdiag_[i0] + Fdiag_[i1] - Fdiag_[i2] - Fdiag_[i3];
-            value *= dsrg_source_->compute_renormalized(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized(D, T2_.block(block).data());
     }
     if (ccvv_source_ == "ZERO") {
         T2_.block("ccvv").zero();
@@ -351,12 +330,8 @@ void SA_MRDSRG::update_t1() {
     }
 
     for (const std::string& block : T1blocks) {
-        DT1_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            double denom = Fdiag_[i0] - Fdiag_[i1];
-            value *= dsrg_source_->compute_renormalized_denominator(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, DT1_.block(block).data());
     }
 
     // Step 2: work on T1 where Hbar1 is treated as intermediate
@@ -374,12 +349,8 @@ void SA_MRDSRG::update_t1() {
 
     // scale T1 by delta exponential
     for (const std::string& block : T1blocks) {
-        T1_.block(block).iterate([&](const std::vector<size_t>& i, double& value) {
-            size_t i0 = label_to_spacemo_[block[0]][i[0]];
-            size_t i1 = label_to_spacemo_[block[1]][i[1]];
-            double denom = Fdiag_[i0] - Fdiag_[i1];
-            value *= dsrg_source_->compute_renormalized(denom);
-        });
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized(D, T1_.block(block).data());
     }
     if (ccvv_source_ == "ZERO") {
         T1_.block("cv").zero();
@@ -26,79 +26,28 @@
  * @END LICENSE
  */
 
-#include "psi4/libdiis/diismanager.h"
-
 #include "sa_mrdsrg.h"
 
 using namespace psi;
 
 namespace forte {
 
-void SA_MRDSRG::diis_manager_init() {
-    diis_manager_ = std::make_shared<DIISManager>(diis_max_vec_, "SA_MRDSRG DIIS",
-                                                  DIISManager::LargestError, DIISManager::OnDisk);
-
-    amp_ptrs_.clear();
-    res_ptrs_.clear();
-
-    std::vector<std::string> blocks{"ca",   "cv",   "av",   "ccaa", "ccav", "ccva",
-                                    "ccvv", "caaa", "caav", "cava", "cavv", "acaa",
-                                    "acav", "acva", "acvv", "aaav", "aava", "aavv"};
-
-    std::vector<size_t> sizes(18);
-    for (int i = 0; i < 18; ++i) {
-        auto block = blocks[i];
-        if (block.size() == 2) {
-            sizes[i] = T1_.block(block).numel();
-            amp_ptrs_.push_back(T1_.block(block).data().data());
-            res_ptrs_.push_back(DT1_.block(block).data().data());
-        } else {
-            sizes[i] = T2_.block(block).numel();
-            amp_ptrs_.push_back(T2_.block(block).data().data());
-            res_ptrs_.push_back(DT2_.block(block).data().data());
-        }
-    }
+std::vector<std::string> SA_MRDSRG::diis_blocks1() const { return {"ca", "cv", "av"}; }
 
-    diis_manager_->set_error_vector_size(
-        18, DIISEntry::Pointer, sizes[0], DIISEntry::Pointer, sizes[1], DIISEntry::Pointer,
-        sizes[2], DIISEntry::Pointer, sizes[3], DIISEntry::Pointer, sizes[4], DIISEntry::Pointer,
-        sizes[5], DIISEntry::Pointer, sizes[6], DIISEntry::Pointer, sizes[7], DIISEntry::Pointer,
-        sizes[8], DIISEntry::Pointer, sizes[9], DIISEntry::Pointer, sizes[10], DIISEntry::Pointer,
-        sizes[11], DIISEntry::Pointer, sizes[12], DIISEntry::Pointer, sizes[13], DIISEntry::Pointer,
-        sizes[14], DIISEntry::Pointer, sizes[15], DIISEntry::Pointer, sizes[16], DIISEntry::Pointer,
-        sizes[17]);
-
-    diis_manager_->set_vector_size(
-        18, DIISEntry::Pointer, sizes[0], DIISEntry::Pointer, sizes[1], DIISEntry::Pointer,
-        sizes[2], DIISEntry::Pointer, sizes[3], DIISEntry::Pointer, sizes[4], DIISEntry::Pointer,
-        sizes[5], DIISEntry::Pointer, sizes[6], DIISEntry::Pointer, sizes[7], DIISEntry::Pointer,
-        sizes[8], DIISEntry::Pointer, sizes[9], DIISEntry::Pointer, sizes[10], DIISEntry::Pointer,
-        sizes[11], DIISEntry::Pointer, sizes[12], DIISEntry::Pointer, sizes[13], DIISEntry::Pointer,
-        sizes[14], DIISEntry::Pointer, sizes[15], DIISEntry::Pointer, sizes[16], DIISEntry::Pointer,
-        sizes[17]);
+std::vector<std::string> SA_MRDSRG::diis_blocks2() const {
+    return {"ccaa", "ccav", "ccva", "ccvv", "caaa", "caav", "cava", "cavv",
+            "acaa", "acav", "acva", "acvv", "aaav", "aava", "aavv"};
 }
 
-void SA_MRDSRG::diis_manager_add_entry() {
-    diis_manager_->add_entry(
-        36, res_ptrs_[0], res_ptrs_[1], res_ptrs_[2], res_ptrs_[3], res_ptrs_[4], res_ptrs_[5],
-        res_ptrs_[6], res_ptrs_[7], res_ptrs_[8], res_ptrs_[9], res_ptrs_[10], res_ptrs_[11],
-        res_ptrs_[12], res_ptrs_[13], res_ptrs_[14], res_ptrs_[15], res_ptrs_[16], res_ptrs_[17],
-        amp_ptrs_[0], amp_ptrs_[1], amp_ptrs_[2], amp_ptrs_[3], amp_ptrs_[4], amp_ptrs_[5],
-        amp_ptrs_[6], amp_ptrs_[7], amp_ptrs_[8], amp_ptrs_[9], amp_ptrs_[10], amp_ptrs_[11],
-        amp_ptrs_[12], amp_ptrs_[13], amp_ptrs_[14], amp_ptrs_[15], amp_ptrs_[16], amp_ptrs_[17]);
+void SA_MRDSRG::diis_manager_init() {
+    diis_manager_ = std::make_shared<DSRG_DIIS>(diis_max_vec_, diis_float_);
+    diis_manager_->add_blocks(T1_, DT1_, diis_blocks1());
+    diis_manager_->add_blocks(T2_, DT2_, diis_blocks2());
 }
 
-void SA_MRDSRG::diis_manager_extrapolate() {
-    diis_manager_->extrapolate(
-        18, amp_ptrs_[0], amp_ptrs_[1], amp_ptrs_[2], amp_ptrs_[3], amp_ptrs_[4], amp_ptrs_[5],
-        amp_ptrs_[6], amp_ptrs_[7], amp_ptrs_[8], amp_ptrs_[9], amp_ptrs_[10], amp_ptrs_[11],
-        amp_ptrs_[12], amp_ptrs_[13], amp_ptrs_[14], amp_ptrs_[15], amp_ptrs_[16], amp_ptrs_[17]);
-}
+void SA_MRDSRG::diis_manager_add_entry() { diis_manager_->add_entry(); }
 
-void SA_MRDSRG::diis_manager_cleanup() {
-    amp_ptrs_.clear();
-    res_ptrs_.clear();
-    diis_manager_->reset_subspace();
-    diis_manager_->delete_diis_file();
-}
+void SA_MRDSRG::diis_manager_extrapolate() { diis_manager_->extrapolate(); }
+
+void SA_MRDSRG::diis_manager_cleanup() { diis_manager_.reset(); }
 } // namespace forte
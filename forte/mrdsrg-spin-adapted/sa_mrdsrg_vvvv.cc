@@ -0,0 +1,206 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <cstring>
+#include <map>
+
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include "helpers/timer.h"
+#include "sa_mrdsrg.h"
+
+using namespace psi;
+
+namespace forte {
+
+namespace {
+/// Return a copy of the core tensor T with the index dim restricted to [begin, end)
+ambit::Tensor slice_index(ambit::Tensor T, size_t dim, size_t begin, size_t end) {
+    const auto& dims = T.dims();
+    size_t outer = 1, inner = 1;
+    for (size_t n = 0; n < dim; ++n) {
+        outer *= dims[n];
+    }
+    for (size_t n = dim + 1; n < dims.size(); ++n) {
+        inner *= dims[n];
+    }
+
+    std::vector<size_t> sdims(dims);
+    sdims[dim] = end - begin;
+    auto S = ambit::Tensor::build(ambit::CoreTensor, T.name() + " slice", sdims);
+
+    const auto& Tdata = T.data();
+    auto& Sdata = S.data();
+    size_t nslice = sdims[dim] * inner;
+    for (size_t o = 0; o < outer; ++o) {
+        std::memcpy(&Sdata[o * nslice], &Tdata[(o * dims[dim] + begin) * inner],
+                    nslice * sizeof(double));
+    }
+    return S;
+}
+} // namespace
+
+void SA_MRDSRG::init_O2_vvvv() {
+    const std::string& v = virt_label_;
+    size_t nv = virt_mos_.size();
+
+    for (size_t t = 0, ntiles = O2vvvv_->ntiles(); t < ntiles; ++t) {
+        size_t p0 = O2vvvv_->tile_begin(t), p1 = O2vvvv_->tile_end(t);
+
+        ambit::Tensor Ot;
+        if (eri_df_) {
+            auto Bvv = B_.block("L" + v + v);
+            auto Bt = slice_index(Bvv, 1, p0, p1);
+            Ot = ambit::Tensor::build(ambit::CoreTensor, "O2vvvv tile", {p1 - p0, nv, nv, nv});
+            Ot("pqrs") = Bt("gpr") * Bvv("gqs");
+        } else {
+            std::vector<size_t> tile_mos(virt_mos_.begin() + p0, virt_mos_.begin() + p1);
+            Ot = ints_->aptei_ab_block(tile_mos, virt_mos_, virt_mos_, virt_mos_);
+        }
+        O2vvvv_->write_tile(t, Ot);
+    }
+}
+
+void SA_MRDSRG::H2vvvv_T_C2(const double& alpha, BlockedTensor& C2) {
+    const std::string& v = virt_label_;
+    std::vector<std::string> holes{core_label_, actv_label_};
+
+    // X["irpq"] = alpha * T1["ia"] * H2["arpq"], accumulated over tiles of a
+    std::map<std::string, ambit::Tensor> X;
+    for (const std::string& h : holes) {
+        X[h] = ambit::Tensor::build(ambit::CoreTensor, "X" + h,
+                                    C2.block(h + v + v + v).dims());
+    }
+
+    double t212 = 0.0, t222 = 0.0;
+    for (size_t t = 0, ntiles = O2vvvv_->ntiles(); t < ntiles; ++t) {
+        size_t a0 = O2vvvv_->tile_begin(t), a1 = O2vvvv_->tile_end(t);
+        auto Ot = O2vvvv_->read_tile(t);
+
+        // C2["ijrs"] += alpha * H2["abrs"] * T2["ijab"]
+        local_timer timer222;
+        for (const std::string& h0 : holes) {
+            for (const std::string& h1 : holes) {
+                std::string block = h0 + h1 + v + v;
+                auto T2t = slice_index(T2_.block(block), 2, a0, a1);
+                C2.block(block)("ijrs") += alpha * T2t("ijab") * Ot("abrs");
+            }
+        }
+        t222 += timer222.get();
+
+        local_timer timer212;
+        for (const std::string& h : holes) {
+            auto T1t = slice_index(T1_.block(h + v), 1, a0, a1);
+            X[h]("irpq") += alpha * T1t("ia") * Ot("arpq");
+        }
+        t212 += timer212.get();
+    }
+
+    // C2["irpq"] += X["irpq"] and C2["riqp"] += X["irpq"]
+    local_timer timer212;
+    for (const std::string& h : holes) {
+        C2.block(h + v + v + v)("irpq") += X[h]("irpq");
+        C2.block(v + h + v + v)("riqp") += X[h]("irpq");
+    }
+    t212 += timer212.get();
+
+    dsrg_time_.add("212", t212);
+    dsrg_time_.add("222", t222);
+}
+
+double SA_MRDSRG::compute_C2_vvvv(const double& alpha) {
+    local_timer timer;
+
+    const std::string& v = virt_label_;
+    const std::string& a = actv_label_;
+    std::vector<std::string> holes{core_label_, actv_label_};
+    size_t nv = virt_mos_.size();
+
+    // Y["xjab"] = Eta1["xy"] * T2["yjab"]
+    std::map<std::string, ambit::Tensor> Y;
+    for (const std::string& h : holes) {
+        auto T2b = T2_.block(a + h + v + v);
+        Y[h] = ambit::Tensor::build(ambit::CoreTensor, "Y" + h, T2b.dims());
+        Y[h]("xjab") = Eta1_.block(a + a)("xy") * T2b("yjab");
+    }
+
+    // Each tile holds C2[p,q,r,s] + C2[r,s,p,q] for p in the tile, where C2 is
+    //   C2["pqab"] += alpha * H2["pqij"] * T2["ijab"]
+    //   C2["pqab"] -= 0.5 * alpha * H2["pqxj"] * Y["xjab"] + (pq,ab) -> (qp,ba)
+    //   C2["pqab"] -= alpha * H2["pqib"] * T1["ia"] + (pq,ab) -> (qp,ba)
+    double norm2 = 0.0;
+    for (size_t t = 0, ntiles = C2vvvv_->ntiles(); t < ntiles; ++t) {
+        size_t p0 = C2vvvv_->tile_begin(t), p1 = C2vvvv_->tile_end(t);
+        auto Ct = ambit::Tensor::build(ambit::CoreTensor, "C2vvvv tile", {p1 - p0, nv, nv, nv});
+
+        for (const std::string& h0 : holes) {
+            for (const std::string& h1 : holes) {
+                auto O2b = O2_.block(v + v + h0 + h1);
+                auto T2b = T2_.block(h0 + h1 + v + v);
+                auto O2t = slice_index(O2b, 0, p0, p1);
+                auto T2t = slice_index(T2b, 2, p0, p1);
+                Ct("pqab") += alpha * O2t("pqij") * T2b("ijab");
+                Ct("pqrs") += alpha * T2t("ijpq") * O2b("rsij");
+            }
+        }
+
+        for (const std::string& h : holes) {
+            auto O2b = O2_.block(v + v + a + h);
+            auto O2t = slice_index(O2b, 0, p0, p1);
+            auto O2s = slice_index(O2b, 1, p0, p1);
+            auto Yt = slice_index(Y[h], 2, p0, p1);
+            auto Ys = slice_index(Y[h], 3, p0, p1);
+            Ct("pqab") -= 0.5 * alpha * O2t("pqxj") * Y[h]("xjab");
+            Ct("pqab") -= 0.5 * alpha * O2s("qpxj") * Y[h]("xjba");
+            Ct("pqrs") -= 0.5 * alpha * Yt("xjpq") * O2b("rsxj");
+            Ct("pqrs") -= 0.5 * alpha * Ys("xjqp") * O2b("srxj");
+        }
+
+        for (const std::string& h : holes) {
+            auto O2b = O2_.block(v + v + h + v);
+            auto T1b = T1_.block(h + v);
+            auto O2t = slice_index(O2b, 0, p0, p1);
+            auto O2s = slice_index(O2b, 1, p0, p1);
+            auto O2u = slice_index(O2b, 3, p0, p1);
+            auto T1t = slice_index(T1b, 1, p0, p1);
+            Ct("pqab") -= alpha * O2t("pqib") * T1b("ia");
+            Ct("pqab") -= alpha * O2s("qpia") * T1b("ib");
+            Ct("pqrs") -= alpha * T1t("ip") * O2b("rsiq");
+            Ct("pqrs") -= alpha * O2u("srip") * T1b("iq");
+        }
+
+        double norm = Ct.norm(2);
+        norm2 += norm * norm;
+        C2vvvv_->write_tile(t, Ct);
+    }
+
+    dsrg_time_.add("222", timer.get());
+    return norm2;
+}
+
+} // namespace forte
@@ -27,7 +27,11 @@
  * @END LICENSE
  */
 
+#include <functional>
+#include <future>
+
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libqt/qt.h"
 
 #include "forte-def.h"
 #include "helpers/disk_io.h"
@@ -39,6 +43,39 @@ using namespace psi;
 
 namespace forte {
 
+namespace {
+/**
+ * @brief Serve load(0), load(1), ... in order.
+ *
+ * With prefetch, load(k + 1) runs in a background thread while the caller works on the
+ * result of load(k), so that reading three-index integrals overlaps with computation.
+ */
+template <typename T> class BatchReader {
+  public:
+    BatchReader(size_t n, std::function<T(size_t)> load, bool prefetch)
+        : n_(n), load_(load), prefetch_(prefetch) {
+        if (prefetch_ and n_ > 0)
+            next_ = std::async(std::launch::async, load_, 0);
+    }
+
+    /// Return the next result
+    T next() {
+        T out = prefetch_ ? next_.get() : load_(k_);
+        ++k_;
+        if (prefetch_ and k_ < n_)
+            next_ = std::async(std::launch::async, load_, k_);
+        return out;
+    }
+
+  private:
+    size_t n_;
+    size_t k_ = 0;
+    std::function<T(size_t)> load_;
+    bool prefetch_;
+    std::future<T> next_;
+};
+} // namespace
+
 SA_MRPT2::SA_MRPT2(RDMs rdms, std::shared_ptr<SCFInfo> scf_info,
                    std::shared_ptr<ForteOptions> options, std::shared_ptr<ForteIntegrals> ints,
                    std::shared_ptr<MOSpaceInfo> mo_space_info)
@@ -227,21 +264,26 @@ void SA_MRPT2::check_memory() {
         auto size_Lv = dsrg_mem_.compute_memory({"Lv"});
         auto size_acc = dsrg_mem_.compute_memory({"acc"});
 
-        auto mem_ccvv = 2 * (size_Lv + dsrg_mem_.compute_memory({"vv"}));
-        auto mem_cavv = size_Lv + dsrg_mem_.compute_memory({"vva", "vva", "aa", "Lva"});
+        // per-thread buffers of the CCVV and CAVV kernels
+        auto mem_ccvv = dsrg_mem_.compute_memory({"vv", "v"});
+        auto mem_cavv = dsrg_mem_.compute_memory({"vva", "vva", "aa"});
         auto mem_ccav = 2 * size_acc + dsrg_mem_.compute_memory({"Lc", "aa", "Lac"});
 
+        // shared B(L|em) buffers hold at least one core orbital each
+        size_t nbuffers = (ints_->integral_type() == DiskDF ? 3 : 2) + (semi_canonical_ ? 0 : 1);
+        auto mem_Lva = dsrg_mem_.compute_memory({"Lva"}, semi_canonical_ ? 1 : 2);
+
         if (!semi_canonical_) {
-            mem_ccvv += 2 * size_Lv;
-            mem_cavv += size_Lv + dsrg_mem_.compute_memory({"Lva"});
             mem_ccav += dsrg_mem_.compute_memory({"Lc", "Lac"});
         }
 
         mem_batched_["ccvv"] = mem_ccvv;
-        dsrg_mem_.add_entry("Local integrals for CCVV energy", mem_ccvv, false);
+        dsrg_mem_.add_entry("Local integrals for CCVV energy", mem_ccvv + nbuffers * size_Lv,
+                            false);
 
         mem_batched_["cavv"] = mem_cavv;
-        dsrg_mem_.add_entry("Local integrals for CAVV energy", mem_cavv, false);
+        dsrg_mem_.add_entry("Local integrals for CAVV energy",
+                            mem_cavv + (nbuffers - 1) * size_Lv + mem_Lva, false);
 
         mem_batched_["ccav"] = mem_ccav;
         dsrg_mem_.add_entry("Local integrals for CCAV energy", mem_ccav, false);
@@ -358,10 +400,10 @@ void SA_MRPT2::compute_t2_df_minimal() {
     }
 
     // build T2
-    T2_.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>&, double& value) {
-        double denom = Fdiag_[i[0]] + Fdiag_[i[1]] - Fdiag_[i[2]] - Fdiag_[i[3]];
-        value *= dsrg_source_->compute_renormalized_denominator(denom);
-    });
+    for (const std::string& block : T2_.block_labels()) {
+        auto D = block_denominators(block);
+        dsrg_source_->scale_renormalized_denominator(D, T2_.block(block).data());
+    }
 
     // transform back to non-canonical basis
     if (!semi_canonical_) {
@@ -418,90 +460,7 @@ double SA_MRPT2::compute_Hbar0_CCVV_DF() {
     timer t_ccvv("Compute CCVV energy term DF");
     print_contents("Computing DF <0|[Vr, T2]|0> CCVV");
 
-    auto nQ = aux_mos_.size();
-    auto nv = virt_mos_.size();
-    auto nc = core_mos_.size();
-
-    // check memory
-    size_t max_n_threads = dsrg_mem_.available() / mem_batched_["ccvv"];
-    int n_threads = static_cast<size_t>(n_threads_) < max_n_threads ? n_threads_ : max_n_threads;
-    if (n_threads != n_threads_) {
-        outfile->Printf("\n  Use %d threads to compute CCVV energy due to memory shortage.",
-                        n_threads);
-    }
-
-    // some tensors used for threading
-    std::vector<ambit::Tensor> Bm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Bn_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> J_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> JK_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Xm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Xn_vec = init_tensor_vecs(n_threads);
-
-    for (int i = 0; i < n_threads; i++) {
-        std::string t = std::to_string(i);
-        Bm_vec.push_back(ambit::Tensor::build(tensor_type_, "Bm_thread" + t, {nQ, nv}));
-        Bn_vec.push_back(ambit::Tensor::build(tensor_type_, "Bn_thread" + t, {nQ, nv}));
-        J_vec.push_back(ambit::Tensor::build(tensor_type_, "J_thread" + t, {nv, nv}));
-        JK_vec.push_back(ambit::Tensor::build(tensor_type_, "(2J - K) thread" + t, {nv, nv}));
-    }
-    if (!semi_canonical_) {
-        for (int i = 0; i < n_threads; i++) {
-            std::string t = std::to_string(i);
-            Xm_vec.push_back(ambit::Tensor::build(tensor_type_, "Xm_thread" + t, {nQ, nv}));
-            Xn_vec.push_back(ambit::Tensor::build(tensor_type_, "Xn_thread" + t, {nQ, nv}));
-        }
-    }
-
-    double E = 0.0;
-    bool complete_ccvv = (ccvv_source_ == "ZERO");
-
-#pragma omp parallel for num_threads(n_threads) reduction(+ : E)
-    for (size_t m = 0; m < nc; ++m) {
-        auto im = core_mos_[m];
-        double Fm = Fdiag_[im];
-
-        int thread = omp_get_thread_num();
-#pragma omp critical
-        {
-            Bm_vec[thread].data() = ints_->three_integral_block(aux_mos_, virt_mos_, {im}).data();
-            if (!semi_canonical_) {
-                Xm_vec[thread]("gf") = Bm_vec[thread]("ge") * U_.block("vv")("fe");
-                Bm_vec[thread]("gf") = Xm_vec[thread]("gf");
-            }
-        }
-
-        for (size_t n = m; n < nc; ++n) {
-            auto in = core_mos_[n];
-            double Fn = Fdiag_[in];
-            double factor = (m < n) ? 2.0 : 1.0;
-
-#pragma omp critical
-            {
-                Bn_vec[thread].data() =
-                    ints_->three_integral_block(aux_mos_, virt_mos_, {in}).data();
-                if (!semi_canonical_) {
-                    Xn_vec[thread]("gf") = Bn_vec[thread]("ge") * U_.block("vv")("fe");
-                    Bn_vec[thread]("gf") = Xn_vec[thread]("gf");
-                }
-            }
-
-            J_vec[thread]("ef") = Bm_vec[thread]("ge") * Bn_vec[thread]("gf");
-            JK_vec[thread]("ef") = 2.0 * J_vec[thread]("ef") - J_vec[thread]("fe");
-
-            J_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                double D = Fm + Fn - Fdiag_[virt_mos_[i[0]]] - Fdiag_[virt_mos_[i[1]]];
-                if (complete_ccvv)
-                    value /= D;
-                else {
-                    double rV = 1.0 + dsrg_source_->compute_renormalized(D);
-                    value *= dsrg_source_->compute_renormalized_denominator(D) * rV;
-                }
-            });
-
-            E += factor * J_vec[thread]("ef") * JK_vec[thread]("ef");
-        }
-    }
+    double E = compute_Hbar0_CCVV_batched(false);
 
     print_done(t_ccvv.stop());
     return E;
@@ -516,10 +475,22 @@ double SA_MRPT2::compute_Hbar0_CCVV_diskDF() {
      *
      * To minimize the number of calls of ints_->three_integral_block,
      * we store as many B(L|em) and B(L|fn) as possible in memory.
-     * Modified from function compute_Hbar0_CCVV_DF.
+     * The next batch of B(L|fn) is read from disk while the current one is used.
      */
+    timer t_ccvv("Compute CCVV energy term DiskDF");
+    print_contents("Computing DiskDF <0|[Vr, T2]|0> CCVV");
+
+    double E = compute_Hbar0_CCVV_batched(true);
+
+    print_done(t_ccvv.stop());
+    return E;
+}
+
+double SA_MRPT2::compute_Hbar0_CCVV_batched(bool prefetch) {
     auto nQ = aux_mos_.size();
     auto nv = virt_mos_.size();
+    if (core_mos_.empty() or nv == 0)
+        return 0.0;
 
     // check memory
     size_t max_n_threads = dsrg_mem_.available() / mem_batched_["ccvv"];
@@ -529,162 +500,142 @@ double SA_MRPT2::compute_Hbar0_CCVV_diskDF() {
                         n_threads);
     }
 
-    size_t max_num_Qv = (dsrg_mem_.available() - n_threads * mem_batched_["ccvv"]) * 0.8 /
-                        (sizeof(double) * nQ * nv * 2);
-    if (max_num_Qv < 2) { // no point to do this batching anymore
-        return compute_Hbar0_CCVV_DF();
-    }
-
-    timer t_ccvv("Compute CCVV energy term DiskDF");
-    print_contents("Computing DiskDF <0|[Vr, T2]|0> CCVV");
-
-    // separate core indices into batches
-    auto core_batches = split_indices_to_batches(core_mos_, max_num_Qv);
+    // B(L|em) of two core batches are kept, plus the one read in the background
+    size_t nbuffers = (prefetch ? 3 : 2) + (semi_canonical_ ? 0 : 1);
+    auto core_batches = split_core_batches(n_threads * mem_batched_["ccvv"], nbuffers);
     size_t nbatch = core_batches.size();
 
-    // some tensors used for threading
-    std::vector<ambit::Tensor> Bm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Bn_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> J_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> JK_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Xm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> Xn_vec = init_tensor_vecs(n_threads);
-
-    for (int i = 0; i < n_threads; i++) {
-        std::string t = std::to_string(i);
-        Bm_vec.push_back(ambit::Tensor::build(tensor_type_, "Bm_thread" + t, {nQ, nv}));
-        Bn_vec.push_back(ambit::Tensor::build(tensor_type_, "Bn_thread" + t, {nQ, nv}));
-        J_vec.push_back(ambit::Tensor::build(tensor_type_, "J_thread" + t, {nv, nv}));
-        JK_vec.push_back(ambit::Tensor::build(tensor_type_, "(2J - K) thread" + t, {nv, nv}));
-    }
-    if (!semi_canonical_) {
-        for (int i = 0; i < n_threads; i++) {
-            std::string t = std::to_string(i);
-            Xm_vec.push_back(ambit::Tensor::build(tensor_type_, "Xm_thread" + t, {nQ, nv}));
-            Xn_vec.push_back(ambit::Tensor::build(tensor_type_, "Xn_thread" + t, {nQ, nv}));
+    // order of the batches: for each M, the batches M, M + 1, ..., nbatch - 1
+    std::vector<size_t> schedule;
+    for (size_t M = 0; M < nbatch; ++M) {
+        for (size_t N = M; N < nbatch; ++N) {
+            schedule.push_back(N);
         }
     }
+    BatchReader<std::vector<double>> reader(
+        schedule.size(), [&](size_t k) { return read_Bvc_slabs(core_batches[schedule[k]]); },
+        prefetch);
 
-    double E = 0.0;
+    std::vector<double> Fv(nv);
+    for (size_t e = 0; e < nv; ++e) {
+        Fv[e] = Fdiag_[virt_mos_[e]];
+    }
     bool complete_ccvv = (ccvv_source_ == "ZERO");
+    size_t slab = nQ * nv;
 
-    for (size_t Mbatch = 0; Mbatch < nbatch; ++Mbatch) {
-        auto Mbatch_size = core_batches[Mbatch].size();
-        auto BM = ints_->three_integral_block(aux_mos_, virt_mos_, core_batches[Mbatch]);
-        auto& BM_data = BM.data();
-
-        // indices m and n belong to the same batch
-#pragma omp parallel for num_threads(n_threads) reduction(+ : E)
-        for (size_t m = 0; m < Mbatch_size; ++m) {
-            auto im = core_batches[Mbatch][m];
-            double Fm = Fdiag_[im];
-
-            int thread = omp_get_thread_num();
-#pragma omp critical
-            {
-                Bm_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                    value = BM_data[i[0] * Mbatch_size * nv + i[1] * Mbatch_size + m];
-                });
-                if (!semi_canonical_) {
-                    Xm_vec[thread]("gf") = Bm_vec[thread]("ge") * U_.block("vv")("fe");
-                    Bm_vec[thread]("gf") = Xm_vec[thread]("gf");
-                }
-            }
-
-            for (size_t n = m; n < Mbatch_size; ++n) {
-                auto in = core_batches[Mbatch][n];
-                double Fn = Fdiag_[in];
-                double factor = (m < n) ? 2.0 : 1.0;
-
-#pragma omp critical
-                {
-                    Bn_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                        value = BM_data[i[0] * Mbatch_size * nv + i[1] * Mbatch_size + n];
-                    });
-                    if (!semi_canonical_) {
-                        Xn_vec[thread]("gf") = Bn_vec[thread]("ge") * U_.block("vv")("fe");
-                        Bn_vec[thread]("gf") = Xn_vec[thread]("gf");
-                    }
+    double E = 0.0;
+    std::vector<double> BM;
+
+    for (size_t M = 0; M < nbatch; ++M) {
+        for (size_t N = M; N < nbatch; ++N) {
+            auto BN = reader.next();
+            if (N == M)
+                BM = std::move(BN);
+            double* BM_data = BM.data();
+            double* BN_data = (N == M) ? BM.data() : BN.data();
+
+            const auto& Mcores = core_batches[M];
+            const auto& Ncores = core_batches[N];
+
+            // core pairs of this batch pair, m <= n if both belong to the same batch
+            std::vector<std::pair<size_t, size_t>> pairs;
+            for (size_t m = 0; m < Mcores.size(); ++m) {
+                for (size_t n = (N == M) ? m : 0; n < Ncores.size(); ++n) {
+                    pairs.emplace_back(m, n);
                 }
-
-                J_vec[thread]("ef") = Bm_vec[thread]("ge") * Bn_vec[thread]("gf");
-                JK_vec[thread]("ef") = 2.0 * J_vec[thread]("ef") - J_vec[thread]("fe");
-
-                J_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                    double D = Fm + Fn - Fdiag_[virt_mos_[i[0]]] - Fdiag_[virt_mos_[i[1]]];
-                    if (complete_ccvv)
-                        value /= D;
-                    else {
-                        double rV = 1.0 + dsrg_source_->compute_renormalized(D);
-                        value *= dsrg_source_->compute_renormalized_denominator(D) * rV;
-                    }
-                });
-
-                E += factor * J_vec[thread]("ef") * JK_vec[thread]("ef");
             }
-        }
-
-        // indices m and n belong to different batches
-        for (size_t Nbatch = Mbatch + 1; Nbatch < nbatch; ++Nbatch) {
-            auto Nbatch_size = core_batches[Nbatch].size();
-            auto BN = ints_->three_integral_block(aux_mos_, virt_mos_, core_batches[Nbatch]);
-            auto& BN_data = BN.data();
-
-#pragma omp parallel for num_threads(n_threads) reduction(+ : E)
-            for (size_t m = 0; m < Mbatch_size; ++m) {
-                auto im = core_batches[Mbatch][m];
-                double Fm = Fdiag_[im];
+            size_t npairs = pairs.size();
 
-                int thread = omp_get_thread_num();
-#pragma omp critical
-                {
-                    Bm_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                        value = BM_data[i[0] * Mbatch_size * nv + i[1] * Mbatch_size + m];
-                    });
-                    if (!semi_canonical_) {
-                        Xm_vec[thread]("gf") = Bm_vec[thread]("ge") * U_.block("vv")("fe");
-                        Bm_vec[thread]("gf") = Xm_vec[thread]("gf");
+#pragma omp parallel num_threads(n_threads) reduction(+ : E)
+            {
+                std::vector<double> J(nv * nv), D(nv * nv), R(nv * nv), X(nv * nv);
+
+#pragma omp for schedule(dynamic)
+                for (size_t p = 0; p < npairs; ++p) {
+                    size_t m = pairs[p].first, n = pairs[p].second;
+                    double Fmn = Fdiag_[Mcores[m]] + Fdiag_[Ncores[n]];
+                    double factor = (N != M or m < n) ? 2.0 : 1.0;
+
+                    // J(ef) = (em|fn)
+                    C_DGEMM('T', 'N', nv, nv, nQ, 1.0, BM_data + m * slab, nv, BN_data + n * slab,
+                            nv, 0.0, J.data(), nv);
+
+                    // R(ef) = [1 - exp(-2 * s * D^2)] / D
+                    for (size_t e = 0; e < nv; ++e) {
+                        for (size_t f = 0; f < nv; ++f) {
+                            D[e * nv + f] = Fmn - Fv[e] - Fv[f];
+                        }
                     }
-                }
-
-                for (size_t n = 0; n < Nbatch_size; ++n) {
-                    auto in = core_batches[Nbatch][n];
-                    double Fn = Fdiag_[in];
-
-#pragma omp critical
-                    {
-                        Bn_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                            value = BN_data[i[0] * Nbatch_size * nv + i[1] * Nbatch_size + n];
-                        });
-                        if (!semi_canonical_) {
-                            Xn_vec[thread]("gf") = Bn_vec[thread]("ge") * U_.block("vv")("fe");
-                            Bn_vec[thread]("gf") = Xn_vec[thread]("gf");
+                    if (complete_ccvv) {
+                        for (size_t ef = 0; ef < nv * nv; ++ef) {
+                            R[ef] = 1.0 / D[ef];
+                        }
+                    } else {
+                        dsrg_source_->compute_renormalized_denominator(D.data(), R.data(), nv * nv);
+                        dsrg_source_->compute_renormalized(D.data(), X.data(), nv * nv);
+                        for (size_t ef = 0; ef < nv * nv; ++ef) {
+                            R[ef] *= 1.0 + X[ef];
                         }
                     }
 
-                    J_vec[thread]("ef") = Bm_vec[thread]("ge") * Bn_vec[thread]("gf");
-                    JK_vec[thread]("ef") = 2.0 * J_vec[thread]("ef") - J_vec[thread]("fe");
-
-                    J_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                        double D = Fm + Fn - Fdiag_[virt_mos_[i[0]]] - Fdiag_[virt_mos_[i[1]]];
-                        if (complete_ccvv)
-                            value /= D;
-                        else {
-                            double rV = 1.0 + dsrg_source_->compute_renormalized(D);
-                            value *= dsrg_source_->compute_renormalized_denominator(D) * rV;
+                    double Emn = 0.0;
+                    for (size_t e = 0; e < nv; ++e) {
+                        const double* Je = J.data() + e * nv;
+                        const double* Re = R.data() + e * nv;
+                        for (size_t f = 0; f < nv; ++f) {
+                            Emn += Je[f] * Re[f] * (2.0 * Je[f] - J[f * nv + e]);
                         }
-                    });
-
-                    E += 2.0 * J_vec[thread]("ef") * JK_vec[thread]("ef");
+                    }
+                    E += factor * Emn;
                 }
             }
         }
     }
 
-    print_done(t_ccvv.stop());
     return E;
 }
 
+std::vector<double> SA_MRPT2::read_Bvc_slabs(const std::vector<size_t>& cores) {
+    auto nQ = aux_mos_.size();
+    auto nv = virt_mos_.size();
+    auto nm = cores.size();
+
+    // B(L|em) is stored as (L, e, m)
+    auto B = ints_->three_integral_block(aux_mos_, virt_mos_, cores);
+    const auto& B_data = B.data();
+
+    std::vector<double> slabs(nm * nQ * nv);
+    for (size_t m = 0; m < nm; ++m) {
+        for (size_t L = 0; L < nQ; ++L) {
+            double* slab_mL = slabs.data() + (m * nQ + L) * nv;
+            for (size_t e = 0; e < nv; ++e) {
+                slab_mL[e] = B_data[(L * nv + e) * nm + m];
+            }
+        }
+    }
+
+    // rotate to semicanonical virtual orbitals: B(L|fm) = B(L|em) * U(fe)
+    if (!semi_canonical_ and nm * nQ * nv != 0) {
+        std::vector<double> X(slabs.size());
+        C_DGEMM('N', 'T', nm * nQ, nv, nv, 1.0, slabs.data(), nv, U_.block("vv").data().data(),
+                nv, 0.0, X.data(), nv);
+        slabs.swap(X);
+    }
+
+    return slabs;
+}
+
+std::vector<std::vector<size_t>> SA_MRPT2::split_core_batches(size_t mem_fixed,
+                                                              size_t nbuffers) {
+    size_t mem_Lv = sizeof(double) * aux_mos_.size() * virt_mos_.size() * nbuffers;
+    size_t mem_avai = dsrg_mem_.available();
+    size_t max_size = 1;
+    if (mem_avai > mem_fixed and mem_Lv != 0) {
+        max_size = std::max(static_cast<size_t>(0.8 * (mem_avai - mem_fixed)) / mem_Lv, max_size);
+    }
+    return split_indices_to_batches(core_mos_, max_size);
+}
+
 double SA_MRPT2::E_V_T2_CAVV() {
     timer t("Compute [V, T2] CAVV energy term");
 
@@ -722,98 +673,7 @@ void SA_MRPT2::compute_Hbar1V_DF(ambit::Tensor& Hbar1, bool Vr) {
     timer t("Compute C1 virtual contraction DF");
     print_contents("Computing DF Hbar1 CAVV");
 
-    auto nQ = aux_mos_.size();
-    auto nv = virt_mos_.size();
-    auto nc = core_mos_.size();
-    auto na = actv_mos_.size();
-
-    // check memory
-    size_t max_n_threads = dsrg_mem_.available() / mem_batched_["cavv"];
-    int n_threads = static_cast<size_t>(n_threads_) < max_n_threads ? n_threads_ : max_n_threads;
-    if (n_threads != n_threads_) {
-        outfile->Printf("\n  Use %d threads to compute CAVV energy due to memory shortage.",
-                        n_threads);
-    }
-
-    // some tensors used for threading
-    std::vector<ambit::Tensor> Bm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> V_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> S_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> C_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> X_vec = init_tensor_vecs(n_threads);
-
-    for (int i = 0; i < n_threads; i++) {
-        std::string t = std::to_string(i);
-        Bm_vec.push_back(ambit::Tensor::build(tensor_type_, "Bm_thread" + t, {nQ, nv}));
-        V_vec.push_back(ambit::Tensor::build(tensor_type_, "V_thread" + t, {nv, nv, na}));
-        S_vec.push_back(ambit::Tensor::build(tensor_type_, "S_thread" + t, {nv, nv, na}));
-        C_vec.push_back(ambit::Tensor::build(tensor_type_, "C_thread" + t, {na, na}));
-    }
-    if (!semi_canonical_) {
-        for (int i = 0; i < n_threads; i++) {
-            std::string t = std::to_string(i);
-            X_vec.push_back(ambit::Tensor::build(tensor_type_, "X_thread" + t, {nQ, nv}));
-        }
-    }
-
-    auto Bva = ints_->three_integral_block(aux_mos_, virt_mos_, actv_mos_);
-    if (!semi_canonical_) {
-        auto X = ambit::Tensor::build(tensor_type_, "tempCAVV", {nQ, nv, na});
-        X("gev") = Bva("geu") * U_.block("aa")("vu");
-        Bva("gfv") = X("gev") * U_.block("vv")("fe");
-    }
-
-#pragma omp parallel for num_threads(n_threads)
-    for (size_t m = 0; m < nc; ++m) {
-        auto im = core_mos_[m];
-        double Fm = Fdiag_[im];
-
-        int thread = omp_get_thread_num();
-#pragma omp critical
-        {
-            Bm_vec[thread].data() = ints_->three_integral_block(aux_mos_, virt_mos_, {im}).data();
-            if (!semi_canonical_) {
-                X_vec[thread]("gf") = Bm_vec[thread]("ge") * U_.block("vv")("fe");
-                Bm_vec[thread]("gf") = X_vec[thread]("gf");
-            }
-        }
-
-        V_vec[thread]("efu") = Bm_vec[thread]("ge") * Bva("gfu");
-        S_vec[thread]("efu") = 2.0 * V_vec[thread]("efu") - V_vec[thread]("feu");
-
-        // scale V by 1 + exp(-s * D^2)
-        if (Vr) {
-            V_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                double denom = Fm + Fdiag_[actv_mos_[i[2]]] - Fdiag_[virt_mos_[i[0]]] -
-                               Fdiag_[virt_mos_[i[1]]];
-                value *= 1.0 + dsrg_source_->compute_renormalized(denom);
-            });
-        }
-
-        // scale T by [1 - exp(-s * D^2)] / D
-        S_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-            double denom =
-                Fm + Fdiag_[actv_mos_[i[2]]] - Fdiag_[virt_mos_[i[0]]] - Fdiag_[virt_mos_[i[1]]];
-            value *= dsrg_source_->compute_renormalized_denominator(denom);
-        });
-
-        C_vec[thread]("vu") += S_vec[thread]("efv") * V_vec[thread]("efu");
-    }
-
-    // finalize results
-    auto C = ambit::Tensor::build(tensor_type_, "C1total_CAVV", {na, na});
-    for (int thread = 0; thread < n_threads; thread++) {
-        C("vu") += C_vec[thread]("vu");
-    }
-
-    // rotate back to original orbital basis
-    if (!semi_canonical_) {
-        auto X = ambit::Tensor::build(tensor_type_, "tempCAVV", {na, na});
-        X("xv") = C("uv") * U_.block("aa")("ux");
-        C("xy") = X("xv") * U_.block("aa")("vy");
-    }
-
-    Hbar1("uv") += C("uv");
+    compute_Hbar1V_batched(Hbar1, Vr, false);
 
     print_done(t.stop());
 }
@@ -834,11 +694,22 @@ void SA_MRPT2::compute_Hbar1V_diskDF(ambit::Tensor& Hbar1, bool Vr) {
      *
      * To minimize the number of calls of ints_->three_integral_block,
      * we store as many B(L|em) as possible in memory.
-     * Modified from function compute_Hbar1V_DF.
+     * The next batch of B(L|em) is read from disk while the current one is used.
      */
+    timer t("Compute C1 virtual contraction DiskDF");
+    print_contents("Computing DiskDF Hbar1 CAVV");
+
+    compute_Hbar1V_batched(Hbar1, Vr, true);
+
+    print_done(t.stop());
+}
+
+void SA_MRPT2::compute_Hbar1V_batched(ambit::Tensor& Hbar1, bool Vr, bool prefetch) {
     auto nQ = aux_mos_.size();
     auto nv = virt_mos_.size();
     auto na = actv_mos_.size();
+    if (core_mos_.empty() or nv == 0 or na == 0)
+        return;
 
     // check memory
     size_t max_n_threads = dsrg_mem_.available() / mem_batched_["cavv"];
@@ -848,109 +719,96 @@ void SA_MRPT2::compute_Hbar1V_diskDF(ambit::Tensor& Hbar1, bool Vr) {
                         n_threads);
     }
 
-    size_t max_num_Qv = (dsrg_mem_.available() - n_threads * mem_batched_["cavv"]) * 0.8 /
-                        (sizeof(double) * nQ * nv);
-    if (max_num_Qv < 2) { // no point to do this batching anymore
-        compute_Hbar1V_DF(Hbar1, Vr);
-        return;
+    auto Bva = ints_->three_integral_block(aux_mos_, virt_mos_, actv_mos_);
+    if (!semi_canonical_) {
+        auto X = ambit::Tensor::build(tensor_type_, "tempCAVV", {nQ, nv, na});
+        X("gev") = Bva("geu") * U_.block("aa")("vu");
+        Bva("gfv") = X("gev") * U_.block("vv")("fe");
     }
+    double* Bva_data = Bva.data().data();
 
-    timer t("Compute C1 virtual contraction DiskDF");
-    print_contents("Computing DiskDF Hbar1 CAVV");
-
-    // separate core indices into batches
-    auto core_batches = split_indices_to_batches(core_mos_, max_num_Qv);
+    // B(L|em) of one core batch is kept, plus the one read in the background
+    size_t nbuffers = (prefetch ? 2 : 1) + (semi_canonical_ ? 0 : 1);
+    auto mem_fixed = n_threads * mem_batched_["cavv"] +
+                     dsrg_mem_.compute_memory({"Lva"}, semi_canonical_ ? 1 : 2);
+    auto core_batches = split_core_batches(mem_fixed, nbuffers);
     size_t nbatch = core_batches.size();
 
-    // some tensors used for threading
-    std::vector<ambit::Tensor> Bm_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> V_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> S_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> C_vec = init_tensor_vecs(n_threads);
-    std::vector<ambit::Tensor> X_vec = init_tensor_vecs(n_threads);
+    BatchReader<std::vector<double>> reader(
+        nbatch, [&](size_t k) { return read_Bvc_slabs(core_batches[k]); }, prefetch);
 
-    for (int i = 0; i < n_threads; i++) {
-        std::string t = std::to_string(i);
-        Bm_vec.push_back(ambit::Tensor::build(tensor_type_, "Bm_thread" + t, {nQ, nv}));
-        V_vec.push_back(ambit::Tensor::build(tensor_type_, "V_thread" + t, {nv, nv, na}));
-        S_vec.push_back(ambit::Tensor::build(tensor_type_, "S_thread" + t, {nv, nv, na}));
-        C_vec.push_back(ambit::Tensor::build(tensor_type_, "C_thread" + t, {na, na}));
+    std::vector<double> Fv(nv), Fa(na);
+    for (size_t e = 0; e < nv; ++e) {
+        Fv[e] = Fdiag_[virt_mos_[e]];
     }
-    if (!semi_canonical_) {
-        for (int i = 0; i < n_threads; i++) {
-            std::string t = std::to_string(i);
-            X_vec.push_back(ambit::Tensor::build(tensor_type_, "X_thread" + t, {nQ, nv}));
-        }
+    for (size_t u = 0; u < na; ++u) {
+        Fa[u] = Fdiag_[actv_mos_[u]];
     }
+    size_t slab = nQ * nv;
+    size_t nvva = nv * nv * na;
 
-    auto Bva = ints_->three_integral_block(aux_mos_, virt_mos_, actv_mos_);
-    if (!semi_canonical_) {
-        auto X = ambit::Tensor::build(tensor_type_, "tempCAVV", {nQ, nv, na});
-        X("gev") = Bva("geu") * U_.block("aa")("vu");
-        Bva("gfv") = X("gev") * U_.block("vv")("fe");
-    }
-
-    for (size_t Mbatch = 0; Mbatch < nbatch; ++Mbatch) {
-        auto Mbatch_size = core_batches[Mbatch].size();
-        auto BM = ints_->three_integral_block(aux_mos_, virt_mos_, core_batches[Mbatch]);
-        auto& BM_data = BM.data();
+    std::vector<double> C(na * na, 0.0);
 
-#pragma omp parallel for num_threads(n_threads)
-        for (size_t m = 0; m < Mbatch_size; ++m) {
-            auto im = core_batches[Mbatch][m];
-            double Fm = Fdiag_[im];
+    for (size_t batch = 0; batch < nbatch; ++batch) {
+        auto BM = reader.next();
+        double* BM_data = BM.data();
+        const auto& cores = core_batches[batch];
+        size_t ncores = cores.size();
 
-            int thread = omp_get_thread_num();
-#pragma omp critical
-            {
-                Bm_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                    value = BM_data[i[0] * Mbatch_size * nv + i[1] * Mbatch_size + m];
-                });
-                if (!semi_canonical_) {
-                    X_vec[thread]("gf") = Bm_vec[thread]("ge") * U_.block("vv")("fe");
-                    Bm_vec[thread]("gf") = X_vec[thread]("gf");
+#pragma omp parallel num_threads(n_threads)
+        {
+            std::vector<double> V(nvva), S(nvva), D(nvva), Ct(na * na, 0.0);
+
+#pragma omp for schedule(dynamic)
+            for (size_t m = 0; m < ncores; ++m) {
+                double Fm = Fdiag_[cores[m]];
+
+                // V(efu) = (em|fu)
+                C_DGEMM('T', 'N', nv, nv * na, nQ, 1.0, BM_data + m * slab, nv, Bva_data,
+                        nv * na, 0.0, V.data(), nv * na);
+
+                // S(efv) = [2 * V(efv) - V(fev)] * [1 - exp(-s * D^2)] / D
+                for (size_t e = 0; e < nv; ++e) {
+                    for (size_t f = 0; f < nv; ++f) {
+                        size_t ef = (e * nv + f) * na, fe = (f * nv + e) * na;
+                        double Def = Fm - Fv[e] - Fv[f];
+                        for (size_t u = 0; u < na; ++u) {
+                            D[ef + u] = Def + Fa[u];
+                            S[ef + u] = 2.0 * V[ef + u] - V[fe + u];
+                        }
+                    }
                 }
-            }
+                dsrg_source_->scale_renormalized_denominator_serial(D, S);
 
-            V_vec[thread]("efu") = Bm_vec[thread]("ge") * Bva("gfu");
-            S_vec[thread]("efu") = 2.0 * V_vec[thread]("efu") - V_vec[thread]("feu");
+                // scale V by 1 + exp(-s * D^2)
+                if (Vr) {
+                    dsrg_source_->scale_renormalized_serial(D, V, 1.0);
+                }
 
-            // scale V by 1 + exp(-s * D^2)
-            if (Vr) {
-                V_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                    double denom = Fm + Fdiag_[actv_mos_[i[2]]] - Fdiag_[virt_mos_[i[0]]] -
-                                   Fdiag_[virt_mos_[i[1]]];
-                    value *= 1.0 + dsrg_source_->compute_renormalized(denom);
-                });
+                // Ct(vu) += S(efv) * V(efu)
+                C_DGEMM('T', 'N', na, na, nv * nv, 1.0, S.data(), na, V.data(), na, 1.0,
+                        Ct.data(), na);
             }
 
-            // scale T by [1 - exp(-s * D^2)] / D
-            S_vec[thread].iterate([&](const std::vector<size_t>& i, double& value) {
-                double denom = Fm + Fdiag_[actv_mos_[i[2]]] - Fdiag_[virt_mos_[i[0]]] -
-                               Fdiag_[virt_mos_[i[1]]];
-                value *= dsrg_source_->compute_renormalized_denominator(denom);
-            });
-
-            C_vec[thread]("vu") += S_vec[thread]("efv") * V_vec[thread]("efu");
+#pragma omp critical
+            for (size_t i = 0; i < na * na; ++i) {
+                C[i] += Ct[i];
+            }
         }
     }
 
     // finalize results
-    auto C = ambit::Tensor::build(tensor_type_, "C1total_CAVV", {na, na});
-    for (int thread = 0; thread < n_threads; thread++) {
-        C("vu") += C_vec[thread]("vu");
-    }
+    auto Cuv = ambit::Tensor::build(tensor_type_, "C1total_CAVV", {na, na});
+    Cuv.data() = C;
 
     // rotate back to original orbital basis
     if (!semi_canonical_) {
         auto X = ambit::Tensor::build(tensor_type_, "tempCAVV", {na, na});
-        X("xv") = C("uv") * U_.block("aa")("ux");
-        C("xy") = X("xv") * U_.block("aa")("vy");
+        X("xv") = Cuv("uv") * U_.block("aa")("ux");
+        Cuv("xy") = X("xv") * U_.block("aa")("vy");
     }
 
-    Hbar1("uv") += C("uv");
-
-    print_done(t.stop());
+    Hbar1("uv") += Cuv("uv");
 }
 
 double SA_MRPT2::E_V_T2_CCAV() {
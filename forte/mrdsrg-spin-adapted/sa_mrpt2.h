@@ -84,6 +84,8 @@ class SA_MRPT2 : public SA_DSRGPT {
     double compute_Hbar0_CCVV_DF();
     /// Energy contribution from CCVV block using DiskDF integrals
     double compute_Hbar0_CCVV_diskDF();
+    /// Threaded CCVV energy over batches of core pairs, read the next batch ahead if prefetch
+    double compute_Hbar0_CCVV_batched(bool prefetch);
 
     /// Compute DSRG-transformed Hamiltonian
     void compute_hbar();
@@ -96,6 +98,13 @@ class SA_MRPT2 : public SA_DSRGPT {
     void compute_Hbar1C_diskDF(ambit::Tensor& Hbar1, bool Vr = true);
     /// Compute Hbar1 from virtual contraction, renormalize V if Vr is true
     void compute_Hbar1V_diskDF(ambit::Tensor& Hbar1, bool Vr = true);
+    /// Threaded virtual contraction over core batches, read the next batch ahead if prefetch
+    void compute_Hbar1V_batched(ambit::Tensor& Hbar1, bool Vr, bool prefetch);
+
+    /// Read B(L|em) of the given core orbitals as slabs (m, L, e) in semicanonical orbitals
+    std::vector<double> read_Bvc_slabs(const std::vector<size_t>& cores);
+    /// Split core orbitals into batches such that nbuffers slabs of B(L|em) fit in memory
+    std::vector<std::vector<size_t>> split_core_batches(size_t mem_fixed, size_t nbuffers);
 
     /// C1 = [Vr, T2] CAVV from compute_Hbar1V_diskDF
     ambit::Tensor C1_VT2_CAVV_;
@@ -349,6 +349,18 @@ void SADSRG::fill_Fdiag(BlockedTensor& F, std::vector<double>& Fa) {
     });
 }
 
+std::vector<double> SADSRG::block_denominators(const std::string& block) {
+    std::vector<std::vector<double>> e;
+    for (char c : block) {
+        std::vector<double> ei;
+        for (size_t p : label_to_spacemo_[c]) {
+            ei.push_back(Fdiag_[p]);
+        }
+        e.push_back(ei);
+    }
+    return compute_block_denominators(e);
+}
+
 double SADSRG::compute_reference_energy_from_ints() {
     BlockedTensor H = BTF_->build(tensor_type_, "OEI", {"cc", "aa"}, true);
     H.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>&, double& value) {
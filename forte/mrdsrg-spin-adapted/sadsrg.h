@@ -205,6 +205,8 @@ class SADSRG : public DynamicCorrelationSolver {
     std::vector<std::string> od_two_labels_pphh();
     /// Compute the blocks labels used in NIVO (number of virtual < 3)
     std::vector<std::string> nivo_labels();
+    /// Compute the blocks labels of a two-body operator without the vvvv block
+    std::vector<std::string> no_vvvv_labels();
 
     // ==> fill in densities from RDMs <==
 
@@ -233,6 +235,8 @@ class SADSRG : public DynamicCorrelationSolver {
     void build_fock_from_ints();
     /// Fill in diagonal elements of Fock matrix to Fdiag
     void fill_Fdiag(BlockedTensor& F, std::vector<double>& Fdiag);
+    /// Energy denominators of a block (e.g., "cavv") ordered like the block data
+    std::vector<double> block_denominators(const std::string& block);
 
     /// Check orbitals if semicanonical
     bool check_semi_orbs();
@@ -290,6 +294,37 @@ class SADSRG : public DynamicCorrelationSolver {
      * B: 3-index integrals from DF/CD
      */
 
+    /**
+     * Intermediates of T2 shared by the terms of [H2, T2] -> C2.
+     *
+     * They depend only on T2 (and S2), so they can be built once and reused for all the nested
+     * commutators of a DSRG transformation. Terms that contract H2 in the same way are fused
+     * through the W intermediates, whose blocks with an active first index hold the cumulant
+     * or hole-density dressed amplitudes.
+     */
+    struct T2Intermediates {
+        /// Whh["ijab"] = T2["ijab"] - 0.5 * Eta1["iy"] * T2["yjab"]
+        ambit::BlockedTensor Whh;
+        /// WT["mjab"] = T2["mjab"] (core m) and WT["xjab"] = 0.5 * L1["xy"] * T2["yjab"]
+        ambit::BlockedTensor WT;
+        /// WS["mjab"] = S2["mjab"] (core m) and WS["xjab"] = 0.5 * L1["xy"] * S2["yjab"]
+        ambit::BlockedTensor WS;
+        /// E1T2["xjab"] = Eta1["xy"] * T2["yjab"]
+        ambit::BlockedTensor E1T2;
+        /// L1T2["ijyb"] = L1["xy"] * T2["ijxb"]
+        ambit::BlockedTensor L1T2;
+        /// L1S2["ijyb"] = L1["xy"] * S2["ijxb"]
+        ambit::BlockedTensor L1S2;
+        /// L1T2x["ijby"] = L1["xy"] * T2["ijbx"]
+        ambit::BlockedTensor L1T2x;
+    };
+
+    /// Build the T2 intermediates used by H2_T2_C2 and V_T2_C2_DF
+    T2Intermediates build_T2_intermediates(BlockedTensor& T2, BlockedTensor& S2);
+
+    /// Estimated number of floating-point operations of a contraction over the given indices
+    double contraction_flops(const std::string& indices);
+
     /// Compute zero-body term of commutator [H1, T1]
     double H1_T1_C0(BlockedTensor& H1, BlockedTensor& T1, const double& alpha, double& C0);
     /// Compute zero-body term of commutator [H1, T2]
@@ -319,6 +354,9 @@ class SADSRG : public DynamicCorrelationSolver {
     /// Compute two-body term of commutator [H2, T2], S2[ijab] = 2 * T[ijab] - T[ijba]
     void H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, const double& alpha,
                   BlockedTensor& C2);
+    /// Compute two-body term of commutator [H2, T2] using precomputed T2 intermediates
+    void H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, T2Intermediates& X, const double& alpha,
+                  BlockedTensor& C2);
 
     /// Compute zero-body term of commutator [V, T1], V is constructed from B (DF/CD)
     void V_T1_C0_DF(BlockedTensor& B, BlockedTensor& T1, const double& alpha, double& C0);
@@ -337,8 +375,11 @@ class SADSRG : public DynamicCorrelationSolver {
     /// Compute two-body term of commutator [V, T2], V is constructed from B (DF/CD)
     void V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, BlockedTensor& S2, const double& alpha,
                     BlockedTensor& C2);
+    /// Compute two-body term of commutator [V, T2] using precomputed T2 intermediates
+    void V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, T2Intermediates& X, const double& alpha,
+                    BlockedTensor& C2);
     /// Compute two-body term of commutator [V, T2], exchange of particle-hole contraction
-    void V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
+    void V_T2_C2_DF_PH_X(BlockedTensor& B, T2Intermediates& X, const double& alpha,
                          BlockedTensor& C2);
 
     /// Compute the active part of commutator C1 + C2 = alpha * [H1 + H2, A1 + A2]
@@ -168,4 +168,25 @@ std::vector<std::string> SADSRG::nivo_labels() {
     return blocks_exclude_V3;
 }
 
+std::vector<std::string> SADSRG::no_vvvv_labels() {
+    std::vector<std::string> elementary_labels{core_label_, actv_label_, virt_label_};
+    std::string vvvv = virt_label_ + virt_label_ + virt_label_ + virt_label_;
+    std::vector<std::string> blocks_exclude_V4;
+
+    for (std::string s0 : elementary_labels) {
+        for (std::string s1 : elementary_labels) {
+            for (std::string s2 : elementary_labels) {
+                for (std::string s3 : elementary_labels) {
+                    std::string s = s0 + s1 + s2 + s3;
+                    if (s != vvvv) {
+                        blocks_exclude_V4.push_back(s);
+                    }
+                }
+            }
+        }
+    }
+
+    return blocks_exclude_V4;
+}
+
 } // namespace forte
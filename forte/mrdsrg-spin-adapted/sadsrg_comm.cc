@@ -349,24 +349,123 @@ void SADSRG::H2_T1_C2(BlockedTensor& H2, BlockedTensor& T1, const double& alpha,
     dsrg_time_.add("212", timer.get());
 }
 
+SADSRG::T2Intermediates SADSRG::build_T2_intermediates(BlockedTensor& T2,
+                                                       BlockedTensor& S2) {
+    local_timer timer;
+
+    // blocks of a tensor whose n-th index is active
+    auto actv_blocks = [&](BlockedTensor& T, size_t n) {
+        std::vector<std::string> blocks;
+        for (const std::string& block : T.block_labels()) {
+            if (block[n] == actv_label_[0])
+                blocks.push_back(block);
+        }
+        return blocks;
+    };
+
+    T2Intermediates X;
+
+    X.E1T2 = ambit::BlockedTensor::build(tensor_type_, "E1T2", actv_blocks(T2, 0));
+    X.E1T2["xjab"] = Eta1_["xy"] * T2["yjab"];
+
+    X.Whh = ambit::BlockedTensor::build(tensor_type_, "Whh", T2.block_labels());
+    X.Whh["ijab"] = T2["ijab"];
+    X.Whh["xjab"] -= 0.5 * X.E1T2["xjab"];
+
+    X.WT = ambit::BlockedTensor::build(tensor_type_, "WT", T2.block_labels());
+    X.WT["mjab"] = T2["mjab"];
+    X.WT["xjab"] = 0.5 * L1_["xy"] * T2["yjab"];
+
+    X.WS = ambit::BlockedTensor::build(tensor_type_, "WS", S2.block_labels());
+    X.WS["mjab"] = S2["mjab"];
+    X.WS["xjab"] = 0.5 * L1_["xy"] * S2["yjab"];
+
+    X.L1T2 = ambit::BlockedTensor::build(tensor_type_, "L1T2", actv_blocks(T2, 2));
+    X.L1T2["ijyb"] = L1_["xy"] * T2["ijxb"];
+
+    X.L1S2 = ambit::BlockedTensor::build(tensor_type_, "L1S2", actv_blocks(S2, 2));
+    X.L1S2["ijyb"] = L1_["xy"] * S2["ijxb"];
+
+    X.L1T2x = ambit::BlockedTensor::build(tensor_type_, "L1T2x", actv_blocks(T2, 3));
+    X.L1T2x["ijby"] = L1_["xy"] * T2["ijbx"];
+
+    dsrg_time_.add_term("222", "T2 intermediates", timer.get(),
+                        3.0 * (contraction_flops("aahpp") + contraction_flops("hhaap")));
+    return X;
+}
+
+double SADSRG::contraction_flops(const std::string& indices) {
+    double flops = 2.0;
+    for (const char c : indices) {
+        flops *= static_cast<double>(dsrg_mem_.compute_n_elements(std::string(1, c)));
+    }
+    return flops;
+}
+
 void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, const double& alpha,
                       BlockedTensor& C2) {
+    auto X = build_T2_intermediates(T2, S2);
+    H2_T2_C2(H2, T2, X, alpha, C2);
+}
+
+void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, T2Intermediates& X,
+                      const double& alpha, BlockedTensor& C2) {
     local_timer timer;
 
-    // particle-particle contractions
-    C2["ijrs"] += alpha * H2["abrs"] * T2["ijab"];
+    // particle-particle contractions, batched over the third index of C2
+    local_timer t_pp;
+    std::vector<std::pair<std::string, std::string>> pp_batches{
+        {"m", core_label_}, {"u", actv_label_}, {"e", virt_label_}};
+    std::vector<std::string> h_labels{core_label_, actv_label_};
+    std::vector<std::string> g_labels{core_label_, actv_label_, virt_label_};
+    for (const auto& pp_batch : pp_batches) {
+        const std::string& r = pp_batch.first;
+
+        // batching only works when C2 contains all "hh" + r + "g" blocks
+        bool all_blocks = true, any_block = false;
+        for (const std::string& i : h_labels) {
+            for (const std::string& j : h_labels) {
+                for (const std::string& s : g_labels) {
+                    bool is_block = C2.is_block(i + j + pp_batch.second + s);
+                    all_blocks = all_blocks and is_block;
+                    any_block = any_block or is_block;
+                }
+            }
+        }
 
-    C2["ijrs"] -= 0.5 * alpha * L1_["xy"] * T2["ijxb"] * H2["ybrs"];
-    C2["jisr"] -= 0.5 * alpha * L1_["xy"] * T2["ijxb"] * H2["ybrs"];
+        if (all_blocks) {
+            C2["ij" + r + "s"] += batched(r, alpha * H2["ab" + r + "s"] * T2["ijab"]);
+        } else if (any_block) {
+            C2["ij" + r + "s"] += alpha * H2["ab" + r + "s"] * T2["ijab"];
+        }
+    }
+    dsrg_time_.add_term("222", "pp ladder", t_pp.get(), contraction_flops("hhppgg"));
 
-    // hole-hole contractions
-    C2["pqab"] += alpha * H2["pqij"] * T2["ijab"];
+    t_pp.reset();
+    std::vector<std::string> blocks;
+    for (const std::string& block : C2.block_labels()) {
+        if (block[0] == virt_label_[0] or block[1] == virt_label_[0])
+            continue;
+        blocks.push_back(block);
+    }
 
-    C2["pqab"] -= 0.5 * alpha * Eta1_["xy"] * T2["yjab"] * H2["pqxj"];
-    C2["qpba"] -= 0.5 * alpha * Eta1_["xy"] * T2["yjab"] * H2["pqxj"];
+    auto temp = ambit::BlockedTensor::build(tensor_type_, "temp", blocks);
+    temp["ijrs"] = X.L1T2["ijyb"] * H2["ybrs"];
 
-    // hole-particle contractions
-    std::vector<std::string> blocks;
+    C2["ijrs"] -= 0.5 * alpha * temp["ijrs"];
+    C2["jisr"] -= 0.5 * alpha * temp["ijrs"];
+    dsrg_time_.add_term("222", "pp L1", t_pp.get(), contraction_flops("hhapgg"));
+
+    // hole-hole contractions, Whh contains the first Eta1 term
+    local_timer t_hh;
+    C2["pqab"] += alpha * H2["pqij"] * X.Whh["ijab"];
+    C2["qpba"] -= 0.5 * alpha * H2["pqxj"] * X.E1T2["xjab"];
+    dsrg_time_.add_term("222", "hh ladder", t_hh.get(),
+                        contraction_flops("gghhpp") + contraction_flops("ggahpp"));
+
+    // hole-particle contractions, WT and WS contain the L1 terms of the same shape
+    local_timer t_ph;
+    blocks.clear();
     for (const std::string& block : C2.block_labels()) {
         if (block.substr(1, 1) == virt_label_ or block.substr(3, 1) == core_label_)
             continue;
@@ -374,13 +473,11 @@ void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, c
             blocks.push_back(block);
     }
 
-    auto temp = ambit::BlockedTensor::build(tensor_type_, "temp", blocks);
-    temp["qjsb"] += alpha * H2["aqms"] * S2["mjab"];
-    temp["qjsb"] -= alpha * H2["aqsm"] * T2["mjab"];
-    temp["qjsb"] += 0.5 * alpha * L1_["xy"] * S2["yjab"] * H2["aqxs"];
-    temp["qjsb"] -= 0.5 * alpha * L1_["xy"] * T2["yjab"] * H2["aqsx"];
-    temp["qjsb"] -= 0.5 * alpha * L1_["xy"] * S2["ijxb"] * H2["yqis"];
-    temp["qjsb"] += 0.5 * alpha * L1_["xy"] * T2["ijxb"] * H2["yqsi"];
+    temp = ambit::BlockedTensor::build(tensor_type_, "temp", blocks);
+    temp["qjsb"] += alpha * H2["aqis"] * X.WS["ijab"];
+    temp["qjsb"] -= alpha * H2["aqsi"] * X.WT["ijab"];
+    temp["qjsb"] -= 0.5 * alpha * X.L1S2["ijyb"] * H2["yqis"];
+    temp["qjsb"] += 0.5 * alpha * X.L1T2["ijyb"] * H2["yqsi"];
 
     C2["qjsb"] += temp["qjsb"];
     C2["jqbs"] += temp["qjsb"];
@@ -394,17 +491,17 @@ void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, c
     }
 
     temp = ambit::BlockedTensor::build(tensor_type_, "temp", blocks);
-    temp["jqsb"] -= alpha * H2["aqsm"] * T2["mjba"];
-    temp["jqsb"] -= 0.5 * alpha * L1_["xy"] * T2["yjba"] * H2["aqsx"];
-    temp["jqsb"] += 0.5 * alpha * L1_["xy"] * T2["ijbx"] * H2["yqsi"];
+    temp["jqsb"] -= alpha * H2["aqsi"] * X.WT["ijba"];
+    temp["jqsb"] += 0.5 * alpha * X.L1T2x["ijby"] * H2["yqsi"];
 
     C2["jqsb"] += temp["jqsb"];
     C2["qjbs"] += temp["jqsb"];
+    dsrg_time_.add_term("222", "ph", t_ph.get(),
+                        3.0 * (contraction_flops("gghpph") + contraction_flops("gghhap")));
 
     if (print_ > 2) {
         outfile->Printf("\n    Time for [H2, T2] -> C2 : %12.3f", timer.get());
     }
-    dsrg_time_.add("222", timer.get());
 }
 
 void SADSRG::V_T1_C0_DF(BlockedTensor& B, BlockedTensor& T1, const double& alpha, double& C0) {
@@ -578,14 +675,24 @@ void SADSRG::V_T1_C2_DF(BlockedTensor& B, BlockedTensor& T1, const double& alpha
 
 void SADSRG::V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, BlockedTensor& S2, const double& alpha,
                         BlockedTensor& C2) {
+    auto X = build_T2_intermediates(T2, S2);
+    V_T2_C2_DF(B, T2, X, alpha, C2);
+}
+
+void SADSRG::V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, T2Intermediates& X,
+                        const double& alpha, BlockedTensor& C2) {
     local_timer timer;
 
     // particle-particle contractions
     // TODO: need to investigate why using "r" fails when C2 does not contain all "rs"
+    local_timer t_pp;
     C2["ijes"] += batched("e", alpha * B["gae"] * B["gbs"] * T2["ijab"]);
     C2["ijus"] += batched("u", alpha * B["gau"] * B["gbs"] * T2["ijab"]);
     C2["ijms"] += batched("m", alpha * B["gam"] * B["gbs"] * T2["ijab"]);
+    dsrg_time_.add_term("222", "pp ladder", t_pp.get(),
+                        contraction_flops("Lppgg") + contraction_flops("hhppgg"));
 
+    t_pp.reset();
     std::vector<std::string> C2blocks;
     for (const std::string& block : C2.block_labels()) {
         if (block[0] == virt_label_[0] or block[1] == virt_label_[0])
@@ -594,13 +701,16 @@ void SADSRG::V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, BlockedTensor& S2,
     }
 
     auto temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222", C2blocks);
-    temp["ijes"] += batched("e", L1_["xy"] * T2["ijxb"] * B["gye"] * B["gbs"]);
-    temp["ijks"] += L1_["xy"] * T2["ijxb"] * B["gyk"] * B["gbs"];
+    temp["ijes"] += batched("e", X.L1T2["ijyb"] * B["gye"] * B["gbs"]);
+    temp["ijks"] += X.L1T2["ijyb"] * B["gyk"] * B["gbs"];
 
     C2["ijrs"] -= 0.5 * alpha * temp["ijrs"];
     C2["jisr"] -= 0.5 * alpha * temp["ijrs"];
+    dsrg_time_.add_term("222", "pp L1", t_pp.get(),
+                        contraction_flops("Lapgg") + contraction_flops("hhapgg"));
 
-    // hole-hole contractions
+    // hole-hole contractions, Whh contains the first Eta1 term
+    local_timer t_hh;
     std::vector<std::string> Vblocks;
     for (const std::string& block : C2.block_labels()) {
         if (block[2] == core_label_[0] or block[3] == core_label_[0])
@@ -613,30 +723,36 @@ void SADSRG::V_T2_C2_DF(BlockedTensor& B, BlockedTensor& T2, BlockedTensor& S2,
     temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222", Vblocks);
     temp["pqij"] = B["gpi"] * B["gqj"];
 
-    C2["pqab"] += alpha * temp["pqij"] * T2["ijab"];
-
-    C2["pqab"] -= 0.5 * alpha * Eta1_["xy"] * T2["yjab"] * temp["pqxj"];
-    C2["qpba"] -= 0.5 * alpha * Eta1_["xy"] * T2["yjab"] * temp["pqxj"];
+    C2["pqab"] += alpha * temp["pqij"] * X.Whh["ijab"];
+    C2["qpba"] -= 0.5 * alpha * temp["pqxj"] * X.E1T2["xjab"];
+    dsrg_time_.add_term("222", "hh ladder", t_hh.get(),
+                        contraction_flops("Lgghh") + contraction_flops("gghhpp") +
+                            contraction_flops("ggahpp"));
 
-    // hole-particle contractions
+    // hole-particle contractions, WS contains the first L1 term
+    local_timer t_ph;
     temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222", {"Lhp"});
-    temp["gjb"] += alpha * B["gam"] * S2["mjab"];
-    temp["gjb"] += 0.5 * alpha * L1_["xy"] * S2["yjab"] * B["gax"];
-    temp["gjb"] -= 0.5 * alpha * L1_["xy"] * S2["ijxb"] * B["gyi"];
+    temp["gjb"] += alpha * B["gai"] * X.WS["ijab"];
+    temp["gjb"] -= 0.5 * alpha * X.L1S2["ijyb"] * B["gyi"];
 
     C2["qjsb"] += temp["gjb"] * B["gqs"];
     C2["jqbs"] += temp["gjb"] * B["gqs"];
+    dsrg_time_.add_term("222", "ph", t_ph.get(),
+                        contraction_flops("Lhhpp") + contraction_flops("Lhhap") +
+                            2.0 * contraction_flops("Lgghp"));
 
     // exchange like terms
-    V_T2_C2_DF_PH_X(B, T2, alpha, C2);
+    t_ph.reset();
+    V_T2_C2_DF_PH_X(B, X, alpha, C2);
+    dsrg_time_.add_term("222", "ph exchange", t_ph.get(),
+                        6.0 * (contraction_flops("Lpggh") + contraction_flops("gghpph")));
 
     if (print_ > 2) {
         outfile->Printf("\n    Time for [H2, T2] -> C2 : %12.3f", timer.get());
     }
-    dsrg_time_.add("222", timer.get());
 }
 
-void SADSRG::V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
+void SADSRG::V_T2_C2_DF_PH_X(BlockedTensor& B, T2Intermediates& X, const double& alpha,
                              BlockedTensor& C2) {
 
     std::vector<std::string> qjsb_small, qjsb_large, jqsb_small, jqsb_large;
@@ -663,50 +779,37 @@ void SADSRG::V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double&
         }
     }
 
+    // WT contains the L1 term of the same shape
     auto temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", qjsb_small);
-    temp["qjsb"] -= alpha * B["gas"] * B["gqm"] * T2["mjab"];
-    temp["qjsb"] -= 0.5 * alpha * L1_["xy"] * T2["yjab"] * B["gas"] * B["gqx"];
-    temp["qjsb"] += 0.5 * alpha * L1_["xy"] * T2["ijxb"] * B["gys"] * B["gqi"];
+    temp["qjsb"] -= alpha * B["gas"] * B["gqi"] * X.WT["ijab"];
+    temp["qjsb"] += 0.5 * alpha * X.L1T2["ijyb"] * B["gys"] * B["gqi"];
 
     C2["qjsb"] += temp["qjsb"];
     C2["jqbs"] += temp["qjsb"];
 
     temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", jqsb_small);
-    temp["jqsb"] -= alpha * B["gas"] * B["gqm"] * T2["mjba"];
-    temp["jqsb"] -= 0.5 * alpha * L1_["xy"] * T2["yjba"] * B["gas"] * B["gqx"];
-    temp["jqsb"] += 0.5 * alpha * L1_["xy"] * T2["ijbx"] * B["gys"] * B["gqi"];
+    temp["jqsb"] -= alpha * B["gas"] * B["gqi"] * X.WT["ijba"];
+    temp["jqsb"] += 0.5 * alpha * X.L1T2x["ijby"] * B["gys"] * B["gqi"];
 
     C2["jqsb"] += temp["jqsb"];
     C2["qjbs"] += temp["jqsb"];
 
     if (qjsb_large.size() != 0) {
-        C2["e,j,f,v0"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,a,v0"]);
-        C2["j,e,v0,f"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,a,v0"]);
-
-        temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", {"ahpv"});
-        temp["xjae"] = L1_["xy"] * T2["yjae"];
-        C2["e,j,f,v0"] -= batched("e", 0.5 * alpha * temp["x,j,a,v0"] * B["g,a,f"] * B["g,e,x"]);
-        C2["j,e,v0,f"] -= batched("e", 0.5 * alpha * temp["x,j,a,v0"] * B["g,a,f"] * B["g,e,x"]);
-
-        temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", {"hhav"});
-        temp["ijye"] = L1_["xy"] * T2["ijxe"];
-        C2["e,j,f,v0"] += batched("e", 0.5 * alpha * temp["i,j,y,v0"] * B["g,y,f"] * B["g,e,i"]);
-        C2["j,e,v0,f"] += batched("e", 0.5 * alpha * temp["i,j,y,v0"] * B["g,y,f"] * B["g,e,i"]);
+        C2["e,j,f,v0"] -= batched("e", alpha * B["g,a,f"] * B["g,e,i"] * X.WT["i,j,a,v0"]);
+        C2["j,e,v0,f"] -= batched("e", alpha * B["g,a,f"] * B["g,e,i"] * X.WT["i,j,a,v0"]);
+
+        C2["e,j,f,v0"] += batched("e", 0.5 * alpha * X.L1T2["i,j,y,v0"] * B["g,y,f"] * B["g,e,i"]);
+        C2["j,e,v0,f"] += batched("e", 0.5 * alpha * X.L1T2["i,j,y,v0"] * B["g,y,f"] * B["g,e,i"]);
     }
 
     if (jqsb_large.size() != 0) {
-        C2["j,e,f,v0"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,v0,a"]);
-        C2["e,j,v0,f"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,v0,a"]);
-
-        temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", {"ahvp"});
-        temp["xjea"] = L1_["xy"] * T2["yjea"];
-        C2["j,e,f,v0"] -= batched("e", 0.5 * alpha * temp["x,j,v0,a"] * B["g,a,f"] * B["g,e,x"]);
-        C2["e,j,v0,f"] -= batched("e", 0.5 * alpha * temp["x,j,v0,a"] * B["g,a,f"] * B["g,e,x"]);
-
-        temp = ambit::BlockedTensor::build(tensor_type_, "DFtemp222PHX", {"hhva"});
-        temp["ijey"] = L1_["xy"] * T2["ijex"];
-        C2["j,e,f,v0"] += batched("e", 0.5 * alpha * temp["i,j,v0,y"] * B["g,y,f"] * B["g,e,i"]);
-        C2["e,j,v0,f"] += batched("e", 0.5 * alpha * temp["i,j,v0,y"] * B["g,y,f"] * B["g,e,i"]);
+        C2["j,e,f,v0"] -= batched("e", alpha * B["g,a,f"] * B["g,e,i"] * X.WT["i,j,v0,a"]);
+        C2["e,j,v0,f"] -= batched("e", alpha * B["g,a,f"] * B["g,e,i"] * X.WT["i,j,v0,a"]);
+
+        C2["j,e,f,v0"] +=
+            batched("e", 0.5 * alpha * X.L1T2x["i,j,v0,y"] * B["g,y,f"] * B["g,e,i"]);
+        C2["e,j,v0,f"] +=
+            batched("e", 0.5 * alpha * X.L1T2x["i,j,v0,y"] * B["g,y,f"] * B["g,e,i"]);
     }
 }
 
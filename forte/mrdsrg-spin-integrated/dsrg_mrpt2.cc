@@ -2974,6 +2974,78 @@ void DSRG_MRPT2::check_t2() {
     print_amp_summary("AA", t2aa, sqrt(T2aanorm), nonzero_aa);
     print_amp_summary("AB", t2ab, sqrt(T2abnorm), nonzero_ab);
     print_amp_summary("BB", t2bb, sqrt(T2bbnorm), nonzero_bb);
+
+    int tile_size = foptions_->get_int("DSRG_T2_TILE_SIZE");
+    if (tile_size > 0) {
+        print_t2_tiles(tile_size, foptions_->get_double("DSRG_T2_TILE_THRESHOLD"));
+    }
+}
+
+void DSRG_MRPT2::print_t2_tiles(size_t tile_size, double threshold) {
+    // norm, energy, and number of elements of every tile of the core-virtual blocks
+    std::vector<std::tuple<double, double, size_t>> tiles;
+
+    for (const std::string& block : {"ccvv", "cCvV", "CCVV"}) {
+        if (!T2_.is_block(block))
+            continue;
+        const auto& t = T2_.block(block).data();
+        const auto& v = V_.block(std::string{block[2], block[3], block[0], block[1]}).data();
+        const auto& dims = T2_.block(block).dims();
+        size_t n0 = dims[0], n1 = dims[1], n2 = dims[2], n3 = dims[3];
+        double scale = (block == "cCvV") ? 1.0 : 0.25;
+
+        for (size_t I = 0; I < n0; I += tile_size) {
+            for (size_t J = 0; J < n1; J += tile_size) {
+                for (size_t A = 0; A < n2; A += tile_size) {
+                    for (size_t B = 0; B < n3; B += tile_size) {
+                        double norm2 = 0.0, energy = 0.0;
+                        size_t nele = 0;
+                        for (size_t i = I; i < std::min(I + tile_size, n0); ++i) {
+                            for (size_t j = J; j < std::min(J + tile_size, n1); ++j) {
+                                for (size_t a = A; a < std::min(A + tile_size, n2); ++a) {
+                                    for (size_t b = B; b < std::min(B + tile_size, n3); ++b) {
+                                        double value = t[((i * n1 + j) * n2 + a) * n3 + b];
+                                        norm2 += value * value;
+                                        energy += value * v[((a * n3 + b) * n0 + i) * n1 + j];
+                                        ++nele;
+                                    }
+                                }
+                            }
+                        }
+                        tiles.emplace_back(std::sqrt(norm2), scale * energy, nele);
+                    }
+                }
+            }
+        }
+    }
+
+    print_h2("Core-Virtual T2 Tiles");
+    outfile->Printf("\n    Tile size: %zu orbitals. The energy is the <[V, T2]> contribution of",
+                    tile_size);
+    outfile->Printf("\n    the tiles whose norm is below the threshold; amplitudes are not dropped.");
+    outfile->Printf("\n");
+
+    std::string dash(52, '-');
+    outfile->Printf("\n    %10s %17s %9s %13s", "Threshold", "Tiles Below", "Elements",
+                    "Energy (Eh)");
+    outfile->Printf("\n    %s", dash.c_str());
+    for (double factor : {100.0, 10.0, 1.0, 0.1, 0.01}) {
+        double thres = factor * threshold;
+        size_t nbelow = 0, nele = 0, nele_below = 0;
+        double energy = 0.0;
+        for (const auto& tile : tiles) {
+            nele += std::get<2>(tile);
+            if (std::get<0>(tile) < thres) {
+                ++nbelow;
+                nele_below += std::get<2>(tile);
+                energy += std::get<1>(tile);
+            }
+        }
+        double percent = nele > 0 ? 100.0 * nele_below / nele : 0.0;
+        outfile->Printf("\n    %10.2e %8zu/%-8zu %8.2f%% %13.4e", thres, nbelow, tiles.size(),
+                        percent, energy);
+    }
+    outfile->Printf("\n    %s", dash.c_str());
 }
 
 void DSRG_MRPT2::check_t1() {
@@ -181,6 +181,8 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     void compute_t2();
     /// Check T2 and store large amplitudes
     void check_t2();
+    /// Print the norms and energies of the core-virtual T2 tiles below a norm threshold
+    void print_t2_tiles(size_t tile_size, double threshold);
     /// Norm of T2
     double T2norm_;
     /// Max (with sign) of T2
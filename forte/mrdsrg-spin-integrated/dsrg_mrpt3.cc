@@ -42,6 +42,13 @@
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libqt/qt.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#endif
+
 #include "helpers/timer.h"
 #include "helpers/blockedtensorfactory.h"
 #include "fci/fci_solver.h"
@@ -89,6 +96,9 @@ void DSRG_MRPT3::startup() {
     size_t sp = sa + sv;
     size_t sg = sc + sp;
 
+    // number of threads for batched contractions
+    num_threads_ = omp_get_max_threads();
+
     // memory usage
     mem_total_ = static_cast<int64_t>(0.98 * psi::Process::environment.get_memory());
 
@@ -3170,6 +3180,8 @@ void DSRG_MRPT3::V_T2_C2_DF_AV(BlockedTensor& B, BlockedTensor& T2, const double
     size_t sa = actv_mos_.size();
     size_t sv = virt_mos_.size();
     size_t sL = aux_mos_.size();
+    if (sa == 0 or sv == 0)
+        return;
 
     // figure out unique HALF block labels of C2[ij|rs]
     std::vector<std::string> C2labels_half0;
@@ -3202,6 +3214,8 @@ void DSRG_MRPT3::V_T2_C2_DF_AV(BlockedTensor& B, BlockedTensor& T2, const double
         const char& h1 = C2label_g[1];
         size_t sh0 = label_to_spacemo_[h0].size();
         size_t sh1 = label_to_spacemo_[h1].size();
+        if (sh0 == 0 or sh1 == 0)
+            continue;
 
         // possible "ab" in H2(rs|ab): aa, av, va, and vv
         char h2a = 'a';
@@ -3217,6 +3231,9 @@ void DSRG_MRPT3::V_T2_C2_DF_AV(BlockedTensor& B, BlockedTensor& T2, const double
         if (isupper(h0))
             h2v = 'V';
 
+        // va block only exists for alpha-beta spin
+        bool do_va = islower(h0) && isupper(h1);
+
         // figure out the real "ij" indices of C2[ij|rs]
         std::vector<std::string> hole_labels{"cc", "ca", "ac", "aa"};
         if (isupper(h3a)) {
@@ -3231,42 +3248,54 @@ void DSRG_MRPT3::V_T2_C2_DF_AV(BlockedTensor& B, BlockedTensor& T2, const double
         std::set_intersection(hole_labels.begin(), hole_labels.end(), C2labels_half0.begin(),
                               C2labels_half0.end(), std::back_inserter(C2labels_hh));
 
-        // decide how to partition the virtual index
-        size_t sc = label_to_spacemo_['c'].size();
-        size_t shole = (sc > sa) ? sc : sa;
-        size_t smax = (sh1 > sh0) ? sh1 : sh0;
-        size_t nbatch = 1;
-        size_t svs = sv / nbatch;
-        size_t nele_total = 2 * shole * shole * sa * svs + sh0 * sh1 * sa * svs + sL * svs * smax;
-        size_t nele_batch = 2 * nele_total; // 2 for tensor resorting
-        while (nele_batch * sizeof(double) > static_cast<size_t>(0.95 * mem_total_)) {
-            nbatch += 1;
-            svs = sv / nbatch;
-            nele_batch = 2 * (2 * shole * shole * sa * svs + sh0 * sh1 * sa * svs + sL * svs * sh1);
+        // keep only "ij" blocks that C2 really has
+        C2labels_hh.erase(std::remove_if(C2labels_hh.begin(), C2labels_hh.end(),
+                                         [&](const std::string& s) {
+                                             return !C2.is_block(std::string{s[0], s[1], h0, h1});
+                                         }),
+                          C2labels_hh.end());
+        if (C2labels_hh.empty())
+            continue;
+
+        // sizes of "ij" blocks
+        std::vector<size_t> nij_blocks;
+        for (const std::string& C2label_h : C2labels_hh) {
+            nij_blocks.push_back(label_to_spacemo_[C2label_h[0]].size() *
+                                 label_to_spacemo_[C2label_h[1]].size());
+        }
+        size_t nij_total = std::accumulate(nij_blocks.begin(), nij_blocks.end(), size_t(0));
+        size_t nij_max = *std::max_element(nij_blocks.begin(), nij_blocks.end());
+
+        // data of C2[ij|rs] and, for aa or bb spin, the va block C2[ij|sr]
+        std::vector<double*> C2_ptrs, C2r_ptrs;
+        for (const std::string& C2label_h : C2labels_hh) {
+            const char& t0 = C2label_h[0];
+            const char& t1 = C2label_h[1];
+            C2_ptrs.push_back(C2.block(std::string{t0, t1, h0, h1}).data().data());
+
+            std::string C2label_r{t0, t1, h1, h0};
+            bool mirror = (isupper(t0) || islower(t1)) && C2.is_block(C2label_r);
+            C2r_ptrs.push_back(mirror ? C2.block(C2label_r).data().data() : nullptr);
         }
 
-        // memory usage
-        std::pair<double, std::string> mem_use = to_xb(nele_batch, sizeof(double));
+        // When r and s are in the same space, C2[ij|sr] of a given r lies in the rows of other
+        // threads. The increments C2[ij|rs] are then accumulated in D2 and antisymmetrized at
+        // the end.
+        bool self_mirror = (h0 == h1) and
+                           std::any_of(C2r_ptrs.begin(), C2r_ptrs.end(),
+                                       [](const double* ptr) { return ptr != nullptr; });
+        size_t nele_mirror = self_mirror ? nij_total * sh0 * sh1 : 0;
 
-        // fill the indices of sub virtuals
-        std::vector<std::vector<size_t>> sub_virt_mos; // relative virtual indices
-        size_t divisible = sv / nbatch;
-        size_t modulo = sv % nbatch;
-        for (size_t i = 0, start = 0; i < nbatch; ++i) {
-            size_t end;
-            if (i < modulo) {
-                end = start + (divisible + 1);
-            } else {
-                end = start + divisible;
-            }
+        // decide how to partition the virtual index:
+        // shared X2[ij|ye], per thread B[L|e] and H2[rs|ye] of a given r, and C2[ij|s]
+        size_t nvirt = virtual_batch_size(nij_total * sa, sL + sa * sh1, sL * sa + nij_max * sh1,
+                                          "AV", nele_mirror);
+        size_t nbatch = (sv + nvirt - 1) / nvirt;
 
-            std::vector<size_t> sub_virt;
-            for (size_t i = start; i < end; ++i) {
-                sub_virt.push_back(i);
-            }
-            sub_virt_mos.push_back(sub_virt);
-            start = end;
-        }
+        // memory usage
+        size_t nele_batch = nvirt * (nij_total * sa + num_threads_ * (sL + sa * sh1)) +
+                            num_threads_ * (sL * sa + nij_max * sh1) + nele_mirror;
+        std::pair<double, std::string> mem_use = to_xb(nele_batch, sizeof(double));
 
         // set timer
         start_ = std::chrono::system_clock::now();
@@ -3279,141 +3308,171 @@ void DSRG_MRPT3::V_T2_C2_DF_AV(BlockedTensor& B, BlockedTensor& T2, const double
                             C2label_g.c_str(), std::ctime(&tt1_));
         }
 
-        // loop over partitioned virtual index
-        for (const auto& virt_mo_sub : sub_virt_mos) {
-            size_t sv_sub = virt_mo_sub.size();
-
-            // contracted indices: av
-            ambit::Tensor H2 = ambit::Tensor::build(tensor_type_, "H2 av", {sh0, sh1, sa, sv_sub});
-
-            // block labels of B
-            std::string Blabel0{'L', h2a, h0};
-            std::string Blabel1{'L', h3v, h1};
-
-            if (nbatch != 1) {
-                ambit::Tensor Bs = ambit::Tensor::build(tensor_type_, "B1 av", {sL, sv_sub, sh1});
-                Bs.iterate([&](const std::vector<size_t>& i, double& value) {
-                    size_t idx = i[0] * sv * sh1 + virt_mo_sub[i[1]] * sh1 + i[2];
-                    value = B.block(Blabel1).data()[idx];
-                });
-
-                H2("rsue") = B.block(Blabel0)("gur") * Bs("ges");
+        // shared intermediates X2[ij|ye] (av) or X2[ij|ey] (va) of a virtual batch
+        std::vector<double> X2(nvirt * nij_total * sa);
 
-            } else {
-                H2("rsue") = B.block(Blabel0)("gur") * B.block(Blabel1)("ges");
+        // increments of the C2[ij|rs] blocks that are their own mirror
+        std::vector<double> D2(nele_mirror, 0.0);
+        std::vector<double*> D2_ptrs(C2labels_hh.size(), nullptr);
+        if (self_mirror) {
+            for (size_t n = 0, offset = 0; n < C2labels_hh.size(); ++n) {
+                D2_ptrs[n] = D2.data() + offset;
+                offset += nij_blocks[n] * sh0 * sh1;
             }
+        }
 
-            // loop over "ij" indices of C2[ij|rs]
-            // the "ij" in C2[ij|rs] is the "ij" in T2[ij|ue]
-            for (const std::string& C2label_h : C2labels_hh) {
-
-                const char& t0 = C2label_h[0];
-                const char& t1 = C2label_h[1];
-                size_t st0 = label_to_spacemo_[t0].size();
-                size_t st1 = label_to_spacemo_[t1].size();
-
-                // make sure C2 has this block
-                std::string C2label{t0, t1, h0, h1};
-                if (!C2.is_block(C2label))
-                    continue;
+        // per thread intermediates, B[L|u] (av) or B[L|e] (va) of a given r
+        std::vector<std::vector<double>> Br(num_threads_,
+                                            std::vector<double>(sL * std::max(sa, nvirt))),
+            H2(num_threads_, std::vector<double>(nvirt * sa * sh1)),
+            Ct(num_threads_, std::vector<double>(nij_max * sh1));
+
+        // contracted indices: av, H2(rs|ue) = B(L|ur) * B(L|es)
+        double* B0 = B.block(std::string{'L', h2a, h0}).data().data();
+        double* B1 = B.block(std::string{'L', h3v, h1}).data().data();
+
+        for (size_t e0 = 0; e0 < sv; e0 += nvirt) {
+            size_t ne = std::min(nvirt, sv - e0);
+
+            // X2[ij|ye] = Eta1[xy] * T2[ij|xe] for e in this batch
+            for (size_t n = 0, offset = 0; n < C2labels_hh.size(); ++n) {
+                const std::string& C2label_h = C2labels_hh[n];
+                std::string T2label{C2label_h[0], C2label_h[1], h2a, h3v};
+                std::string D1label = isupper(C2label_h[0]) ? "AA" : "aa";
+                double* T2_data = T2.block(T2label).data().data();
+                double* D1_data = Eta1_.block(D1label).data().data();
+                double* X2_data = X2.data() + offset;
+
+#pragma omp parallel for num_threads(num_threads_)
+                for (size_t ij = 0; ij < nij_blocks[n]; ++ij) {
+                    C_DGEMM('T', 'N', sa, ne, sa, 1.0, D1_data, sa, T2_data + ij * sa * sv + e0,
+                            sv, 0.0, X2_data + ij * sa * ne, ne);
+                }
+                offset += nij_blocks[n] * sa * ne;
+            }
 
-                // labels of T2 and Eta
-                std::string T2label{t0, t1, h2a, h3v};
-                std::string D1label = "aa";
-                if (isupper(t0))
-                    D1label = "AA";
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+            for (size_t r = 0; r < sh0; ++r) {
+                int thread = omp_get_thread_num();
+                double* Br_data = Br[thread].data();
+                double* H2_data = H2[thread].data();
+                double* Ct_data = Ct[thread].data();
+
+                // B[L|u] of the given r
+                for (size_t g = 0; g < sL; ++g) {
+                    for (size_t u = 0; u < sa; ++u) {
+                        Br_data[g * sa + u] = B0[(g * sa + u) * sh0 + r];
+                    }
+                }
 
-                ambit::Tensor X2 =
-                    ambit::Tensor::build(tensor_type_, "T2s av * Eta1", {st0, st1, sa, sv_sub});
+                // H2[u|es] = B[L|u] * B(L|es)
+                C_DGEMM('T', 'N', sa, ne * sh1, sL, 1.0, Br_data, sa, B1 + e0 * sh1, sv * sh1,
+                        0.0, H2_data, ne * sh1);
 
-                if (nbatch != 1) {
-                    ambit::Tensor T2s =
-                        ambit::Tensor::build(tensor_type_, "T2s av", {st0, st1, sa, sv_sub});
-                    T2s.iterate([&](const std::vector<size_t>& i, double& value) {
-                        size_t idx =
-                            i[0] * st1 * sa * sv + i[1] * sa * sv + i[2] * sv + virt_mo_sub[i[3]];
-                        value = T2.block(T2label).data()[idx];
-                    });
+                for (size_t n = 0, offset = 0; n < C2labels_hh.size(); ++n) {
+                    size_t nij = nij_blocks[n];
+                    double* X2_data = X2.data() + offset;
+                    offset += nij * sa * ne;
 
-                    X2("ijye") = Eta1_.block(D1label)("xy") * T2s("ijxe");
+                    double* C2_data = C2_ptrs[n];
+                    double* C2r_data = C2r_ptrs[n];
+                    if (C2r_data == nullptr) {
+                        C_DGEMM('N', 'N', nij, sh1, sa * ne, alpha, X2_data, sa * ne, H2_data,
+                                sh1, 1.0, C2_data + r * sh1, sh0 * sh1);
+                        continue;
+                    }
+                    if (self_mirror) {
+                        C_DGEMM('N', 'N', nij, sh1, sa * ne, alpha, X2_data, sa * ne, H2_data,
+                                sh1, 1.0, D2_ptrs[n] + r * sh1, sh0 * sh1);
+                        continue;
+                    }
 
-                } else {
-                    X2("ijye") = Eta1_.block(D1label)("xy") * T2.block(T2label)("ijxe");
+                    // C2[ij|rs] and the column r of C2[ij|sr] are only touched by this thread
+                    C_DGEMM('N', 'N', nij, sh1, sa * ne, alpha, X2_data, sa * ne, H2_data, sh1,
+                            0.0, Ct_data, sh1);
+                    for (size_t ij = 0; ij < nij; ++ij) {
+                        for (size_t s = 0; s < sh1; ++s) {
+                            double value = Ct_data[ij * sh1 + s];
+                            C2_data[(ij * sh0 + r) * sh1 + s] += value;
+                            C2r_data[(ij * sh1 + s) * sh0 + r] -= value;
+                        }
+                    }
                 }
+            }
+        }
 
-                C2.block(C2label)("ijrs") += alpha * H2("rsye") * X2("ijye");
-
-                // if aa or bb spin, also consider va block
-                if (isupper(t0) || islower(t1)) {
-                    std::string C2label_r{t0, t1, h1, h0};
-                    if (C2.is_block(C2label_r)) {
-                        C2.block(C2label_r)("ijsr") -= alpha * H2("rsye") * X2("ijye");
+        // C2[ij|rs] += D2[ij|rs] - D2[ij|sr]
+        if (self_mirror) {
+            for (size_t n = 0; n < C2labels_hh.size(); ++n) {
+                if (C2r_ptrs[n] == nullptr)
+                    continue;
+                double* C2_data = C2_ptrs[n];
+                const double* D2_data = D2_ptrs[n];
+#pragma omp parallel for num_threads(num_threads_)
+                for (size_t ij = 0; ij < nij_blocks[n]; ++ij) {
+                    double* C2_ij = C2_data + ij * sh0 * sh1;
+                    const double* D2_ij = D2_data + ij * sh0 * sh1;
+                    for (size_t r = 0; r < sh0; ++r) {
+                        for (size_t s = 0; s < sh1; ++s) {
+                            C2_ij[r * sh1 + s] += D2_ij[r * sh1 + s] - D2_ij[s * sh0 + r];
+                        }
                     }
                 }
             }
+        }
 
-            // contracted indices: va (only alpha-beta spin)
-            if (islower(h0) && isupper(h1)) {
-
-                Blabel0 = std::string{'L', h2v, h0};
-                Blabel1 = std::string{'L', h3a, h1};
-
-                H2 = ambit::Tensor::build(tensor_type_, "H2 va", {sh0, sh1, sv_sub, sa});
-                if (nbatch != 1) {
-                    ambit::Tensor Bs =
-                        ambit::Tensor::build(tensor_type_, "B0 va", {sL, sv_sub, sh0});
-                    Bs.iterate([&](const std::vector<size_t>& i, double& value) {
-                        size_t idx = i[0] * sv * sh0 + virt_mo_sub[i[1]] * sh0 + i[2];
-                        value = B.block(Blabel0).data()[idx];
-                    });
-
-                    H2("rseu") = B.block(Blabel1)("gus") * Bs("ger");
-
-                } else {
-                    H2("rseu") = B.block(Blabel1)("gus") * B.block(Blabel0)("ger");
+        // contracted indices: va, H2(rs|eu) = B(L|er) * B(L|us) (only alpha-beta spin)
+        if (do_va) {
+            B0 = B.block(std::string{'L', h2v, h0}).data().data();
+            B1 = B.block(std::string{'L', h3a, h1}).data().data();
+
+            for (size_t e0 = 0; e0 < sv; e0 += nvirt) {
+                size_t ne = std::min(nvirt, sv - e0);
+
+                // X2[ij|ey] = Eta1[xy] * T2[ij|ex] for e in this batch
+                for (size_t n = 0, offset = 0; n < C2labels_hh.size(); ++n) {
+                    const std::string& C2label_h = C2labels_hh[n];
+                    std::string T2label{C2label_h[0], C2label_h[1], h2v, h3a};
+                    double* T2_data = T2.block(T2label).data().data();
+                    double* D1_data = Eta1_.block("AA").data().data();
+                    double* X2_data = X2.data() + offset;
+
+#pragma omp parallel for num_threads(num_threads_)
+                    for (size_t ij = 0; ij < nij_blocks[n]; ++ij) {
+                        C_DGEMM('N', 'N', ne, sa, sa, 1.0, T2_data + (ij * sv + e0) * sa, sa,
+                                D1_data, sa, 0.0, X2_data + ij * ne * sa, sa);
+                    }
+                    offset += nij_blocks[n] * ne * sa;
                 }
 
-                // loop over "ij" indices of C2[ij|rs]
-                // the "ij" in C2[ij|rs] is the "ij" in T2[ij|ue]
-                for (const std::string& C2label_h : C2labels_hh) {
-
-                    char t0 = C2label_h[0];
-                    char t1 = C2label_h[1];
-                    size_t st0 = label_to_spacemo_[t0].size();
-                    size_t st1 = label_to_spacemo_[t1].size();
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+                for (size_t r = 0; r < sh0; ++r) {
+                    int thread = omp_get_thread_num();
+                    double* Br_data = Br[thread].data();
+                    double* H2_data = H2[thread].data();
 
-                    // make sure C2 has this block
-                    std::string C2label{t0, t1, h0, h1};
-                    if (!C2.is_block(C2label))
-                        continue;
-
-                    // labels of T2 and Eta
-                    std::string T2label{t0, t1, h2v, h3a};
-                    std::string D1label = "AA";
+                    // B[L|e] of the given r
+                    for (size_t g = 0; g < sL; ++g) {
+                        for (size_t e = 0; e < ne; ++e) {
+                            Br_data[g * ne + e] = B0[(g * sv + e0 + e) * sh0 + r];
+                        }
+                    }
 
-                    ambit::Tensor X2 =
-                        ambit::Tensor::build(tensor_type_, "T2s av * Eta1", {st0, st1, sv_sub, sa});
-                    if (nbatch != 1) {
-                        ambit::Tensor T2s =
-                            ambit::Tensor::build(tensor_type_, "T2s va", {st0, st1, sv_sub, sa});
-                        T2s.iterate([&](const std::vector<size_t>& i, double& value) {
-                            size_t idx = i[0] * st1 * sa * sv + i[1] * sa * sv +
-                                         virt_mo_sub[i[2]] * sa + i[3];
-                            value = T2.block(T2label).data()[idx];
-                        });
+                    // H2[e|us] = B[L|e] * B(L|us)
+                    C_DGEMM('T', 'N', ne, sa * sh1, sL, 1.0, Br_data, ne, B1, sa * sh1, 0.0,
+                            H2_data, sa * sh1);
 
-                        X2("ijey") = Eta1_.block(D1label)("xy") * T2s("ijex");
+                    for (size_t n = 0, offset = 0; n < C2labels_hh.size(); ++n) {
+                        size_t nij = nij_blocks[n];
+                        double* X2_data = X2.data() + offset;
+                        offset += nij * ne * sa;
 
-                    } else {
-                        X2("ijey") = Eta1_.block(D1label)("xy") * T2.block(T2label)("ijex");
+                        C_DGEMM('N', 'N', nij, sh1, ne * sa, alpha, X2_data, ne * sa, H2_data,
+                                sh1, 1.0, C2_ptrs[n] + r * sh1, sh0 * sh1);
                     }
-
-                    C2.block(C2label)("ijrs") += alpha * H2("rsey") * X2("ijey");
                 }
-
-            } // end loop va block
-
-        } // end loop sub_virt_mos
+            }
+        }
 
         end_ = std::chrono::system_clock::now();
         tt2_ = std::chrono::system_clock::to_time_t(end_);
@@ -3431,6 +3490,8 @@ void DSRG_MRPT3::V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double
 
     size_t sv = virt_mos_.size();
     size_t sL = aux_mos_.size();
+    if (sv == 0)
+        return;
 
     // figure out unique HALF block labels of C2[ij|rs]
     std::vector<std::string> C2labels_half0;
@@ -3463,27 +3524,19 @@ void DSRG_MRPT3::V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double
         const char& h1 = C2label_g[1];
         size_t sh0 = label_to_spacemo_[h0].size();
         size_t sh1 = label_to_spacemo_[h1].size();
+        if (sh0 == 0 or sh1 == 0)
+            continue;
 
         // possible "ab" in H2(rs|ab): aa, av, va, and vv
-        char h2a = 'a';
-        char h3a = 'a';
-        char h2v = 'v';
-        char h3v = 'v';
-        if (isupper(h1))
-            h3a = 'A';
-        if (isupper(h0))
-            h2a = 'A';
-        if (isupper(h1))
-            h3v = 'V';
-        if (isupper(h0))
-            h2v = 'V';
+        char h2v = isupper(h0) ? 'V' : 'v';
+        char h3v = isupper(h1) ? 'V' : 'v';
 
         // figure out the real "ij" indices of C2[ij|rs]
         std::vector<std::string> hole_labels{"cc", "ca", "ac", "aa"};
-        if (isupper(h3a)) {
+        if (isupper(h3v)) {
             hole_labels = {"cC", "cA", "aC", "aA"};
         }
-        if (isupper(h2a)) {
+        if (isupper(h2v)) {
             hole_labels = {"CC", "CA", "AC", "AA"};
         }
         std::sort(hole_labels.begin(), hole_labels.end());
@@ -3492,94 +3545,30 @@ void DSRG_MRPT3::V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double
         std::set_intersection(hole_labels.begin(), hole_labels.end(), C2labels_half0.begin(),
                               C2labels_half0.end(), std::back_inserter(C2labels_hh));
 
-        // decide how to partition the virtual index
-        size_t sa = label_to_spacemo_['a'].size();
-        size_t sc = label_to_spacemo_['c'].size();
-        size_t shole = (sc > sa) ? sc : sa;
-
-        std::vector<std::vector<size_t>> sub_virt_mos0, sub_virt_mos1; // relative virtual indices
-        size_t nbatch0 = 1, nbatch1 = 1;
-        size_t total_ele = sv * sv * (sh0 * sh1 + shole * shole) + sL * sv * (sh1 + sh0);
-        size_t nele_batch = 2 * total_ele;
+        // data of C2[ij|rs] and T2[ij|ef]
+        std::vector<size_t> nij_blocks;
+        std::vector<double*> C2_ptrs, T2_ptrs;
+        for (const std::string& C2label_h : C2labels_hh) {
+            const char& t0 = C2label_h[0];
+            const char& t1 = C2label_h[1];
+            std::string C2label{t0, t1, h0, h1};
+            if (!C2.is_block(C2label))
+                continue;
 
-        while (nele_batch * sizeof(double) > static_cast<size_t>(0.95 * mem_total_)) {
-            nbatch0 += 1;
-            nele_batch = 2 * (sv * sv * (sh0 * sh1 + shole * shole) + sL * sv * (sh1 + sh0)) /
-                         nbatch0; // 2 for tensor resorting
+            nij_blocks.push_back(label_to_spacemo_[t0].size() * label_to_spacemo_[t1].size());
+            C2_ptrs.push_back(C2.block(C2label).data().data());
+            T2_ptrs.push_back(T2.block(std::string{t0, t1, h2v, h3v}).data().data());
         }
+        if (nij_blocks.empty())
+            continue;
 
-        // if sv > nbatch0, just separate the 1st virtual index
-        // otherwise we will separate the 2nd virtual index, and set nbatch0 = sv
-        if (sv > nbatch0) {
-
-            // 1st virtual index
-            size_t divisible = sv / nbatch0;
-            size_t modulo = sv % nbatch0;
-            for (size_t i = 0, start = 0; i < nbatch0; ++i) {
-                size_t end;
-                if (i < modulo) {
-                    end = start + (divisible + 1);
-                } else {
-                    end = start + divisible;
-                }
-
-                std::vector<size_t> sub0;
-                for (size_t i = start; i < end; ++i) {
-                    sub0.push_back(i);
-                }
-                sub_virt_mos0.push_back(sub0);
-                start = end;
-            }
-
-            // 2nd virtual index
-            std::vector<size_t> sub1;
-            for (size_t i = 0; i < sv; ++i) {
-                sub1.push_back(i);
-            }
-            sub_virt_mos1.push_back(sub1);
-
-        } else {
-
-            while (nbatch1 * sv < nbatch0) {
-                ++nbatch1;
-            }
-            nbatch0 = sv;
-
-            // if nbatch1 > sv, tensor is too large to be batched
-            if (nbatch1 > sv) {
-                outfile->Printf("\n    Not enough memory for batching tensor "
-                                "H2(%zu * %zu * %zu * %zu).",
-                                sh0, sh1, sv, sv);
-                throw psi::PSIEXCEPTION("Not enough memory for batching at "
-                                        "DSRG-MRPT3 V_T2_C2_DF_VV.");
-            }
-
-            // 1st virtual index
-            for (size_t i = 0; i < sv; ++i) {
-                sub_virt_mos0.push_back({i});
-            }
-
-            // 2nd virtual index
-            size_t divisible = sv / nbatch1;
-            size_t modulo = sv % nbatch1;
-            for (size_t i = 0, start = 0; i < nbatch1; ++i) {
-                size_t end;
-                if (i < modulo) {
-                    end = start + (divisible + 1);
-                } else {
-                    end = start + divisible;
-                }
-
-                std::vector<size_t> sub1;
-                for (size_t i = start; i < end; ++i) {
-                    sub1.push_back(i);
-                }
-                sub_virt_mos1.push_back(sub1);
-                start = end;
-            }
-        }
+        // decide how to partition the 1st virtual index:
+        // per thread B[L|e] and H2[rs|ef] of a given r
+        size_t nvirt = virtual_batch_size(0, sL + sv * sh1, 0, "VV");
+        size_t nbatch = (sv + nvirt - 1) / nvirt;
 
         // memory usage
+        size_t nele_batch = num_threads_ * nvirt * (sL + sv * sh1);
         std::pair<double, std::string> mem_use = to_xb(nele_batch, sizeof(double));
 
         // set timer
@@ -3587,84 +3576,41 @@ void DSRG_MRPT3::V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double
         tt1_ = std::chrono::system_clock::to_time_t(start_);
         outfile->Printf("\n    Computing [V, T2] DF -> C2 PP(VV) block %s in "
                         "batches (%zu, %.2f %s)",
-                        C2label_g.c_str(), nbatch0, mem_use.first, mem_use.second.c_str());
+                        C2label_g.c_str(), nbatch, mem_use.first, mem_use.second.c_str());
         if (profile_print_) {
             outfile->Printf("\n  [V, T2] DF -> C2 PP(VV) block %s started: %s", C2label_g.c_str(),
                             std::ctime(&tt1_));
         }
 
-        // block labels of B
-        std::string Blabel0{'L', h2v, h0};
-        std::string Blabel1{'L', h3v, h1};
-
-        // loop over the 1st partitioned virtual index
-        for (const auto& virt_mo_sub0 : sub_virt_mos0) {
-            size_t sv_sub0 = virt_mo_sub0.size();
-
-            // loop over the 2nd partitioned virtual index
-            for (const auto& virt_mo_sub1 : sub_virt_mos1) {
-                size_t sv_sub1 = virt_mo_sub1.size();
-
-                ambit::Tensor H2 =
-                    ambit::Tensor::build(tensor_type_, "H2 vv", {sh0, sh1, sv_sub0, sv_sub1});
-
-                if (nbatch0 != 1) {
-
-                    ambit::Tensor B0vv =
-                        ambit::Tensor::build(tensor_type_, "B0 vv", {sL, sv_sub0, sh0});
-                    B0vv.iterate([&](const std::vector<size_t>& i, double& value) {
-                        size_t idx = i[0] * sv * sh0 + virt_mo_sub0[i[1]] * sh0 + i[2];
-                        value = B.block(Blabel0).data()[idx];
-                    });
-
-                    if (nbatch1 != 1) {
+        // H2(rs|ef) = B(L|er) * B(L|fs)
+        double* B0 = B.block(std::string{'L', h2v, h0}).data().data();
+        double* B1 = B.block(std::string{'L', h3v, h1}).data().data();
 
-                        ambit::Tensor B1 =
-                            ambit::Tensor::build(tensor_type_, "B1 vv", {sL, sv_sub1, sh1});
-                        B1.iterate([&](const std::vector<size_t>& i, double& value) {
-                            size_t idx = i[0] * sv * sh1 + virt_mo_sub1[i[1]] * sh1 + i[2];
-                            value = B.block(Blabel1).data()[idx];
-                        });
+        // each thread owns the rows C2[ij|r*] of a given r
+#pragma omp parallel num_threads(num_threads_)
+        {
+            std::vector<double> Br(sL * nvirt), H2(nvirt * sv * sh1);
 
-                        H2("rsef") = B0vv("ger") * B1("gfs");
-                    } else {
+#pragma omp for schedule(dynamic)
+            for (size_t r = 0; r < sh0; ++r) {
+                for (size_t e0 = 0; e0 < sv; e0 += nvirt) {
+                    size_t ne = std::min(nvirt, sv - e0);
 
-                        H2("rsef") = B0vv("ger") * B.block(Blabel1)("gfs");
+                    // B[L|e] of the given r
+                    for (size_t g = 0; g < sL; ++g) {
+                        for (size_t e = 0; e < ne; ++e) {
+                            Br[g * ne + e] = B0[(g * sv + e0 + e) * sh0 + r];
+                        }
                     }
 
-                } else {
-                    H2("rsef") = B.block(Blabel0)("ger") * B.block(Blabel1)("gfs");
-                }
-
-                for (const std::string& C2label_h : C2labels_hh) {
+                    // H2[e|fs] = B[L|e] * B(L|fs)
+                    C_DGEMM('T', 'N', ne, sv * sh1, sL, 1.0, Br.data(), ne, B1, sv * sh1, 0.0,
+                            H2.data(), sv * sh1);
 
-                    const char& t0 = C2label_h[0];
-                    const char& t1 = C2label_h[1];
-                    size_t st0 = label_to_spacemo_[t0].size();
-                    size_t st1 = label_to_spacemo_[t1].size();
-
-                    // make sure C2 has this block
-                    std::string C2label{t0, t1, h0, h1};
-                    if (!C2.is_block(C2label))
-                        continue;
-
-                    // T2 block label
-                    std::string T2label{t0, t1, h2v, h3v};
-
-                    // get subset of T2 amplitudes
-                    if (nbatch0 != 1) {
-                        ambit::Tensor T2s = ambit::Tensor::build(tensor_type_, "T2s vv",
-                                                                 {st0, st1, sv_sub0, sv_sub1});
-                        T2s.iterate([&](const std::vector<size_t>& i, double& value) {
-                            size_t idx = i[0] * st1 * sv * sv + i[1] * sv * sv +
-                                         virt_mo_sub0[i[2]] * sv + virt_mo_sub1[i[3]];
-                            value = T2.block(T2label).data()[idx];
-                        });
-
-                        C2.block(C2label)("ijrs") += alpha * H2("rsef") * T2s("ijef");
-
-                    } else {
-                        C2.block(C2label)("ijrs") += alpha * H2("rsef") * T2.block(T2label)("ijef");
+                    // C2[ij|rs] += T2[ij|ef] * H2[ef|s], T2 is read in place
+                    for (size_t n = 0; n < nij_blocks.size(); ++n) {
+                        C_DGEMM('N', 'N', nij_blocks[n], sh1, ne * sv, alpha, T2_ptrs[n] + e0 * sv,
+                                sv * sv, H2.data(), sh1, 1.0, C2_ptrs[n] + r * sh1, sh0 * sh1);
                     }
                 }
             }
@@ -3681,6 +3627,39 @@ void DSRG_MRPT3::V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double
     }
 }
 
+size_t DSRG_MRPT3::virtual_batch_size(size_t nele_shared, size_t nele_thread, size_t nele_fixed,
+                                      const std::string& name, size_t nele_fixed_shared) {
+    size_t sv = virt_mos_.size();
+
+    // batch size set by the user
+    int nvirt_user = foptions_->get_int("DSRG_MRPT3_VIRT_BATCH");
+    if (nvirt_user > 0) {
+        return std::min(static_cast<size_t>(nvirt_user), sv);
+    }
+
+    // memory per virtual orbital in a batch and the batch-independent part
+    size_t mem_virt = sizeof(double) * (nele_shared + num_threads_ * nele_thread);
+    int64_t mem_avai =
+        static_cast<int64_t>(0.95 * mem_total_) -
+        static_cast<int64_t>(sizeof(double) * (num_threads_ * nele_fixed + nele_fixed_shared));
+
+    size_t nvirt = sv;
+    if (mem_virt != 0) {
+        nvirt = mem_avai > 0 ? static_cast<size_t>(mem_avai) / mem_virt : 0;
+    }
+
+    if (nvirt == 0) {
+        if (not foptions_->get_bool("IGNORE_MEMORY_WARNINGS")) {
+            outfile->Printf("\n    Not enough memory for batching virtual orbitals.");
+            throw psi::PSIEXCEPTION("Not enough memory for batching at DSRG-MRPT3 V_T2_C2_DF_" +
+                                    name + ".");
+        }
+        nvirt = 1;
+    }
+
+    return std::min(nvirt, sv);
+}
+
 void DSRG_MRPT3::V_T2_C2_DF_AH_EX(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
                                   BlockedTensor& C2,
                                   const std::vector<std::vector<std::string>>& qs,
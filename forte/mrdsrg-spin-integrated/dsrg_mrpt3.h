@@ -98,6 +98,8 @@ class DSRG_MRPT3 : public MASTER_DSRG {
 
     /// Total memory left
     int64_t mem_total_;
+    /// Number of threads used in batched contractions
+    int num_threads_;
 
     /// Fill up two-electron integrals
     void build_tei(BlockedTensor& V);
@@ -213,6 +215,11 @@ class DSRG_MRPT3 : public MASTER_DSRG {
     /// Compute two-body term of commutator [V, T2] (batch), particle-particle
     /// contraction when "ab" in T2 are virtuals
     void V_T2_C2_DF_VV(BlockedTensor& B, BlockedTensor& T2, const double& alpha, BlockedTensor& C2);
+    /// Number of virtual orbitals per batch that fits in the memory left, given the number of
+    /// elements per virtual orbital that are shared or per thread, the per-thread fixed part,
+    /// and the shared fixed part
+    size_t virtual_batch_size(size_t nele_shared, size_t nele_thread, size_t nele_fixed,
+                              const std::string& name, size_t nele_fixed_shared = 0);
     /// Compute two-body term of commutator [V, T2], particle-hole contraction
     /// (exchange part), contracted particle index is active
     void V_T2_C2_DF_AH_EX(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
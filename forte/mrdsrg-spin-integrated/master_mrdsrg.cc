@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cctype>
 #include <numeric>
 
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -275,6 +276,21 @@ void MASTER_DSRG::fill_Fdiag(BlockedTensor& F, std::vector<double>& Fa, std::vec
     });
 }
 
+std::vector<double> MASTER_DSRG::block_denominators(const std::string& block,
+                                                    const std::vector<double>& Fa,
+                                                    const std::vector<double>& Fb) {
+    std::vector<std::vector<double>> e;
+    for (char c : block) {
+        const auto& F = std::islower(c) ? Fa : Fb;
+        std::vector<double> ei;
+        for (size_t p : label_to_spacemo_[c]) {
+            ei.push_back(F[p]);
+        }
+        e.push_back(ei);
+    }
+    return compute_block_denominators(e);
+}
+
 void MASTER_DSRG::check_init_reference_energy() {
     outfile->Printf("\n    Checking reference energy ....................... ");
     double E = compute_reference_energy_from_ints(ints_);
@@ -269,6 +269,9 @@ class MASTER_DSRG : public DynamicCorrelationSolver {
     void build_fock_from_ints(std::shared_ptr<ForteIntegrals> ints);
     /// Fill in diagonal elements of Fock matrix to Fdiag
     void fill_Fdiag(BlockedTensor& F, std::vector<double>& Fa, std::vector<double>& Fb);
+    /// Energy denominators of a block (e.g., "cAvV") ordered like the block data
+    std::vector<double> block_denominators(const std::string& block, const std::vector<double>& Fa,
+                                           const std::vector<double>& Fb);
     /// Check orbitals if semicanonical
     bool check_semi_orbs();
     /// Checked results of each block of Fock matrix
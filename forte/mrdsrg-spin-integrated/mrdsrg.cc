@@ -181,6 +181,7 @@ void MRDSRG::print_options() {
         {"Restart amplitudes", restart_amps_},
         {"Sequential DSRG transformation", sequential_Hbar_},
         {"Omit blocks of >= 3 virtual indices", nivo_},
+        {"Single-precision DIIS vectors", diis_float_},
         {"Read amplitudes from current dir", read_amps_cwd_},
         {"Write amplitudes to current dir", dump_amps_cwd_}};
 
@@ -29,16 +29,16 @@
 #ifndef _mrdsrg_h_
 #define _mrdsrg_h_
 
+#include "mrdsrg-helper/dsrg_diis.h"
+#include "mrdsrg-helper/srg_ode_solver.h"
 #include "master_mrdsrg.h"
 
 using namespace ambit;
 
-namespace psi {
-class DIISManager;
-}
-
 namespace forte {
 
+class MRSRG_Print;
+
 class MRDSRG : public MASTER_DSRG {
     friend class MRSRG_ODEInt;
     friend class MRSRG_Print;
@@ -313,23 +313,14 @@ class MRDSRG : public MASTER_DSRG {
     //    void H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, const double& alpha, BlockedTensor&
     //    C2);
 
-    /// Copy T1 and T2 to a big vector for DIIS
-    std::vector<double> copy_amp_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                                      BlockedTensor& T2, const std::vector<std::string>& label2);
-    /// Compute number of elements of the big vector for DIIS
-    size_t vector_size_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                            BlockedTensor& T2, const std::vector<std::string>& label2);
-    /// Copy extrapolated values back to T1 and T2
-    void return_amp_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                         BlockedTensor& T2, const std::vector<std::string>& label2,
-                         const std::vector<double>& data);
-
-    /// Shared pointer of DIISManager object from Psi4
-    std::shared_ptr<psi::DIISManager> diis_manager_;
-    /// Amplitudes pointers
-    std::vector<double*> amp_ptrs_;
-    /// Residual pointers
-    std::vector<double*> res_ptrs_;
+    /// DIIS accelerator of T1 and T2
+    std::shared_ptr<DSRG_DIIS> diis_manager_;
+    /// T1 blocks stored in DIIS
+    std::vector<std::string> diis_blocks1() const;
+    /// T2 blocks stored in DIIS
+    std::vector<std::string> diis_blocks2() const;
+    /// Check that the DIIS history fits in memory, reduce or turn off DIIS otherwise
+    void check_diis_memory();
     /// Initialize DIISManager
     void diis_manager_init();
     /// Add entry for DIISManager
@@ -374,6 +365,10 @@ class MRDSRG : public MASTER_DSRG {
     double compute_energy_srgpt2();
     /// Time spent for each step
     double srg_time_;
+    /// Integrate the flow of x (Hbar0_ and tensors) from s = 0 using SRG_ODESolver
+    void integrate_srg_flow(std::vector<ambit::BlockedTensor> x,
+                            const SRG_ODESolver::rhs_type& rhs, MRSRG_Print& printer,
+                            const std::string& name, double end_time, double initial_step);
 
     /// Compute zero-body term of commutator [H1, G1]
     void H1_G1_C0(BlockedTensor& H1, BlockedTensor& G1, const double& alpha, double& C0);
@@ -419,6 +414,9 @@ class MRSRG_ODEInt {
   public:
     MRSRG_ODEInt(MRDSRG& mrdsrg_obj) : mrdsrg_obj_(mrdsrg_obj) {}
     void operator()(const odeint_state_type& x, odeint_state_type& dxdt, const double t);
+    /// Tensor form: x = {H1, H2}, dxds = {dH1/ds, dH2/ds}, and dE/ds
+    void operator()(std::vector<ambit::BlockedTensor>& x, std::vector<ambit::BlockedTensor>& dxds,
+                    double& dEds, const double t);
 
   protected:
     MRDSRG& mrdsrg_obj_;
@@ -430,11 +428,16 @@ class SRGPT2_ODEInt {
     SRGPT2_ODEInt(MRDSRG& mrdsrg_obj, std::string Hzero, bool relax_ref)
         : mrdsrg_obj_(mrdsrg_obj), relax_ref_(relax_ref), Hzero_(Hzero) {}
     void operator()(const odeint_state_type& x, odeint_state_type& dxdt, const double t);
+    /// Tensor form: x = {H1, H2} (+ {C1, C2} if relax_ref), dxds of the same shape, and dE/ds
+    void operator()(std::vector<ambit::BlockedTensor>& x, std::vector<ambit::BlockedTensor>& dxds,
+                    double& dEds, const double t);
 
   protected:
     MRDSRG& mrdsrg_obj_;
     bool relax_ref_;
     std::string Hzero_;
+    /// Derivative tensors used by the odeint interface
+    std::vector<ambit::BlockedTensor> dxds_;
 };
 
 /// The functor used to print in each ODE integration step
@@ -442,6 +445,7 @@ class MRSRG_Print {
   public:
     MRSRG_Print(MRDSRG& mrdsrg_obj) : mrdsrg_obj_(mrdsrg_obj) {}
     void operator()(const odeint_state_type& x, const double t);
+    void operator()(const double x0, const double t);
     std::vector<double> energies() { return energies_; }
 
   protected:
@@ -162,20 +162,10 @@ void MRDSRG::guess_t2_std(BlockedTensor& V, BlockedTensor& T2) {
         T2["IJCD"] = tempT2["IJAB"] * U_["DB"] * U_["CA"];
     }
 
-    T2.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-        if (std::fabs(value) > 1.0e-15) {
-            if ((spin[0] == AlphaSpin) && (spin[1] == AlphaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                        Fa_[i[2]] - Fa_[i[3]]);
-            } else if ((spin[0] == AlphaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                        Fa_[i[2]] - Fb_[i[3]]);
-            } else if ((spin[0] == BetaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                        Fb_[i[2]] - Fb_[i[3]]);
-            }
-        }
-    });
+    for (const std::string& block : T2.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, T2.block(block).data(), 1.0e-15);
+    }
 
     // transform back to non-canonical basis
     if (!semi_canonical_) {
@@ -220,20 +210,10 @@ void MRDSRG::guess_t2_std_df(BlockedTensor& B, BlockedTensor& T2) {
         T2["IJCD"] = tempT2["IJAB"] * U_["DB"] * U_["CA"];
     }
 
-    T2.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-        if (std::fabs(value) > 1.0e-15) {
-            if ((spin[0] == AlphaSpin) && (spin[1] == AlphaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                        Fa_[i[2]] - Fa_[i[3]]);
-            } else if ((spin[0] == AlphaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                        Fa_[i[2]] - Fb_[i[3]]);
-            } else if ((spin[0] == BetaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                        Fb_[i[2]] - Fb_[i[3]]);
-            }
-        }
-    });
+    for (const std::string& block : T2.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, T2.block(block).data(), 1.0e-15);
+    }
 
     // transform back to non-canonical basis
     if (!semi_canonical_) {
@@ -309,15 +289,10 @@ void MRDSRG::guess_t1_std(BlockedTensor& F, BlockedTensor& T2, BlockedTensor& T1
         T1["IA"] = tempT1["IA"];
     }
 
-    T1.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-        if (std::fabs(value) > 1.0e-15) {
-            if (spin[0] == AlphaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] - Fa_[i[1]]);
-            } else {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] - Fb_[i[1]]);
-            }
-        }
-    });
+    for (const std::string& block : T1.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, T1.block(block).data(), 1.0e-15);
+    }
 
     // transform back to non-canonical basis
     if (!semi_canonical_) {
@@ -672,19 +647,10 @@ void MRDSRG::update_t2_std() {
 
     timer t2("scale Hbar2 by renormalized denominator");
     // scale Hbar2 by renormalized denominator
-    DT2_.iterate(
-        [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-            if ((spin[0] == AlphaSpin) && (spin[1] == AlphaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                        Fa_[i[2]] - Fa_[i[3]]);
-            } else if ((spin[0] == AlphaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                        Fa_[i[2]] - Fb_[i[3]]);
-            } else if ((spin[0] == BetaSpin) && (spin[1] == BetaSpin)) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                        Fb_[i[2]] - Fb_[i[3]]);
-            }
-        });
+    for (const std::string& block : DT2_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, DT2_.block(block).data());
+    }
     t2.stop();
 
     // Step 2: work on T2 where Hbar2 is treated as intermediate
@@ -711,19 +677,10 @@ void MRDSRG::update_t2_std() {
 
     timer t6("scale T2 by delta exponential");
     // scale T2 by delta exponential
-    T2_.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin,
-                    double& value) {
-        if ((spin[0] == AlphaSpin) && (spin[1] == AlphaSpin)) {
-            value *=
-                dsrg_source_->compute_renormalized(Fa_[i[0]] + Fa_[i[1]] - Fa_[i[2]] - Fa_[i[3]]);
-        } else if ((spin[0] == AlphaSpin) && (spin[1] == BetaSpin)) {
-            value *=
-                dsrg_source_->compute_renormalized(Fa_[i[0]] + Fb_[i[1]] - Fa_[i[2]] - Fb_[i[3]]);
-        } else if ((spin[0] == BetaSpin) && (spin[1] == BetaSpin)) {
-            value *=
-                dsrg_source_->compute_renormalized(Fb_[i[0]] + Fb_[i[1]] - Fb_[i[2]] - Fb_[i[3]]);
-        }
-    });
+    for (const std::string& block : T2_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized(D, T2_.block(block).data());
+    }
     t6.stop();
 
     timer t7("minus the renormalized T2 from renormalized Hbar2");
@@ -819,14 +776,10 @@ void MRDSRG::update_t1_std() {
     DT1_["IA"] = Hbar1_["IA"];
 
     // scale Hbar1 by renormalized denominator
-    DT1_.iterate(
-        [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-            if (spin[0] == AlphaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] - Fa_[i[1]]);
-            } else {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] - Fb_[i[1]]);
-            }
-        });
+    for (const std::string& block : DT1_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, DT1_.block(block).data());
+    }
 
     // Step 2: work on T1 where Hbar1 is treated as intermediate
 
@@ -845,14 +798,10 @@ void MRDSRG::update_t1_std() {
     }
 
     // scale T1 by delta exponential
-    T1_.iterate(
-        [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-            if (spin[0] == AlphaSpin) {
-                value *= dsrg_source_->compute_renormalized(Fa_[i[0]] - Fa_[i[1]]);
-            } else {
-                value *= dsrg_source_->compute_renormalized(Fb_[i[0]] - Fb_[i[1]]);
-            }
-        });
+    for (const std::string& block : T1_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized(D, T1_.block(block).data());
+    }
 
     // minus the renormalized T1 from renormalized Hbar1
     DT1_["ia"] -= T1_["ia"];
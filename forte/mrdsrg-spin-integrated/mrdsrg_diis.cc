@@ -26,8 +26,7 @@
  * @END LICENSE
  */
 
-#include "psi4/libdiis/diismanager.h"
-#include "ambit/blocked_tensor.h"
+#include "psi4/libpsi4util/process.h"
 
 #include "mrdsrg.h"
 
@@ -35,177 +34,65 @@ using namespace psi;
 
 namespace forte {
 
-std::vector<double> MRDSRG::copy_amp_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                                          BlockedTensor& T2,
-                                          const std::vector<std::string>& label2) {
-    std::vector<double> out;
-
-    for (const auto& block : label1) {
-        out.insert(out.end(), T1.block(block).data().begin(), T1.block(block).data().end());
-    }
-    for (const auto& block : label2) {
-        out.insert(out.end(), T2.block(block).data().begin(), T2.block(block).data().end());
-    }
+std::vector<std::string> MRDSRG::diis_blocks1() const {
+    return {"ca", "cv", "av", "CA", "CV", "AV"};
+}
 
-    return out;
+std::vector<std::string> MRDSRG::diis_blocks2() const {
+    return {"ccaa", "ccav", "ccva", "ccvv", "caaa", "caav", "cava", "cavv", "acaa", "acav",
+            "acva", "acvv", "aaav", "aava", "aavv", "cCaA", "cCaV", "cCvA", "cCvV", "cAaA",
+            "cAaV", "cAvA", "cAvV", "aCaA", "aCaV", "aCvA", "aCvV", "aAaV", "aAvA", "aAvV",
+            "CCAA", "CCAV", "CCVA", "CCVV", "CAAA", "CAAV", "CAVA", "CAVV", "ACAA", "ACAV",
+            "ACVA", "ACVV", "AAAV", "AAVA", "AAVV"};
 }
 
-size_t MRDSRG::vector_size_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                                BlockedTensor& T2, const std::vector<std::string>& label2) {
-    size_t total_elements = 0;
-    for (const auto& block : label1) {
-        total_elements += T1.block(block).numel();
+void MRDSRG::check_diis_memory() {
+    // tensors already stored by MR-DSRG
+    size_t n_ele = 0;
+    for (const ambit::BlockedTensor* T : {&H_, &V_, &B_, &F_, &T1_, &T2_, &DT1_, &DT2_, &Hbar1_,
+                                          &Hbar2_, &O1_, &O2_, &C1_, &C2_, &Gamma1_, &Eta1_,
+                                          &Lambda2_, &Fock_}) {
+        n_ele += T->numel();
     }
-    for (const auto& block : label2) {
-        total_elements += T2.block(block).numel();
-    }
-    return total_elements;
-}
 
-void MRDSRG::return_amp_diis(BlockedTensor& T1, const std::vector<std::string>& label1,
-                             BlockedTensor& T2, const std::vector<std::string>& label2,
-                             const std::vector<double>& data) {
-    // test data
-    std::map<std::string, size_t> num_elements;
-    size_t total_elements = 0;
+    int64_t mem_avai = psi::Process::environment.get_memory() * 0.9;
+    DSRG_MEM dsrg_mem(mem_avai, {});
+    dsrg_mem.add_entry("Integrals, amplitudes, and Hbar", n_ele * sizeof(double));
 
-    for (const auto& block : label1) {
-        size_t numel = T1.block(block).numel();
-        num_elements[block] = total_elements;
-        total_elements += numel;
+    size_t vec_size = 0;
+    for (const std::string& block : diis_blocks1()) {
+        vec_size += T1_.block(block).numel();
     }
-    for (const auto& block : label2) {
-        size_t numel = T2.block(block).numel();
-        num_elements[block] = total_elements;
-        total_elements += numel;
-    }
-
-    if (data.size() != total_elements) {
-        throw psi::PSIEXCEPTION("Number of elements in T1 and T2 do not match the bid data vector");
+    for (const std::string& block : diis_blocks2()) {
+        vec_size += T2_.block(block).numel();
     }
 
-    // transfer data
-    for (const auto& block : label1) {
-        std::vector<double>::const_iterator start = data.begin() + num_elements[block];
-        std::vector<double>::const_iterator end = start + T1.block(block).numel();
-        std::vector<double> T1_this_block(start, end);
-        T1.block(block).data() = T1_this_block;
-    }
-    for (const auto& block : label2) {
-        std::vector<double>::const_iterator start = data.begin() + num_elements[block];
-        std::vector<double>::const_iterator end = start + T2.block(block).numel();
-        std::vector<double> T2_this_block(start, end);
-        T2.block(block).data() = T2_this_block;
+    int nvec = add_diis_memory_entry(dsrg_mem, vec_size, diis_max_vec_, diis_min_vec_, diis_float_);
+    if (nvec == 0) {
+        diis_start_ = 0;
+        warnings_.push_back(std::make_tuple("DIIS history does not fit in memory",
+                                            "Turn off DIIS", "Increase memory"));
+    } else if (nvec < diis_max_vec_) {
+        diis_max_vec_ = nvec;
+        warnings_.push_back(std::make_tuple("DIIS history does not fit in memory",
+                                            "Reduce DSRG_DIIS_MAX_VEC", "Increase memory"));
     }
 }
 
 void MRDSRG::diis_manager_init() {
-    diis_manager_ = std::make_shared<DIISManager>(diis_max_vec_, "MRDSRG DIIS",
-                                                  DIISManager::LargestError, DIISManager::OnDisk);
-
-    amp_ptrs_.clear();
-    res_ptrs_.clear();
-
-    std::vector<std::string> blocks{
-        "ca",   "cv",   "av",   "CA",   "CV",   "AV",   "ccaa", "ccav", "ccva", "ccvv", "caaa",
-        "caav", "cava", "cavv", "acaa", "acav", "acva", "acvv", "aaav", "aava", "aavv", "cCaA",
-        "cCaV", "cCvA", "cCvV", "cAaA", "cAaV", "cAvA", "cAvV", "aCaA", "aCaV", "aCvA", "aCvV",
-        "aAaV", "aAvA", "aAvV", "CCAA", "CCAV", "CCVA", "CCVV", "CAAA", "CAAV", "CAVA", "CAVV",
-        "ACAA", "ACAV", "ACVA", "ACVV", "AAAV", "AAVA", "AAVV"};
-
-    std::vector<size_t> sizes(51);
-    for (int i = 0; i < 51; ++i) {
-        auto block = blocks[i];
-        if (block.size() == 2) {
-            sizes[i] = T1_.block(block).numel();
-            amp_ptrs_.push_back(T1_.block(block).data().data());
-            res_ptrs_.push_back(DT1_.block(block).data().data());
-        } else {
-            sizes[i] = T2_.block(block).numel();
-            amp_ptrs_.push_back(T2_.block(block).data().data());
-            res_ptrs_.push_back(DT2_.block(block).data().data());
-        }
+    check_diis_memory();
+    if (diis_start_ <= 0) {
+        return;
     }
 
-    diis_manager_->set_error_vector_size(
-        51, DIISEntry::Pointer, sizes[0], DIISEntry::Pointer, sizes[1], DIISEntry::Pointer,
-        sizes[2], DIISEntry::Pointer, sizes[3], DIISEntry::Pointer, sizes[4], DIISEntry::Pointer,
-        sizes[5], DIISEntry::Pointer, sizes[6], DIISEntry::Pointer, sizes[7], DIISEntry::Pointer,
-        sizes[8], DIISEntry::Pointer, sizes[9], DIISEntry::Pointer, sizes[10], DIISEntry::Pointer,
-        sizes[11], DIISEntry::Pointer, sizes[12], DIISEntry::Pointer, sizes[13], DIISEntry::Pointer,
-        sizes[14], DIISEntry::Pointer, sizes[15], DIISEntry::Pointer, sizes[16], DIISEntry::Pointer,
-        sizes[17], DIISEntry::Pointer, sizes[18], DIISEntry::Pointer, sizes[19], DIISEntry::Pointer,
-        sizes[20], DIISEntry::Pointer, sizes[21], DIISEntry::Pointer, sizes[22], DIISEntry::Pointer,
-        sizes[23], DIISEntry::Pointer, sizes[24], DIISEntry::Pointer, sizes[25], DIISEntry::Pointer,
-        sizes[26], DIISEntry::Pointer, sizes[27], DIISEntry::Pointer, sizes[28], DIISEntry::Pointer,
-        sizes[29], DIISEntry::Pointer, sizes[30], DIISEntry::Pointer, sizes[31], DIISEntry::Pointer,
-        sizes[32], DIISEntry::Pointer, sizes[33], DIISEntry::Pointer, sizes[34], DIISEntry::Pointer,
-        sizes[35], DIISEntry::Pointer, sizes[36], DIISEntry::Pointer, sizes[37], DIISEntry::Pointer,
-        sizes[38], DIISEntry::Pointer, sizes[39], DIISEntry::Pointer, sizes[40], DIISEntry::Pointer,
-        sizes[41], DIISEntry::Pointer, sizes[42], DIISEntry::Pointer, sizes[43], DIISEntry::Pointer,
-        sizes[44], DIISEntry::Pointer, sizes[45], DIISEntry::Pointer, sizes[46], DIISEntry::Pointer,
-        sizes[47], DIISEntry::Pointer, sizes[48], DIISEntry::Pointer, sizes[49], DIISEntry::Pointer,
-        sizes[50]);
-
-    diis_manager_->set_vector_size(
-        51, DIISEntry::Pointer, sizes[0], DIISEntry::Pointer, sizes[1], DIISEntry::Pointer,
-        sizes[2], DIISEntry::Pointer, sizes[3], DIISEntry::Pointer, sizes[4], DIISEntry::Pointer,
-        sizes[5], DIISEntry::Pointer, sizes[6], DIISEntry::Pointer, sizes[7], DIISEntry::Pointer,
-        sizes[8], DIISEntry::Pointer, sizes[9], DIISEntry::Pointer, sizes[10], DIISEntry::Pointer,
-        sizes[11], DIISEntry::Pointer, sizes[12], DIISEntry::Pointer, sizes[13], DIISEntry::Pointer,
-        sizes[14], DIISEntry::Pointer, sizes[15], DIISEntry::Pointer, sizes[16], DIISEntry::Pointer,
-        sizes[17], DIISEntry::Pointer, sizes[18], DIISEntry::Pointer, sizes[19], DIISEntry::Pointer,
-        sizes[20], DIISEntry::Pointer, sizes[21], DIISEntry::Pointer, sizes[22], DIISEntry::Pointer,
-        sizes[23], DIISEntry::Pointer, sizes[24], DIISEntry::Pointer, sizes[25], DIISEntry::Pointer,
-        sizes[26], DIISEntry::Pointer, sizes[27], DIISEntry::Pointer, sizes[28], DIISEntry::Pointer,
-        sizes[29], DIISEntry::Pointer, sizes[30], DIISEntry::Pointer, sizes[31], DIISEntry::Pointer,
-        sizes[32], DIISEntry::Pointer, sizes[33], DIISEntry::Pointer, sizes[34], DIISEntry::Pointer,
-        sizes[35], DIISEntry::Pointer, sizes[36], DIISEntry::Pointer, sizes[37], DIISEntry::Pointer,
-        sizes[38], DIISEntry::Pointer, sizes[39], DIISEntry::Pointer, sizes[40], DIISEntry::Pointer,
-        sizes[41], DIISEntry::Pointer, sizes[42], DIISEntry::Pointer, sizes[43], DIISEntry::Pointer,
-        sizes[44], DIISEntry::Pointer, sizes[45], DIISEntry::Pointer, sizes[46], DIISEntry::Pointer,
-        sizes[47], DIISEntry::Pointer, sizes[48], DIISEntry::Pointer, sizes[49], DIISEntry::Pointer,
-        sizes[50]);
+    diis_manager_ = std::make_shared<DSRG_DIIS>(diis_max_vec_, diis_float_);
+    diis_manager_->add_blocks(T1_, DT1_, diis_blocks1());
+    diis_manager_->add_blocks(T2_, DT2_, diis_blocks2());
 }
 
-void MRDSRG::diis_manager_add_entry() {
-    diis_manager_->add_entry(
-        102, res_ptrs_[0], res_ptrs_[1], res_ptrs_[2], res_ptrs_[3], res_ptrs_[4], res_ptrs_[5],
-        res_ptrs_[6], res_ptrs_[7], res_ptrs_[8], res_ptrs_[9], res_ptrs_[10], res_ptrs_[11],
-        res_ptrs_[12], res_ptrs_[13], res_ptrs_[14], res_ptrs_[15], res_ptrs_[16], res_ptrs_[17],
-        res_ptrs_[18], res_ptrs_[19], res_ptrs_[20], res_ptrs_[21], res_ptrs_[22], res_ptrs_[23],
-        res_ptrs_[24], res_ptrs_[25], res_ptrs_[26], res_ptrs_[27], res_ptrs_[28], res_ptrs_[29],
-        res_ptrs_[30], res_ptrs_[31], res_ptrs_[32], res_ptrs_[33], res_ptrs_[34], res_ptrs_[35],
-        res_ptrs_[36], res_ptrs_[37], res_ptrs_[38], res_ptrs_[39], res_ptrs_[40], res_ptrs_[41],
-        res_ptrs_[42], res_ptrs_[43], res_ptrs_[44], res_ptrs_[45], res_ptrs_[46], res_ptrs_[47],
-        res_ptrs_[48], res_ptrs_[49], res_ptrs_[50], amp_ptrs_[0], amp_ptrs_[1], amp_ptrs_[2],
-        amp_ptrs_[3], amp_ptrs_[4], amp_ptrs_[5], amp_ptrs_[6], amp_ptrs_[7], amp_ptrs_[8],
-        amp_ptrs_[9], amp_ptrs_[10], amp_ptrs_[11], amp_ptrs_[12], amp_ptrs_[13], amp_ptrs_[14],
-        amp_ptrs_[15], amp_ptrs_[16], amp_ptrs_[17], amp_ptrs_[18], amp_ptrs_[19], amp_ptrs_[20],
-        amp_ptrs_[21], amp_ptrs_[22], amp_ptrs_[23], amp_ptrs_[24], amp_ptrs_[25], amp_ptrs_[26],
-        amp_ptrs_[27], amp_ptrs_[28], amp_ptrs_[29], amp_ptrs_[30], amp_ptrs_[31], amp_ptrs_[32],
-        amp_ptrs_[33], amp_ptrs_[34], amp_ptrs_[35], amp_ptrs_[36], amp_ptrs_[37], amp_ptrs_[38],
-        amp_ptrs_[39], amp_ptrs_[40], amp_ptrs_[41], amp_ptrs_[42], amp_ptrs_[43], amp_ptrs_[44],
-        amp_ptrs_[45], amp_ptrs_[46], amp_ptrs_[47], amp_ptrs_[48], amp_ptrs_[49], amp_ptrs_[50]);
-}
+void MRDSRG::diis_manager_add_entry() { diis_manager_->add_entry(); }
 
-void MRDSRG::diis_manager_extrapolate() {
-    diis_manager_->extrapolate(
-        51, amp_ptrs_[0], amp_ptrs_[1], amp_ptrs_[2], amp_ptrs_[3], amp_ptrs_[4], amp_ptrs_[5],
-        amp_ptrs_[6], amp_ptrs_[7], amp_ptrs_[8], amp_ptrs_[9], amp_ptrs_[10], amp_ptrs_[11],
-        amp_ptrs_[12], amp_ptrs_[13], amp_ptrs_[14], amp_ptrs_[15], amp_ptrs_[16], amp_ptrs_[17],
-        amp_ptrs_[18], amp_ptrs_[19], amp_ptrs_[20], amp_ptrs_[21], amp_ptrs_[22], amp_ptrs_[23],
-        amp_ptrs_[24], amp_ptrs_[25], amp_ptrs_[26], amp_ptrs_[27], amp_ptrs_[28], amp_ptrs_[29],
-        amp_ptrs_[30], amp_ptrs_[31], amp_ptrs_[32], amp_ptrs_[33], amp_ptrs_[34], amp_ptrs_[35],
-        amp_ptrs_[36], amp_ptrs_[37], amp_ptrs_[38], amp_ptrs_[39], amp_ptrs_[40], amp_ptrs_[41],
-        amp_ptrs_[42], amp_ptrs_[43], amp_ptrs_[44], amp_ptrs_[45], amp_ptrs_[46], amp_ptrs_[47],
-        amp_ptrs_[48], amp_ptrs_[49], amp_ptrs_[50]);
-}
+void MRDSRG::diis_manager_extrapolate() { diis_manager_->extrapolate(); }
 
-void MRDSRG::diis_manager_cleanup() {
-    amp_ptrs_.clear();
-    res_ptrs_.clear();
-    diis_manager_->reset_subspace();
-    diis_manager_->delete_diis_file();
-}
+void MRDSRG::diis_manager_cleanup() { diis_manager_.reset(); }
 } // namespace forte
@@ -30,6 +30,7 @@
 #include <chrono>
 
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include "base_classes/mo_space_info.h"
 #include "boost/format.hpp"
@@ -42,21 +43,13 @@ using namespace psi;
 
 namespace forte {
 
-void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxdt, const double) {
-    auto t_start = std::chrono::high_resolution_clock::now();
-
-    // a bunch of references to simplify the typing
-    double& Hbar0 = mrdsrg_obj_.Hbar0_;
-    ambit::BlockedTensor& Hbar1 = mrdsrg_obj_.Hbar1_;
-    ambit::BlockedTensor& Hbar2 = mrdsrg_obj_.Hbar2_;
+void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxdt, const double t) {
     ambit::BlockedTensor& C1 = mrdsrg_obj_.C1_;
     ambit::BlockedTensor& C2 = mrdsrg_obj_.C2_;
-    ambit::BlockedTensor& O1 = mrdsrg_obj_.O1_;
-    ambit::BlockedTensor& O2 = mrdsrg_obj_.O2_;
-    ambit::BlockedTensor& T1 = mrdsrg_obj_.T1_;
-    ambit::BlockedTensor& T2 = mrdsrg_obj_.T2_;
+    ambit::BlockedTensor& Hbar1 = mrdsrg_obj_.Hbar1_;
+    ambit::BlockedTensor& Hbar2 = mrdsrg_obj_.Hbar2_;
 
-    // Step 1: read from x
+    // read from x
     size_t nelement = 1;
     C1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
         value = x[nelement];
@@ -67,7 +60,39 @@ void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxd
         ++nelement;
     });
 
-    // Step 2: compute the flow generator
+    // compute the rhs into Hbar
+    std::vector<ambit::BlockedTensor> xt{C1, C2};
+    std::vector<ambit::BlockedTensor> dxdt_t{Hbar1, Hbar2};
+    operator()(xt, dxdt_t, dxdt[0], t);
+
+    // set values for the rhs of the ODE
+    nelement = 1;
+    Hbar1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
+        dxdt[nelement] = value;
+        ++nelement;
+    });
+    Hbar2.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
+        dxdt[nelement] = value;
+        ++nelement;
+    });
+}
+
+void MRSRG_ODEInt::operator()(std::vector<ambit::BlockedTensor>& x,
+                              std::vector<ambit::BlockedTensor>& dxds, double& dEds,
+                              const double) {
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    // a bunch of references to simplify the typing
+    ambit::BlockedTensor& C1 = x[0];
+    ambit::BlockedTensor& C2 = x[1];
+    ambit::BlockedTensor& Hbar1 = dxds[0];
+    ambit::BlockedTensor& Hbar2 = dxds[1];
+    ambit::BlockedTensor& O1 = mrdsrg_obj_.O1_;
+    ambit::BlockedTensor& O2 = mrdsrg_obj_.O2_;
+    ambit::BlockedTensor& T1 = mrdsrg_obj_.T1_;
+    ambit::BlockedTensor& T2 = mrdsrg_obj_.T2_;
+
+    // Step 1: compute the flow generator
 
     //     a) O1_ and O2_ are the diagonal part
     for (const auto& block : mrdsrg_obj_.diag_one_labels()) {
@@ -97,7 +122,7 @@ void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxd
     mrdsrg_obj_.H1_G2_C2(T1, O2, -1.0, Hbar2);
     mrdsrg_obj_.H2_G2_C2(O2, T2, 1.0, Hbar2);
 
-    //     d) copy Hbar1_ and Hbar2_ to T1_ and T2_, respectively
+    //     d) copy Hbar1 and Hbar2 to T1_ and T2_, respectively
     T1["pq"] = Hbar1["pq"];
     T1["PQ"] = Hbar1["PQ"];
 
@@ -105,13 +130,13 @@ void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxd
     T2["pQrS"] = Hbar2["pQrS"];
     T2["PQRS"] = Hbar2["PQRS"];
 
-    // Step 3: compute d[H(s)] / d(s) = -[H(s), eta(s)]
+    // Step 2: compute d[H(s)] / d(s) = -[H(s), eta(s)]
 
-    Hbar0 = 0.0;
-    mrdsrg_obj_.H1_G1_C0(C1, T1, -1.0, Hbar0);
-    mrdsrg_obj_.H1_G2_C0(C1, T2, -1.0, Hbar0);
-    mrdsrg_obj_.H1_G2_C0(T1, C2, 1.0, Hbar0);
-    mrdsrg_obj_.H2_G2_C0(C2, T2, -1.0, Hbar0);
+    dEds = 0.0;
+    mrdsrg_obj_.H1_G1_C0(C1, T1, -1.0, dEds);
+    mrdsrg_obj_.H1_G2_C0(C1, T2, -1.0, dEds);
+    mrdsrg_obj_.H1_G2_C0(T1, C2, 1.0, dEds);
+    mrdsrg_obj_.H2_G2_C0(C2, T2, -1.0, dEds);
 
     Hbar1.zero();
     mrdsrg_obj_.H1_G1_C1(C1, T1, -1.0, Hbar1);
@@ -124,33 +149,22 @@ void MRSRG_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxd
     mrdsrg_obj_.H1_G2_C2(T1, C2, 1.0, Hbar2);
     mrdsrg_obj_.H2_G2_C2(C2, T2, -1.0, Hbar2);
 
-    // Step 4: set values for the rhs of the ODE
-    dxdt[0] = Hbar0;
-
-    nelement = 1;
-    Hbar1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        dxdt[nelement] = value;
-        ++nelement;
-    });
-    Hbar2.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        dxdt[nelement] = value;
-        ++nelement;
-    });
-
     auto t_end = std::chrono::high_resolution_clock::now();
     auto t_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count();
     mrdsrg_obj_.srg_time_ += t_ms / 1000.0;
 }
 
-void MRSRG_Print::operator()(const odeint_state_type& x, const double t) {
+void MRSRG_Print::operator()(const odeint_state_type& x, const double t) { operator()(x[0], t); }
+
+void MRSRG_Print::operator()(const double x0, const double t) {
     double Ediff;
     size_t size = energies_.size();
     if (size == 0) {
         Ediff = 0.0;
     } else {
-        Ediff = x[0] - energies_.back();
+        Ediff = x0 - energies_.back();
     }
-    energies_.push_back(x[0]);
+    energies_.push_back(x0);
     ++size;
 
     // compute norms of off-diagonal Hbar
@@ -158,10 +172,44 @@ void MRSRG_Print::operator()(const odeint_state_type& x, const double t) {
     double Hbar2od = mrdsrg_obj_.Hbar2od_norm(mrdsrg_obj_.od_two_labels_hhpp());
 
     // print
-    outfile->Printf("\n    %5zu  %10.5f  %16.12f %10.3e  %10.3e %10.3e  %8.3f", size, t, x[0],
-                    Ediff, Hbar1od, Hbar2od, mrdsrg_obj_.srg_time_);
+    outfile->Printf("\n    %5zu  %10.5f  %16.12f %10.3e  %10.3e %10.3e  %8.3f", size, t, x0, Ediff,
+                    Hbar1od, Hbar2od, mrdsrg_obj_.srg_time_);
     mrdsrg_obj_.srg_time_ = 0.0;
-    mrdsrg_obj_.Hbar0_ = x[0];
+    mrdsrg_obj_.Hbar0_ = x0;
+}
+
+void MRDSRG::integrate_srg_flow(std::vector<ambit::BlockedTensor> x,
+                                const SRG_ODESolver::rhs_type& rhs, MRSRG_Print& printer,
+                                const std::string& name, double end_time, double initial_step) {
+    double absolute_error = foptions_->get_double("SRG_ODEINT_ABSERR");
+    double relative_error = foptions_->get_double("SRG_ODEINT_RELERR");
+    SRG_ODESolver solver(x, absolute_error, relative_error);
+
+    std::string chk_file = "forte.mrdsrg.spin." + name + ".srg.bin";
+    solver.set_checkpoint(chk_file, foptions_->get_int("SRG_CHECKPOINT_FREQ"));
+
+    double s = 0.0, ds = initial_step;
+    Hbar0_ = 0.0;
+    if (foptions_->get_bool("SRG_RESTART")) {
+        if (solver.read_checkpoint(s, ds, Hbar0_)) {
+            outfile->Printf("\n    Restart the flow from s = %.6f (%s).", s, chk_file.c_str());
+            if (s > end_time) {
+                throw psi::PSIEXCEPTION("SRG checkpoint " + chk_file + " is at s = " +
+                                        std::to_string(s) + ", beyond DSRG_S.");
+            }
+        } else {
+            outfile->Printf("\n    Checkpoint %s not found. Start the flow from s = 0.",
+                            chk_file.c_str());
+        }
+    }
+
+    double E = Hbar0_;
+    int nsteps =
+        solver.integrate(rhs, E, s, end_time, ds, [&](double t, double x0) { printer(x0, t); });
+    Hbar0_ = E;
+
+    psi::Process::environment.globals["SRG START S"] = s;
+    psi::Process::environment.globals["SRG ACCEPTED STEPS"] = nsteps;
 }
 
 double MRDSRG::compute_energy_lsrg2() {
@@ -202,48 +250,66 @@ double MRDSRG::compute_energy_lsrg2() {
     // initialize tensors
     Hbar1_ = BTF_->build(tensor_type_, "Hbar1", spin_cases({"gg"}));
     Hbar2_ = BTF_->build(tensor_type_, "Hbar2", spin_cases({"gggg"}));
-    C1_ = BTF_->build(tensor_type_, "C1", spin_cases({"gg"}));
-    C2_ = BTF_->build(tensor_type_, "C2", spin_cases({"gggg"}));
     O1_ = BTF_->build(tensor_type_, "O1", diag_one_labels());
     O2_ = BTF_->build(tensor_type_, "O2", diag_two_labels());
     T1_ = BTF_->build(tensor_type_, "T1", od_one_labels());
     T2_ = BTF_->build(tensor_type_, "T2", od_two_labels());
     BlockedTensor::set_expert_mode(true);
 
-    // set up ODE initial conditions
-    odeint_state_type x;
-    Hbar0_ = 0.0;
-    x.push_back(Hbar0_);
-
-    F_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        x.push_back(value);
-    });
-    V_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        x.push_back(value);
-    });
-
-    double absolute_error = foptions_->get_double("SRG_ODEINT_ABSERR");
-    double relative_error = foptions_->get_double("SRG_ODEINT_RELERR");
     srg_time_ = 0.0;
     MRSRG_ODEInt mrsrg_flow_computer(*this);
     MRSRG_Print mrsrg_printer(*this);
 
     // start iterations
-    if (srg_odeint == "FEHLBERG78") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_fehlberg78<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
-    } else if (srg_odeint == "CASHKARP") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_cash_karp54<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
-    } else if (srg_odeint == "DOPRI5") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_dopri5<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
+    if (srg_odeint == "TENSOR_DOPRI5") {
+        // the flow acts directly on Hbar1_ and Hbar2_ initialized to the bare Hamiltonian
+        Hbar1_["pq"] = F_["pq"];
+        Hbar1_["PQ"] = F_["PQ"];
+        Hbar2_["pqrs"] = V_["pqrs"];
+        Hbar2_["pQrS"] = V_["pQrS"];
+        Hbar2_["PQRS"] = V_["PQRS"];
+
+        auto rhs = [&](double s, double, std::vector<ambit::BlockedTensor>& x, double& dEds,
+                       std::vector<ambit::BlockedTensor>& dxds) {
+            mrsrg_flow_computer(x, dxds, dEds, s);
+        };
+        integrate_srg_flow({Hbar1_, Hbar2_}, rhs, mrsrg_printer, "lsrg2", end_time,
+                           initial_step);
+    } else {
+        C1_ = BTF_->build(tensor_type_, "C1", spin_cases({"gg"}));
+        C2_ = BTF_->build(tensor_type_, "C2", spin_cases({"gggg"}));
+
+        // set up ODE initial conditions
+        odeint_state_type x;
+        Hbar0_ = 0.0;
+        x.push_back(Hbar0_);
+
+        F_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
+            x.push_back(value);
+        });
+        V_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
+            x.push_back(value);
+        });
+
+        double absolute_error = foptions_->get_double("SRG_ODEINT_ABSERR");
+        double relative_error = foptions_->get_double("SRG_ODEINT_RELERR");
+
+        if (srg_odeint == "FEHLBERG78") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_fehlberg78<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        } else if (srg_odeint == "CASHKARP") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_cash_karp54<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        } else if (srg_odeint == "DOPRI5") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_dopri5<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        }
     }
 
     // print summary
@@ -260,19 +326,12 @@ double MRDSRG::compute_energy_lsrg2() {
     return Hbar0_;
 }
 
-void SRGPT2_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxdt, const double) {
-    auto t_start = std::chrono::high_resolution_clock::now();
-
-    // a bunch of references to simplify the typing
-    double& Hbar0 = mrdsrg_obj_.Hbar0_;
+void SRGPT2_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dxdt,
+                               const double t) {
     ambit::BlockedTensor& Hbar1 = mrdsrg_obj_.Hbar1_;
     ambit::BlockedTensor& Hbar2 = mrdsrg_obj_.Hbar2_;
-    ambit::BlockedTensor& O1 = mrdsrg_obj_.O1_;
-    ambit::BlockedTensor& O2 = mrdsrg_obj_.O2_;
-    ambit::BlockedTensor& T1 = mrdsrg_obj_.T1_;
-    ambit::BlockedTensor& T2 = mrdsrg_obj_.T2_;
 
-    // Step 1: read from x
+    // read from x
     size_t nelement = 1;
     Hbar1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
         value = x[nelement];
@@ -283,7 +342,47 @@ void SRGPT2_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dx
         ++nelement;
     });
 
-    // Step 2: compute first-order eta
+    // the rhs does not depend on C1 and C2
+    std::vector<ambit::BlockedTensor> xt{Hbar1, Hbar2};
+    if (relax_ref_) {
+        xt.push_back(mrdsrg_obj_.C1_);
+        xt.push_back(mrdsrg_obj_.C2_);
+    }
+
+    if (dxds_.empty()) {
+        for (auto& T : xt) {
+            dxds_.push_back(
+                ambit::BlockedTensor::build(mrdsrg_obj_.tensor_type_, "dxds", T.block_labels()));
+        }
+    }
+    operator()(xt, dxds_, dxdt[0], t);
+
+    // set values for the rhs of the ODE
+    nelement = 1;
+    for (auto& T : dxds_) {
+        T.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
+            dxdt[nelement] = value;
+            ++nelement;
+        });
+    }
+}
+
+void SRGPT2_ODEInt::operator()(std::vector<ambit::BlockedTensor>& x,
+                               std::vector<ambit::BlockedTensor>& dxds, double& dEds,
+                               const double) {
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    // a bunch of references to simplify the typing
+    ambit::BlockedTensor& Hbar1 = x[0];
+    ambit::BlockedTensor& Hbar2 = x[1];
+    ambit::BlockedTensor& dHbar1 = dxds[0];
+    ambit::BlockedTensor& dHbar2 = dxds[1];
+    ambit::BlockedTensor& O1 = mrdsrg_obj_.O1_;
+    ambit::BlockedTensor& O2 = mrdsrg_obj_.O2_;
+    ambit::BlockedTensor& T1 = mrdsrg_obj_.T1_;
+    ambit::BlockedTensor& T2 = mrdsrg_obj_.T2_;
+
+    // Step 1: compute first-order eta
     T1.zero();
     T2.zero();
     mrdsrg_obj_.H1_G1_C1(O1, Hbar1, 1.0, T1);
@@ -298,76 +397,43 @@ void SRGPT2_ODEInt::operator()(const odeint_state_type& x, odeint_state_type& dx
         mrdsrg_obj_.H2_G2_C2(O2, Hbar2, 1.0, T2);
     }
 
-    // Step 3: compute first-order d[H(s)] / d(s) = [eta(s), H(s)]
-    Hbar1.zero();
-    Hbar2.zero();
-    mrdsrg_obj_.H1_G1_C1(T1, O1, 1.0, Hbar1);
-    mrdsrg_obj_.H1_G2_C1(O1, T2, -1.0, Hbar1);
-    mrdsrg_obj_.H1_G2_C2(O1, T2, -1.0, Hbar2);
+    // Step 2: compute first-order d[H(s)] / d(s) = [eta(s), H(s)]
+    dHbar1.zero();
+    dHbar2.zero();
+    mrdsrg_obj_.H1_G1_C1(T1, O1, 1.0, dHbar1);
+    mrdsrg_obj_.H1_G2_C1(O1, T2, -1.0, dHbar1);
+    mrdsrg_obj_.H1_G2_C2(O1, T2, -1.0, dHbar2);
 
     if (Hzero_ == "FDIAG_VDIAG" || Hzero_ == "FDIAG_VACTV") {
-        mrdsrg_obj_.H1_G2_C1(T1, O2, 1.0, Hbar1);
-        mrdsrg_obj_.H2_G2_C1(T2, O2, 1.0, Hbar1);
+        mrdsrg_obj_.H1_G2_C1(T1, O2, 1.0, dHbar1);
+        mrdsrg_obj_.H2_G2_C1(T2, O2, 1.0, dHbar1);
 
-        mrdsrg_obj_.H1_G2_C2(T1, O2, 1.0, Hbar2);
-        mrdsrg_obj_.H2_G2_C2(T2, O2, 1.0, Hbar2);
+        mrdsrg_obj_.H1_G2_C2(T1, O2, 1.0, dHbar2);
+        mrdsrg_obj_.H2_G2_C2(T2, O2, 1.0, dHbar2);
     }
 
-    // Step 4: set values for the rhs of the ODE
-    nelement = 1;
-    Hbar1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        dxdt[nelement] = value;
-        ++nelement;
-    });
-    Hbar2.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        dxdt[nelement] = value;
-        ++nelement;
-    });
+    // Step 3: compute second-order energy
+    dEds = 0.0;
+    mrdsrg_obj_.H1_G1_C0(T1, Hbar1, 1.0, dEds);
+    mrdsrg_obj_.H1_G2_C0(T1, Hbar2, 1.0, dEds);
+    mrdsrg_obj_.H1_G2_C0(Hbar1, T2, -1.0, dEds);
+    mrdsrg_obj_.H2_G2_C0(T2, Hbar2, 1.0, dEds);
 
-    // Step 5: compute second-order energy
-    //      a) need to reset Hbar to first-order Hamiltonian
-    nelement = 1;
-    Hbar1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        value = x[nelement];
-        ++nelement;
-    });
-    Hbar2.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        value = x[nelement];
-        ++nelement;
-    });
-
-    //      b) compute 2nd-order energy
-    Hbar0 = 0.0;
-    mrdsrg_obj_.H1_G1_C0(T1, Hbar1, 1.0, Hbar0);
-    mrdsrg_obj_.H1_G2_C0(T1, Hbar2, 1.0, Hbar0);
-    mrdsrg_obj_.H1_G2_C0(Hbar1, T2, -1.0, Hbar0);
-    mrdsrg_obj_.H2_G2_C0(T2, Hbar2, 1.0, Hbar0);
-    dxdt[0] = Hbar0;
-
-    // Step 6: if relax reference
+    // Step 4: if relax reference
     if (relax_ref_) {
-        ambit::BlockedTensor& C1 = mrdsrg_obj_.C1_;
-        ambit::BlockedTensor& C2 = mrdsrg_obj_.C2_;
-
-        C1.zero();
-        mrdsrg_obj_.H1_G1_C1(T1, Hbar1, 1.0, C1);
-        mrdsrg_obj_.H1_G2_C1(T1, Hbar2, 1.0, C1);
-        mrdsrg_obj_.H1_G2_C1(Hbar1, T2, -1.0, C1);
-        mrdsrg_obj_.H2_G2_C1(T2, Hbar2, 1.0, C1);
-
-        C2.zero();
-        mrdsrg_obj_.H1_G2_C2(T1, Hbar2, 1.0, C2);
-        mrdsrg_obj_.H1_G2_C2(Hbar1, T2, -1.0, C2);
-        mrdsrg_obj_.H2_G2_C2(T2, Hbar2, 1.0, C2);
-
-        C1.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-            dxdt[nelement] = value;
-            ++nelement;
-        });
-        C2.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-            dxdt[nelement] = value;
-            ++nelement;
-        });
+        ambit::BlockedTensor& dC1 = dxds[2];
+        ambit::BlockedTensor& dC2 = dxds[3];
+
+        dC1.zero();
+        mrdsrg_obj_.H1_G1_C1(T1, Hbar1, 1.0, dC1);
+        mrdsrg_obj_.H1_G2_C1(T1, Hbar2, 1.0, dC1);
+        mrdsrg_obj_.H1_G2_C1(Hbar1, T2, -1.0, dC1);
+        mrdsrg_obj_.H2_G2_C1(T2, Hbar2, 1.0, dC1);
+
+        dC2.zero();
+        mrdsrg_obj_.H1_G2_C2(T1, Hbar2, 1.0, dC2);
+        mrdsrg_obj_.H1_G2_C2(Hbar1, T2, -1.0, dC2);
+        mrdsrg_obj_.H2_G2_C2(T2, Hbar2, 1.0, dC2);
     }
 
     auto t_end = std::chrono::high_resolution_clock::now();
@@ -446,11 +512,6 @@ double MRDSRG::compute_energy_srgpt2() {
         O2_["PQRS"] = V_["PQRS"];
     }
 
-    // set up ODE initial conditions
-    odeint_state_type x;
-    Hbar0_ = 0.0;
-    x.push_back(Hbar0_);
-
     // note that Hbar contains only non-diagonal part
     // so it is safe to do the following
     Hbar1_["pq"] = F_["pq"];
@@ -460,44 +521,60 @@ double MRDSRG::compute_energy_srgpt2() {
     Hbar2_["pQrS"] = V_["pQrS"];
     Hbar2_["PQRS"] = V_["PQRS"];
 
-    Hbar1_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        x.push_back(value);
-    });
-    Hbar2_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-        x.push_back(value);
-    });
-
+    std::vector<ambit::BlockedTensor> state{Hbar1_, Hbar2_};
     if (relax_ref) {
-        C1_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-            x.push_back(value);
-        });
-        C2_.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&, double& value) {
-            x.push_back(value);
-        });
+        state.push_back(C1_);
+        state.push_back(C2_);
     }
 
-    double absolute_error = foptions_->get_double("SRG_ODEINT_ABSERR");
-    double relative_error = foptions_->get_double("SRG_ODEINT_RELERR");
     srg_time_ = 0.0;
     SRGPT2_ODEInt mrsrg_flow_computer(*this, Hzero, relax_ref);
     MRSRG_Print mrsrg_printer(*this);
 
     // start iterations
-    if (srg_odeint == "FEHLBERG78") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_fehlberg78<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
-    } else if (srg_odeint == "CASHKARP") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_cash_karp54<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
-    } else if (srg_odeint == "DOPRI5") {
-        integrate_adaptive(make_controlled(absolute_error, relative_error,
-                                           runge_kutta_dopri5<odeint_state_type>()),
-                           mrsrg_flow_computer, x, start_time, end_time, initial_step,
-                           mrsrg_printer);
+    if (srg_odeint == "TENSOR_DOPRI5") {
+        auto rhs = [&](double s, double, std::vector<ambit::BlockedTensor>& x, double& dEds,
+                       std::vector<ambit::BlockedTensor>& dxds) {
+            mrsrg_flow_computer(x, dxds, dEds, s);
+        };
+        integrate_srg_flow(state, rhs, mrsrg_printer, "srgpt2", end_time, initial_step);
+    } else {
+        // set up ODE initial conditions
+        odeint_state_type x;
+        Hbar0_ = 0.0;
+        x.push_back(Hbar0_);
+
+        for (auto& T : state) {
+            T.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&,
+                          double& value) { x.push_back(value); });
+        }
+
+        double absolute_error = foptions_->get_double("SRG_ODEINT_ABSERR");
+        double relative_error = foptions_->get_double("SRG_ODEINT_RELERR");
+
+        if (srg_odeint == "FEHLBERG78") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_fehlberg78<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        } else if (srg_odeint == "CASHKARP") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_cash_karp54<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        } else if (srg_odeint == "DOPRI5") {
+            integrate_adaptive(make_controlled(absolute_error, relative_error,
+                                               runge_kutta_dopri5<odeint_state_type>()),
+                               mrsrg_flow_computer, x, start_time, end_time, initial_step,
+                               mrsrg_printer);
+        }
+
+        // copy the final state back to the tensors
+        size_t nelement = 1;
+        for (auto& T : state) {
+            T.iterate([&](const std::vector<size_t>&, const std::vector<SpinType>&,
+                          double& value) { value = x[nelement++]; });
+        }
     }
 
     // print summary
@@ -59,6 +59,7 @@
 #include "helpers/blockedtensorfactory.h"
 #include "helpers/printing.h"
 #include "helpers/timer.h"
+#include "integrals/three_index_prefetcher.h"
 #include "fci/fci_solver.h"
 #include "fci/fci_vector.h"
 #include "sci/fci_mo.h"
@@ -88,12 +89,8 @@ THREE_DSRG_MRPT2::THREE_DSRG_MRPT2(RDMs rdms, std::shared_ptr<SCFInfo> scf_info,
 
     num_threads_ = omp_get_max_threads();
     /// Get processor number
-    int nproc = 1;
-    int my_proc = 0;
-#ifdef HAVE_MPI
-    nproc = MPI::COMM_WORLD.Get_size();
-    my_proc = MPI::COMM_WORLD.Get_rank();
-#endif
+    int nproc, my_proc;
+    mpi_rank_size(my_proc, nproc);
 
     std::string title_thread = std::to_string(num_threads_) + " thread";
     if (num_threads_ > 1) {
@@ -129,12 +126,8 @@ THREE_DSRG_MRPT2::THREE_DSRG_MRPT2(RDMs rdms, std::shared_ptr<SCFInfo> scf_info,
 THREE_DSRG_MRPT2::~THREE_DSRG_MRPT2() { cleanup(); }
 
 void THREE_DSRG_MRPT2::startup() {
-    //    int nproc = 1;
-    int my_proc = 0;
-#ifdef HAVE_MPI
-    nproc = MPI::COMM_WORLD.Get_size();
-    my_proc = MPI::COMM_WORLD.Get_rank();
-#endif
+    int nproc, my_proc;
+    mpi_rank_size(my_proc, nproc);
 
     integral_type_ = ints_->integral_type();
     // GA_Sync();
@@ -233,23 +226,17 @@ void THREE_DSRG_MRPT2::startup() {
                 }
             });
 
-        RDelta1_.iterate(
-            [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-                if (spin[0] == AlphaSpin) {
-                    value = dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] - Fa_[i[1]]);
-                } else if (spin[0] == BetaSpin) {
-                    value = dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] - Fb_[i[1]]);
-                }
-            });
+        for (const std::string& block : RDelta1_.block_labels()) {
+            auto D = block_denominators(block, Fa_, Fb_);
+            auto& data = RDelta1_.block(block).data();
+            dsrg_source_->compute_renormalized_denominator(D.data(), data.data(), D.size());
+        }
 
-        RExp1_.iterate(
-            [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-                if (spin[0] == AlphaSpin) {
-                    value = dsrg_source_->compute_renormalized(Fa_[i[0]] - Fa_[i[1]]);
-                } else if (spin[0] == BetaSpin) {
-                    value = dsrg_source_->compute_renormalized(Fb_[i[0]] - Fb_[i[1]]);
-                }
-            });
+        for (const std::string& block : RExp1_.block_labels()) {
+            auto D = block_denominators(block, Fa_, Fb_);
+            auto& data = RExp1_.block(block).data();
+            dsrg_source_->compute_renormalized(D.data(), data.data(), D.size());
+        }
 
         // allocate memory for T1
         T1_ = BTF_->build(tensor_type_, "T1 Amplitudes", spin_cases({"hp"}));
@@ -294,6 +281,14 @@ void THREE_DSRG_MRPT2::startup() {
             }
         }
     }
+
+#ifdef HAVE_MPI
+    // the distributed energy terms need the orbital energies on every process
+    Fa_.resize(ncmo_);
+    Fb_.resize(ncmo_);
+    MPI_Bcast(Fa_.data(), ncmo_, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(Fb_.data(), ncmo_, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
 }
 
 void THREE_DSRG_MRPT2::print_options_summary() {
@@ -336,12 +331,8 @@ void THREE_DSRG_MRPT2::print_options_summary() {
 void THREE_DSRG_MRPT2::cleanup() {}
 
 double THREE_DSRG_MRPT2::compute_energy() {
-    int my_proc = 0;
-//    int nproc = 1;
-#ifdef HAVE_MPI
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_proc);
-    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
-#endif
+    int nproc, my_proc;
+    mpi_rank_size(my_proc, nproc);
 
     if (my_proc == 0) {
         // check semi-canonical orbitals
@@ -517,19 +508,10 @@ void THREE_DSRG_MRPT2::compute_t2() {
     T2_["ijab"] = V_["abij"];
     T2_["iJaB"] = V_["aBiJ"];
     T2_["IJAB"] = V_["ABIJ"];
-    T2_.iterate(
-        [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-            if (spin[0] == AlphaSpin && spin[1] == AlphaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                        Fa_[i[2]] - Fa_[i[3]]);
-            } else if (spin[0] == BetaSpin && spin[1] == BetaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                        Fb_[i[2]] - Fb_[i[3]]);
-            } else {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                        Fa_[i[2]] - Fb_[i[3]]);
-            }
-        });
+    for (const std::string& block : T2_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, T2_.block(block).data());
+    }
 
     // internal amplitudes (AA->AA)
     std::string internal_amp = foptions_->get_str("INTERNAL_AMP");
@@ -661,19 +643,10 @@ THREE_DSRG_MRPT2::compute_T2_minimal(const std::vector<std::string>& t2_spaces)
         outfile->Printf("\n Took %8.4f s to compute T2 from B", v_t2.get());
 
     local_timer t2_iterate;
-    T2min.iterate(
-        [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-            if (spin[0] == AlphaSpin && spin[1] == AlphaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                        Fa_[i[2]] - Fa_[i[3]]);
-            } else if (spin[0] == BetaSpin && spin[1] == BetaSpin) {
-                value *= dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                        Fb_[i[2]] - Fb_[i[3]]);
-            } else {
-                value *= dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                        Fa_[i[2]] - Fb_[i[3]]);
-            }
-        });
+    for (const std::string& block : T2min.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized_denominator(D, T2min.block(block).data());
+    }
     if (detail_time_)
         outfile->Printf("\n T2 iteration takes %8.4f s", t2_iterate.get());
 
@@ -810,19 +783,10 @@ ambit::BlockedTensor THREE_DSRG_MRPT2::compute_V_minimal(const std::vector<std::
 
     if (renormalize) {
         local_timer RenormV;
-        Vmin.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin,
-                         double& value) {
-            if ((spin[0] == AlphaSpin) and (spin[1] == AlphaSpin)) {
-                value = (value + value * dsrg_source_->compute_renormalized(Fa_[i[0]] + Fa_[i[1]] -
-                                                                            Fa_[i[2]] - Fa_[i[3]]));
-            } else if ((spin[0] == AlphaSpin) and (spin[1] == BetaSpin)) {
-                value = (value + value * dsrg_source_->compute_renormalized(Fa_[i[0]] + Fb_[i[1]] -
-                                                                            Fa_[i[2]] - Fb_[i[3]]));
-            } else if ((spin[0] == BetaSpin) and (spin[1] == BetaSpin)) {
-                value = (value + value * dsrg_source_->compute_renormalized(Fb_[i[0]] + Fb_[i[1]] -
-                                                                            Fb_[i[2]] - Fb_[i[3]]));
-            }
-        });
+        for (const std::string& block : Vmin.block_labels()) {
+            auto D = block_denominators(block, Fa_, Fb_);
+            dsrg_source_->scale_renormalized(D, Vmin.block(block).data(), 1.0);
+        }
         if (detail_time_) {
             outfile->Printf("\n  RenormalizeV takes %8.6f s.", RenormV.get());
         }
@@ -983,18 +947,10 @@ void THREE_DSRG_MRPT2::renormalize_V() {
     local_timer timer;
     outfile->Printf("\n    %-40s ...", "Renormalizing V");
 
-    V_.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-        if ((spin[0] == AlphaSpin) and (spin[1] == AlphaSpin)) {
-            value *= 1.0 + dsrg_source_->compute_renormalized(Fa_[i[0]] + Fa_[i[1]] - Fa_[i[2]] -
-                                                              Fa_[i[3]]);
-        } else if ((spin[0] == AlphaSpin) and (spin[1] == BetaSpin)) {
-            value *= 1.0 + dsrg_source_->compute_renormalized(Fa_[i[0]] + Fb_[i[1]] - Fa_[i[2]] -
-                                                              Fb_[i[3]]);
-        } else if ((spin[0] == BetaSpin) and (spin[1] == BetaSpin)) {
-            value *= 1.0 + dsrg_source_->compute_renormalized(Fb_[i[0]] + Fb_[i[1]] - Fb_[i[2]] -
-                                                              Fb_[i[3]]);
-        }
-    });
+    for (const std::string& block : V_.block_labels()) {
+        auto D = block_denominators(block, Fa_, Fb_);
+        dsrg_source_->scale_renormalized(D, V_.block(block).data(), 1.0);
+    }
 
     outfile->Printf("... Done. Timing %15.6f s", timer.get());
 }
@@ -1153,12 +1109,17 @@ double THREE_DSRG_MRPT2::E_FT2() {
 
 double THREE_DSRG_MRPT2::E_VT2_2() {
     double E = 0.0;
-    int my_proc = 0;
-#ifdef HAVE_MPI
-    my_proc = MPI::COMM_WORLD.Get_rank();
-#endif
+    int nproc, my_proc;
+    mpi_rank_size(my_proc, nproc);
     ambit::BlockedTensor temp = BTF_->build(tensor_type_, "temp", {"aa", "AA"});
     local_timer timer;
+
+    // the cavv and ccva terms are batched over core orbitals on all processes
+    double E_one_active = 0.0;
+    if (integral_type_ == DiskDF) {
+        E_one_active = E_VT2_2_one_active();
+    }
+
     if (my_proc == 0) {
         outfile->Printf("\n    %-40s ...", "Computing <[V, T2]> (C_2)^4 (no ccvv)");
         // TODO: Implement these without storing V and/or T2 by using blocking
@@ -1181,7 +1142,7 @@ double THREE_DSRG_MRPT2::E_VT2_2() {
             E += temp["VU"] * Eta1_["UV"];
             // outfile->Printf("\n E = V^{ve}_{mn} * T_{ue}^{mn}: %8.6f", E);
         } else {
-            E += E_VT2_2_one_active();
+            E += E_one_active;
         }
 
         /// These terms all have at least two active indices (assume can be store in core).
@@ -1258,32 +1219,28 @@ double THREE_DSRG_MRPT2::E_VT2_2() {
     } else if (ccvv_algorithm == "BATCH_CORE") {
         if (my_proc == 0)
             Eccvv = E_VT2_2_batch_core();
-    } else if (ccvv_algorithm == "BATCH_CORE_GA") {
-#ifdef HAVE_MPI
-        Eccvv = E_VT2_2_batch_core_ga();
-#endif
-    } else if (ccvv_algorithm == "BATCH_CORE_REP") {
-#ifdef HAVE_MPI
-        Eccvv = E_VT2_2_batch_core_rep();
-#endif
     } else if (ccvv_algorithm == "BATCH_CORE_MPI") {
-#ifdef HAVE_MPI
         Eccvv = E_VT2_2_batch_core_mpi();
-#endif
     } else if (ccvv_algorithm == "BATCH_VIRTUAL") {
         if (my_proc == 0)
             Eccvv = E_VT2_2_batch_virtual();
+    } else if (ccvv_algorithm == "BATCH_VIRTUAL_MPI") {
+        Eccvv = E_VT2_2_batch_virtual_mpi();
+#if defined(HAVE_MPI) && defined(HAVE_GA)
+    } else if (ccvv_algorithm == "BATCH_CORE_GA") {
+        Eccvv = E_VT2_2_batch_core_ga();
+    } else if (ccvv_algorithm == "BATCH_CORE_REP") {
+        Eccvv = E_VT2_2_batch_core_rep();
     } else if (ccvv_algorithm == "BATCH_VIRTUAL_GA") {
-#ifdef HAVE_MPI
         Eccvv = E_VT2_2_batch_virtual_ga();
-#endif
     } else if (ccvv_algorithm == "BATCH_VIRTUAL_REP") {
-#ifdef HAVE_MPI
         Eccvv = E_VT2_2_batch_virtual_rep();
-#endif
-    } else if (ccvv_algorithm == "BATCH_VIRTUAL_MPI") {
-#ifdef HAVE_MPI
-        Eccvv = E_VT2_2_batch_virtual_mpi();
+#else
+    } else if (ccvv_algorithm == "BATCH_CORE_GA" || ccvv_algorithm == "BATCH_CORE_REP" ||
+               ccvv_algorithm == "BATCH_VIRTUAL_GA" || ccvv_algorithm == "BATCH_VIRTUAL_REP") {
+        throw psi::PSIEXCEPTION("CCVV_ALGORITHM " + ccvv_algorithm +
+                                " requires MPI and Global Arrays. Use BATCH_CORE_MPI or "
+                                "BATCH_VIRTUAL_MPI instead.");
 #endif
     } else {
         outfile->Printf("\n Specify a correct algorithm string");
@@ -2029,7 +1986,9 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_core() {
     outfile->Printf("\n\n====Blocking information==========\n");
     size_t int_mem_int = (nthree_ * ncore_ * nvirtual_) * sizeof(double);
     size_t memory_input = psi::Process::environment.get_memory() * 0.75;
-    size_t num_block = int_mem_int / memory_input < 1 ? 1 : int_mem_int / memory_input;
+    // BmQe, BnQf, the block being resorted, and the block being prefetched
+    size_t num_block = std::max((4 * int_mem_int + memory_input - 1) / memory_input, size_t(1));
+    num_block = std::min(num_block, std::max(ncore_, size_t(1)));
 
     if (foptions_->get_int("CCVV_BATCH_NUMBER") != -1) {
         num_block = foptions_->get_int("CCVV_BATCH_NUMBER");
@@ -2074,30 +2033,32 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_core() {
     }
 
     // Step 2:  Loop over memory allowed blocks of m and n
-    // Get batch sizes and create vectors of mblock length
+    // The last block also takes the remainder of ncore_ / num_block
+    std::vector<std::vector<size_t>> blocks(num_block);
+    for (size_t b = 0; b < num_block; ++b) {
+        size_t start = b * block_size;
+        size_t end = (b == num_block - 1) ? ncore_ : start + block_size;
+        blocks[b].assign(core_mos_.begin() + start, core_mos_.begin() + end);
+    }
+
+    // Blocks are read in the order they are used: the next one is read in the background
+    // while the current pair of blocks is contracted
+    std::vector<ThreeIndexPrefetcher::Request> requests;
     for (size_t m_blocks = 0; m_blocks < num_block; m_blocks++) {
-        std::vector<size_t> m_batch;
-        // If core_ goes into num_block equally, all blocks are equal
-        if (ncore_ % num_block == 0) {
-            // Fill the mbatch from block_begin to block_end
-            // This is done so I can pass a block to IntegralsAPI to read a
-            // chunk
-            m_batch.resize(block_size);
-            // copy used to get correct indices for B.
-            std::copy(core_mos_.begin() + (m_blocks * block_size),
-                      core_mos_.begin() + ((m_blocks + 1) * block_size), m_batch.begin());
-        } else {
-            // If last_block is shorter or long, fill the rest
-            size_t gimp_block_size =
-                m_blocks == (num_block - 1) ? block_size + ncore_ % num_block : block_size;
-            m_batch.resize(gimp_block_size);
-            // std::iota(m_batch.begin(), m_batch.end(), m_blocks * (core_ /
-            // num_block));
-            std::copy(core_mos_.begin() + (m_blocks)*block_size,
-                      core_mos_.begin() + (m_blocks)*block_size + gimp_block_size, m_batch.begin());
+        requests.emplace_back(blocks[m_blocks], virt_mos_);
+        for (size_t n_blocks = 0; n_blocks < m_blocks; n_blocks++) {
+            requests.emplace_back(blocks[n_blocks], virt_mos_);
         }
+    }
+    ThreeIndexPrefetcher prefetcher(ints_, aux_mos_, requests,
+                                    foptions_->get_bool("DSRG_DISKDF_PREFETCH"));
+    double compute_time = 0.0;
+
+    for (size_t m_blocks = 0; m_blocks < num_block; m_blocks++) {
+        const std::vector<size_t>& m_batch = blocks[m_blocks];
 
-        ambit::Tensor B = ints_->three_integral_block(aux_mos_, m_batch, virt_mos_);
+        ambit::Tensor B = prefetcher.next();
+        double io_wait = prefetcher.last_wait();
         ambit::Tensor BmQe =
             ambit::Tensor::build(tensor_type_, "BmQE", {m_batch.size(), nthree_, nvirtual_});
         BmQe("mQe") = B("Qme");
@@ -2118,29 +2079,14 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_core() {
         }
 
         for (size_t n_blocks = 0; n_blocks <= m_blocks; n_blocks++) {
-            std::vector<size_t> n_batch;
-            // If core_ goes into num_block equally, all blocks are equal
-            if (ncore_ % num_block == 0) {
-                // Fill the mbatch from block_begin to block_end
-                // This is done so I can pass a block to IntegralsAPI to read a chunk
-                n_batch.resize(block_size);
-                std::copy(core_mos_.begin() + n_blocks * block_size,
-                          core_mos_.begin() + ((n_blocks + 1) * block_size), n_batch.begin());
-            } else {
-                // If last_block is longer, block_size + remainder
-                size_t gimp_block_size =
-                    n_blocks == (num_block - 1) ? block_size + ncore_ % num_block : block_size;
-                n_batch.resize(gimp_block_size);
-                std::copy(core_mos_.begin() + (n_blocks)*block_size,
-                          core_mos_.begin() + (n_blocks * block_size) + gimp_block_size,
-                          n_batch.begin());
-            }
+            const std::vector<size_t>& n_batch = blocks[n_blocks];
             ambit::Tensor BnQf =
                 ambit::Tensor::build(tensor_type_, "BnQf", {n_batch.size(), nthree_, nvirtual_});
             if (n_blocks == m_blocks) {
                 BnQf.copy(BmQe);
             } else {
-                ambit::Tensor B = ints_->three_integral_block(aux_mos_, n_batch, virt_mos_);
+                ambit::Tensor B = prefetcher.next();
+                io_wait += prefetcher.last_wait();
                 BnQf("mQe") = B("Qme");
                 B.reset();
             }
@@ -2236,10 +2182,16 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_core() {
                                     m, n, Ealpha, Emixed, Ealpha + Emixed);
                 }
             }
-            outfile->Printf("\n Batch_core loop per Mbatch: %d and Nbatch: %d takes %8.8f",
-                            m_blocks, n_blocks, Core_Loop.get());
+            double loop_time = Core_Loop.get();
+            compute_time += loop_time;
+            outfile->Printf("\n Batch_core loop per Mbatch: %d and Nbatch: %d takes %8.8f"
+                            " (I/O wait %8.8f)",
+                            m_blocks, n_blocks, loop_time, io_wait);
+            io_wait = 0.0;
         }
     }
+    outfile->Printf("\n  Batch_core I/O wait: %.3f s, read: %.3f s, compute: %.3f s",
+                    prefetcher.total_wait(), prefetcher.total_read(), compute_time);
     // return (Ealpha + Ebeta + Emixed);
     return (Ealpha + Ebeta + Emixed);
 }
@@ -2382,7 +2334,9 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_virtual() {
     outfile->Printf("\n\n====Blocking information==========\n");
     size_t int_mem_int = (nthree_ * ncore_ * nvirtual_) * sizeof(double);
     size_t memory_input = psi::Process::environment.get_memory() * 0.75;
-    size_t num_block = int_mem_int / memory_input < 1 ? 1 : int_mem_int / memory_input;
+    // BeQm, BfQn, the block being resorted, and the block being prefetched
+    size_t num_block = std::max((4 * int_mem_int + memory_input - 1) / memory_input, size_t(1));
+    num_block = std::min(num_block, std::max(nvirtual_, size_t(1)));
 
     if (foptions_->get_int("CCVV_BATCH_NUMBER") != -1) {
         num_block = foptions_->get_int("CCVV_BATCH_NUMBER");
@@ -2426,31 +2380,33 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_virtual() {
         RDVec.push_back(ambit::Tensor::build(tensor_type_, "RDVec", {ncore_, ncore_}));
     }
 
-    // Step 2:  Loop over memory allowed blocks of m and n
-    // Get batch sizes and create vectors of mblock length
+    // Step 2:  Loop over memory allowed blocks of e and f
+    // The last block also takes the remainder of nvirtual_ / num_block
+    std::vector<std::vector<size_t>> blocks(num_block);
+    for (size_t b = 0; b < num_block; ++b) {
+        size_t start = b * block_size;
+        size_t end = (b == num_block - 1) ? nvirtual_ : start + block_size;
+        blocks[b].assign(virt_mos_.begin() + start, virt_mos_.begin() + end);
+    }
+
+    // Blocks are read in the order they are used: the next one is read in the background
+    // while the current pair of blocks is contracted
+    std::vector<ThreeIndexPrefetcher::Request> requests;
     for (size_t e_blocks = 0; e_blocks < num_block; e_blocks++) {
-        std::vector<size_t> e_batch;
-        // If core_ goes into num_block equally, all blocks are equal
-        if (nvirtual_ % num_block == 0) {
-            // Fill the mbatch from block_begin to block_end
-            // This is done so I can pass a block to IntegralsAPI to read a
-            // chunk
-            e_batch.resize(block_size);
-            // copy used to get correct indices for B.
-            std::copy(virt_mos_.begin() + (e_blocks * block_size),
-                      virt_mos_.begin() + ((e_blocks + 1) * block_size), e_batch.begin());
-        } else {
-            // If last_block is shorter or long, fill the rest
-            size_t gimp_block_size =
-                e_blocks == (num_block - 1) ? block_size + nvirtual_ % num_block : block_size;
-            e_batch.resize(gimp_block_size);
-            // std::iota(m_batch.begin(), m_batch.end(), m_blocks * (core_ /
-            // num_block));
-            std::copy(virt_mos_.begin() + (e_blocks)*block_size,
-                      virt_mos_.begin() + (e_blocks)*block_size + gimp_block_size, e_batch.begin());
+        requests.emplace_back(blocks[e_blocks], core_mos_);
+        for (size_t f_blocks = 0; f_blocks < e_blocks; f_blocks++) {
+            requests.emplace_back(blocks[f_blocks], core_mos_);
         }
+    }
+    ThreeIndexPrefetcher prefetcher(ints_, aux_mos_, requests,
+                                    foptions_->get_bool("DSRG_DISKDF_PREFETCH"));
+    double compute_time = 0.0;
+
+    for (size_t e_blocks = 0; e_blocks < num_block; e_blocks++) {
+        const std::vector<size_t>& e_batch = blocks[e_blocks];
 
-        ambit::Tensor B = ints_->three_integral_block(aux_mos_, e_batch, core_mos_);
+        ambit::Tensor B = prefetcher.next();
+        double io_wait = prefetcher.last_wait();
         ambit::Tensor BeQm =
             ambit::Tensor::build(tensor_type_, "BmQE", {e_batch.size(), nthree_, ncore_});
         BeQm("eQm") = B("Qem");
@@ -2471,30 +2427,14 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_virtual() {
         }
 
         for (size_t f_blocks = 0; f_blocks <= e_blocks; f_blocks++) {
-            std::vector<size_t> f_batch;
-            // If core_ goes into num_block equally, all blocks are equal
-            if (nvirtual_ % num_block == 0) {
-                // Fill the mbatch from block_begin to block_end
-                // This is done so I can pass a block to IntegralsAPI to read a
-                // chunk
-                f_batch.resize(block_size);
-                std::copy(virt_mos_.begin() + f_blocks * block_size,
-                          virt_mos_.begin() + ((f_blocks + 1) * block_size), f_batch.begin());
-            } else {
-                // If last_block is longer, block_size + remainder
-                size_t gimp_block_size =
-                    f_blocks == (num_block - 1) ? block_size + nvirtual_ % num_block : block_size;
-                f_batch.resize(gimp_block_size);
-                std::copy(virt_mos_.begin() + (f_blocks)*block_size,
-                          virt_mos_.begin() + (f_blocks * block_size) + gimp_block_size,
-                          f_batch.begin());
-            }
+            const std::vector<size_t>& f_batch = blocks[f_blocks];
             ambit::Tensor BfQn =
                 ambit::Tensor::build(tensor_type_, "BnQf", {f_batch.size(), nthree_, ncore_});
             if (f_blocks == e_blocks) {
                 BfQn.copy(BeQm);
             } else {
-                ambit::Tensor B = ints_->three_integral_block(aux_mos_, f_batch, core_mos_);
+                ambit::Tensor B = prefetcher.next();
+                io_wait += prefetcher.last_wait();
                 BfQn("eQm") = B("Qem");
                 B.reset();
             }
@@ -2570,12 +2510,17 @@ double THREE_DSRG_MRPT2::E_VT2_2_batch_virtual() {
                                     e, f, Ealpha, Emixed, Ealpha + Emixed);
                 }
             }
+            double loop_time = Virtual_loop.get();
+            compute_time += loop_time;
             if (debug_print)
                 outfile->Printf("\n Virtual loop OpenMP timing for e_batch: %d "
-                                "and f_batch: %d takes %8.8f",
-                                e_blocks, f_blocks, Virtual_loop.get());
+                                "and f_batch: %d takes %8.8f (I/O wait %8.8f)",
+                                e_blocks, f_blocks, loop_time, io_wait);
+            io_wait = 0.0;
         }
     }
+    outfile->Printf("\n  Batch_virtual I/O wait: %.3f s, read: %.3f s, compute: %.3f s",
+                    prefetcher.total_wait(), prefetcher.total_read(), compute_time);
     // return (Ealpha + Ebeta + Emixed);
     return (Ealpha + Ebeta + Emixed);
 }
@@ -2601,32 +2546,16 @@ double THREE_DSRG_MRPT2::E_VT2_2_core() {
     if (foptions_->get_str("CCVV_SOURCE") == "NORMAL") {
         BlockedTensor RD2_ccvv = BTF_->build(tensor_type_, "RDelta2ccvv", spin_cases({"ccvv"}));
         BlockedTensor RExp2ccvv = BTF_->build(tensor_type_, "RExp2ccvv", spin_cases({"ccvv"}));
-        RD2_ccvv.iterate(
-            [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-                if ((spin[0] == AlphaSpin) and (spin[1] == AlphaSpin)) {
-                    value = dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fa_[i[1]] -
-                                                                           Fa_[i[2]] - Fa_[i[3]]);
-                } else if ((spin[0] == AlphaSpin) and (spin[1] == BetaSpin)) {
-                    value = dsrg_source_->compute_renormalized_denominator(Fa_[i[0]] + Fb_[i[1]] -
-                                                                           Fa_[i[2]] - Fb_[i[3]]);
-                } else if ((spin[0] == BetaSpin) and (spin[1] == BetaSpin)) {
-                    value = dsrg_source_->compute_renormalized_denominator(Fb_[i[0]] + Fb_[i[1]] -
-                                                                           Fb_[i[2]] - Fb_[i[3]]);
-                }
-            });
-        RExp2ccvv.iterate(
-            [&](const std::vector<size_t>& i, const std::vector<SpinType>& spin, double& value) {
-                if ((spin[0] == AlphaSpin) and (spin[1] == AlphaSpin)) {
-                    value = dsrg_source_->compute_renormalized(Fa_[i[0]] + Fa_[i[1]] - Fa_[i[2]] -
-                                                               Fa_[i[3]]);
-                } else if ((spin[0] == AlphaSpin) and (spin[1] == BetaSpin)) {
-                    value = dsrg_source_->compute_renormalized(Fa_[i[0]] + Fb_[i[1]] - Fa_[i[2]] -
-                                                               Fb_[i[3]]);
-                } else if ((spin[0] == BetaSpin) and (spin[1] == BetaSpin)) {
-                    value = dsrg_source_->compute_renormalized(Fb_[i[0]] + Fb_[i[1]] - Fb_[i[2]] -
-                                                               Fb_[i[3]]);
-                }
-            });
+        for (const std::string& block : RD2_ccvv.block_labels()) {
+            auto D = block_denominators(block, Fa_, Fb_);
+            auto& data = RD2_ccvv.block(block).data();
+            dsrg_source_->compute_renormalized_denominator(D.data(), data.data(), D.size());
+        }
+        for (const std::string& block : RExp2ccvv.block_labels()) {
+            auto D = block_denominators(block, Fa_, Fb_);
+            auto& data = RExp2ccvv.block(block).data();
+            dsrg_source_->compute_renormalized(D.data(), data.data(), D.size());
+        }
         BlockedTensor Rv = BTF_->build(tensor_type_, "ReV", spin_cases({"ccvv"}));
         Rv("mnef") = v("mnef");
         Rv("mNeF") = v("mNeF");
@@ -2667,6 +2596,9 @@ double THREE_DSRG_MRPT2::E_VT2_2_core() {
 double THREE_DSRG_MRPT2::E_VT2_2_one_active() {
     double Eccva = 0;
     double Eacvv = 0;
+    // core orbitals are dealt round-robin to the processes
+    int nproc, my_proc;
+    mpi_rank_size(my_proc, nproc);
     int nthread = 1;
 #ifdef _OPENMP
     nthread = omp_get_max_threads();
@@ -2712,7 +2644,7 @@ double THREE_DSRG_MRPT2::E_VT2_2_one_active() {
 // I think this loop is typically too small to allow efficient use of
 // OpenMP.  Should probably test this assumption.
 #pragma omp parallel for num_threads(num_threads_)
-    for (size_t m = 0; m < ncore_; m++) {
+    for (size_t m = my_proc; m < ncore_; m += nproc) {
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
@@ -2855,7 +2787,7 @@ double THREE_DSRG_MRPT2::E_VT2_2_one_active() {
     ambit::Tensor Eta1_AA = Eta1_.block("AA");
 
 #pragma omp parallel for num_threads(num_threads_)
-    for (size_t m = 0; m < ncore_; ++m) {
+    for (size_t m = my_proc; m < ncore_; m += nproc) {
         size_t ma = core_mos_[m];
         size_t mb = core_mos_[m];
         int thread = 0;
@@ -2954,7 +2886,7 @@ double THREE_DSRG_MRPT2::E_VT2_2_one_active() {
         outfile->Printf("\n\n  CCVA takes %8.8f", cavvTimer.get());
     }
 
-    return (Eacvv + Eccva);
+    return mpi_sum(Eacvv + Eccva);
 }
 
 void THREE_DSRG_MRPT2::form_Hbar() {
@@ -3159,47 +3091,57 @@ void THREE_DSRG_MRPT2::compute_Hbar1C_diskDF(ambit::BlockedTensor& Hbar1, bool s
      **/
 
     size_t nc2 = ncore_ * ncore_;
-    ambit::Tensor V, T, B1, B2;
+    ambit::Tensor V, T;
     V = ambit::Tensor::build(tensor_type_, "V_z", {nvirtual_, ncore_, ncore_});
     T = ambit::Tensor::build(tensor_type_, "T_w", {nvirtual_, ncore_, ncore_});
 
-    int nthread = 1;
-#ifdef _OPENMP
-    nthread = num_threads_;
-#endif
+    // batches of e: two blocks B(L|en) (current and prefetched) and one slice of V or T
+    size_t memory = psi::Process::environment.get_memory() * 0.75;
+    size_t memory_VT = 2 * nvirtual_ * nc2 * sizeof(double);
+    size_t memory_e = (2 * nthree_ * ncore_ + nc2) * sizeof(double);
+    size_t e_batch_size = memory > memory_VT ? (memory - memory_VT) / memory_e : 1;
+    auto e_batches = split_in_batches(virt_mos_, e_batch_size);
 
-    std::vector<ambit::Tensor> B3(nthread, ambit::Tensor());
-    std::vector<ambit::Tensor> temp(nthread, ambit::Tensor());
-    for (int thread = 0; thread < nthread; ++thread) {
-        temp[thread] = ambit::Tensor::build(tensor_type_, "V_ez", {ncore_, ncore_});
+    // the order of reads: B(L|zm), all B(L|en), then for each w: B(L|mw), all B(L|en)
+    std::vector<ThreeIndexPrefetcher::Request> requests;
+    for (size_t z = 0; z < nactive_; ++z) {
+        requests.emplace_back(std::vector<size_t>{actv_mos_[z]}, core_mos_);
+        for (const auto& e_batch : e_batches) {
+            requests.emplace_back(e_batch, core_mos_);
+        }
+        for (size_t w = 0; w < nactive_; ++w) {
+            requests.emplace_back(std::vector<size_t>{actv_mos_[w]}, core_mos_);
+            for (const auto& e_batch : e_batches) {
+                requests.emplace_back(e_batch, core_mos_);
+            }
+        }
     }
+    ThreeIndexPrefetcher prefetcher(ints_, aux_mos_, requests,
+                                    foptions_->get_bool("DSRG_DISKDF_PREFETCH"));
+
+    // read B(L|xm) for the active index x and fill X(e,n,m) = B(L|xn) * B(L|em)
+    auto fill_batches = [&](ambit::Tensor& X) {
+        ambit::Tensor Bx = ambit::Tensor::build(tensor_type_, "B_x", {nthree_, ncore_});
+        Bx.data() = prefetcher.next().data();
+        size_t e0 = 0;
+        for (const auto& e_batch : e_batches) {
+            auto B3 = prefetcher.next();
+            auto temp =
+                ambit::Tensor::build(tensor_type_, "V_ez", {e_batch.size(), ncore_, ncore_});
+            temp("enm") = Bx("gn") * B3("gem");
+            std::copy(temp.data().begin(), temp.data().end(), X.data().begin() + e0 * nc2);
+            e0 += e_batch.size();
+        }
+    };
+
+    local_timer compute_timer;
 
     /// => start from here <=
     for (size_t z = 0; z < nactive_; ++z) {
-        size_t nz = actv_mos_[z];
-        double Fz = Fa_[nz];
+        double Fz = Fa_[actv_mos_[z]];
 
         /// V (alpha-beta equivalent) for a given "z"
-        B1 = ints_->three_integral_block_two_index(aux_mos_, nz, core_mos_);
-
-#pragma omp parallel for
-        for (size_t e = 0; e < nvirtual_; ++e) {
-            size_t ne = virt_mos_[e];
-            int thread = 0; // SUPER IMPORTANT!!!
-#ifdef _OPENMP
-            thread = omp_get_thread_num();
-#endif
-#pragma omp critical
-            { B3[thread] = ints_->three_integral_block_two_index(aux_mos_, ne, core_mos_); }
-
-            // compute V for a given "z" and "e"
-            temp[thread]("nm") = B1("gn") * B3[thread]("gm");
-
-            // copy temp to V
-            size_t offset = e * nc2;
-            std::copy(temp[thread].data().begin(), temp[thread].data().end(),
-                      V.data().begin() + offset);
-        }
+        fill_batches(V);
 
         // scale V := V * (1 + e^{-s * D * D})
         // TODO: test if this needs to be parallelized
@@ -3212,30 +3154,10 @@ void THREE_DSRG_MRPT2::compute_Hbar1C_diskDF(ambit::BlockedTensor& Hbar1, bool s
 
         /// => loop active index for T <=
         for (size_t w = 0; w < nactive_; ++w) {
-            size_t nw = actv_mos_[w];
-            double Fw = Fa_[nw];
+            double Fw = Fa_[actv_mos_[w]];
 
             /// T (alpha-beta equivalent) for a given "w"
-            B2 = ints_->three_integral_block_two_index(aux_mos_, nw, core_mos_);
-
-#pragma omp parallel for
-            for (size_t e = 0; e < nvirtual_; ++e) {
-                size_t ne = virt_mos_[e];
-                int thread = 0; // SUPER IMPORTANT!!!
-#ifdef _OPENMP
-                thread = omp_get_thread_num();
-#endif
-#pragma omp critical
-                { B3[thread] = ints_->three_integral_block_two_index(aux_mos_, ne, core_mos_); }
-
-                // compute V for T for a given "w" and "e"
-                temp[thread]("nm") = B2("gn") * B3[thread]("gm");
-
-                // copy temp to T
-                size_t offset = e * nc2;
-                std::copy(temp[thread].data().begin(), temp[thread].data().end(),
-                          T.data().begin() + offset);
-            }
+            fill_batches(T);
 
             // scale T := V * (1 - e^{-s * D * D}) / D
             // TODO: test if this needs to be parallelized
@@ -3252,6 +3174,14 @@ void THREE_DSRG_MRPT2::compute_Hbar1C_diskDF(ambit::BlockedTensor& Hbar1, bool s
             Hbar1.block("AA").data()[z * nactive_ + w] -= 2.0 * hbar;
         }
     }
+
+    if (print_ > 1) {
+        double total = compute_timer.get();
+        outfile->Printf("\n    Hbar1 CCAV (%zu batches of e): I/O wait %.3f s, read %.3f s,"
+                        " compute %.3f s",
+                        e_batches.size(), prefetcher.total_wait(), prefetcher.total_read(),
+                        total - prefetcher.total_wait());
+    }
 }
 
 void THREE_DSRG_MRPT2::compute_Hbar1V_diskDF(ambit::BlockedTensor& Hbar1, bool scaleV) {
@@ -3284,47 +3214,57 @@ void THREE_DSRG_MRPT2::compute_Hbar1V_diskDF(ambit::BlockedTensor& Hbar1, bool s
      * 4. Remember to include Hermitian adjoint of [V, T] to Hbar1!
      **/
 
-    ambit::Tensor V, T, B1, B2;
+    ambit::Tensor V, T;
     size_t nv2 = nvirtual_ * nvirtual_;
     V = ambit::Tensor::build(tensor_type_, "V_w", {ncore_, nvirtual_, nvirtual_});
     T = ambit::Tensor::build(tensor_type_, "T_z", {ncore_, nvirtual_, nvirtual_});
 
-    int nthread = 1;
-#ifdef _OPENMP
-    nthread = num_threads_;
-#endif
+    // batches of m: two blocks B(L|fm) (current and prefetched) and one slice of V or T
+    size_t memory = psi::Process::environment.get_memory() * 0.75;
+    size_t memory_VT = 2 * ncore_ * nv2 * sizeof(double);
+    size_t memory_m = (2 * nthree_ * nvirtual_ + nv2) * sizeof(double);
+    size_t m_batch_size = memory > memory_VT ? (memory - memory_VT) / memory_m : 1;
+    auto m_batches = split_in_batches(core_mos_, m_batch_size);
 
-    std::vector<ambit::Tensor> B3(nthread, ambit::Tensor());
-    std::vector<ambit::Tensor> temp(nthread, ambit::Tensor());
-    for (int thread = 0; thread < nthread; ++thread) {
-        temp[thread] = ambit::Tensor::build(tensor_type_, "V_wm", {nvirtual_, nvirtual_});
+    // the order of reads: B(L|ew), all B(L|fm), then for each z: B(L|ze), all B(L|fm)
+    std::vector<ThreeIndexPrefetcher::Request> requests;
+    for (size_t w = 0; w < nactive_; ++w) {
+        requests.emplace_back(std::vector<size_t>{actv_mos_[w]}, virt_mos_);
+        for (const auto& m_batch : m_batches) {
+            requests.emplace_back(m_batch, virt_mos_);
+        }
+        for (size_t z = 0; z < nactive_; ++z) {
+            requests.emplace_back(std::vector<size_t>{actv_mos_[z]}, virt_mos_);
+            for (const auto& m_batch : m_batches) {
+                requests.emplace_back(m_batch, virt_mos_);
+            }
+        }
     }
+    ThreeIndexPrefetcher prefetcher(ints_, aux_mos_, requests,
+                                    foptions_->get_bool("DSRG_DISKDF_PREFETCH"));
+
+    // read B(L|xe) for the active index x and fill X(m,e,f) = B(L|xe) * B(L|mf)
+    auto fill_batches = [&](ambit::Tensor& X) {
+        ambit::Tensor Bx = ambit::Tensor::build(tensor_type_, "B_x", {nthree_, nvirtual_});
+        Bx.data() = prefetcher.next().data();
+        size_t m0 = 0;
+        for (const auto& m_batch : m_batches) {
+            auto B3 = prefetcher.next();
+            auto temp =
+                ambit::Tensor::build(tensor_type_, "V_wm", {m_batch.size(), nvirtual_, nvirtual_});
+            temp("mef") = Bx("ge") * B3("gmf");
+            std::copy(temp.data().begin(), temp.data().end(), X.data().begin() + m0 * nv2);
+            m0 += m_batch.size();
+        }
+    };
+
+    local_timer compute_timer;
 
     for (size_t w = 0; w < nactive_; ++w) {
-        size_t nw = actv_mos_[w];
-        double Fw = Fa_[nw];
+        double Fw = Fa_[actv_mos_[w]];
 
         /// compute (ew|fm) = B(L|ew) * B(L|fm) for a given "w"
-        B1 = ints_->three_integral_block_two_index(aux_mos_, nw, virt_mos_);
-
-#pragma omp parallel for
-        for (size_t m = 0; m < ncore_; ++m) {
-            size_t nm = core_mos_[m];
-            int thread = 0; // SUPER IMPORTANT!!!
-#ifdef _OPENMP
-            thread = omp_get_thread_num();
-#endif
-#pragma omp critical
-            { B3[thread] = ints_->three_integral_block_two_index(aux_mos_, nm, virt_mos_); }
-
-            // compute V for a given "w" and "m"
-            temp[thread]("ef") = B1("ge") * B3[thread]("gf");
-
-            // copy temp to V
-            size_t offset = m * nv2;
-            std::copy(temp[thread].data().begin(), temp[thread].data().end(),
-                      V.data().begin() + offset);
-        }
+        fill_batches(V);
 
         // scale V := V * (1 + e^{-s * D * D})
         // TODO: test if this needs to be parallelized
@@ -3336,30 +3276,10 @@ void THREE_DSRG_MRPT2::compute_Hbar1V_diskDF(ambit::BlockedTensor& Hbar1, bool s
         }
 
         for (size_t z = 0; z < nactive_; ++z) {
-            size_t nz = actv_mos_[z];
-            double Fz = Fa_[nz];
+            double Fz = Fa_[actv_mos_[z]];
 
             /// compute (ze|mf) = B(L|ze) * B(L|mf) for T for a given "z"
-            B2 = ints_->three_integral_block_two_index(aux_mos_, nz, virt_mos_);
-
-#pragma omp parallel for
-            for (size_t m = 0; m < ncore_; ++m) {
-                size_t nm = core_mos_[m];
-                int thread = 0; // SUPER IMPORTANT!!!
-#ifdef _OPENMP
-                thread = omp_get_thread_num();
-#endif
-#pragma omp critical
-                { B3[thread] = ints_->three_integral_block_two_index(aux_mos_, nm, virt_mos_); }
-
-                // compute T for a given "z" and "m"
-                temp[thread]("ef") = B2("ge") * B3[thread]("gf");
-
-                // copy temp to T
-                size_t offset = m * nv2;
-                std::copy(temp[thread].data().begin(), temp[thread].data().end(),
-                          T.data().begin() + offset);
-            }
+            fill_batches(T);
 
             // scale T := V * (1 - e^{-s * D * D}) / D
             // TODO: test if this needs to be parallelized
@@ -3376,6 +3296,14 @@ void THREE_DSRG_MRPT2::compute_Hbar1V_diskDF(ambit::BlockedTensor& Hbar1, bool s
             Hbar1.block("AA").data()[z * nactive_ + w] += 2.0 * hbar;
         }
     }
+
+    if (print_ > 1) {
+        double total = compute_timer.get();
+        outfile->Printf("\n    Hbar1 CAVV (%zu batches of m): I/O wait %.3f s, read %.3f s,"
+                        " compute %.3f s",
+                        m_batches.size(), prefetcher.total_wait(), prefetcher.total_read(),
+                        total - prefetcher.total_wait());
+    }
 }
 
 // std::vector<double>
@@ -208,6 +208,13 @@ class THREE_DSRG_MRPT2 : public MASTER_DSRG {
     double E_VT2_2_batch_core_ga();
     double E_VT2_2_batch_core_rep();
     double E_VT2_2_batch_virtual_mpi();
+    /// Plain MPI ccvv energy: B is distributed by core (or virtual) index over the processes
+    /// and the slices are passed around a ring; falls back to one process without MPI
+    double E_VT2_2_ring_mpi(bool by_virtual);
+    /// The rank of this process and the number of processes (0 and 1 without MPI)
+    void mpi_rank_size(int& my_proc, int& nproc);
+    /// Sum a value over all processes and return it on every process
+    double mpi_sum(double value);
     double E_VT2_2_batch_virtual_ga();
     double E_VT2_2_batch_virtual_rep();
     double E_VT2_2_AO_Slow();
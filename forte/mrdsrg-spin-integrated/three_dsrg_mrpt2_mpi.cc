@@ -0,0 +1,235 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#ifdef HAVE_MPI
+#include <mpi.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#endif
+
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include "helpers/timer.h"
+#include "three_dsrg_mrpt2.h"
+
+using namespace psi;
+
+namespace forte {
+
+namespace {
+/// Split n indices into nproc contiguous ranges, return the nproc + 1 offsets
+std::vector<size_t> split_indices(size_t n, int nproc) {
+    std::vector<size_t> offsets(nproc + 1, 0);
+    for (int p = 0; p < nproc; ++p) {
+        offsets[p + 1] = offsets[p] + n / nproc + (static_cast<size_t>(p) < n % nproc ? 1 : 0);
+    }
+    return offsets;
+}
+
+#ifdef HAVE_MPI
+/// MPI_Sendrecv of n doubles, sent in pieces whose count fits in an int
+void sendrecv_doubles(const double* send, double* recv, size_t n, int dest, int source, int tag) {
+    const size_t max_count = std::numeric_limits<int>::max();
+    for (size_t offset = 0; offset < n; offset += max_count) {
+        int count = static_cast<int>(std::min(max_count, n - offset));
+        MPI_Sendrecv(send + offset, count, MPI_DOUBLE, dest, tag, recv + offset, count,
+                     MPI_DOUBLE, source, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+}
+#endif
+} // namespace
+
+void THREE_DSRG_MRPT2::mpi_rank_size(int& my_proc, int& nproc) {
+    my_proc = 0;
+    nproc = 1;
+#ifdef HAVE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_proc);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+#endif
+}
+
+double THREE_DSRG_MRPT2::mpi_sum(double value) {
+#ifdef HAVE_MPI
+    double sum = 0.0;
+    MPI_Allreduce(&value, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return sum;
+#else
+    return value;
+#endif
+}
+
+double THREE_DSRG_MRPT2::E_VT2_2_batch_core_mpi() { return E_VT2_2_ring_mpi(false); }
+
+double THREE_DSRG_MRPT2::E_VT2_2_batch_virtual_mpi() { return E_VT2_2_ring_mpi(true); }
+
+double THREE_DSRG_MRPT2::E_VT2_2_ring_mpi(bool by_virtual) {
+    int my_proc, nproc;
+    mpi_rank_size(my_proc, nproc);
+
+    // The distributed index is p (local) and q (visiting), the contracted pair is r and s.
+    // By core: K_pq(r,s) = (pr|qs) = (me|nf), D = Fm + Fn - Fe - Ff
+    // By virtual: K_pq(r,s) = (pr|qs) = (em|fn), D = -(Fe + Ff - Fm - Fn)
+    const std::vector<size_t>& dist_mos = by_virtual ? virt_mos_ : core_mos_;
+    const std::vector<size_t>& pair_mos = by_virtual ? core_mos_ : virt_mos_;
+    const double sign = by_virtual ? -1.0 : 1.0;
+    const size_t ndist = dist_mos.size();
+    const size_t npair = pair_mos.size();
+    const size_t slice_dim = nthree_ * npair;
+
+    std::vector<size_t> offsets = split_indices(ndist, nproc);
+    size_t max_slice = 0;
+    for (int p = 0; p < nproc; ++p) {
+        max_slice = std::max(max_slice, offsets[p + 1] - offsets[p]);
+    }
+    const size_t my_size = offsets[my_proc + 1] - offsets[my_proc];
+
+    // the local block, the visiting block, the receive buffer, and one K per thread
+    int nthread = omp_get_max_threads();
+    size_t nbuffers = nproc > 1 ? 3 : 1;
+    size_t mem_needed =
+        (nbuffers * max_slice * slice_dim + nthread * npair * npair) * sizeof(double);
+    size_t mem_avail = psi::Process::environment.get_memory() * 0.75;
+    if (my_proc == 0) {
+        outfile->Printf("\n  Distributing B(Q|%s) over %d process(es) by %s index",
+                        by_virtual ? "em" : "me", nproc, by_virtual ? "virtual" : "core");
+        outfile->Printf("\n  Largest slice: %zu orbitals, memory per process: %.2f MB",
+                        max_slice, mem_needed / 1048576.0);
+    }
+    if (mem_needed > mem_avail) {
+        throw psi::PSIEXCEPTION("Not enough memory for the distributed ccvv algorithm. "
+                                "Increase memory or the number of MPI processes.");
+    }
+
+    // Step 1: each process reads its own slice of B(Q|pr) and stores it as B(p|Qr)
+    local_timer read_timer;
+    std::vector<double> Blocal(max_slice * slice_dim, 0.0);
+    if (my_size > 0) {
+        std::vector<size_t> my_mos(dist_mos.begin() + offsets[my_proc],
+                                   dist_mos.begin() + offsets[my_proc + 1]);
+        ambit::Tensor B = ints_->three_integral_block(aux_mos_, my_mos, pair_mos);
+        const std::vector<double>& Bdata = B.data();
+        for (size_t Q = 0; Q < nthree_; ++Q) {
+            for (size_t p = 0; p < my_size; ++p) {
+                std::copy(&Bdata[(Q * my_size + p) * npair], &Bdata[(Q * my_size + p + 1) * npair],
+                          &Blocal[(p * nthree_ + Q) * npair]);
+            }
+        }
+    }
+    double read_time = read_timer.get();
+
+    // Step 2: pass the blocks around a ring of processes.  At step k the visiting block
+    // belongs to process (my_proc - k), so each pair of blocks is met once for k <= nproc / 2.
+    std::vector<double> Bvisit(Blocal);
+    std::vector<double> Brecv(nproc > 1 ? Blocal.size() : 0);
+    std::vector<std::vector<double>> Kvec(nthread, std::vector<double>(npair * npair));
+    int right = (my_proc + 1) % nproc;
+    int left = (my_proc - 1 + nproc) % nproc;
+
+    double Eaa = 0.0;
+    double Eab = 0.0;
+    double comm_time = 0.0;
+    local_timer compute_timer;
+    for (int step = 0; step <= nproc / 2; ++step) {
+        if (step > 0) {
+#ifdef HAVE_MPI
+            local_timer comm_timer;
+            // all blocks have the same padded size, so the pieces match on both sides
+            sendrecv_doubles(Bvisit.data(), Brecv.data(), Bvisit.size(), right, left, step);
+            std::swap(Bvisit, Brecv);
+            comm_time += comm_timer.get();
+#endif
+        }
+        int src = (my_proc - step + nproc) % nproc;
+        // with an even number of processes the middle pairs are met twice: keep one
+        if (step > 0 && 2 * step == nproc && my_proc > src) {
+            continue;
+        }
+        const size_t src_size = offsets[src + 1] - offsets[src];
+
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic) reduction(+ : Eaa, Eab)
+        for (size_t pq = 0; pq < my_size * src_size; ++pq) {
+            size_t p = pq / src_size;
+            size_t q = pq % src_size;
+            double factor = 2.0;
+            if (step == 0) {
+                if (q > p)
+                    continue;
+                factor = (p == q ? 1.0 : 2.0);
+            }
+            size_t pa = dist_mos[offsets[my_proc] + p];
+            size_t qa = dist_mos[offsets[src] + q];
+
+            std::vector<double>& K = Kvec[omp_get_thread_num()];
+            C_DGEMM('T', 'N', npair, npair, nthree_, 1.0, &Blocal[p * slice_dim], npair,
+                    &Bvisit[q * slice_dim], npair, 0.0, K.data(), npair);
+
+            double eaa = 0.0;
+            double eab = 0.0;
+            for (size_t r = 0; r < npair; ++r) {
+                size_t ra = pair_mos[r];
+                for (size_t s = 0; s < npair; ++s) {
+                    size_t sa = pair_mos[s];
+                    double k = K[r * npair + s];
+
+                    double D = sign * (Fa_[pa] + Fa_[qa] - Fa_[ra] - Fa_[sa]);
+                    double RD = dsrg_source_->compute_renormalized_denominator(D) *
+                                (1.0 + dsrg_source_->compute_renormalized(D));
+                    eaa += (k * k - k * K[s * npair + r]) * RD;
+
+                    D = sign * (Fa_[pa] + Fb_[qa] - Fa_[ra] - Fb_[sa]);
+                    RD = dsrg_source_->compute_renormalized_denominator(D) *
+                         (1.0 + dsrg_source_->compute_renormalized(D));
+                    eab += k * k * RD;
+                }
+            }
+            Eaa += factor * eaa;
+            Eab += factor * eab;
+        }
+    }
+    double compute_time = compute_timer.get() - comm_time;
+
+    if (my_proc == 0) {
+        outfile->Printf("\n  Distributed ccvv read: %.3f s, communication: %.3f s, compute: %.3f s",
+                        read_time, comm_time, compute_time);
+    }
+
+    return mpi_sum(Eaa + Eab);
+}
+} // namespace forte
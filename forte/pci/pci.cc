@@ -643,6 +643,7 @@ void ProjectorCI::pre_iter_preparation() {
 
     dets_hashvec_.clear();
     C_.clear();
+    spawning_stats_.clear();
 
     psi::timer_on("PCI:Couplings");
     double factor = std::max(1.0, std::pow(2.0, 1.0 / functional_order_ - 0.5));
@@ -820,6 +821,8 @@ void ProjectorCI::post_iter_process() {
     psi::outfile->Printf("\n  * ProjectorCI Approximate Energy    = %18.12f Eh", 1, approx_energy_);
     psi::outfile->Printf("\n  * ProjectorCI Projective  Energy    = %18.12f Eh", 1, proj_energy_);
 
+    print_spawning_stats();
+
     psi::timer_on("PCI:sort");
     sortHashVecByCoefficient(dets_hashvec_, C_);
     psi::timer_off("PCI:sort");
@@ -904,6 +907,25 @@ void ProjectorCI::post_iter_process() {
     }
 }
 
+void ProjectorCI::print_spawning_stats() {
+    if (spawning_stats_.empty())
+        return;
+    psi::outfile->Printf("\n\n  ==> Spawning Throughput <==\n");
+    psi::outfile->Printf("\n    Steps        Spawns     Time/s       Spawns/s");
+    psi::outfile->Printf("\n  ------------------------------------------------");
+    size_t total_spawns = 0;
+    double total_time = 0.0;
+    for (const auto& [cycle, num_spawns, time] : spawning_stats_) {
+        psi::outfile->Printf("\n  %7d %13zu %10.3f %14.3e", cycle, num_spawns, time,
+                             time > 0.0 ? num_spawns / time : 0.0);
+        total_spawns += num_spawns;
+        total_time += time;
+    }
+    psi::outfile->Printf("\n  ------------------------------------------------");
+    psi::outfile->Printf("\n    Total %13zu %10.3f %14.3e (%d threads)", total_spawns, total_time,
+                         total_time > 0.0 ? total_spawns / total_time : 0.0, num_threads_);
+}
+
 bool ProjectorCI::converge_test() {
     if (!stop_higher_new_low_) {
         return false;
@@ -944,6 +966,8 @@ double ProjectorCI::initial_guess(det_hashvec& dets_hashvec, std::vector<double>
     sigma_vector.compute_sigma(sigma_psi, C_psi);
     C = to_std_vector(sigma_psi);
     num_off_diag_elem_ = sigma_vector.get_num_off_diag();
+    spawning_stats_.emplace_back(cycle_, sigma_vector.get_num_spawns(),
+                                 sigma_vector.get_spawning_time());
 
     //    apply_tau_H_symm(time_step_, initial_guess_spawning_threshold_, dets_hashvec, start_C, C,
     //    0.0,
@@ -1053,6 +1077,8 @@ void ProjectorCI::propagate_wallCh(det_hashvec& dets_hashvec, std::vector<double
     sigma_psi->scale(-1.0);
     C = to_std_vector(sigma_psi);
     num_off_diag_elem_ = sigma_vector.get_num_off_diag();
+    spawning_stats_.emplace_back(cycle_, sigma_vector.get_num_spawns(),
+                                 sigma_vector.get_spawning_time());
 
     double S = range_ * root + shift_;
 #pragma omp parallel for
@@ -1122,6 +1148,8 @@ void ProjectorCI::propagate_DL(det_hashvec& dets_hashvec, std::vector<double>& C
         a_couplings_, b_couplings_, aa_couplings_, ab_couplings_, bb_couplings_,
         dets_max_couplings_, dets_single_max_coupling_, dets_double_max_coupling_, solutions_);
     num_off_diag_elem_ = sigma_vector->get_num_off_diag();
+    spawning_stats_.emplace_back(cycle_, sigma_vector->get_num_spawns(),
+                                 sigma_vector->get_spawning_time());
     size_t ref_size = C.size();
 
     //    outfile->Printf("\n\n result_size = %zu", result_size);
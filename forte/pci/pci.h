@@ -209,6 +209,8 @@ class ProjectorCI : public SelectedCIMethod {
     size_t aa_couplings_size_, ab_couplings_size_, bb_couplings_size_, a_couplings_size_,
         b_couplings_size_;
     size_t num_off_diag_elem_;
+    /// The number of spawns and the spawning time (in s) for each iteration
+    std::vector<std::tuple<int, size_t, double>> spawning_stats_;
 
     // * Energy estimation
     /// Estimate the variational energy?
@@ -303,6 +305,8 @@ class ProjectorCI : public SelectedCIMethod {
                           double spawning_threshold);
     /// The DL Generator
     void propagate_DL(det_hashvec& dets_hashvec, std::vector<double>& C, double spawning_threshold);
+    /// Print the spawning throughput of each iteration
+    void print_spawning_stats();
     /// Apply symmetric approx tau H to a set of determinants with selection
     /// according to reference coefficients
 
@@ -31,9 +31,11 @@
 #include <cmath>
 #include <cstring>
 #include <algorithm>
+#include <functional>
 
 #include "psi4/libmints/vector.h"
 
+#include "helpers/timer.h"
 #include "integrals/active_space_integrals.h"
 #include "pci_sigma.h"
 
@@ -100,6 +102,11 @@ void PCISigmaVector::reset(std::vector<double>& ref_C) {
     ref_C_ = ref_C;
     size_ = dets_.size();
 
+    ref_max_couplings_.resize(ref_size_);
+    for (size_t I = 0; I < ref_size_; ++I) {
+        ref_max_couplings_[I] = dets_max_couplings_[dets_[I]];
+    }
+
 #pragma omp parallel for
     for (size_t I = ref_size_; I < size_; ++I) {
         diag_[I] = as_ints_->energy(dets_[I]);
@@ -125,7 +132,7 @@ void PCISigmaVector::compute_sigma(psi::SharedVector sigma, psi::SharedVector b)
 }
 
 void PCISigmaVector::get_diagonal(psi::Vector& diag) {
-    std::memcpy(diag.pointer(), diag_.data(), size_);
+    std::copy(diag_.begin(), diag_.begin() + size_, diag.pointer());
 }
 
 void PCISigmaVector::add_bad_roots(
@@ -144,6 +151,10 @@ size_t PCISigmaVector::get_num_off_diag() { return num_off_diag_elem_; }
 
 size_t PCISigmaVector::get_sigma_build_count() { return sigma_build_count_; }
 
+size_t PCISigmaVector::get_num_spawns() { return num_spawns_; }
+
+double PCISigmaVector::get_spawning_time() { return spawning_time_; }
+
 void PCISigmaVector::orthogonalize(
     const det_hashvec& space, std::vector<double>& C,
     const std::vector<std::pair<det_hashvec, std::vector<double>>>& solutions) {
@@ -156,49 +167,44 @@ void PCISigmaVector::orthogonalize(
 void PCISigmaVector::apply_tau_H_symm(double spawning_threshold, det_hashvec& ref_dets,
                                       std::vector<double>& ref_C, std::vector<double>& result_C,
                                       size_t& overlap_size) {
+    local_timer t_spawn;
 
     size_t ref_size = ref_dets.size();
-    //    result_dets.clear();
     result_C.clear();
-    //    det_hashvec result_dets(ref_dets);
     det_hashvec extra_dets;
     std::vector<double> extra_C;
     result_C.resize(ref_size, DBL_MIN);
 
+    // Look up the coupling bounds once, so that the threads do not need to access the map
+    std::vector<std::pair<double, double>> max_couplings(ref_size);
+    std::vector<char> new_max_couplings(ref_size, 0);
+    for (size_t I = 0; I < ref_size; ++I) {
+        max_couplings[I] = dets_max_couplings_[ref_dets[I]];
+        new_max_couplings[I] =
+            (max_couplings[I].first == 0.0 or max_couplings[I].second == 0.0) ? 1 : 0;
+    }
+
+    // Each thread collects the (det, amplitude) pairs it spawns outside the reference space in
+    // its own buffer. The buffers are never shared, so no locking is needed during spawning.
     std::vector<std::vector<std::pair<Determinant, double>>> thread_det_C_vecs(num_threads_);
     num_off_diag_elem_ = 0;
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
     for (size_t I = 0; I < ref_size; ++I) {
-        std::pair<double, double> max_coupling;
         size_t current_rank = omp_get_thread_num();
-#pragma omp critical(dets_coupling)
-        { max_coupling = dets_max_couplings_[ref_dets[I]]; }
-        if (max_coupling.first == 0.0 or max_coupling.second == 0.0) {
-            thread_det_C_vecs[current_rank].clear();
-            apply_tau_H_symm_det_dynamic_HBCI_2(spawning_threshold, ref_dets, ref_C, I, ref_C[I],
-                                                result_C, thread_det_C_vecs[current_rank],
-                                                max_coupling);
-#pragma omp critical(merge_extra)
-            {
-                merge(extra_dets, extra_C, thread_det_C_vecs[current_rank],
-                      std::function<double(double, double)>(std::plus<double>()), 0.0, false);
-            }
-#pragma omp critical(dets_coupling)
-            { dets_max_couplings_[ref_dets[I]] = max_coupling; }
-        } else {
-            thread_det_C_vecs[current_rank].clear();
-            apply_tau_H_symm_det_dynamic_HBCI_2(spawning_threshold, ref_dets, ref_C, I, ref_C[I],
-                                                result_C, thread_det_C_vecs[current_rank],
-                                                max_coupling);
-#pragma omp critical(merge_extra)
-            {
-                merge(extra_dets, extra_C, thread_det_C_vecs[current_rank],
-                      std::function<double(double, double)>(std::plus<double>()), 0.0, false);
-            }
+        apply_tau_H_symm_det_dynamic_HBCI_2(spawning_threshold, ref_dets, ref_C, I, ref_C[I],
+                                            result_C, thread_det_C_vecs[current_rank],
+                                            max_couplings[I]);
+    }
+
+    for (size_t I = 0; I < ref_size; ++I) {
+        if (new_max_couplings[I]) {
+            dets_max_couplings_[ref_dets[I]] = max_couplings[I];
         }
     }
 
+    merge_spawned_dets(thread_det_C_vecs, extra_dets, extra_C);
+
     std::vector<size_t> removing_indices;
     for (size_t I = 0; I < ref_size; ++I) {
         if (result_C[I] == DBL_MIN) {
@@ -221,6 +227,50 @@ void PCISigmaVector::apply_tau_H_symm(double spawning_threshold, det_hashvec& re
         diag_[I] = as_ints_->energy(ref_dets[I]);
         result_C[I] += diag_[I] * ref_C[I];
     }
+
+    num_spawns_ = num_off_diag_elem_ / 2;
+    spawning_time_ = t_spawn.get();
+}
+
+void PCISigmaVector::merge_spawned_dets(
+    std::vector<std::vector<std::pair<Determinant, double>>>& thread_det_C_vecs,
+    det_hashvec& extra_dets, std::vector<double>& extra_C) {
+    // Distribute the spawned determinants into buckets according to their hash. A determinant
+    // always lands in the same bucket, so each bucket can be merged by one thread independently.
+    // The hash is scrambled (Fibonacci hashing) so that the determinants of a bucket do not all
+    // fall in the same slots of the bucket's hash vector.
+    const size_t nbuckets = num_threads_;
+    auto bucket_of = [nbuckets](const Determinant& d) {
+        const uint64_t h = Determinant::Hash()(d) * UINT64_C(11400714819323198485);
+        return static_cast<size_t>(h >> 32) % nbuckets;
+    };
+
+    std::vector<std::vector<std::vector<std::pair<Determinant, double>>>> thread_buckets(
+        num_threads_, std::vector<std::vector<std::pair<Determinant, double>>>(nbuckets));
+#pragma omp parallel for
+    for (int t = 0; t < num_threads_; ++t) {
+        for (const auto& det_C : thread_det_C_vecs[t]) {
+            thread_buckets[t][bucket_of(det_C.first)].push_back(det_C);
+        }
+        std::vector<std::pair<Determinant, double>>().swap(thread_det_C_vecs[t]);
+    }
+
+    std::vector<det_hashvec> bucket_dets(nbuckets);
+    std::vector<std::vector<double>> bucket_C(nbuckets);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t b = 0; b < nbuckets; ++b) {
+        for (int t = 0; t < num_threads_; ++t) {
+            merge(bucket_dets[b], bucket_C[b], thread_buckets[t][b],
+                  std::function<double(double, double)>(std::plus<double>()), 0.0, false);
+            std::vector<std::pair<Determinant, double>>().swap(thread_buckets[t][b]);
+        }
+    }
+
+    // The buckets are disjoint, so they can simply be appended
+    for (size_t b = 0; b < nbuckets; ++b) {
+        extra_dets.merge(bucket_dets[b]);
+        extra_C.insert(extra_C.end(), bucket_C[b].begin(), bucket_C[b].end());
+    }
 }
 
 void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
@@ -239,6 +289,9 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                         std::fabs(dets_double_max_coupling_ * CI) >= spawning_threshold;
     bool do_doubles = std::fabs(max_coupling.second * CI) >= spawning_threshold;
 
+    // Number of off-diagonal elements, added to the shared counter only once per determinant
+    size_t num_off_diag = 0;
+
     // Diagonal contributions
     // parallel_timer_on("PCI:diagonal", omp_get_thread_num());
     bool diagonal_flag = false;
@@ -280,8 +333,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                         new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                         diagonal_flag = true;
-#pragma omp atomic
-                                        num_off_diag_elem_ += 2;
+                                        num_off_diag += 2;
                                     }
                                 } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                               spawning_threshold)) {
@@ -289,8 +341,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     result_C[index] += HJI * CI;
                                     diagonal_flag = true;
                                     diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             }
 
@@ -332,8 +383,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                         new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                         diagonal_flag = true;
-#pragma omp atomic
-                                        num_off_diag_elem_ += 2;
+                                        num_off_diag += 2;
                                     }
                                 } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                               spawning_threshold)) {
@@ -341,8 +391,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     result_C[index] += HJI * CI;
                                     diagonal_flag = true;
                                     diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             }
 
@@ -389,8 +438,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                         new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                         diagonal_flag = true;
-#pragma omp atomic
-                                        num_off_diag_elem_ += 2;
+                                        num_off_diag += 2;
                                     }
                                 } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                               spawning_threshold)) {
@@ -398,8 +446,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     result_C[index] += HJI * CI;
                                     diagonal_flag = true;
                                     diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             }
 
@@ -443,8 +490,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                         new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                         diagonal_flag = true;
-#pragma omp atomic
-                                        num_off_diag_elem_ += 2;
+                                        num_off_diag += 2;
                                     }
                                 } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                               spawning_threshold)) {
@@ -452,8 +498,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                     result_C[index] += HJI * CI;
                                     diagonal_flag = true;
                                     diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             }
 
@@ -498,8 +543,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -507,8 +551,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -549,8 +592,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -558,8 +600,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -600,8 +641,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -609,8 +649,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -655,8 +694,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -664,8 +702,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -707,8 +744,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -716,8 +752,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -759,8 +794,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 if (important_H_CI_CJ_(HJI, CI, 0.0, spawning_threshold)) {
                                     new_det_C_vec.push_back(std::make_pair(detJ, HJI * CI));
                                     diagonal_flag = true;
-#pragma omp atomic
-                                    num_off_diag_elem_ += 2;
+                                    num_off_diag += 2;
                                 }
                             } else if (important_H_CI_CJ_(HJI, CI, pre_C[index],
                                                           spawning_threshold)) {
@@ -768,8 +802,7 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
                                 result_C[index] += HJI * CI;
                                 diagonal_flag = true;
                                 diagonal_contribution += HJI * pre_C[index];
-#pragma omp atomic
-                                num_off_diag_elem_ += 2;
+                                num_off_diag += 2;
                             }
                         }
 
@@ -792,6 +825,8 @@ void PCISigmaVector::apply_tau_H_symm_det_dynamic_HBCI_2(
             result_C[I] -= DBL_MIN;
         }
     }
+#pragma omp atomic
+    num_off_diag_elem_ += num_off_diag;
 }
 
 void PCISigmaVector::apply_tau_H_ref_C_symm(
@@ -802,13 +837,11 @@ void PCISigmaVector::apply_tau_H_ref_C_symm(
     result_C.clear();
     result_C.resize(result_size, 0.0);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
     for (size_t I = 0; I < overlap_size; ++I) {
-        std::pair<double, double> max_coupling;
-        max_coupling = dets_max_couplings_[result_dets[I]];
         apply_tau_H_ref_C_symm_det_dynamic_HBCI_2(spawning_threshold, result_dets, pre_C, ref_C, I,
                                                   pre_C[I], ref_C[I], overlap_size, result_C,
-                                                  max_coupling);
+                                                  ref_max_couplings_[I]);
     }
 
 #pragma omp parallel for
@@ -64,6 +64,10 @@ class PCISigmaVector : public SigmaVector {
     void compute_sigma_with_diag(psi::SharedVector sigma, psi::SharedVector b);
     size_t get_num_off_diag();
     size_t get_sigma_build_count();
+    /// @return the number of spawns (off-diagonal couplings) generated when building the space
+    size_t get_num_spawns();
+    /// @return the time (in s) spent spawning and merging the new determinants
+    double get_spawning_time();
 
   private:
     det_hashvec& dets_;
@@ -104,6 +108,12 @@ class PCISigmaVector : public SigmaVector {
     size_t sigma_build_count_;
     /// The maximum number of threads
     int num_threads_;
+    /// The number of spawns generated by apply_tau_H_symm
+    size_t num_spawns_ = 0;
+    /// The time spent in apply_tau_H_symm
+    double spawning_time_ = 0.0;
+    /// The coupling bounds of the reference determinants (indexed as in dets_)
+    std::vector<std::pair<double, double>> ref_max_couplings_;
 
     /// Orthogonalize the wave function to previous solutions
     void orthogonalize(const det_hashvec& space, std::vector<double>& C,
@@ -115,6 +125,12 @@ class PCISigmaVector : public SigmaVector {
                           std::vector<double>& ref_C, std::vector<double>& result_C,
                           size_t& overlap_size);
 
+    /// Merge the determinants spawned by each thread into a single list. The spawned
+    /// determinants are first bucketed by hash and each bucket is merged by a single thread.
+    void merge_spawned_dets(
+        std::vector<std::vector<std::pair<Determinant, double>>>& thread_det_C_vecs,
+        det_hashvec& extra_dets, std::vector<double>& extra_C);
+
     /// Apply symmetric approx tau H to a determinant using dynamic screening
     /// with selection according to a reference coefficient
     /// and with HBCI sorting scheme with singles screening
@@ -36,6 +36,8 @@ from psi4.driver.procrouting.proc_util import check_iwl_file_from_scf_type
 
 from psi4 import core
 
+import forte
+
 
 def fcidump(wfn, fname='INTDUMP', oe_ints=None, write_pntgrp=False):
     """Save integrals to file in FCIDUMP format as defined in Comp. Phys. Commun. 54 75 (1989)
@@ -362,3 +364,36 @@ def fcidump_from_file(fname, convert_to_psi4=False):
     intdump['eri'] = eri
 
     return intdump
+
+
+def fcidump_from_file_native(fname, convert_to_psi4=False):
+    """Function to read in a FCIDUMP file (text or binary) with the Forte C++ reader.
+
+    :returns: a dictionary with the same keys as fcidump_from_file, except that
+    the electron-repulsion integrals are not stored as a numpy array. Instead:
+      - 'ints' : a forte.FCIDUMP object that holds the integrals,
+                 (pq|rs) is returned by ints.eri(p, q, r, s)
+
+    :param fname: FCIDUMP file name
+    :param convert_to_psi4: If turned on and the FCIDUMP
+    file contains the PNTGRP label, the orbital symmetries will
+    be converted to the ordering used in psi4
+    """
+    ints = forte.FCIDUMP(str(fname))
+    intdump = {'norb': ints.norb(), 'nelec': ints.nelec(), 'ms2': ints.ms2(), 'isym': ints.isym(),
+               'uhf': False, 'orbsym': list(ints.orbsym())}
+    if ints.pntgrp() != '':
+        intdump['pntgrp'] = ints.pntgrp()
+
+    if convert_to_psi4 and ('pntgrp' in intdump):
+        irrep_map_inverse = _irrep_map_inverse(intdump['pntgrp'])
+        intdump['orbsym'] = [irrep_map_inverse[x] for x in intdump['orbsym']]
+        intdump['isym'] = irrep_map_inverse[intdump['isym']]
+
+    intdump['enuc'] = ints.enuc()
+    intdump['hcore'] = ints.hcore()
+    if len(ints.epsilon()) > 0:
+        intdump['epsilon'] = np.array(ints.epsilon())
+    intdump['ints'] = ints
+
+    return intdump
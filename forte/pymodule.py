@@ -292,7 +292,7 @@ def prepare_forte_objects_from_fcidump(options,path='.'):
     filename = pathlib.Path(path) / fcidump_file
     psi4.core.print_out(
         f'\n  Reading integral information from FCIDUMP file {filename}')
-    fcidump = forte.proc.fcidump_from_file(filename, convert_to_psi4=True)
+    fcidump = forte.proc.fcidump_from_file_native(filename, convert_to_psi4=True)
 
     irrep_size = {
         'c1': 1,
@@ -354,23 +354,23 @@ def prepare_forte_objects_from_fcidump(options,path='.'):
         epsilon_a = psi4.core.Vector(nmo)
         epsilon_b = psi4.core.Vector(nmo)
         hcore = fcidump['hcore']
-        eri = fcidump['eri']
+        eri = fcidump['ints'].eri
         nmo = fcidump['norb']
         for i in range(nmo):
             val = hcore[i,i]
             for h in range(nirrep):
                 for j in range(nmopi_offset[h],nmopi_offset[h]+doccpi[h]+soccpi[h]):
-                    val += eri[i,i,j,j] - eri[i,j,i,j]
+                    val += eri(i, i, j, j) - eri(i, j, i, j)
                 for j in range(nmopi_offset[h],nmopi_offset[h]+doccpi[h]):
-                    val += eri[i,i,j,j]
+                    val += eri(i, i, j, j)
             epsilon_a.set(i,val)
 
             val = hcore[i,i]
             for h in range(nirrep):
                 for j in range(nmopi_offset[h],nmopi_offset[h]+doccpi[h]+soccpi[h]):
-                    val += eri[i,i,j,j]
+                    val += eri(i, i, j, j)
                 for j in range(nmopi_offset[h],nmopi_offset[h]+doccpi[h]):
-                    val += eri[i,i,j,j] - eri[i,j,i,j]
+                    val += eri(i, i, j, j) - eri(i, j, i, j)
             epsilon_b.set(i,val)
 
     scf_info = forte.SCFInfo(doccpi, soccpi, 0.0, epsilon_a, epsilon_b)
@@ -381,6 +381,10 @@ def prepare_forte_objects_from_fcidump(options,path='.'):
 
 
 def make_ints_from_fcidump(fcidump, options, mo_space_info):
+    # the native reader stores the integrals in physicist notation and hands them over
+    if 'ints' in fcidump:
+        return forte.make_custom_ints_from_fcidump(options, mo_space_info, fcidump['ints'])
+
     # transform two-electron integrals from chemist to physicist notation
     eri = fcidump['eri']
     nmo = fcidump['norb']
@@ -505,6 +505,11 @@ def register_aci_options(options):
 
     options.add_bool("ACI_APPROXIMATE_RDM", False, "Approximate the RDMs?")
 
+    options.add_bool("ACI_INCREMENTAL_SIGMA", False,
+                     "Reuse the coupling lists of the determinants kept from the previous cycle"
+                     " (SPARSE algorithm only) and start the PQ-space Davidson procedure from"
+                     " the P-space eigenvectors?")
+
     options.add_bool("ACI_PRINT_WEIGHTS", False,
                      "Print weights for active space prediction?")
 
@@ -560,7 +565,7 @@ def register_aci_options(options):
     options.add_int("ACTIVE_GUESS_SIZE", 1000,
                     "Number of determinants for CI guess")
 
-    options.add_str("DIAG_ALGORITHM", "SPARSE", ["DYNAMIC", "FULL", "SPARSE"],
+    options.add_str("DIAG_ALGORITHM", "SPARSE", ["DYNAMIC", "FULL", "SPARSE", "GAS", "HYBRID"],
                     "The diagonalization method")
 
     options.add_bool("FORCE_DIAG_METHOD", False,
@@ -663,6 +668,33 @@ def register_integral_options(options):
                        "The tolerance for cholesky integrals")
     options.add_double("INTS_TOLERANCE", 1.0e-12,
                        "The tolerance for cholesky integrals")
+    options.add_str("THREE_INDEX_FILE", "",
+                    "A file used to store the DF/DISKDF three-index integrals. If the file"
+                    " exists and was computed with the same basis, geometry, and orbitals,"
+                    " the integrals are read from it instead of being recomputed")
+    options.add_str("INTEGRAL_CACHE_DIR", "",
+                    "A directory used to cache the transformed integrals (CONVENTIONAL, DF,"
+                    " and DISKDF) keyed on a hash of the basis, geometry, orbitals, and frozen"
+                    " orbitals. Repeated jobs with the same orbitals skip the transformation."
+                    " Only the integrals of the initial orbitals are cached, not those of the"
+                    " orbitals updated during an orbital optimization")
+    options.add_bool("THREE_INDEX_FILE_VERIFY", False,
+                     "Compare the checksum of the whole THREE_INDEX_FILE when it is reused"
+                     " (reads the entire file; by default only the header and tile table are"
+                     " checked)")
+    options.add_str("THREE_INDEX_FILE_LAYOUT", "PQMAJOR", ["PQMAJOR", "QMAJOR"],
+                    "The order of the elements in the tiles of THREE_INDEX_FILE")
+    options.add_str("THREE_INDEX_FILE_COMPRESSION", "NONE", ["NONE", "BOUNDED"],
+                    "The compression of THREE_INDEX_FILE"
+                    "- NONE Store the integrals as double precision numbers"
+                    "- BOUNDED Store 16- or 32-bit integers with absolute error"
+                    " below THREE_INDEX_FILE_MAX_ERROR")
+    options.add_double("THREE_INDEX_FILE_MAX_ERROR", 1.0e-8,
+                       "The maximum absolute error of the integrals stored in THREE_INDEX_FILE"
+                       " when THREE_INDEX_FILE_COMPRESSION is BOUNDED")
+    options.add_int("DISKDF_CACHE_MAX_MEMORY", 0,
+                    "The number of doubles used to cache (Q|pq) slabs when"
+                    " reading single DISKDF integrals (0: one eighth of the psi4 memory)")
     options.add_bool("PRINT_INTS", False,
                      "Print the one- and two-electron integrals?")
 
@@ -729,6 +761,13 @@ def register_dsrg_options(options):
     options.add_double("INTRUDER_TAMP", 0.10,
                        "Threshold for amplitudes considered as intruders for printing")
 
+    options.add_int("DSRG_T2_TILE_SIZE", 0,
+                    "Tile size (orbitals per index) of the core-virtual T2 tile report printed"
+                    " by DSRG-MRPT2 (0 to skip the report)")
+
+    options.add_double("DSRG_T2_TILE_THRESHOLD", 1.0e-6,
+                       "Central tile norm threshold of the DSRG-MRPT2 core-virtual T2 tile report")
+
     options.add_str("DSRG_TRANS_TYPE", "UNITARY", ["UNITARY", "CC"],
                     "DSRG transformation type")
 
@@ -784,13 +823,21 @@ def register_dsrg_options(options):
                     ["CORE", "FLY_AMBIT", "FLY_LOOP", "BATCH_CORE", "BATCH_VIRTUAL",
                      "BATCH_CORE_GA", "BATCH_VIRTUAL_GA", "BATCH_VIRTUAL_MPI", "BATCH_CORE_MPI",
                      "BATCH_CORE_REP", "BATCH_VIRTUAL_REP"],
-                    "Algorithm to compute the CCVV term in DSRG-MRPT2 (only in three-dsrg-mrpt2 code)")
+                    "Algorithm to compute the CCVV term in DSRG-MRPT2 (only in three-dsrg-mrpt2 code)."
+                    " BATCH_CORE_MPI and BATCH_VIRTUAL_MPI distribute the three-index integrals"
+                    " over MPI processes by core or virtual index. Only the ccvv term and, with"
+                    " DiskDF, the cavv/ccva terms are distributed; all other terms and Hbar are"
+                    " computed on rank 0, which needs the memory of a serial run")
 
     options.add_bool("AO_DSRG_MRPT2", False,
                      "Do AO-DSRG-MRPT2 if true (not available)")
 
     options.add_int("CCVV_BATCH_NUMBER", -1, "Batches for CCVV_ALGORITHM")
 
+    options.add_bool("DSRG_DISKDF_PREFETCH", True,
+                     "Read the next block of three-index integrals on a background thread"
+                     " in the batched algorithms of three-dsrg-mrpt2")
+
     options.add_bool("DSRG_MRPT2_DEBUG", False,
                      "Excssive printing for three-dsrg-mrpt2")
 
@@ -809,15 +856,31 @@ def register_dsrg_options(options):
     options.add_bool("DSRG_NIVO", False,
                      "NIVO approximation: Omit tensor blocks with >= 3 virtual indices if true")
 
+    options.add_bool("DSRG_DISK_VVVV", False,
+                     "Store the vvvv blocks of the MR-LDSRG(2) commutator intermediates on disk"
+                     " in tiles (SA-MRDSRG only)")
+
+    options.add_int("DSRG_DISK_VVVV_TILE", 0,
+                    "The number of virtual orbitals (first index) in one vvvv tile stored on disk"
+                    " (0: as many as fit in the available memory)")
+
     options.add_bool("PRINT_1BODY_EVALS", False,
                      "Print eigenvalues of 1-body effective H")
 
     options.add_bool("DSRG_MRPT3_BATCHED", False,
                      "Force running the DSRG-MRPT3 code using the batched algorithm")
 
+    options.add_int("DSRG_MRPT3_VIRT_BATCH", 0,
+                    "The number of virtual orbitals in one batch of the batched DSRG-MRPT3"
+                    " algorithm (0: as many as fit in the available memory)")
+
     options.add_bool("IGNORE_MEMORY_WARNINGS", False,
                      "Force running the DSRG-MRPT3 code using the batched algorithm")
 
+    options.add_int("DSRG_MRPT3_VIRT_BATCH", 0,
+                    "The number of virtual orbitals in one batch of the batched DSRG-MRPT3"
+                    " algorithm (0: as many as fit in the available memory)")
+
     options.add_int("DSRG_DIIS_START", 2,
                     "Iteration cycle to start adding error vectors for"
                     " DSRG DIIS (< 1 for not doing DIIS)")
@@ -829,6 +892,13 @@ def register_dsrg_options(options):
 
     options.add_int("DSRG_DIIS_MAX_VEC", 6, "Maximum size of DIIS vectors")
 
+    options.add_bool("DSRG_DIIS_FLOAT", False,
+                     "Store DSRG DIIS vectors in single precision to halve their memory."
+                     " Extrapolated amplitudes are then accurate to about 1e-7 (relative)")
+
+    options.add_bool("DSRG_SO_DIIS", False,
+                     "Use DIIS (controlled by the DSRG_DIIS_* options) in SO-MRDSRG")
+
     options.add_bool("DSRG_RESTART_AMPS", True,
                      "Restart DSRG amplitudes from a previous step")
 
@@ -1037,8 +1107,19 @@ def register_old_options(options):
                     "Select a modified commutator")
 
     options.add_str("SRG_ODEINT", "FEHLBERG78",
-                    ["DOPRI5", "CASHKARP", "FEHLBERG78"],
-                    "The integrator used to propagate the SRG equations")
+                    ["DOPRI5", "CASHKARP", "FEHLBERG78", "TENSOR_DOPRI5"],
+                    "The integrator used to propagate the SRG equations."
+                    " TENSOR_DOPRI5 integrates directly on the tensors and supports checkpoints")
+
+    options.add_int("SRG_CHECKPOINT_FREQ", 0,
+                    "Write the SRG flow state to disk every this many accepted steps"
+                    " (TENSOR_DOPRI5 only, 0 to disable)")
+
+    options.add_bool("SRG_RESTART", False,
+                     "Resume the SRG flow from the checkpoint file in the current directory"
+                     " (TENSOR_DOPRI5 only). The file holds the last checkpointed state, which"
+                     " may be the end of a finished flow with a smaller DSRG_S. The starting s"
+                     " is printed and stored in the variable SRG START S")
     #    /*- The end value of the integration parameter s -*/
     options.add_double("SRG_SMAX", 10.0, "The end value of the integration parameter s")
 
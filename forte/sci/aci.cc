@@ -40,6 +40,7 @@
 #include "helpers/helpers.h"
 #include "ci_rdm/ci_rdms.h"
 #include "sparse_ci/ci_reference.h"
+#include "sparse_ci/sigma_vector_sparse_list.h"
 
 #include "mrpt2.h"
 #include "aci.h"
@@ -128,6 +129,8 @@ void AdaptiveCI::startup() {
     if (sigma_vector_type_ == SigmaVectorType::Dynamic) {
         build_lists_ = false;
     }
+
+    incremental_sigma_ = options_->get_bool("ACI_INCREMENTAL_SIGMA");
 }
 
 void AdaptiveCI::print_info() {
@@ -161,7 +164,8 @@ void AdaptiveCI::print_info() {
         {"Project out spin contaminants", project_out_spin_contaminants_ ? "True" : "False"},
         {"Enforce spin completeness of basis", spin_complete_ ? "True" : "False"},
         {"Enforce complete aimed selection", add_aimed_degenerate_ ? "True" : "False"},
-        {"Multiroot averaging ", average_function_ == AverageFunction::MaxF ? "Max" : "Average"}};
+        {"Multiroot averaging ", average_function_ == AverageFunction::MaxF ? "Max" : "Average"},
+        {"Incremental sigma vector", incremental_sigma_ ? "True" : "False"}};
 
     // Print some information
     outfile->Printf("\n  ==> Calculation Information <==\n");
@@ -674,7 +678,8 @@ void AdaptiveCI::diagonalize_P_space() {
     sparse_solver_->manual_guess(false);
     local_timer diag;
 
-    auto sigma_vector = make_sigma_vector(P_space_, as_ints_, max_memory_, sigma_vector_type_);
+    auto sigma_vector =
+        make_sigma_vector(P_space_, as_ints_, max_memory_, sigma_vector_type_, relative_gas_mo_);
     std::tie(P_evals_, P_evecs_) = sparse_solver_->diagonalize_hamiltonian(
         P_space_, sigma_vector, num_ref_roots_, multiplicity_);
     auto spin = sparse_solver_->spin();
@@ -729,10 +734,42 @@ void AdaptiveCI::diagonalize_PQ_space() {
 
     outfile->Printf("\n  Number of reference roots: %d", num_ref_roots_);
 
-    auto sigma_vector = make_sigma_vector(PQ_space_, as_ints_, max_memory_, sigma_vector_type_);
+    std::shared_ptr<SigmaVector> sigma_vector;
+    if (incremental_sigma_ and sigma_vector_type_ == SigmaVectorType::SparseList) {
+        // keep the coupling lists of the determinants that survive from the previous cycle
+        if (not PQ_lists_) {
+            PQ_lists_ = std::make_shared<DeterminantSubstitutionLists>(as_ints_);
+            PQ_lists_->set_quiet_mode(quiet_mode_);
+        }
+        sigma_vector = std::make_shared<SigmaVectorSparseList>(PQ_space_, as_ints_, PQ_lists_);
+    } else {
+        sigma_vector = make_sigma_vector(PQ_space_, as_ints_, max_memory_, sigma_vector_type_,
+                                         relative_gas_mo_);
+    }
+
+    // start the Davidson procedure from the P space solution (P is contained in PQ)
+    bool warm_start = incremental_sigma_ and P_evecs_ and
+                      (P_evecs_->coldim() >= num_ref_roots_);
+    if (warm_start) {
+        std::vector<std::vector<std::pair<size_t, double>>> guess(num_ref_roots_);
+        for (int n = 0; n < num_ref_roots_; ++n) {
+            for (size_t I = 0, max_I = P_space_.size(); I < max_I; ++I) {
+                const Determinant& det = P_space_.get_det(I);
+                if (PQ_space_.has_det(det)) {
+                    guess[n].push_back(std::make_pair(PQ_space_.get_idx(det), P_evecs_->get(I, n)));
+                }
+            }
+        }
+        sparse_solver_->set_initial_guess(guess);
+    }
+
     std::tie(PQ_evals_, PQ_evecs_) = sparse_solver_->diagonalize_hamiltonian(
         PQ_space_, sigma_vector, num_ref_roots_, multiplicity_);
 
+    if (warm_start) {
+        sparse_solver_->manual_guess(false);
+    }
+
     if (!quiet_mode_)
         outfile->Printf("\n  Total time spent diagonalizing H:   %1.6f s", diag_pq.get());
 
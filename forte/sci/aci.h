@@ -34,6 +34,7 @@
 
 #include "sci/sci.h"
 #include "sparse_ci/sparse_ci_solver.h"
+#include "sparse_ci/determinant_substitution_lists.h"
 #include "helpers/timer.h"
 
 using d1 = std::vector<double>;
@@ -197,6 +198,11 @@ class AdaptiveCI : public SelectedCIMethod {
 
     bool build_lists_;
 
+    /// Reuse the sigma vector data and the eigenvectors between cycles?
+    bool incremental_sigma_ = false;
+    /// The coupling lists of the PQ space, updated incrementally at each cycle
+    std::shared_ptr<DeterminantSubstitutionLists> PQ_lists_;
+
     /// A map of determinants in the P space
     std::unordered_map<Determinant, int, Determinant::Hash> P_space_map_;
     /// A History of Determinants
@@ -150,8 +150,18 @@ void DETCI::diagoanlize_hamiltonian() {
         sigma_vector_type_ = SigmaVectorType::Full;
     }
 
+    // the GAS sigma vector groups the strings according to the GAS occupation
+    std::vector<std::vector<size_t>> gas_mos;
+    if (actv_space_type_ == "GAS" and sigma_vector_type_ == SigmaVectorType::GAS) {
+        for (size_t n = 1; n <= 6; ++n) {
+            auto mos = mo_space_info_->pos_in_space("GAS" + std::to_string(n), "ACTIVE");
+            if (not mos.empty())
+                gas_mos.push_back(mos);
+        }
+    }
+
     auto sigma_vector =
-        make_sigma_vector(p_space_, as_ints_, sigma_max_memory_, sigma_vector_type_);
+        make_sigma_vector(p_space_, as_ints_, sigma_max_memory_, sigma_vector_type_, gas_mos);
     std::tie(evals_, evecs_) =
         solver->diagonalize_hamiltonian(p_space_, sigma_vector, nroot_, multiplicity_);
 
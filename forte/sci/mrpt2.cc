@@ -127,6 +127,9 @@ double MRPT2::energy_kernel(int bin, int nbin, int root) {
     const size_t n_dets = reference_.size();
     const det_hashvec& dets = reference_.wfn_hash();
     det_hash<double> A_I;
+    std::vector<std::pair<int, int>> excitations;
+    std::vector<Determinant> new_dets;
+    std::vector<double> couplings;
     for (size_t I = 0; I < n_dets; ++I) {
         double c_I = evecs_->get(I, root);
         const Determinant& det = dets[I];
@@ -142,6 +145,8 @@ double MRPT2::energy_kernel(int bin, int nbin, int root) {
         Determinant new_det(det);
 
         // Generate alpha excitations
+        excitations.clear();
+        new_dets.clear();
         for (int i = 0; i < noalpha; ++i) {
             int ii = aocc[i];
             for (int a = 0; a < nvalpha; ++a) {
@@ -156,17 +161,22 @@ double MRPT2::energy_kernel(int bin, int nbin, int root) {
                     // Check if the determinant goes in this bin
                     size_t hash_val = Determinant::Hash()(new_det);
                     if ((hash_val % nbin) == bin) {
-                        double coupling =
-                            as_ints_->slater_rules_single_alpha(new_det, ii, aa) * c_I;
-                        if (A_I.find(new_det) != A_I.end()) {
-                            coupling += A_I[new_det];
-                        }
-                        A_I[new_det] = coupling;
+                        excitations.push_back({ii, aa});
+                        new_dets.push_back(new_det);
                     }
                 }
             }
         }
+        as_ints_->slater_rules_singles_alpha_abs(aocc, bocc, excitations, couplings);
+        for (size_t k = 0, maxk = new_dets.size(); k < maxk; ++k) {
+            const auto& [ii, aa] = excitations[k];
+            double sign = new_dets[k].slater_sign_aa(ii, aa);
+            A_I[new_dets[k]] += sign * couplings[k] * c_I;
+        }
+
         // Generate beta excitations
+        excitations.clear();
+        new_dets.clear();
         for (int i = 0; i < nobeta; ++i) {
             int ii = bocc[i];
             for (int a = 0; a < nvbeta; ++a) {
@@ -180,15 +190,18 @@ double MRPT2::energy_kernel(int bin, int nbin, int root) {
                     // Check if the determinant goes in this bin
                     size_t hash_val = Determinant::Hash()(new_det);
                     if ((hash_val % nbin) == bin) {
-                        double coupling = as_ints_->slater_rules_single_beta(new_det, ii, aa) * c_I;
-                        if (A_I.find(new_det) != A_I.end()) {
-                            coupling += A_I[new_det];
-                        }
-                        A_I[new_det] = coupling;
+                        excitations.push_back({ii, aa});
+                        new_dets.push_back(new_det);
                     }
                 }
             }
         }
+        as_ints_->slater_rules_singles_beta_abs(aocc, bocc, excitations, couplings);
+        for (size_t k = 0, maxk = new_dets.size(); k < maxk; ++k) {
+            const auto& [ii, aa] = excitations[k];
+            double sign = new_dets[k].slater_sign_bb(ii, aa);
+            A_I[new_dets[k]] += sign * couplings[k] * c_I;
+        }
         // Generate ab excitations
         for (int i = 0; i < noalpha; ++i) {
             int ii = aocc[i];
@@ -282,8 +295,18 @@ double MRPT2::energy_kernel(int bin, int nbin, int root) {
         }
     }
 
-    for (auto& det : A_I) {
-        energy += (det.second * det.second) / (E_0 - as_ints_->energy(det.first));
+    // evaluate the diagonal of the excited determinants in one batch
+    new_dets.clear();
+    couplings.clear();
+    new_dets.reserve(A_I.size());
+    couplings.reserve(A_I.size());
+    for (const auto& [det, coupling] : A_I) {
+        new_dets.push_back(det);
+        couplings.push_back(coupling);
+    }
+    std::vector<double> E_A = as_ints_->energy(new_dets);
+    for (size_t A = 0, maxA = new_dets.size(); A < maxA; ++A) {
+        energy += (couplings[A] * couplings[A]) / (E_0 - E_A[A]);
     }
     return energy;
 }
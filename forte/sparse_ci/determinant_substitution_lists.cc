@@ -405,6 +405,165 @@ void DeterminantSubstitutionLists::clear_tp_s_lists() {
     ab_list_.clear();
 }
 
+namespace {
+/// Remap the determinant indices stored in a coupling list and remove the determinants that are
+/// no longer in the space (new index = npos). Empty lists are removed and the map from the
+/// annihilated determinants to the lists is updated accordingly.
+template <typename T>
+void remap_coupling_list(std::vector<std::vector<T>>& list, det_hash<size_t>& ann_map,
+                         const std::vector<size_t>& old_to_new) {
+    const size_t npos = det_hashvec::npos;
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t K = 0; K < list.size(); ++K) {
+        auto& entries = list[K];
+        size_t n = 0;
+        for (const auto& e : entries) {
+            const size_t new_I = old_to_new[std::get<0>(e)];
+            if (new_I != npos) {
+                entries[n] = e;
+                std::get<0>(entries[n]) = new_I;
+                n++;
+            }
+        }
+        entries.resize(n);
+    }
+
+    // compact the list
+    std::vector<size_t> new_pos(list.size(), npos);
+    size_t n = 0;
+    for (size_t K = 0; K < list.size(); ++K) {
+        if (not list[K].empty()) {
+            new_pos[K] = n;
+            if (n != K)
+                list[n] = std::move(list[K]);
+            n++;
+        }
+    }
+    list.resize(n);
+    for (auto it = ann_map.begin(); it != ann_map.end();) {
+        if (new_pos[it->second] == npos) {
+            it = ann_map.erase(it);
+        } else {
+            it->second = new_pos[it->second];
+            ++it;
+        }
+    }
+}
+
+/// Find the list of an annihilated determinant, adding a new list if necessary
+template <typename T>
+std::vector<T>& find_coupling_list(std::vector<std::vector<T>>& list, det_hash<size_t>& ann_map,
+                                   const Determinant& ann_det) {
+    auto it = ann_map.find(ann_det);
+    if (it == ann_map.end()) {
+        ann_map[ann_det] = list.size();
+        list.emplace_back();
+        return list.back();
+    }
+    return list[it->second];
+}
+} // namespace
+
+void DeterminantSubstitutionLists::update_lists(const DeterminantHashVec& wfn) {
+    timer ops("Incremental sub. lists");
+
+    const det_hashvec& dets = wfn.wfn_hash();
+    const size_t nold = lists_dets_.size();
+
+    // Remove the determinants that are no longer in the space and update the indices
+    local_timer t_remap;
+    std::vector<size_t> old_to_new(nold);
+#pragma omp parallel for
+    for (size_t I = 0; I < nold; ++I) {
+        old_to_new[I] = dets.find(lists_dets_[I]);
+    }
+    remap_coupling_list(a_list_, a_ann_map_, old_to_new);
+    remap_coupling_list(b_list_, b_ann_map_, old_to_new);
+    remap_coupling_list(aa_list_, aa_ann_map_, old_to_new);
+    remap_coupling_list(bb_list_, bb_ann_map_, old_to_new);
+    remap_coupling_list(ab_list_, ab_ann_map_, old_to_new);
+    double remap_time = t_remap.get();
+
+    // Add the substitutions of the new determinants
+    local_timer t_add;
+    size_t nnew = 0;
+    for (size_t I = 0, max_I = dets.size(); I < max_I; ++I) {
+        if (lists_dets_.find(dets[I]) == det_hashvec::npos) {
+            add_det_to_lists(I, dets[I]);
+            nnew++;
+        }
+    }
+    double add_time = t_add.get();
+
+    lists_dets_ = dets;
+
+    if (!quiet_) {
+        print_h2("Updating Coupling Lists");
+        outfile->Printf("\n        Determinants kept  %zu", dets.size() - nnew);
+        outfile->Printf("\n        Determinants added %zu", nnew);
+        outfile->Printf("\n        Remap      %.3e seconds", remap_time);
+        outfile->Printf("\n        Add        %.3e seconds", add_time);
+    }
+}
+
+void DeterminantSubstitutionLists::add_det_to_lists(size_t I, const Determinant& detI) {
+    const std::vector<int> aocc = detI.get_alfa_occ(ncmo_);
+    const std::vector<int> bocc = detI.get_beta_occ(ncmo_);
+    const int noalfa = aocc.size();
+    const int nobeta = bocc.size();
+
+    // alpha singles and alpha-alpha doubles
+    for (int i = 0; i < noalfa; ++i) {
+        int ii = aocc[i];
+        Determinant detJ(detI);
+        detJ.set_alfa_bit(ii, false);
+        double sign = detI.slater_sign_a(ii);
+        find_coupling_list(a_list_, a_ann_map_, detJ)
+            .push_back(std::make_pair(I, sign > 0.0 ? (ii + 1) : (-ii - 1)));
+        for (int j = i + 1; j < noalfa; ++j) {
+            int jj = aocc[j];
+            Determinant detK(detJ);
+            detK.set_alfa_bit(jj, false);
+            double sign_aa = sign * detI.slater_sign_a(jj);
+            find_coupling_list(aa_list_, aa_ann_map_, detK)
+                .push_back(std::make_tuple(I, (sign_aa > 0.0) ? (ii + 1) : (-ii - 1), jj));
+        }
+    }
+
+    // beta singles and beta-beta doubles
+    for (int i = 0; i < nobeta; ++i) {
+        int ii = bocc[i];
+        Determinant detJ(detI);
+        detJ.set_beta_bit(ii, false);
+        double sign = detI.slater_sign_b(ii);
+        find_coupling_list(b_list_, b_ann_map_, detJ)
+            .push_back(std::make_pair(I, sign > 0.0 ? (ii + 1) : (-ii - 1)));
+        for (int j = i + 1; j < nobeta; ++j) {
+            int jj = bocc[j];
+            Determinant detK(detJ);
+            detK.set_beta_bit(jj, false);
+            double sign_bb = sign * detI.slater_sign_b(jj);
+            find_coupling_list(bb_list_, bb_ann_map_, detK)
+                .push_back(std::make_tuple(I, (sign_bb > 0.0) ? (ii + 1) : (-ii - 1), jj));
+        }
+    }
+
+    // alpha-beta doubles (the sign is computed as in tp_s_lists())
+    for (int i = 0; i < noalfa; ++i) {
+        int ii = aocc[i];
+        Determinant detJ(detI);
+        detJ.set_alfa_bit(ii, false);
+        for (int j = 0; j < nobeta; ++j) {
+            int jj = bocc[j];
+            Determinant detK(detJ);
+            detK.set_beta_bit(jj, false);
+            double sign = detJ.slater_sign_a(ii) * detJ.slater_sign_b(jj);
+            find_coupling_list(ab_list_, ab_ann_map_, detK)
+                .push_back(std::make_tuple(I, (sign > 0.0) ? (ii + 1) : (-ii - 1), jj));
+        }
+    }
+}
+
 void DeterminantSubstitutionLists::three_s_lists(const DeterminantHashVec& wfn) {
     timer ops("Triple sub. lists");
 
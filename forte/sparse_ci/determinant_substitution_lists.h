@@ -62,6 +62,13 @@ class DeterminantSubstitutionLists {
 
     void clear_op_s_lists();
     void clear_tp_s_lists();
+
+    /// Build the one- and two-particle coupling lists incrementally. The lists built for the
+    /// space passed in the previous call are kept: determinants that are no longer in wfn are
+    /// removed, the indices of the surviving ones are updated, and only the substitutions of the
+    /// determinants not contained in the previous space are generated.
+    /// Unlike op_s_lists()/tp_s_lists(), the lists may contain entries with a single determinant.
+    void update_lists(const DeterminantHashVec& wfn);
     /*- Operators -*/
 
     void build_strings(const DeterminantHashVec& wfn);
@@ -98,6 +105,20 @@ class DeterminantSubstitutionLists {
 
     /// The integrals
     std::shared_ptr<ActiveSpaceIntegrals> fci_ints_;
+
+    // ==> Data used by update_lists() <==
+
+    /// The space used in the last call to update_lists()
+    det_hashvec lists_dets_;
+    /// Maps from annihilated determinants to the position of their list
+    det_hash<size_t> a_ann_map_;
+    det_hash<size_t> b_ann_map_;
+    det_hash<size_t> aa_ann_map_;
+    det_hash<size_t> bb_ann_map_;
+    det_hash<size_t> ab_ann_map_;
+
+    /// Add the one- and two-particle substitutions of determinant I to the lists
+    void add_det_to_lists(size_t I, const Determinant& detI);
 };
 } // namespace forte
 
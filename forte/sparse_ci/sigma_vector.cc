@@ -29,6 +29,8 @@
 #include "helpers/string_algorithms.h"
 #include "integrals/active_space_integrals.h"
 #include "sigma_vector_dynamic.h"
+#include "sigma_vector_gas.h"
+#include "sigma_vector_hybrid.h"
 #include "sigma_vector_sparse_list.h"
 
 namespace forte {
@@ -41,14 +43,19 @@ SigmaVectorType string_to_sigma_vector_type(std::string type) {
         return SigmaVectorType::SparseList;
     } else if (type == "DYNAMIC") {
         return SigmaVectorType::Dynamic;
+    } else if (type == "GAS") {
+        return SigmaVectorType::GAS;
+    } else if (type == "HYBRID") {
+        return SigmaVectorType::Hybrid;
     }
     throw std::runtime_error("string_to_sigma_vector_type() called with incorrect type: " + type);
     return SigmaVectorType::Dynamic;
 }
 
-std::shared_ptr<SigmaVector> make_sigma_vector(DeterminantHashVec& space,
-                                               std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
-                                               size_t max_memory, SigmaVectorType sigma_type) {
+std::shared_ptr<SigmaVector>
+make_sigma_vector(DeterminantHashVec& space, std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                  size_t max_memory, SigmaVectorType sigma_type,
+                  const std::vector<std::vector<size_t>>& gas_mos) {
     std::shared_ptr<SigmaVector> sigma_vector;
     if (sigma_type == SigmaVectorType::Dynamic) {
         sigma_vector = std::make_shared<SigmaVectorDynamic>(space, fci_ints, max_memory);
@@ -56,6 +63,10 @@ std::shared_ptr<SigmaVector> make_sigma_vector(DeterminantHashVec& space,
         sigma_vector = std::make_shared<SigmaVectorSparseList>(space, fci_ints);
     } else if (sigma_type == SigmaVectorType::Full) {
         sigma_vector = std::make_shared<SigmaVectorFull>(space, fci_ints);
+    } else if (sigma_type == SigmaVectorType::GAS) {
+        sigma_vector = std::make_shared<SigmaVectorGAS>(space, fci_ints, max_memory, gas_mos);
+    } else if (sigma_type == SigmaVectorType::Hybrid) {
+        sigma_vector = std::make_shared<SigmaVectorHybrid>(space, fci_ints, max_memory);
     }
     return sigma_vector;
 }
@@ -40,7 +40,7 @@ class Vector;
 
 namespace forte {
 
-enum class SigmaVectorType { Dynamic, SparseList, Full };
+enum class SigmaVectorType { Dynamic, SparseList, Full, GAS, Hybrid };
 
 class ActiveSpaceIntegrals;
 class DeterminantSubstitutionLists;
@@ -99,9 +99,12 @@ class SigmaVectorFull : public SigmaVector {
 
 SigmaVectorType string_to_sigma_vector_type(std::string type);
 
-std::shared_ptr<SigmaVector> make_sigma_vector(DeterminantHashVec& space,
-                                               std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
-                                               size_t max_memory, SigmaVectorType sigma_type);
+/// Make a sigma vector object. gas_mos (optional) lists the orbitals in each GAS and is used only
+/// by the GAS algorithm
+std::shared_ptr<SigmaVector>
+make_sigma_vector(DeterminantHashVec& space, std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                  size_t max_memory, SigmaVectorType sigma_type,
+                  const std::vector<std::vector<size_t>>& gas_mos = {});
 
 std::shared_ptr<SigmaVector> make_sigma_vector(const std::vector<Determinant>& space,
                                                std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
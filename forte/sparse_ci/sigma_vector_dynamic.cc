@@ -27,6 +27,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cmath>
 #include <thread>
 #include <future>
@@ -84,11 +85,7 @@ SigmaVectorDynamic::SigmaVectorDynamic(const DeterminantHashVec& space,
 
     nmo_ = fci_ints_->nmo();
 
-    for (size_t I = 0; I < size_; ++I) {
-        const Determinant& detI = space.get_det(I);
-        double EI = fci_ints_->energy(detI);
-        diag_.push_back(EI);
-    }
+    diag_ = fci_ints_->energy(space.wfn_hash());
     temp_sigma_.resize(size_);
     temp_b_.resize(size_);
 
@@ -199,9 +196,7 @@ void SigmaVectorDynamic::add_bad_roots(std::vector<std::vector<std::pair<size_t,
 }
 
 void SigmaVectorDynamic::get_diagonal(psi::Vector& diag) {
-    for (size_t I = 0; I < diag_.size(); ++I) {
-        diag.set(I, diag_[I]);
-    }
+    std::copy(diag_.begin(), diag_.end(), diag.pointer());
 }
 
 void SigmaVectorDynamic::compute_sigma_scalar(psi::SharedVector sigma, psi::SharedVector b) {
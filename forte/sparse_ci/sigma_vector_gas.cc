@@ -0,0 +1,574 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libmints/vector.h"
+
+#include "helpers/timer.h"
+#include "integrals/active_space_integrals.h"
+#include "sigma_vector_gas.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#define omp_get_num_threads() 1
+#endif
+
+using namespace psi;
+
+namespace forte {
+
+namespace {
+/// Build a determinant with only the alpha (or beta) string occupied
+Determinant single_spin_det(const String& s, bool alpha, size_t nmo) {
+    Determinant d;
+    for (size_t p = 0; p < nmo; ++p) {
+        if (s.get_bit(p)) {
+            if (alpha) {
+                d.set_alfa_bit(p, true);
+            } else {
+                d.set_beta_bit(p, true);
+            }
+        }
+    }
+    return d;
+}
+
+/// Return the occupied and unoccupied orbitals of a string
+void occ_vir(const String& s, size_t nmo, std::vector<size_t>& occ, std::vector<size_t>& vir) {
+    occ.clear();
+    vir.clear();
+    for (size_t p = 0; p < nmo; ++p) {
+        if (s.get_bit(p)) {
+            occ.push_back(p);
+        } else {
+            vir.push_back(p);
+        }
+    }
+}
+} // namespace
+
+SigmaVectorGAS::SigmaVectorGAS(const DeterminantHashVec& space,
+                               std::shared_ptr<ActiveSpaceIntegrals> fci_ints, size_t max_memory,
+                               const std::vector<std::vector<size_t>>& gas_mos, bool print)
+    : SigmaVector(space, fci_ints, SigmaVectorType::GAS, "SigmaVectorGAS") {
+    local_timer t;
+    nmo_ = fci_ints_->nmo();
+
+    build_string_classes(gas_mos);
+    build_blocks(max_memory);
+    build_same_spin_couplings(true);
+    build_same_spin_couplings(false);
+    build_alpha_substitutions();
+    build_beta_substitutions();
+    build_tasks();
+    compute_diagonal();
+
+    // the string maps are only needed to build the coupling lists
+    a_string_map_.clear();
+    b_string_map_.clear();
+
+    if (not print)
+        return;
+    size_t nblock_pairs = blocks_.size() * blocks_.size();
+    outfile->Printf("\n  GAS sigma vector: %zu alpha and %zu beta string classes",
+                    a_class_strings_.size(), b_class_strings_.size());
+    outfile->Printf("\n  Number of dense blocks:       %10zu (fill = %.3f)", blocks_.size(),
+                    blocked_size_ > 0 ? static_cast<double>(size_) / blocked_size_ : 0.0);
+    outfile->Printf("\n  Coupled block pairs (aa/bb/ab): %zu/%zu/%zu out of %zu", aa_tasks_.size(),
+                    bb_tasks_.size(), ab_tasks_.size(), nblock_pairs);
+    outfile->Printf("\n  Time to build the GAS lists:  %10.3f s", t.get());
+}
+
+void SigmaVectorGAS::build_string_classes(const std::vector<std::vector<size_t>>& gas_mos) {
+    // assign each orbital to a GAS, orbitals not in any GAS go in an extra space
+    std::vector<size_t> orbital_gas(nmo_, gas_mos.size());
+    for (size_t n = 0; n < gas_mos.size(); ++n) {
+        for (size_t p : gas_mos[n]) {
+            orbital_gas[p] = n;
+        }
+    }
+    const size_t ngas = gas_mos.size() + 1;
+
+    auto classify = [&](const String& s, std::map<std::vector<int>, size_t>& patterns,
+                        std::vector<std::vector<size_t>>& class_strings) {
+        std::vector<int> pattern(ngas, 0);
+        for (size_t p = 0; p < nmo_; ++p) {
+            if (s.get_bit(p))
+                pattern[orbital_gas[p]] += 1;
+        }
+        auto it = patterns.find(pattern);
+        if (it == patterns.end()) {
+            it = patterns.emplace(pattern, patterns.size()).first;
+            class_strings.emplace_back();
+        }
+        return it->second;
+    };
+
+    std::map<std::vector<int>, size_t> a_patterns;
+    std::map<std::vector<int>, size_t> b_patterns;
+    const det_hashvec& dets = space_.wfn_hash();
+    for (size_t I = 0, maxI = dets.size(); I < maxI; ++I) {
+        String Ia = dets[I].get_alfa_bits();
+        if (a_string_map_.count(Ia) == 0) {
+            size_t c = classify(Ia, a_patterns, a_class_strings_);
+            a_string_map_[Ia] = a_strings_.size();
+            a_index_.push_back(a_class_strings_[c].size());
+            a_class_strings_[c].push_back(a_strings_.size());
+            a_class_.push_back(c);
+            a_strings_.push_back(Ia);
+        }
+        String Ib = dets[I].get_beta_bits();
+        if (b_string_map_.count(Ib) == 0) {
+            size_t c = classify(Ib, b_patterns, b_class_strings_);
+            b_string_map_[Ib] = b_strings_.size();
+            b_index_.push_back(b_class_strings_[c].size());
+            b_class_strings_[c].push_back(b_strings_.size());
+            b_class_.push_back(c);
+            b_strings_.push_back(Ib);
+        }
+    }
+}
+
+void SigmaVectorGAS::build_blocks(size_t max_memory) {
+    const det_hashvec& dets = space_.wfn_hash();
+    const size_t ndets = dets.size();
+    std::vector<size_t> det_a(ndets);
+    std::vector<size_t> det_b(ndets);
+    for (size_t I = 0; I < ndets; ++I) {
+        det_a[I] = a_string_map_[dets[I].get_alfa_bits()];
+        det_b[I] = b_string_map_[dets[I].get_beta_bits()];
+        auto key = std::make_pair(a_class_[det_a[I]], b_class_[det_b[I]]);
+        if (block_index_.count(key) == 0) {
+            size_t na = a_class_strings_[key.first].size();
+            size_t nb = b_class_strings_[key.second].size();
+            block_index_[key] = blocks_.size();
+            blocks_.push_back({key.first, key.second, na, nb, blocked_size_});
+            blocked_size_ += na * nb;
+        }
+    }
+
+    // the blocked C and sigma vectors
+    if (2 * blocked_size_ > max_memory) {
+        throw std::runtime_error(
+            "SigmaVectorGAS: the dense blocks require " + std::to_string(2 * blocked_size_) +
+            " doubles (SIGMA_VECTOR_MAX_MEMORY = " + std::to_string(max_memory) +
+            "). Use a sparse sigma vector algorithm for this space.");
+    }
+
+    det_pos_.resize(ndets);
+    for (size_t I = 0; I < ndets; ++I) {
+        const auto& block = blocks_[block_index_[{a_class_[det_a[I]], b_class_[det_b[I]]}]];
+        det_pos_[I] = block.offset + a_index_[det_a[I]] * block.nb + b_index_[det_b[I]];
+    }
+    C_.assign(blocked_size_, 0.0);
+    S_.assign(blocked_size_, 0.0);
+}
+
+void SigmaVectorGAS::build_same_spin_couplings(bool alpha) {
+    const auto& strings = alpha ? a_strings_ : b_strings_;
+    const auto& string_map = alpha ? a_string_map_ : b_string_map_;
+    const auto& string_class = alpha ? a_class_ : b_class_;
+    const auto& string_index = alpha ? a_index_ : b_index_;
+    const auto& class_strings = alpha ? a_class_strings_ : b_class_strings_;
+    auto& couplings = alpha ? aa_couplings_ : bb_couplings_;
+
+    std::vector<size_t> occ, vir;
+    for (size_t J = 0, maxJ = strings.size(); J < maxJ; ++J) {
+        const String& Js = strings[J];
+        const size_t Jc = string_class[J];
+        const Determinant Jdet = single_spin_det(Js, alpha, nmo_);
+        occ_vir(Js, nmo_, occ, vir);
+
+        auto add_coupling = [&](const String& Is) {
+            auto it = string_map.find(Is);
+            if (it == string_map.end())
+                return;
+            size_t I = it->second;
+            double H = fci_ints_->slater_rules(Jdet, single_spin_det(Is, alpha, nmo_));
+            if (H == 0.0)
+                return;
+            auto& list = couplings[std::make_pair(Jc, string_class[I])];
+            if (list.empty())
+                list.resize(class_strings[Jc].size());
+            list[string_index[J]].push_back({string_index[I], H});
+        };
+
+        // single replacements
+        for (size_t i : occ) {
+            for (size_t a : vir) {
+                String Is = Js;
+                Is.set_bit(i, false);
+                Is.set_bit(a, true);
+                add_coupling(Is);
+            }
+        }
+        // double replacements
+        for (size_t ii = 0, nocc = occ.size(); ii < nocc; ++ii) {
+            for (size_t jj = ii + 1; jj < nocc; ++jj) {
+                for (size_t aa = 0, nvir = vir.size(); aa < nvir; ++aa) {
+                    for (size_t bb = aa + 1; bb < nvir; ++bb) {
+                        String Is = Js;
+                        Is.set_bit(occ[ii], false);
+                        Is.set_bit(occ[jj], false);
+                        Is.set_bit(vir[aa], true);
+                        Is.set_bit(vir[bb], true);
+                        add_coupling(Is);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SigmaVectorGAS::build_alpha_substitutions() {
+    // J = sign E_pq I, including the diagonal replacements E_qq I = I (q occupied)
+    const size_t nmo2 = nmo_ * nmo_;
+    std::vector<size_t> occ, vir;
+    for (size_t I = 0, maxI = a_strings_.size(); I < maxI; ++I) {
+        const String& Is = a_strings_[I];
+        occ_vir(Is, nmo_, occ, vir);
+        for (size_t q : occ) {
+            auto& diag_list = a_subs_[std::make_pair(a_class_[I], a_class_[I])];
+            if (diag_list.empty())
+                diag_list.resize(nmo2);
+            diag_list[q * nmo_ + q].push_back({a_index_[I], a_index_[I], 1.0});
+            for (size_t p : vir) {
+                String Js = Is;
+                Js.set_bit(q, false);
+                Js.set_bit(p, true);
+                auto it = a_string_map_.find(Js);
+                if (it == a_string_map_.end())
+                    continue;
+                size_t J = it->second;
+                auto& list = a_subs_[std::make_pair(a_class_[I], a_class_[J])];
+                if (list.empty())
+                    list.resize(nmo2);
+                list[p * nmo_ + q].push_back({a_index_[I], a_index_[J], Is.slater_sign(p, q)});
+            }
+        }
+    }
+}
+
+void SigmaVectorGAS::build_beta_substitutions() {
+    // J = sign E_rs I, including the diagonal replacements E_rr J = J (r occupied)
+    const size_t nmo2 = nmo_ * nmo_;
+    std::vector<size_t> occ, vir;
+    for (size_t J = 0, maxJ = b_strings_.size(); J < maxJ; ++J) {
+        const String& Js = b_strings_[J];
+        const size_t Jc = b_class_[J];
+        occ_vir(Js, nmo_, occ, vir);
+        for (size_t r : occ) {
+            auto& diag_list = b_subs_[std::make_pair(Jc, Jc)];
+            if (diag_list.empty())
+                diag_list.resize(b_class_strings_[Jc].size());
+            diag_list[b_index_[J]].push_back({b_index_[J], r * nmo2 + r, 1.0});
+            for (size_t s : vir) {
+                String Is = Js;
+                Is.set_bit(r, false);
+                Is.set_bit(s, true);
+                auto it = b_string_map_.find(Is);
+                if (it == b_string_map_.end())
+                    continue;
+                size_t I = it->second;
+                auto& list = b_subs_[std::make_pair(b_class_[I], Jc)];
+                if (list.empty())
+                    list.resize(b_class_strings_[Jc].size());
+                list[b_index_[J]].push_back({b_index_[I], r * nmo2 + s, Js.slater_sign(r, s)});
+            }
+        }
+    }
+}
+
+void SigmaVectorGAS::build_tasks() {
+    auto find_block = [&](size_t ac, size_t bc) {
+        auto it = block_index_.find(std::make_pair(ac, bc));
+        return it == block_index_.end() ? blocks_.size() : it->second;
+    };
+    const size_t nablock = a_class_strings_.size();
+    const size_t nbblock = b_class_strings_.size();
+
+    // (target, source) alpha classes, same beta class
+    for (const auto& [classes, couplings] : aa_couplings_) {
+        for (size_t bc = 0; bc < nbblock; ++bc) {
+            size_t target = find_block(classes.first, bc);
+            size_t source = find_block(classes.second, bc);
+            if ((target < blocks_.size()) and (source < blocks_.size()))
+                aa_tasks_.push_back({source, target, &couplings});
+        }
+    }
+    // (target, source) beta classes, same alpha class
+    for (const auto& [classes, couplings] : bb_couplings_) {
+        for (size_t ac = 0; ac < nablock; ++ac) {
+            size_t target = find_block(ac, classes.first);
+            size_t source = find_block(ac, classes.second);
+            if ((target < blocks_.size()) and (source < blocks_.size()))
+                bb_tasks_.push_back({source, target, &couplings});
+        }
+    }
+    // (source, target) alpha and beta classes
+    for (const auto& [a_classes, a_subs] : a_subs_) {
+        for (const auto& [b_classes, b_subs] : b_subs_) {
+            size_t source = find_block(a_classes.first, b_classes.first);
+            size_t target = find_block(a_classes.second, b_classes.second);
+            if ((target < blocks_.size()) and (source < blocks_.size()))
+                ab_tasks_.push_back({source, target, &a_subs, &b_subs});
+        }
+    }
+}
+
+void SigmaVectorGAS::compute_diagonal() {
+    diag_ = fci_ints_->energy(space_.wfn_hash());
+}
+
+void SigmaVectorGAS::add_bad_roots(std::vector<std::vector<std::pair<size_t, double>>>& roots) {
+    bad_states_.clear();
+    for (int i = 0, max_i = roots.size(); i < max_i; ++i) {
+        bad_states_.push_back(roots[i]);
+    }
+}
+
+void SigmaVectorGAS::get_diagonal(psi::Vector& diag) {
+    std::copy(diag_.begin(), diag_.end(), diag.pointer());
+}
+
+void SigmaVectorGAS::gather(const double* b, std::vector<double>& C) const {
+    std::fill(C.begin(), C.end(), 0.0);
+#pragma omp parallel for
+    for (size_t I = 0; I < size_; ++I) {
+        C[det_pos_[I]] = b[I];
+    }
+}
+
+void SigmaVectorGAS::compute_sigma(psi::SharedVector sigma, psi::SharedVector b) {
+    double* sigma_p = sigma->pointer();
+    double* b_p = b->pointer();
+
+    // Project out the bad roots
+    int nbad = bad_states_.size();
+    for (int n = 0; n < nbad; ++n) {
+        std::vector<std::pair<size_t, double>>& bad_state = bad_states_[n];
+        double overlap = 0.0;
+        for (const auto& [det, c] : bad_state) {
+            overlap += c * b_p[det];
+        }
+        for (const auto& [det, c] : bad_state) {
+            b_p[det] -= c * overlap;
+        }
+    }
+
+    gather(b_p, C_);
+    std::fill(S_.begin(), S_.end(), 0.0);
+
+    apply_aa(C_, S_);
+    apply_bb(C_, S_);
+    apply_ab(C_, S_);
+
+#pragma omp parallel for
+    for (size_t I = 0; I < size_; ++I) {
+        sigma_p[I] = diag_[I] * b_p[I] + S_[det_pos_[I]];
+    }
+}
+
+void SigmaVectorGAS::apply_aa(const std::vector<double>& C, std::vector<double>& S) const {
+    for (const auto& task : aa_tasks_) {
+        const auto& source = blocks_[task.source];
+        const auto& target = blocks_[task.target];
+        const auto& couplings = *task.couplings;
+        const size_t nb = target.nb;
+        const double* C_s = C.data() + source.offset;
+        double* S_t = S.data() + target.offset;
+#pragma omp parallel for schedule(dynamic)
+        for (size_t Ja = 0; Ja < target.na; ++Ja) {
+            double* S_row = S_t + Ja * nb;
+            for (const auto& [Ia, H] : couplings[Ja]) {
+                const double* C_row = C_s + Ia * nb;
+                for (size_t n = 0; n < nb; ++n) {
+                    S_row[n] += H * C_row[n];
+                }
+            }
+        }
+    }
+}
+
+void SigmaVectorGAS::apply_bb(const std::vector<double>& C, std::vector<double>& S) const {
+    for (const auto& task : bb_tasks_) {
+        const auto& source = blocks_[task.source];
+        const auto& target = blocks_[task.target];
+        const auto& couplings = *task.couplings;
+        const size_t nbs = source.nb;
+        const size_t nbt = target.nb;
+        const double* C_s = C.data() + source.offset;
+        double* S_t = S.data() + target.offset;
+#pragma omp parallel for schedule(dynamic)
+        for (size_t Ia = 0; Ia < target.na; ++Ia) {
+            const double* C_row = C_s + Ia * nbs;
+            double* S_row = S_t + Ia * nbt;
+            for (size_t Jb = 0; Jb < nbt; ++Jb) {
+                double s = 0.0;
+                for (const auto& [Ib, H] : couplings[Jb]) {
+                    s += H * C_row[Ib];
+                }
+                S_row[Jb] += s;
+            }
+        }
+    }
+}
+
+void SigmaVectorGAS::apply_ab(const std::vector<double>& C, std::vector<double>& S) const {
+    const size_t nmo2 = nmo_ * nmo_;
+    const size_t nmo3 = nmo2 * nmo_;
+    // scratch space for the gathered coefficients (Ib,k) = sign_k C(Ia_k,Ib)
+    std::vector<double> CT;
+    // the integrals <pr|qs> of a given p, read from the flat integrals if available, otherwise
+    // gathered from the packed ones into tei_p
+    const double* tei_ab = fci_ints_->tei_ab_dense();
+    std::vector<double> tei_p;
+    for (const auto& task : ab_tasks_) {
+        const auto& source = blocks_[task.source];
+        const auto& target = blocks_[task.target];
+        const auto& a_subs = *task.a_subs;
+        const auto& b_subs = *task.b_subs;
+        const size_t nbs = source.nb;
+        const size_t nbt = target.nb;
+        const double* C_s = C.data() + source.offset;
+        double* S_t = S.data() + target.offset;
+
+        for (size_t p = 0; p < nmo_; ++p) {
+            const double* tei_pp = tei_ab ? tei_ab + p * nmo3 : nullptr;
+            for (size_t q = 0; q < nmo_; ++q) {
+                const auto& subs = a_subs[p * nmo_ + q];
+                const size_t nk = subs.size();
+                if (nk == 0)
+                    continue;
+                if (tei_pp == nullptr) {
+                    tei_p.resize(nmo3);
+#pragma omp parallel for
+                    for (size_t r = 0; r < nmo_; ++r) {
+                        for (size_t qq = 0; qq < nmo_; ++qq) {
+                            for (size_t s = 0; s < nmo_; ++s) {
+                                tei_p[r * nmo2 + qq * nmo_ + s] = fci_ints_->tei_ab(p, r, qq, s);
+                            }
+                        }
+                    }
+                    tei_pp = tei_p.data();
+                }
+                const bool diag_a = (p == q);
+                const double* tei_pq = tei_pp + q * nmo_;
+                CT.resize(nbs * nk);
+
+#pragma omp parallel
+                {
+#pragma omp for
+                    for (size_t Ib = 0; Ib < nbs; ++Ib) {
+                        double* CT_row = CT.data() + Ib * nk;
+                        for (size_t k = 0; k < nk; ++k) {
+                            CT_row[k] = subs[k].sign * C_s[subs[k].I * nbs + Ib];
+                        }
+                    }
+
+                    // each thread owns a set of target beta strings
+                    std::vector<double> D(nk);
+#pragma omp for schedule(dynamic)
+                    for (size_t Jb = 0; Jb < nbt; ++Jb) {
+                        std::fill(D.begin(), D.end(), 0.0);
+                        bool nonzero = false;
+                        for (const auto& [Ib, rs, sign] : b_subs[Jb]) {
+                            // skip the diagonal part, which is added separately
+                            if (diag_a and (rs / nmo2 == rs % nmo2))
+                                continue;
+                            const double V = sign * tei_pq[rs];
+                            if (V == 0.0)
+                                continue;
+                            const double* CT_row = CT.data() + Ib * nk;
+                            for (size_t k = 0; k < nk; ++k) {
+                                D[k] += V * CT_row[k];
+                            }
+                            nonzero = true;
+                        }
+                        if (nonzero) {
+                            for (size_t k = 0; k < nk; ++k) {
+                                S_t[subs[k].J * nbt + Jb] += D[k];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+double SigmaVectorGAS::compute_spin(const std::vector<double>& c) {
+    double S2 = 0.0;
+    const det_hashvec& wfn_map = space_.wfn_hash();
+    for (size_t I = 0, max_I = wfn_map.size(); I < max_I; ++I) {
+        // Compute the diagonal contribution
+        const Determinant& PhiI = wfn_map[I];
+        double CI = c[I];
+        int npair = PhiI.npair();
+        int na = PhiI.count_alfa();
+        int nb = PhiI.count_beta();
+        double ms = 0.5 * static_cast<double>(na - nb);
+        S2 += (ms * ms - ms + static_cast<double>(na) - static_cast<double>(npair)) * CI * CI;
+    }
+
+    // Off-diagonal contribution: - sum_{p != q} <J| a+_pa a_qa a+_qb a_pb |I> C_J C_I
+    std::vector<double> C(blocked_size_, 0.0);
+    gather(c.data(), C);
+    const size_t nmo2 = nmo_ * nmo_;
+    for (const auto& task : ab_tasks_) {
+        const auto& source = blocks_[task.source];
+        const auto& target = blocks_[task.target];
+        const auto& a_subs = *task.a_subs;
+        const auto& b_subs = *task.b_subs;
+        const double* C_s = C.data() + source.offset;
+        const double* C_t = C.data() + target.offset;
+        // walk the beta replacements E_qp once and pair each with the alpha list of E_pq
+        for (size_t Jb = 0; Jb < target.nb; ++Jb) {
+            for (const auto& [Ib, rs, sign_b] : b_subs[Jb]) {
+                const size_t q = rs / nmo2;
+                const size_t p = rs % nmo2;
+                if (p == q)
+                    continue;
+                for (const auto& [Ia, Ja, sign_a] : a_subs[p * nmo_ + q]) {
+                    S2 -= sign_a * sign_b * C_t[Ja * target.nb + Jb] * C_s[Ia * source.nb + Ib];
+                }
+            }
+        }
+    }
+    return S2;
+}
+
+} // namespace forte
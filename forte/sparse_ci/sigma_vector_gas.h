@@ -0,0 +1,196 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _sigma_vector_gas_h_
+#define _sigma_vector_gas_h_
+
+#include <map>
+#include <unordered_map>
+
+#include "sigma_vector.h"
+
+namespace psi {
+class Vector;
+}
+
+namespace forte {
+
+/**
+ * @brief The SigmaVectorGAS class
+ * Computes the sigma vector with a string-driven algorithm that exploits the structure of
+ * generalized active spaces (GAS).
+ *
+ * The alpha and beta strings of the determinant space are grouped into classes according to their
+ * GAS occupation pattern (number of electrons in each GAS). A determinant belongs to the block
+ * (alpha class, beta class) and the coefficients of each occupied block are stored as a dense
+ * matrix. The Hamiltonian is applied as in a string-driven FCI code,
+ *
+ *     sigma = sum_{pqrs} (pq|rs) E^a_pq E^b_rs C + alpha-alpha + beta-beta terms,
+ *
+ * but only between pairs of blocks that are both present in the space. Pairs of blocks forbidden by
+ * the GAS restrictions are never visited. Determinants that are absent from a partially occupied
+ * block are treated as zeros, so the result is exact for any determinant space.
+ */
+class SigmaVectorGAS : public SigmaVector {
+  public:
+    /// @param gas_mos the (active-space relative) orbitals in each GAS. Orbitals not listed here
+    ///        are collected in an extra space. If empty, all orbitals belong to the same space.
+    /// @param print print a summary of the blocks
+    SigmaVectorGAS(const DeterminantHashVec& space, std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                   size_t max_memory, const std::vector<std::vector<size_t>>& gas_mos = {},
+                   bool print = true);
+
+    void compute_sigma(std::shared_ptr<psi::Vector> sigma, std::shared_ptr<psi::Vector> b) override;
+    void get_diagonal(psi::Vector& diag) override;
+    void add_bad_roots(std::vector<std::vector<std::pair<size_t, double>>>& bad_states) override;
+    double compute_spin(const std::vector<double>& c) override;
+
+    std::vector<std::vector<std::pair<size_t, double>>> bad_states_;
+
+  protected:
+    /// A dense block of coefficients for the determinants |Ia Ib> with Ia in the alpha class
+    /// aclass and Ib in the beta class bclass. The block is stored row-major (alpha index first)
+    struct StringBlock {
+        size_t aclass;
+        size_t bclass;
+        size_t na;
+        size_t nb;
+        size_t offset;
+    };
+
+    /// A matrix element between two strings (I = index of the string in its class)
+    struct StringCoupling {
+        size_t I;
+        double H;
+    };
+
+    /// A single replacement J = sign E_pq I between strings of two classes
+    struct StringSubstitution {
+        size_t I;
+        size_t J;
+        double sign;
+    };
+
+    /// A single replacement J = sign E_rs I, where rs stores the offset r * nmo^2 + s used to
+    /// address the alpha-beta integrals
+    struct StringRSCoupling {
+        size_t I;
+        size_t rs;
+        double sign;
+    };
+
+    /// Alpha-alpha (or beta-beta) coupling between a source and a target block
+    struct SameSpinTask {
+        size_t source;
+        size_t target;
+        const std::vector<std::vector<StringCoupling>>* couplings;
+    };
+
+    /// Alpha-beta coupling between a source and a target block
+    struct OppositeSpinTask {
+        size_t source;
+        size_t target;
+        const std::vector<std::vector<StringSubstitution>>* a_subs;
+        const std::vector<std::vector<StringRSCoupling>>* b_subs;
+    };
+
+    /// Group the strings into classes according to their GAS occupation
+    void build_string_classes(const std::vector<std::vector<size_t>>& gas_mos);
+    /// Partition the determinants into dense blocks
+    void build_blocks(size_t max_memory);
+    /// Build the alpha-alpha (alpha = true) or beta-beta coupling lists
+    void build_same_spin_couplings(bool alpha);
+    /// Build the list of alpha single replacements used in the alpha-beta term
+    void build_alpha_substitutions();
+    /// Build the list of beta single replacements used in the alpha-beta term
+    void build_beta_substitutions();
+    /// Find all the pairs of blocks connected by the Hamiltonian
+    void build_tasks();
+    /// Compute the diagonal elements of the Hamiltonian
+    void compute_diagonal();
+
+    /// Copy a vector into the blocked storage
+    void gather(const double* b, std::vector<double>& C) const;
+
+    /// sigma += H_aa C
+    void apply_aa(const std::vector<double>& C, std::vector<double>& S) const;
+    /// sigma += H_bb C
+    void apply_bb(const std::vector<double>& C, std::vector<double>& S) const;
+    /// sigma += H_ab C
+    void apply_ab(const std::vector<double>& C, std::vector<double>& S) const;
+
+    /// The number of molecular orbitals
+    size_t nmo_ = 0;
+
+    /// The alpha strings in the space
+    std::vector<String> a_strings_;
+    /// The beta strings in the space
+    std::vector<String> b_strings_;
+    /// Map from alpha/beta strings to their index (used only during the setup)
+    std::unordered_map<String, size_t, String::Hash> a_string_map_;
+    std::unordered_map<String, size_t, String::Hash> b_string_map_;
+    /// The class of each alpha/beta string
+    std::vector<size_t> a_class_;
+    std::vector<size_t> b_class_;
+    /// The index of each alpha/beta string within its class
+    std::vector<size_t> a_index_;
+    std::vector<size_t> b_index_;
+    /// The strings that belong to each alpha/beta class
+    std::vector<std::vector<size_t>> a_class_strings_;
+    std::vector<std::vector<size_t>> b_class_strings_;
+
+    /// The dense blocks
+    std::vector<StringBlock> blocks_;
+    /// Map (alpha class, beta class) -> block
+    std::map<std::pair<size_t, size_t>, size_t> block_index_;
+    /// The position of each determinant in the blocked storage
+    std::vector<size_t> det_pos_;
+    /// The size of the blocked storage
+    size_t blocked_size_ = 0;
+
+    /// Same-spin couplings indexed by (target class, source class) and by target string
+    std::map<std::pair<size_t, size_t>, std::vector<std::vector<StringCoupling>>> aa_couplings_;
+    std::map<std::pair<size_t, size_t>, std::vector<std::vector<StringCoupling>>> bb_couplings_;
+    /// Alpha single replacements indexed by (source class, target class) and by pq
+    std::map<std::pair<size_t, size_t>, std::vector<std::vector<StringSubstitution>>> a_subs_;
+    /// Beta single replacements indexed by (source class, target class) and by target string
+    std::map<std::pair<size_t, size_t>, std::vector<std::vector<StringRSCoupling>>> b_subs_;
+
+    /// The list of block pairs connected by the Hamiltonian
+    std::vector<SameSpinTask> aa_tasks_;
+    std::vector<SameSpinTask> bb_tasks_;
+    std::vector<OppositeSpinTask> ab_tasks_;
+
+    /// Temporary storage for the blocked C and sigma vectors
+    std::vector<double> C_;
+    std::vector<double> S_;
+};
+
+} // namespace forte
+
+#endif // _sigma_vector_gas_h_
@@ -0,0 +1,384 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libmints/vector.h"
+
+#include "helpers/timer.h"
+#include "integrals/active_space_integrals.h"
+#include "sparse_ci/determinant_substitution_lists.h"
+#include "sigma_vector_gas.h"
+#include "sigma_vector_hybrid.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#define omp_get_num_threads() 1
+#endif
+
+using namespace psi;
+
+namespace forte {
+
+namespace {
+/// Greedy search of a large complete block in a bipartite graph. partners[r] is the sorted list
+/// of columns connected to row r. Returns the rows and the columns of the block.
+std::pair<std::vector<size_t>, std::vector<size_t>>
+greedy_complete_block(const std::vector<std::vector<size_t>>& partners) {
+    std::vector<size_t> order(partners.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return partners[a].size() > partners[b].size();
+    });
+
+    std::vector<size_t> best_cols;
+    size_t best_nrows = 0;
+    if (order.empty())
+        return {{}, {}};
+
+    // add rows in order of decreasing number of partners and keep the common columns
+    std::vector<size_t> cols = partners[order[0]];
+    std::vector<size_t> common;
+    for (size_t k = 0, maxk = order.size(); k < maxk; ++k) {
+        if (k > 0) {
+            const auto& row = partners[order[k]];
+            common.clear();
+            std::set_intersection(cols.begin(), cols.end(), row.begin(), row.end(),
+                                  std::back_inserter(common));
+            std::swap(cols, common);
+        }
+        // no larger block can be formed with the remaining rows
+        if (cols.size() * maxk <= best_nrows * best_cols.size())
+            break;
+        if ((k + 1) * cols.size() > best_nrows * best_cols.size()) {
+            best_nrows = k + 1;
+            best_cols = cols;
+        }
+    }
+    std::vector<size_t> rows(order.begin(), order.begin() + best_nrows);
+    return {rows, best_cols};
+}
+
+/// Move the tail determinants of each list to its front, in place. Returns the indices of the
+/// lists that contain at least one tail determinant and their number of tail determinants.
+template <typename T>
+void partition_tail_lists(std::vector<std::vector<T>>& lists, const std::vector<bool>& is_core,
+                          std::vector<size_t>& tail_lists, std::vector<size_t>& ntail) {
+    tail_lists.clear();
+    ntail.clear();
+    for (size_t K = 0, max_K = lists.size(); K < max_K; ++K) {
+        auto& list = lists[K];
+        auto first_core = std::partition(list.begin(), list.end(), [&](const T& d) {
+            return not is_core[std::get<0>(d)];
+        });
+        size_t n = std::distance(list.begin(), first_core);
+        if (n == 0)
+            continue;
+        tail_lists.push_back(K);
+        ntail.push_back(n);
+    }
+}
+} // namespace
+
+SigmaVectorHybrid::SigmaVectorHybrid(const DeterminantHashVec& space,
+                                     std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                                     size_t max_memory, double min_core_fill)
+    : SigmaVectorSparseList(space, fci_ints, SigmaVectorType::Hybrid, "SigmaVectorHybrid") {
+    local_timer t;
+    find_dense_core();
+
+    double fill = size_ > 0 ? static_cast<double>(core_dets_.size()) / size_ : 0.0;
+    // the dense core needs two vectors of the size of the core
+    if ((fill < min_core_fill) or (2 * core_dets_.size() > max_memory)) {
+        outfile->Printf("\n  Hybrid sigma vector: the dense core contains %zu determinants "
+                        "(%.1f%%), using the sparse algorithm",
+                        core_dets_.size(), 100.0 * fill);
+        core_dets_.clear();
+        is_core_.assign(size_, false);
+        psi::Process::environment.globals["HYBRID SIGMA CORE SIZE"] = 0.0;
+        return;
+    }
+
+    const det_hashvec& dets = space_.wfn_hash();
+    for (size_t I : core_dets_) {
+        core_space_.add(dets[I]);
+    }
+    core_sigma_ = std::make_shared<SigmaVectorGAS>(core_space_, fci_ints_, max_memory,
+                                                   std::vector<std::vector<size_t>>{}, false);
+    core_b_ = std::make_shared<psi::Vector>(core_dets_.size());
+    core_sigma_vec_ = std::make_shared<psi::Vector>(core_dets_.size());
+
+    build_tail_lists();
+
+    outfile->Printf("\n  Hybrid sigma vector: the dense core contains %zu determinants (%.1f%%)",
+                    core_dets_.size(), 100.0 * fill);
+    psi::Process::environment.globals["HYBRID SIGMA CORE SIZE"] =
+        static_cast<double>(core_dets_.size());
+    outfile->Printf("\n  Time to build the hybrid sigma vector: %.3f s", t.get());
+}
+
+SigmaVectorHybrid::~SigmaVectorHybrid() {}
+
+void SigmaVectorHybrid::find_dense_core() {
+    const det_hashvec& dets = space_.wfn_hash();
+    const size_t ndets = dets.size();
+
+    // index the alpha and beta strings and find which strings are paired in the space
+    std::unordered_map<String, size_t, String::Hash> a_map;
+    std::unordered_map<String, size_t, String::Hash> b_map;
+    std::vector<size_t> det_a(ndets);
+    std::vector<size_t> det_b(ndets);
+    for (size_t I = 0; I < ndets; ++I) {
+        det_a[I] = a_map.emplace(dets[I].get_alfa_bits(), a_map.size()).first->second;
+        det_b[I] = b_map.emplace(dets[I].get_beta_bits(), b_map.size()).first->second;
+    }
+    std::vector<std::vector<size_t>> a_partners(a_map.size());
+    std::vector<std::vector<size_t>> b_partners(b_map.size());
+    for (size_t I = 0; I < ndets; ++I) {
+        a_partners[det_a[I]].push_back(det_b[I]);
+        b_partners[det_b[I]].push_back(det_a[I]);
+    }
+    for (auto& v : a_partners)
+        std::sort(v.begin(), v.end());
+    for (auto& v : b_partners)
+        std::sort(v.begin(), v.end());
+
+    // search starting from the alpha and the beta side and keep the largest block
+    auto [a_rows, b_cols] = greedy_complete_block(a_partners);
+    auto [b_rows, a_cols] = greedy_complete_block(b_partners);
+    std::vector<bool> a_core(a_map.size(), false);
+    std::vector<bool> b_core(b_map.size(), false);
+    if (a_rows.size() * b_cols.size() >= b_rows.size() * a_cols.size()) {
+        for (size_t a : a_rows)
+            a_core[a] = true;
+        for (size_t b : b_cols)
+            b_core[b] = true;
+    } else {
+        for (size_t a : a_cols)
+            a_core[a] = true;
+        for (size_t b : b_rows)
+            b_core[b] = true;
+    }
+
+    is_core_.assign(ndets, false);
+    core_dets_.clear();
+    for (size_t I = 0; I < ndets; ++I) {
+        if (a_core[det_a[I]] and b_core[det_b[I]]) {
+            is_core_[I] = true;
+            core_dets_.push_back(I);
+        }
+    }
+}
+
+void SigmaVectorHybrid::build_tail_lists() {
+    // the order of the determinants in a list does not matter to the sparse algorithm
+    partition_tail_lists(op_->a_list_, is_core_, a_tail_, a_ntail_);
+    partition_tail_lists(op_->b_list_, is_core_, b_tail_, b_ntail_);
+    partition_tail_lists(op_->aa_list_, is_core_, aa_tail_, aa_ntail_);
+    partition_tail_lists(op_->bb_list_, is_core_, bb_tail_, bb_ntail_);
+    partition_tail_lists(op_->ab_list_, is_core_, ab_tail_, ab_ntail_);
+}
+
+void SigmaVectorHybrid::compute_sigma(psi::SharedVector sigma, psi::SharedVector b) {
+    if (core_dets_.empty()) {
+        SigmaVectorSparseList::compute_sigma(sigma, b);
+        return;
+    }
+
+    sigma->zero();
+    double* sigma_p = sigma->pointer();
+    double* b_p = b->pointer();
+
+    // Project out the bad roots
+    for (auto& bad_state : bad_states_) {
+        double overlap = 0.0;
+        for (const auto& [det, c] : bad_state) {
+            overlap += c * b_p[det];
+        }
+        for (const auto& [det, c] : bad_state) {
+            b_p[det] -= c * overlap;
+        }
+    }
+
+    // Dense core-core contribution (includes the diagonal)
+    const size_t ncore = core_dets_.size();
+    double* core_b_p = core_b_->pointer();
+    for (size_t k = 0; k < ncore; ++k) {
+        core_b_p[k] = b_p[core_dets_[k]];
+    }
+    core_sigma_->compute_sigma(core_sigma_vec_, core_b_);
+
+    // Sparse contributions: only pairs with at least one tail determinant. Since the tail
+    // determinants come first in each list, the loop over the first index stops at ntail
+    auto& dets = space_.wfn_hash();
+#pragma omp parallel
+    {
+        size_t num_thread = omp_get_num_threads();
+        size_t tid = omp_get_thread_num();
+
+        std::vector<double> sigma_t(size_);
+
+#pragma omp for
+        for (size_t J = 0; J < size_; ++J) {
+            if (not is_core_[J])
+                sigma_t[J] += diag_[J] * b_p[J];
+        }
+
+        // a singles
+        for (size_t K = 0, max_K = a_tail_.size(); K < max_K; ++K) {
+            if ((K % num_thread) != tid)
+                continue;
+            const auto& c_dets = op_->a_list_[a_tail_[K]];
+            for (size_t det = 0, max_det = c_dets.size(), ntail = a_ntail_[K]; det < ntail;
+                 ++det) {
+                const size_t J = c_dets[det].first;
+                const size_t p = std::abs(c_dets[det].second) - 1;
+                double sign_p = c_dets[det].second > 0.0 ? 1.0 : -1.0;
+                for (size_t det2 = det + 1; det2 < max_det; ++det2) {
+                    const size_t q = std::abs(c_dets[det2].second) - 1;
+                    if (p != q) {
+                        const size_t I = c_dets[det2].first;
+                        double sign_q = c_dets[det2].second > 0.0 ? 1.0 : -1.0;
+                        const double HIJ =
+                            fci_ints_->slater_rules_single_alpha_abs(dets[J], p, q) * sign_p *
+                            sign_q;
+                        sigma_t[I] += HIJ * b_p[J];
+                        sigma_t[J] += HIJ * b_p[I];
+                    }
+                }
+            }
+        }
+
+        // b singles
+        for (size_t K = 0, max_K = b_tail_.size(); K < max_K; ++K) {
+            if ((K % num_thread) != tid)
+                continue;
+            const auto& c_dets = op_->b_list_[b_tail_[K]];
+            for (size_t det = 0, max_det = c_dets.size(), ntail = b_ntail_[K]; det < ntail;
+                 ++det) {
+                const size_t J = c_dets[det].first;
+                const size_t p = std::abs(c_dets[det].second) - 1;
+                double sign_p = c_dets[det].second > 0.0 ? 1.0 : -1.0;
+                for (size_t det2 = det + 1; det2 < max_det; ++det2) {
+                    const size_t q = std::abs(c_dets[det2].second) - 1;
+                    if (p != q) {
+                        const size_t I = c_dets[det2].first;
+                        double sign_q = c_dets[det2].second > 0.0 ? 1.0 : -1.0;
+                        const double HIJ =
+                            fci_ints_->slater_rules_single_beta_abs(dets[J], p, q) * sign_p *
+                            sign_q;
+                        sigma_t[I] += HIJ * b_p[J];
+                        sigma_t[J] += HIJ * b_p[I];
+                    }
+                }
+            }
+        }
+
+        // same-spin doubles
+        auto add_same_spin_doubles = [&](const auto& lists, const auto& tails, const auto& ntails,
+                                         bool alpha) {
+            for (size_t K = 0, max_K = tails.size(); K < max_K; ++K) {
+                if ((K % num_thread) != tid)
+                    continue;
+                const auto& c_dets = lists[tails[K]];
+                for (size_t det = 0, max_det = c_dets.size(), ntail = ntails[K]; det < ntail;
+                     ++det) {
+                    const auto& detJ = c_dets[det];
+                    size_t J = std::get<0>(detJ);
+                    short p = std::abs(std::get<1>(detJ)) - 1;
+                    short q = std::get<2>(detJ);
+                    double sign_p = std::get<1>(detJ) > 0.0 ? 1.0 : -1.0;
+                    for (size_t det2 = det + 1; det2 < max_det; ++det2) {
+                        const auto& detI = c_dets[det2];
+                        short r = std::abs(std::get<1>(detI)) - 1;
+                        short s = std::get<2>(detI);
+                        if ((p != r) and (q != s) and (p != s) and (q != r)) {
+                            size_t I = std::get<0>(detI);
+                            double sign_q = std::get<1>(detI) > 0.0 ? 1.0 : -1.0;
+                            double HIJ = sign_p * sign_q *
+                                         (alpha ? fci_ints_->tei_aa(p, q, r, s)
+                                                : fci_ints_->tei_bb(p, q, r, s));
+                            sigma_t[I] += HIJ * b_p[J];
+                            sigma_t[J] += HIJ * b_p[I];
+                        }
+                    }
+                }
+            }
+        };
+        add_same_spin_doubles(op_->aa_list_, aa_tail_, aa_ntail_, true);
+        add_same_spin_doubles(op_->bb_list_, bb_tail_, bb_ntail_, false);
+
+        // AB doubles
+        for (size_t K = 0, max_K = ab_tail_.size(); K < max_K; ++K) {
+            if ((K % num_thread) != tid)
+                continue;
+            const auto& c_dets = op_->ab_list_[ab_tail_[K]];
+            for (size_t det = 0, max_det = c_dets.size(), ntail = ab_ntail_[K]; det < ntail;
+                 ++det) {
+                const auto& detJ = c_dets[det];
+                size_t J = std::get<0>(detJ);
+                short p = std::abs(std::get<1>(detJ)) - 1;
+                short q = std::get<2>(detJ);
+                double sign_p = std::get<1>(detJ) > 0.0 ? 1.0 : -1.0;
+                for (size_t det2 = det + 1; det2 < max_det; ++det2) {
+                    const auto& detI = c_dets[det2];
+                    short r = std::abs(std::get<1>(detI)) - 1;
+                    short s = std::get<2>(detI);
+                    if ((p != r) and (q != s)) {
+                        size_t I = std::get<0>(detI);
+                        double sign_q = std::get<1>(detI) > 0.0 ? 1.0 : -1.0;
+                        double HIJ = sign_p * sign_q * fci_ints_->tei_ab(p, q, r, s);
+                        sigma_t[I] += HIJ * b_p[J];
+                        sigma_t[J] += HIJ * b_p[I];
+                    }
+                }
+            }
+        }
+
+        for (size_t I = 0; I < size_; ++I) {
+#pragma omp atomic update
+            sigma_p[I] += sigma_t[I];
+        }
+    }
+
+    const double* core_sigma_p = core_sigma_vec_->pointer();
+    for (size_t k = 0; k < ncore; ++k) {
+        sigma_p[core_dets_[k]] += core_sigma_p[k];
+    }
+}
+
+} // namespace forte
@@ -0,0 +1,101 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2020 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _sigma_vector_hybrid_h_
+#define _sigma_vector_hybrid_h_
+
+#include "sigma_vector_sparse_list.h"
+
+namespace psi {
+class Vector;
+}
+
+namespace forte {
+
+class SigmaVectorGAS;
+
+/**
+ * @brief The SigmaVectorHybrid class
+ * Computes the sigma vector of a selected CI space by splitting it into a dense core and a sparse
+ * tail.
+ *
+ * The core is the largest complete block of determinants {|Ia Ib>, Ia in A, Ib in B} found in the
+ * space (usually a CAS-like reference). The core-core couplings are computed with the dense
+ * string-driven kernels of SigmaVectorGAS, while the couplings that involve at least one
+ * determinant in the tail are computed from the sparse substitution lists. If the core contains
+ * less than a fraction min_core_fill of the determinants this class falls back to the sparse
+ * algorithm.
+ */
+class SigmaVectorHybrid : public SigmaVectorSparseList {
+  public:
+    SigmaVectorHybrid(const DeterminantHashVec& space,
+                      std::shared_ptr<ActiveSpaceIntegrals> fci_ints, size_t max_memory,
+                      double min_core_fill = 0.2);
+    ~SigmaVectorHybrid();
+
+    void compute_sigma(std::shared_ptr<psi::Vector> sigma, std::shared_ptr<psi::Vector> b) override;
+
+    /// Return the number of determinants in the dense core
+    size_t core_size() const { return core_dets_.size(); }
+
+  protected:
+    /// Find the largest complete alpha x beta block of determinants
+    void find_dense_core();
+    /// Find the substitution lists that contain at least one tail determinant
+    void build_tail_lists();
+
+    /// The determinants in the core (indices in the full space)
+    std::vector<size_t> core_dets_;
+    /// Is a determinant part of the core?
+    std::vector<bool> is_core_;
+    /// The core space (must outlive core_sigma_)
+    DeterminantHashVec core_space_;
+    /// The dense sigma vector for the core
+    std::shared_ptr<SigmaVectorGAS> core_sigma_;
+    /// Temporary vectors for the core
+    std::shared_ptr<psi::Vector> core_b_;
+    std::shared_ptr<psi::Vector> core_sigma_vec_;
+
+    /// Indices of the substitution lists of op_ with at least one tail determinant. The lists of
+    /// op_ are partitioned in place so that the tail determinants come first and the number of
+    /// tail determinants is stored in the corresponding *_ntail_ vector
+    std::vector<size_t> a_tail_;
+    std::vector<size_t> b_tail_;
+    std::vector<size_t> aa_tail_;
+    std::vector<size_t> bb_tail_;
+    std::vector<size_t> ab_tail_;
+    std::vector<size_t> a_ntail_;
+    std::vector<size_t> b_ntail_;
+    std::vector<size_t> aa_ntail_;
+    std::vector<size_t> bb_ntail_;
+    std::vector<size_t> ab_ntail_;
+};
+
+} // namespace forte
+
+#endif // _sigma_vector_hybrid_h_
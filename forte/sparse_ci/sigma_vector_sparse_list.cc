@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "psi4/psi4-dec.h"
@@ -49,7 +50,14 @@ namespace forte {
 
 SigmaVectorSparseList::SigmaVectorSparseList(const DeterminantHashVec& space,
                                              std::shared_ptr<ActiveSpaceIntegrals> fci_ints)
-    : SigmaVector(space, fci_ints, SigmaVectorType::SparseList, "SigmaVectorSparseList") {
+    : SigmaVectorSparseList(space, fci_ints, SigmaVectorType::SparseList,
+                            "SigmaVectorSparseList") {}
+
+SigmaVectorSparseList::SigmaVectorSparseList(const DeterminantHashVec& space,
+                                             std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                                             SigmaVectorType sigma_vector_type,
+                                             const std::string& label)
+    : SigmaVector(space, fci_ints, sigma_vector_type, label) {
 
     op_ = std::make_shared<DeterminantSubstitutionLists>(fci_ints_);
     /// Build the coupling lists for 1- and 2-particle operators
@@ -58,11 +66,19 @@ SigmaVectorSparseList::SigmaVectorSparseList(const DeterminantHashVec& space,
     op_->tp_s_lists(space_);
     //    op_->set_quiet_mode(quiet_mode_);
 
-    const det_hashvec& detmap = space_.wfn_hash();
-    diag_.resize(space_.size());
-    for (size_t I = 0, max_I = detmap.size(); I < max_I; ++I) {
-        diag_[I] = fci_ints_->energy(detmap[I]);
-    }
+    compute_diagonal();
+}
+
+SigmaVectorSparseList::SigmaVectorSparseList(const DeterminantHashVec& space,
+                                             std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                                             std::shared_ptr<DeterminantSubstitutionLists> op)
+    : SigmaVector(space, fci_ints, SigmaVectorType::SparseList, "SigmaVectorSparseList"), op_(op) {
+    op_->update_lists(space_);
+    compute_diagonal();
+}
+
+void SigmaVectorSparseList::compute_diagonal() {
+    diag_ = fci_ints_->energy(space_.wfn_hash());
 }
 
 void SigmaVectorSparseList::add_bad_roots(
@@ -74,17 +90,15 @@ void SigmaVectorSparseList::add_bad_roots(
 }
 
 void SigmaVectorSparseList::get_diagonal(psi::Vector& diag) {
-    for (size_t I = 0; I < diag_.size(); ++I) {
-        diag.set(I, diag_[I]);
-    }
+    std::copy(diag_.begin(), diag_.end(), diag.pointer());
 }
 
 void SigmaVectorSparseList::compute_sigma(psi::SharedVector sigma, psi::SharedVector b) {
-    auto a_list_ = op_->a_list_;
-    auto b_list_ = op_->b_list_;
-    auto aa_list_ = op_->aa_list_;
-    auto ab_list_ = op_->ab_list_;
-    auto bb_list_ = op_->bb_list_;
+    const auto& a_list_ = op_->a_list_;
+    const auto& b_list_ = op_->b_list_;
+    const auto& aa_list_ = op_->aa_list_;
+    const auto& ab_list_ = op_->ab_list_;
+    const auto& bb_list_ = op_->bb_list_;
 
     sigma->zero();
 
@@ -295,7 +309,7 @@ void SigmaVectorSparseList::compute_sigma(psi::SharedVector sigma, psi::SharedVe
 }
 
 double SigmaVectorSparseList::compute_spin(const std::vector<double>& c) {
-    auto ab_list_ = op_->ab_list_;
+    const auto& ab_list_ = op_->ab_list_;
 
     double S2 = 0.0;
     const det_hashvec& wfn_map = space_.wfn_hash();
@@ -45,6 +45,11 @@ class SigmaVectorSparseList : public SigmaVector {
   public:
     SigmaVectorSparseList(const DeterminantHashVec& space,
                           std::shared_ptr<ActiveSpaceIntegrals> fci_ints);
+    /// Build a sigma vector reusing the coupling lists of a previous space. The lists in op are
+    /// updated (see DeterminantSubstitutionLists::update_lists) and shared with this object.
+    SigmaVectorSparseList(const DeterminantHashVec& space,
+                          std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                          std::shared_ptr<DeterminantSubstitutionLists> op);
 
     void compute_sigma(std::shared_ptr<psi::Vector> sigma, std::shared_ptr<psi::Vector> b) override;
     void get_diagonal(psi::Vector& diag) override;
@@ -54,6 +59,14 @@ class SigmaVectorSparseList : public SigmaVector {
     std::vector<std::vector<std::pair<size_t, double>>> bad_states_;
 
   protected:
+    /// Build the coupling lists for a derived sigma vector algorithm
+    SigmaVectorSparseList(const DeterminantHashVec& space,
+                          std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
+                          SigmaVectorType sigma_vector_type, const std::string& label);
+
+    /// Compute the diagonal elements of the Hamiltonian
+    void compute_diagonal();
+
     bool print_;
     bool use_disk_ = false;
     /// Substitutions lists
@@ -38,7 +38,7 @@ size_t num_success_ = 0;
 
 StateVector SparseExp::compute(const SparseOperator& sop, const StateVector& state0,
                                const std::string& algorithm, double scaling_factor, int maxk,
-                               double screen_thresh) {
+                               double screen_thresh, bool adaptive) {
     local_timer t;
     Algorithm alg = Algorithm::Cached;
     if (algorithm == "onthefly") {
@@ -48,7 +48,9 @@ StateVector SparseExp::compute(const SparseOperator& sop, const StateVector& sta
         alg = Algorithm::OnTheFlyStd;
     }
 
-    auto state = apply_exp_operator(sop, state0, scaling_factor, maxk, screen_thresh, alg);
+    auto state = adaptive ? apply_exp_operator_adaptive(sop, state0, scaling_factor, maxk,
+                                                        screen_thresh, alg)
+                          : apply_exp_operator(sop, state0, scaling_factor, maxk, screen_thresh, alg);
 
     timings_["total"] = t.get();
     return state;
@@ -66,13 +68,7 @@ StateVector SparseExp::apply_exp_operator(const SparseOperator& sop, const State
     double factor = 1.0;
     for (int k = 1; k <= maxk; k++) {
         factor *= scaling_factor / static_cast<double>(k);
-        if (alg == Algorithm::Cached) {
-            new_terms = apply_operator_cached(sop, state, screen_thresh);
-        } else if (alg == Algorithm::OnTheFlyStd) {
-            new_terms = apply_operator_std(sop, state, screen_thresh);
-        } else if (alg == Algorithm::OnTheFlySorted) {
-            new_terms = apply_operator_sorted(sop, state, screen_thresh);
-        }
+        new_terms = apply_operator(sop, state, screen_thresh, alg);
         double norm = 0.0;
         double inf_norm = 0.0;
         for (const auto& det_c : new_terms) {
@@ -90,6 +86,55 @@ StateVector SparseExp::apply_exp_operator(const SparseOperator& sop, const State
     return exp_state;
 }
 
+StateVector SparseExp::apply_exp_operator_adaptive(const SparseOperator& sop,
+                                                   const StateVector& state0,
+                                                   double scaling_factor, int maxk,
+                                                   double screen_thresh, Algorithm alg) {
+    StateVector exp_state(state0);
+    // the k-th term of the expansion, op^k/k! |state0>, including its prefactor
+    StateVector state(state0);
+
+    for (int k = 1; k <= maxk; k++) {
+        StateVector new_terms = apply_operator(sop, state, screen_thresh, alg);
+        // the previous term is no longer needed, release it before accumulating
+        state.clear();
+
+        local_timer t_prune;
+        const double factor = scaling_factor / static_cast<double>(k);
+        double norm = 0.0;
+        auto& terms = new_terms.map();
+        for (auto it = terms.begin(); it != terms.end();) {
+            const double delta_exp = factor * it->second;
+            exp_state[it->first] += delta_exp;
+            norm += delta_exp * delta_exp;
+            // prune the elements that are too small to contribute to the next order
+            if (std::fabs(delta_exp) < screen_thresh) {
+                it = terms.erase(it);
+            } else {
+                it->second = delta_exp;
+                ++it;
+            }
+        }
+        timings_["prune"] += t_prune.get();
+
+        if (std::sqrt(norm) < screen_thresh or new_terms.size() == 0) {
+            break;
+        }
+        state = std::move(new_terms);
+    }
+    return exp_state;
+}
+
+StateVector SparseExp::apply_operator(const SparseOperator& sop, const StateVector& state0,
+                                      double screen_thresh, Algorithm alg) {
+    if (alg == Algorithm::OnTheFlyStd) {
+        return apply_operator_std(sop, state0, screen_thresh);
+    } else if (alg == Algorithm::OnTheFlySorted) {
+        return apply_operator_sorted(sop, state0, screen_thresh);
+    }
+    return apply_operator_cached(sop, state0, screen_thresh);
+}
+
 StateVector SparseExp::apply_operator_cached(const SparseOperator& sop, const StateVector& state0,
                                              double screen_thresh) {
     // make a copy of the state
@@ -72,9 +72,13 @@ class SparseExp {
     /// @param screen_thresh a threshold to select which elements of the operator applied to the state.
     /// An operator in the form exp(t ...), where t is an amplitude, will be applied to a determinant
     /// Phi_I with coefficient C_I if the product |t * C_I| > screen_threshold
+    /// @param adaptive if true, the k-th term op^k/k! |state> is stored with its prefactor
+    /// included, coefficients smaller than screen_thresh are pruned before the next order is
+    /// computed, and the expansion stops when the norm of the k-th term drops below screen_thresh.
+    /// This reduces the number of operator applications and the number of determinants stored.
     StateVector compute(const SparseOperator& sop, const StateVector& state,
                         const std::string& algorithm = "cached", double scaling_factor = 1.0,
-                        int maxk = 19, double screen_thresh = 1.0e-12);
+                        int maxk = 19, double screen_thresh = 1.0e-12, bool adaptive = false);
     /// @return timings for this class
     std::map<std::string, double> timings() const;
 
@@ -82,6 +86,11 @@ class SparseExp {
     StateVector apply_exp_operator(const SparseOperator& sop, const StateVector& state0,
                                    double scaling_factor, int maxk, double screen_thresh,
                                    Algorithm alg);
+    StateVector apply_exp_operator_adaptive(const SparseOperator& sop, const StateVector& state0,
+                                            double scaling_factor, int maxk, double screen_thresh,
+                                            Algorithm alg);
+    StateVector apply_operator(const SparseOperator& sop, const StateVector& state0,
+                               double screen_thresh, Algorithm alg);
     StateVector apply_operator_cached(const SparseOperator& sop, const StateVector& state0,
                                       double screen_thresh);
     StateVector apply_operator_sorted(const SparseOperator& sop, const StateVector& state0,
@@ -89,7 +98,6 @@ class SparseExp {
     StateVector apply_operator_std(const SparseOperator& sop, const StateVector& state0,
                                    double screen_thresh);
 
-
     std::map<std::string, double> timings_;
     DeterminantHashVec exp_hash_;
     // map Determinant -> [(operator, new determinant, factor),...]
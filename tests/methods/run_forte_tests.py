@@ -7,6 +7,7 @@ import shutil
 import subprocess
 import sys
 import re
+import shlex
 import time
 import yaml
 
@@ -32,35 +33,46 @@ class bcolors:
     ENDC = '\033[0m'
 
 
-def run_job(jobdir, psi4command, test_results, test_time):
-    """Run a test in jobdir using the psi4command"""
+def run_job(jobdir, command, test_results, test_time, label=None):
+    """Run a test in jobdir using command (the psi4 executable and its arguments)"""
+    label = jobdir if label is None else label
     start = time.time()
     os.chdir(jobdir)
     successful = True
     # Run Psi4
     try:
-        out = subprocess.check_output([psi4command, "-n2"])
+        out = subprocess.check_output(command)
     except:
         # something went wrong
         successful = False
-        test_results[jobdir] = 'FAILED'
+        test_results[label] = 'FAILED'
 
     # check if Forte ended successfully
     if successful:
         timing = open('output.dat').read()
         m = TIMING_RE.search(timing)
         if m:
-            test_results[jobdir] = 'PASSED'
+            test_results[label] = 'PASSED'
         else:
-            test_results[jobdir] = 'FAILED'
+            test_results[label] = 'FAILED'
             successful = False
         print(out.decode('utf-8'))
     os.chdir(MAINDIR)
     end = time.time()
-    test_time[jobdir] = end - start
+    test_time[label] = end - start
     return successful
 
 
+def job_commands(test, psi4command, args):
+    """Return the (label, command) pairs used to run a test"""
+    if not args.mpi:
+        return [(test, [psi4command, "-n2"])]
+    # one run per number of MPI processes, each process with one thread
+    return [('{} (np {})'.format(test, nproc),
+             shlex.split(args.mpiexec) + ['-n', str(nproc), psi4command, '-n1'])
+            for nproc in args.mpi]
+
+
 def prepare_summary(jobdir, test_results, test_time, summary, color):
     """Append the result of a computation to a summary"""
     if test_results[jobdir] == 'PASSED':
@@ -107,6 +119,13 @@ def setup_argument_parser():
     parser.add_argument('--group',
                         help='which group of tests to run? (default: None)',
                         default=None)
+    parser.add_argument('--mpi',
+                        help='run each test under MPI with these numbers of processes'
+                        ' (needs Forte built with ENABLE_MPI, e.g. --file mpi_tests.yaml --mpi 2 3)',
+                        type=int, nargs='+', default=None)
+    parser.add_argument('--mpiexec',
+                        help='the MPI launcher and its options (default: mpirun)',
+                        default='mpirun')
     return parser.parse_args()
 
 
@@ -168,16 +187,18 @@ def main():
                 local_failed_tests = []
                 if test_level in TEST_LEVELS[args.type]:
                     for test in tests:
-                        print('    Running test {}'.format(test.upper()))
-                        successful = run_job(test, psi4command, test_results,
-                                             test_time)
-                        if not successful:
-                            local_failed_tests.append(test)
-                            nfailed += 1
-                        total_time += prepare_summary(test, test_results,
-                                                      test_time, summary,
-                                                      not args.bw)
-                    ntests += len(tests)
+                        for label, command in job_commands(test, psi4command, args):
+                            print('    Running test {}'.format(label.upper()))
+                            successful = run_job(test, command, test_results,
+                                                 test_time, label)
+                            if not successful:
+                                if test not in local_failed_tests:
+                                    local_failed_tests.append(test)
+                                nfailed += 1
+                            total_time += prepare_summary(label, test_results,
+                                                          test_time, summary,
+                                                          not args.bw)
+                            ntests += 1
                     if len(local_failed_tests) > 0:
                         group_failed_tests[test_level] = local_failed_tests
             if len(group_failed_tests) > 0:
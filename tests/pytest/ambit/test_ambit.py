@@ -14,4 +14,7 @@ def test_ambit():
             for k in range(shape[2]):
                 assert t[i][j][k] == n
                 n += 1
+    # the array is a read-only view that keeps the tensor alive
+    assert not t.flags.writeable
+    assert not t.flags.owndata
     forte.cleanup()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import pytest
+
+
+def test_rdms_views():
+    """Test the numpy views of the RDMs and that the derived quantities follow a modified 2-RDM"""
+    import psi4
+    import forte
+
+    psi4.core.clean()
+    # need to clean the options otherwise this job will interfere
+    forte.clean_options()
+
+    psi4.geometry("""
+     H
+     H 1 1.0
+     H 2 1.0 1 90.0
+     H 3 1.0 2 90.0 1 0.0
+     symmetry c1
+    """)
+
+    psi4.set_options({'basis': 'sto-3g', 'scf_type': 'pk', 'e_convergence': 10})
+    psi4.set_module_options('FORTE', {'active_space_solver': 'fci'})
+    E_scf, wfn = psi4.energy('scf', return_wfn=True)
+
+    forte.startup()
+    options = forte.prepare_forte_options()
+    mo_space_info = forte.make_mo_space_info(wfn.nmopi(), 'c1', options)
+    state_weights_map, mo_space_info, scf_info = forte.prepare_forte_objects_from_psi4_wfn(
+        options, wfn, mo_space_info)
+    ints = forte.make_ints_from_psi4(wfn, options, mo_space_info)
+    as_ints = forte.make_active_space_ints(mo_space_info, ints, 'ACTIVE', ['RESTRICTED_DOCC'])
+    state_map = forte.to_state_nroots_map(state_weights_map)
+    solver = forte.make_active_space_solver('FCI', state_map, scf_info, mo_space_info, as_ints,
+                                            options)
+    solver.compute_energy()
+    rdms = solver.compute_average_rdms(state_weights_map, 2)
+
+    # the default views are read-only
+    g2ab = rdms.g2ab()
+    assert not g2ab.flags.writeable
+    with pytest.raises(ValueError):
+        g2ab[0, 0, 0, 0] = 1.0
+    L2ab = rdms.L2ab()
+    SFg2 = rdms.SFg2_data()
+    assert not L2ab.flags.writeable
+    assert not SFg2.flags.writeable
+    L2ab_0000 = L2ab[0, 0, 0, 0]
+    SFg2_0000 = SFg2[0, 0, 0, 0]
+
+    # modify the alpha-beta 2-RDM through a writable view
+    g2ab_w = rdms.g2ab(writable=True)
+    assert g2ab_w.flags.writeable
+    g2ab_w[0, 0, 0, 0] += 0.1
+    assert rdms.g2ab()[0, 0, 0, 0] == pytest.approx(g2ab_w[0, 0, 0, 0], 1.0e-12)
+
+    # L2ab[pqrs] = g2ab[pqrs] - g1a[pr] g1b[qs], SFg2[0000] contains g2ab[0000] twice
+    assert rdms.L2ab()[0, 0, 0, 0] == pytest.approx(L2ab_0000 + 0.1, 1.0e-12)
+    assert rdms.SFg2_data()[0, 0, 0, 0] == pytest.approx(SFg2_0000 + 0.2, 1.0e-12)
+
+    forte.cleanup()
+    psi4.core.clean()
+
+
+if __name__ == "__main__":
+    test_rdms_views()
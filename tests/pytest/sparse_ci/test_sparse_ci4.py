@@ -90,6 +90,20 @@ def test_sparse_ci4():
     assert wfn[det("0220")] == pytest.approx(+0.158390400605, abs=1e-9)
     assert wfn[det("2200")] == pytest.approx(+0.978860446763, abs=1e-9)
 
+    exp = forte.SparseExp()
+    wfn = exp.compute(op, ref, adaptive=True)
+    assert wfn[det("-2+0")] == pytest.approx(-0.091500564912, abs=1e-9)
+    assert wfn[det("+2-0")] == pytest.approx(-0.091500564912, abs=1e-9)
+    assert wfn[det("0220")] == pytest.approx(+0.158390400605, abs=1e-9)
+    assert wfn[det("2200")] == pytest.approx(+0.978860446763, abs=1e-9)
+
+    exp = forte.SparseExp()
+    wfn = exp.compute(op, ref, algorithm='onthefly', adaptive=True)
+    assert wfn[det("-2+0")] == pytest.approx(-0.091500564912, abs=1e-9)
+    assert wfn[det("+2-0")] == pytest.approx(-0.091500564912, abs=1e-9)
+    assert wfn[det("0220")] == pytest.approx(+0.158390400605, abs=1e-9)
+    assert wfn[det("2200")] == pytest.approx(+0.978860446763, abs=1e-9)
+
     exp = forte.SparseExp()
     wfn = exp.compute(op, ref)
     wfn2 = exp.compute(op, wfn, scaling_factor=-1.0)
@@ -114,6 +128,14 @@ def test_sparse_ci4():
     assert wfn2[det("+2-0")] == pytest.approx(0.0, abs=1e-9)
     assert wfn2[det("-2+0")] == pytest.approx(0.0, abs=1e-9)
 
+    exp = forte.SparseExp()
+    wfn = exp.compute(op, ref, adaptive=True)
+    wfn2 = exp.compute(op, wfn, scaling_factor=-1.0, adaptive=True)
+    assert wfn2[det("2200")] == pytest.approx(1.0, abs=1e-9)
+    assert wfn2[det("0220")] == pytest.approx(0.0, abs=1e-9)
+    assert wfn2[det("+2-0")] == pytest.approx(0.0, abs=1e-9)
+    assert wfn2[det("-2+0")] == pytest.approx(0.0, abs=1e-9)
+
     ### Test the factorized exponential operator ###
     op = forte.SparseOperator(antihermitian=True)
     op.add_term_from_str('[2a+ 0a-]', 0.1)